@@ -37,5 +37,6 @@ if test $PHP_CRYPTOPP != "no"; then
     PHP_SUBST(CRYPTOPP_SHARED_LIBADD)
     PHP_ADD_LIBRARY(stdc++, 1, CRYPTOPP_SHARED_LIBADD)
     PHP_ADD_LIBRARY(cryptopp, 1, CRYPTOPP_SHARED_LIBADD)
+    PHP_ADD_LIBRARY(pthread, 1, CRYPTOPP_SHARED_LIBADD)
     PHP_NEW_EXTENSION(cryptopp, $SRC_FILE_LIST, $ext_shared)
 fi
@@ -58,6 +58,7 @@ configFileList.append("src/hash/config/hash_interface.py")
 configFileList.append("src/hash/config/hash_abstract.py")
 configFileList.append("src/hash/config/hash_md5.py")
 configFileList.append("src/hash/config/hash_sha1.py")
+configFileList.append("src/hash/config/hash_sha2.py")
 configFileList.append("src/hash/config/hash_sha3.py")
 configFileList.append("src/hash/config/hash_proxy.py")
 
@@ -68,6 +69,10 @@ configFileList.append("src/mac/config/mac_cmac.py")
 configFileList.append("src/mac/config/mac_hmac.py")
 configFileList.append("src/mac/config/mac_ttmac.py")
 configFileList.append("src/mac/config/mac_proxy.py")
+configFileList.append("src/mac/config/otp.py")
+configFileList.append("src/mac/config/signing_key_chain.py")
+configFileList.append("src/mac/config/jws.py")
+configFileList.append("src/mac/config/poly1305.py")
 
 configFileList.append("src/prng/config/rbg_interface.py")
 configFileList.append("src/prng/config/rbg.py")
@@ -75,6 +80,7 @@ configFileList.append("src/prng/config/rbg.py")
 configFileList.append("src/symmetric/cipher/config/symmetric_cipher_interface.py")
 configFileList.append("src/symmetric/cipher/config/symmetric_transformation_interface.py")
 configFileList.append("src/symmetric/cipher/config/symmetric_transformation_proxy.py")
+configFileList.append("src/symmetric/cipher/config/key_schedule_cache.py")
 
 configFileList.append("src/symmetric/cipher/block/config/block_cipher.py")
 configFileList.append("src/symmetric/cipher/block/config/block_cipher_interface.py")
@@ -89,6 +95,8 @@ configFileList.append("src/symmetric/cipher/stream/config/stream_cipher_panama.p
 configFileList.append("src/symmetric/cipher/stream/config/stream_cipher_sosemanuk.py")
 configFileList.append("src/symmetric/cipher/stream/config/stream_cipher_salsa20.py")
 configFileList.append("src/symmetric/cipher/stream/config/stream_cipher_xsalsa20.py")
+configFileList.append("src/symmetric/cipher/stream/config/stream_cipher_chacha20.py")
+configFileList.append("src/symmetric/cipher/stream/config/stream_cipher_xchacha20.py")
 
 configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher.py")
 configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_interface.py")
@@ -97,6 +105,10 @@ configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_s
 configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_gcm.py")
 configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_ccm.py")
 configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_eax.py")
+configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_ocb.py")
+configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_chacha20_poly1305.py")
+configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_aes_siv.py")
+configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_secret_box.py")
 configFileList.append("src/symmetric/cipher/authenticated/config/authenticated_symmetric_cipher_proxy.py")
 
 configFileList.append("src/symmetric/mode/config/symmetric_mode.py")
@@ -107,6 +119,7 @@ configFileList.append("src/symmetric/mode/config/symmetric_mode_cfb.py")
 configFileList.append("src/symmetric/mode/config/symmetric_mode_ctr.py")
 configFileList.append("src/symmetric/mode/config/symmetric_mode_ecb.py")
 configFileList.append("src/symmetric/mode/config/symmetric_mode_ofb.py")
+configFileList.append("src/symmetric/mode/config/symmetric_mode_xts.py")
 
 configFileList.append("src/padding/config/padding_interface.py")
 configFileList.append("src/padding/config/padding_no_padding.py")
@@ -115,12 +128,14 @@ configFileList.append("src/padding/config/padding_pkcs7.py")
 configFileList.append("src/filter/config/symmetric_transformation_filter.py")
 configFileList.append("src/filter/config/authenticated_symmetric_transformation_filter.py")
 configFileList.append("src/filter/config/hash_transformation_filter.py")
+configFileList.append("src/filter/config/chunked_authenticated_transformation_filter.py")
 
 # process all config scripts
 phpMinitStatements      = []
 srcFileList             = ["php_cryptopp.cpp", "utils/algo_list.cpp", "utils/zend_object_utils.cpp"]
 headerFileList          = []
 functionDeclarationList = []
+defineList              = []
 hashNativeAssoc         = {}
 hashCryptoppHeaders     = []
 
@@ -149,6 +164,9 @@ for configFile in configFileList:
     if "functionDeclarationList" in config:
         functionDeclarationList.extend(config["functionDeclarationList"])
 
+    if "defineList" in config:
+        defineList.extend(config["defineList"])
+
 # build includes for main header file
 headerFileIncludes = ""
 
@@ -161,9 +179,16 @@ headerFileFunctions = ""
 for i in functionDeclarationList:
     headerFileFunctions += "    " + i + "\n"
 
+# build defines of enabled features for main header file
+headerFileDefines = ""
+
+for i in defineList:
+    headerFileDefines += "#define " + i + " 1\n"
+
 # create main header file
 mainHeaderContent   = open("src/php_cryptopp.raw.h", "r").read()
 mainHeaderContent   = mainHeaderContent.replace("%ext_version%", EXTENSION_VERSION)
+mainHeaderContent   = mainHeaderContent.replace("//%configure_defines%", headerFileDefines)
 open("src/php_cryptopp.h", "w").write(mainHeaderContent)
 
 # create init header file
@@ -0,0 +1,126 @@
+<?php
+
+namespace Cryptopp;
+
+class ChunkedAuthenticatedTransformationFilter
+{
+    /**
+     * Constructor.
+     * Data is split into chunks of $chunkSize bytes, each one being encrypted and authenticated on its own,
+     * so that large files can be processed with constant memory and any range can be decrypted without reading the whole data.
+     * @param \Cryptopp\AuthenticatedSymmetricCipherAbstract $cipher authenticated symmetric cipher to use. It must accept data
+     *        of any size and 16 bytes nonces (e.g. Cryptopp\AuthenticatedSymmetricCipherGcm with Cryptopp\BlockCipherAes).
+     * @param string $keyId [optional] identifier of the key, up to 255 bytes, written in clear in the header of encrypted data
+     * @param int $chunkSize [optional] size of plaintext chunks, between 1 and 8388608. Defaults to 65536.
+     * @throws \Cryptopp\CryptoppException
+     */
+    public function __construct(AuthenticatedSymmetricCipherAbstract $cipher, $keyId = "", $chunkSize = 65536) {}
+
+    /**
+     * Returns the authenticated symmetric cipher used
+     * @return \Cryptopp\AuthenticatedSymmetricCipherAbstract
+     */
+    final public function getCipher() {}
+
+    /**
+     * Returns the key id
+     * @return string
+     */
+    final public function getKeyId() {}
+
+    /**
+     * Returns the size of plaintext chunks
+     * @return int
+     */
+    final public function getChunkSize() {}
+
+    /**
+     * Returns the key id written in the header of encrypted data, to pick the key able to decrypt it.
+     * Only the header is needed.
+     * @param string $data encrypted data
+     * @return string
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function readKeyId($data) {}
+
+    /**
+     * Encrypts data
+     * @param string $data data to encrypt
+     * @return string encrypted data
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function encryptString($data) {}
+
+    /**
+     * Verifies and decrypts data
+     * @param string $ciphertext data to decrypt
+     * @return string decrypted data
+     * @throws \Cryptopp\CryptoppException
+     * @throws \Cryptopp\CryptoppMacVerificationFailedException
+     */
+    final public function decryptString($ciphertext) {}
+
+    /**
+     * Encrypts a stream from its current position to its end, and writes the result to another stream.
+     * Only one chunk at a time is held in memory.
+     * @param resource $input stream to encrypt
+     * @param resource $output stream to write encrypted data to
+     * @return bool
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function encryptStream($input, $output) {}
+
+    /**
+     * Verifies and decrypts a stream from its current position to its end, and writes the result to another stream.
+     * Each chunk is written as soon as it is verified: if an exception is thrown, the chunks before the faulty one are already written.
+     * @param resource $input stream to decrypt
+     * @param resource $output stream to write decrypted data to
+     * @return bool
+     * @throws \Cryptopp\CryptoppException
+     * @throws \Cryptopp\CryptoppMacVerificationFailedException
+     */
+    final public function decryptStream($input, $output) {}
+
+    /**
+     * Encrypts a file into another one
+     * @param string $inputPath path of the file to encrypt
+     * @param string $outputPath path of the encrypted file
+     * @return bool
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function encryptFile($inputPath, $outputPath) {}
+
+    /**
+     * Verifies and decrypts a file into another one.
+     * As with decryptStream(), if an exception is thrown, the output file holds the chunks before the faulty one.
+     * @param string $inputPath path of the file to decrypt
+     * @param string $outputPath path of the decrypted file
+     * @return bool
+     * @throws \Cryptopp\CryptoppException
+     * @throws \Cryptopp\CryptoppMacVerificationFailedException
+     */
+    final public function decryptFile($inputPath, $outputPath) {}
+
+    /**
+     * Verifies and decrypts a range of plaintext. Only the chunks holding it and the last chunk are read and decrypted.
+     * The last chunk is always verified, so that data truncated at a chunk boundary is rejected even if the range does not reach it.
+     * As with substr(), the result is shorter if the range goes past the end of the plaintext.
+     * @param string|resource $input encrypted data, or a seekable stream whose beginning is the beginning of encrypted data
+     * @param int $offset offset of the range in the plaintext
+     * @param int $length length of the range
+     * @return string decrypted range
+     * @throws \Cryptopp\CryptoppException
+     * @throws \Cryptopp\CryptoppMacVerificationFailedException
+     */
+    final public function decryptRange($input, $offset, $length) {}
+
+    /**
+     * Disables object serialization
+     */
+    final public function __sleep() {}
+
+    /**
+     * Disables object serialization
+     */
+    final public function __wakeup() {}
+}
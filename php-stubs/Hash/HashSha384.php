@@ -0,0 +1,11 @@
+<?php
+
+namespace Cryptopp;
+
+class HashSha384 extends HashAbstract
+{
+    /**
+     * Constructor
+     */
+    public function __construct() {}
+}
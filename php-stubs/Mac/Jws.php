@@ -0,0 +1,35 @@
+<?php
+
+namespace Cryptopp;
+
+abstract class Jws
+{
+    /**
+     * Returns a compact JWS token (RFC 7515).
+     * The JWS algorithm (HS256, HS384 or HS512) depends on the MAC.
+     * Native MACs are copied, so that their pending data is kept. A HMAC of a user hash cannot be copied and is rejected
+     * @param array|string $payload payload. Arrays are json encoded
+     * @param \Cryptopp\MacInterface $mac keyed HMAC-SHA256, HMAC-SHA384 or HMAC-SHA512
+     * @return string
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function sign($payload, MacInterface $mac) {}
+
+    /**
+     * Verify a compact JWS token
+     * @param string $token
+     * @param \Cryptopp\MacInterface $mac keyed HMAC-SHA256, HMAC-SHA384 or HMAC-SHA512
+     * @return string|bool the decoded payload, or false if the token is not valid
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function verify($token, MacInterface $mac) {}
+
+    /**
+     * Verify several compact JWS tokens with the same MAC
+     * @param array $tokens
+     * @param \Cryptopp\MacInterface $mac keyed HMAC-SHA256, HMAC-SHA384 or HMAC-SHA512
+     * @return array keys are preserved. each value is the decoded payload, or false if the token is not valid
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function verifyBatch(array $tokens, MacInterface $mac) {}
+}
@@ -0,0 +1,81 @@
+<?php
+
+namespace Cryptopp;
+
+class Otp
+{
+    /**
+     * Constructor
+     * Codes are computed with a copy of a native MAC, so that its pending data is kept. Native MACs that cannot be copied,
+     * such as a HMAC of a user hash, are rejected.
+     * @param \Cryptopp\MacInterface $mac keyed MAC used to compute codes (usually a HMAC)
+     * @param int $digits number of digits of generated codes, between 6 and 8. Default to 6
+     * @param int $period TOTP time step, in seconds. Default to 30
+     * @throws \Cryptopp\CryptoppException
+     */
+    public function __construct(MacInterface $mac, $digits = null, $period = null) {}
+
+    /**
+     * Returns the MAC object
+     * @return \Cryptopp\MacInterface
+     */
+    final public function getMac() {}
+
+    /**
+     * Returns the number of digits of generated codes
+     * @return int
+     */
+    final public function getDigits() {}
+
+    /**
+     * Returns the TOTP time step, in seconds
+     * @return int
+     */
+    final public function getPeriod() {}
+
+    /**
+     * Generates a counter based code (RFC 4226)
+     * @param int $counter
+     * @return string
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function generateHotp($counter) {}
+
+    /**
+     * Generates a time based code (RFC 6238)
+     * @param int $timestamp unix timestamp. Default to the current time
+     * @return string
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function generateTotp($timestamp = null) {}
+
+    /**
+     * Verifies a counter based code against counters from $counter to $counter + $window
+     * @param string $code code to verify
+     * @param int $counter expected counter
+     * @param int $window number of following counters to accept, up to 100. Default to 0
+     * @return int|bool the matching counter, or false if the code is not valid
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function verifyHotp($code, $counter, $window = null) {}
+
+    /**
+     * Verifies a time based code, accepting up to $window time steps before and after the current one
+     * @param string $code code to verify
+     * @param int $window number of time steps to accept on each side, up to 100. Default to 0
+     * @param int $timestamp unix timestamp. Default to the current time
+     * @return bool
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function verify($code, $window = null, $timestamp = null) {}
+
+    /**
+     * Disables object serialization
+     */
+    final public function __sleep() {}
+
+    /**
+     * Disables object serialization
+     */
+    final public function __wakeup() {}
+}
@@ -0,0 +1,58 @@
+<?php
+
+namespace Cryptopp;
+
+class SigningKeyChain
+{
+    /**
+     * Constructor.
+     * Signing keys are derived with a HMAC chain: secret -> date -> region -> service -> terminator.
+     * For AWS signature version 4, use a HMAC-SHA256 and "AWS4" . $secretAccessKey as secret.
+     * @param \Cryptopp\MacHmac $mac HMAC used to derive keys. Its key is left unchanged
+     * @param string $secret initial key of the chain
+     * @param string $terminator last element of the chain. Default to "aws4_request"
+     * @throws \Cryptopp\CryptoppException
+     */
+    public function __construct(MacHmac $mac, $secret, $terminator = null) {}
+
+    /**
+     * Returns the MAC object
+     * @return \Cryptopp\MacHmac
+     */
+    final public function getMac() {}
+
+    /**
+     * Returns the signing key of a scope.
+     * Derived keys are cached. Only the two most recent dates, and 64 scopes per date, are kept in the cache
+     * @param string $date
+     * @param string $region
+     * @param string $service
+     * @return string
+     */
+    final public function getSigningKey($date, $region, $service) {}
+
+    /**
+     * Calculates the MAC of a string with the signing key of a scope
+     * @param string $date
+     * @param string $region
+     * @param string $service
+     * @param string $data
+     * @return string
+     */
+    final public function sign($date, $region, $service, $data) {}
+
+    /**
+     * Removes all cached signing keys
+     */
+    final public function clearCache() {}
+
+    /**
+     * Disables object serialization
+     */
+    final public function __sleep() {}
+
+    /**
+     * Disables object serialization
+     */
+    final public function __wakeup() {}
+}
@@ -84,6 +84,49 @@ abstract class AuthenticatedSymmetricCipherAbstract implements AuthenticatedSymm
      */
     final public function finalizeDecryption() {}
 
+    /**
+     * Encrypts a whole message with the given nonce and authenticates it with the additional data.
+     * The current initialization vector is left unchanged.
+     * @param string $nonce nonce, used as initialization vector for this message only
+     * @param string $plaintext data to encrypt
+     * @param string $aad additional authenticated data
+     * @return string ciphertext followed by the MAC tag
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function seal($nonce, $plaintext, $aad = '') {}
+
+    /**
+     * Verifies and decrypts a message returned by seal().
+     * The current initialization vector is left unchanged.
+     * @param string $nonce nonce given to seal()
+     * @param string $ciphertext ciphertext followed by the MAC tag
+     * @param string $aad additional authenticated data
+     * @return string plaintext
+     * @throws \Cryptopp\CryptoppMacVerificationFailedException if the MAC tag is not valid
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function open($nonce, $ciphertext, $aad = '') {}
+
+    /**
+     * Seals several messages with the current key, in one call.
+     * With GCM and OCB, the blocks of small messages are passed to the block cipher together.
+     * The current initialization vector is left unchanged.
+     * @param array $items each item is an array(nonce, plaintext [, aad])
+     * @return array keys are preserved. each value is the ciphertext followed by the MAC tag
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function sealBatch(array $items) {}
+
+    /**
+     * Verifies and decrypts several messages returned by seal() or sealBatch(), in one call.
+     * With GCM and OCB, the blocks of small messages are passed to the block cipher together.
+     * The current initialization vector is left unchanged.
+     * @param array $items each item is an array(nonce, ciphertext [, aad])
+     * @return array keys are preserved. each value is the plaintext, or false if the message is not authentic
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function openBatch(array $items) {}
+
     /**
      * Disables object serialization
      */
@@ -0,0 +1,17 @@
+<?php
+
+namespace Cryptopp;
+
+class AuthenticatedSymmetricCipherAesSiv extends AuthenticatedSymmetricCipherAbstract
+{
+    /**
+     * Constructor.
+     * Deterministic authenticated encryption of RFC 5297: sealing the same plaintext with the same key, nonce and aad
+     * always gives the same result. With an empty nonce, encrypted values can be compared for equality.
+     * The key is the CMAC key followed by the CTR key: 32, 48 or 64 bytes. The nonce can be of any length.
+     * The synthetic iv is the MAC tag, so messages can only be processed whole with seal(), open(), sealBatch() and openBatch().
+     * Unlike RFC 5297, that places the synthetic iv first, the tag follows the ciphertext as with other authenticated ciphers.
+     * An empty aad or nonce is not authenticated as an S2V component
+     */
+    public function __construct() {}
+}
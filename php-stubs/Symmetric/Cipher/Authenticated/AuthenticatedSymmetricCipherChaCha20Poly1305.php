@@ -0,0 +1,11 @@
+<?php
+
+namespace Cryptopp;
+
+class AuthenticatedSymmetricCipherChaCha20Poly1305 extends AuthenticatedSymmetricCipherAbstract
+{
+    /**
+     * Constructor
+     */
+    public function __construct() {}
+}
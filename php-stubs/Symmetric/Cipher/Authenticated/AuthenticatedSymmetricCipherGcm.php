@@ -7,7 +7,30 @@ class AuthenticatedSymmetricCipherGcm extends AuthenticatedSymmetricCipherAbstra
     /**
      * Constructor
      * @param \Cryptopp\BlockCipherInterface $cipher block cipher to use. Must be a 128 bits (16 bytes) block size cipher.
+     * @param int $tableSize size of the GHASH multiplication table, in bytes. Can be 2048 or 65536.
+     *                       Larger tables are faster on CPUs without carry-less multiplication.
+     *                       The table is computed once per key, the other direction copies it.
      * @throws \Cryptopp\CryptoppException
      */
-    public function __construct(BlockCipherInterface $cipher) {}
+    public function __construct(BlockCipherInterface $cipher, $tableSize = 2048) {}
+
+    /**
+     * Returns the size of the GHASH multiplication table, in bytes
+     * @return int
+     */
+    final public function getTableSize() {}
+
+    /**
+     * Sets the data size from which encryption and decryption are split between several threads.
+     * Only applies to native block ciphers. GHASH is computed by the calling thread.
+     * @param int $threshold size in bytes. 0 disables multi-threading. Defaults to 4MB.
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function setParallelThreshold($threshold) {}
+
+    /**
+     * Returns the data size from which encryption and decryption are split between several threads
+     * @return int
+     */
+    final public function getParallelThreshold() {}
 }
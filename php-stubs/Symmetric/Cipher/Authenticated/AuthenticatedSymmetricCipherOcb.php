@@ -0,0 +1,13 @@
+<?php
+
+namespace Cryptopp;
+
+class AuthenticatedSymmetricCipherOcb extends AuthenticatedSymmetricCipherAbstract
+{
+    /**
+     * Constructor
+     * @param \Cryptopp\BlockCipherInterface $cipher block cipher to use
+     * @throws \Cryptopp\CryptoppException
+     */
+    public function __construct(BlockCipherInterface $cipher) {}
+}
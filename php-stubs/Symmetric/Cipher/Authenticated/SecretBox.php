@@ -0,0 +1,28 @@
+<?php
+
+namespace Cryptopp;
+
+abstract class SecretBox
+{
+    /**
+     * Encrypts and authenticates data with XSalsa20-Poly1305.
+     * The result is the 16 bytes tag followed by the ciphertext, as produced by NaCl/libsodium crypto_secretbox_easy()
+     * @param string $key 32 bytes key
+     * @param string $nonce 24 bytes nonce. Must never be reused with the same key
+     * @param string $data
+     * @return string
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function seal($key, $nonce, $data) {}
+
+    /**
+     * Verifies and decrypts data produced by seal() or by NaCl/libsodium crypto_secretbox_easy()
+     * @param string $key 32 bytes key
+     * @param string $nonce 24 bytes nonce
+     * @param string $data tag followed by the ciphertext
+     * @return string
+     * @throws \Cryptopp\CryptoppException
+     * @throws \Cryptopp\CryptoppMacVerificationFailedException
+     */
+    public static function open($key, $nonce, $data) {}
+}
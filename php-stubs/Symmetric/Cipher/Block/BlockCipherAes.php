@@ -8,4 +8,22 @@ class BlockCipherAes extends BlockCipherAbstract
      * Constructor
      */
     public function __construct() {}
+
+    /**
+     * Encrypts several messages with AES in CTR mode, each one under its own key.
+     * Blocks of different messages are processed together, which is much faster than
+     * one SymmetricModeCtr per message for short messages.
+     * @param array $items list of array($key, $iv, $plaintext)
+     * @return array ciphertexts. keys are preserved
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function encryptCtrBatch(array $items) {}
+
+    /**
+     * Decrypts several messages with AES in CTR mode, each one under its own key
+     * @param array $items list of array($key, $iv, $ciphertext)
+     * @return array plaintexts. keys are preserved
+     * @throws \Cryptopp\CryptoppException
+     */
+    public static function decryptCtrBatch(array $items) {}
 }
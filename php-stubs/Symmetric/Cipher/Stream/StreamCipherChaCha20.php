@@ -0,0 +1,19 @@
+<?php
+
+namespace Cryptopp;
+
+class StreamCipherChaCha20 extends StreamCipherAbstract
+{
+    /**
+     * Constructor
+     */
+    public function __construct() {}
+
+    /**
+     * Moves to a byte offset of the keystream, relative to the initialization vector.
+     * Data before the offset is neither encrypted nor decrypted.
+     * @param int $offset byte offset
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function seek($offset) {}
+}
@@ -14,4 +14,12 @@ class StreamCipherXSalsa20 extends StreamCipherAbstract
      * @param int $rounds can be one of 8, 12 or 20
      */
     final public function setRounds($rounds) {}
+
+    /**
+     * Moves to a byte offset of the keystream, relative to the initialization vector.
+     * Data before the offset is neither encrypted nor decrypted.
+     * @param int $offset byte offset
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function seek($offset) {}
 }
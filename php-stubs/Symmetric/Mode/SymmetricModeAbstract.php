@@ -59,6 +59,28 @@ abstract class SymmetricModeAbstract implements SymmetricModeInterface
      */
     final public function restart() {}
 
+    /**
+     * Encrypts several strings, each one with its own initialization vector.
+     * The key schedule is kept between strings, only the initialization vector changes.
+     * Keys of $data are preserved. The next call to encrypt() starts again from the current initialization vector
+     * @param array $ivs initialization vectors, with the same keys as $data
+     * @param array $data
+     * @return array
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function encryptBatch(array $ivs, array $data) {}
+
+    /**
+     * Decrypts several strings, each one with its own initialization vector.
+     * The key schedule is kept between strings, only the initialization vector changes.
+     * Keys of $data are preserved. The next call to decrypt() starts again from the current initialization vector
+     * @param array $ivs initialization vectors, with the same keys as $data
+     * @param array $data
+     * @return array
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function decryptBatch(array $ivs, array $data) {}
+
     /**
      * Disables object serialization
      */
@@ -10,4 +10,26 @@ class SymmetricModeCtr extends SymmetricModeAbstract
      * @throws \Cryptopp\CryptoppException
      */
     public function __construct(BlockCipherInterface $cipher) {}
+
+    /**
+     * Moves to a byte offset of the keystream, relative to the initialization vector.
+     * Data before the offset is neither encrypted nor decrypted.
+     * @param int $offset byte offset
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function seek($offset) {}
+
+    /**
+     * Sets the data size from which encryption and decryption are split between several threads.
+     * Only applies to native block ciphers.
+     * @param int $threshold size in bytes. 0 disables multi-threading. Defaults to 4MB.
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function setParallelThreshold($threshold) {}
+
+    /**
+     * Returns the data size from which encryption and decryption are split between several threads
+     * @return int
+     */
+    final public function getParallelThreshold() {}
 }
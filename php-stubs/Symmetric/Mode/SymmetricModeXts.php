@@ -0,0 +1,71 @@
+<?php
+
+namespace Cryptopp;
+
+class SymmetricModeXts
+{
+    /**
+     * Constructor
+     * @param Cryptopp\BlockCipherAbstract $dataCipher cipher whose key encrypts data. Block size must be 16 bytes.
+     * @param Cryptopp\BlockCipherAbstract $tweakCipher cipher whose key encrypts sector numbers. Block size must be 16 bytes.
+     *                                                  Its key should be different from the key of $dataCipher.
+     * @throws \Cryptopp\CryptoppException
+     */
+    public function __construct(BlockCipherAbstract $dataCipher, BlockCipherAbstract $tweakCipher) {}
+
+    /**
+     * Prevents serialization of a SymmetricModeXts instance
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function __sleep() {}
+
+    /**
+     * Prevents use of a SymmetricModeXts instance that has been unserialized
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function __wakeup() {}
+
+    /**
+     * Returns algorithm name
+     * @return string
+     */
+    final public function getName() {}
+
+    /**
+     * Encrypts a sector
+     * @param int $sector sector number
+     * @param string $data sector data. Must be at least 16 bytes long.
+     * @return string encrypted data
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function encryptSector($sector, $data) {}
+
+    /**
+     * Decrypts a sector
+     * @param int $sector sector number
+     * @param string $data encrypted sector data. Must be at least 16 bytes long.
+     * @return string decrypted data
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function decryptSector($sector, $data) {}
+
+    /**
+     * Encrypts consecutive sectors
+     * @param int $firstSector number of the first sector
+     * @param string $data data of all sectors. The last sector can be shorter than $sectorSize, but must be at least 16 bytes long.
+     * @param int $sectorSize sector size. Must be at least 16.
+     * @return string encrypted data
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function encryptSectors($firstSector, $data, $sectorSize) {}
+
+    /**
+     * Decrypts consecutive sectors
+     * @param int $firstSector number of the first sector
+     * @param string $data encrypted data of all sectors. The last sector can be shorter than $sectorSize, but must be at least 16 bytes long.
+     * @param int $sectorSize sector size. Must be at least 16.
+     * @return string decrypted data
+     * @throws \Cryptopp\CryptoppException
+     */
+    final public function decryptSectors($firstSector, $data, $sectorSize) {}
+}
@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # random nonce prefixes are generated with AutoSeededRandomPool
+    if not os.path.isfile(cryptoppDir + "/osrng.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]               = True
+    config["srcFileList"]           = ["filter/php_chunked_authenticated_transformation_filter.cpp"]
+    config["headerFileList"]        = ["filter/php_chunked_authenticated_transformation_filter.h"]
+    config["phpMinitStatements"]    = ["init_class_ChunkedAuthenticatedTransformationFilter(TSRMLS_C);"]
+
+    return config
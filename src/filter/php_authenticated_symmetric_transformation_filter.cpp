@@ -288,6 +288,17 @@ static bool isNativeCipherObjectValid(zval *stfObject TSRMLS_DC) {
 }
 /* }}} */
 
+/* {{{ ensureNativeCipherObjectIsKeyed
+   keys the direction about to be used of the native cipher object holded by a stf object */
+static void ensureNativeCipherObjectIsKeyed(zval *stfObject, bool encryption TSRMLS_DC) {
+    zval *cipherObject = zend_read_property(cryptopp_ce_AuthenticatedSymmetricTransformationFilter, stfObject, "cipher", 6, 0 TSRMLS_CC);
+
+    if (IS_OBJECT == Z_TYPE_P(cipherObject) && instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_AuthenticatedSymmetricCipherAbstract TSRMLS_CC)) {
+        ensureCryptoppAuthenticatedSymmetricCipherKeyed(cipherObject, encryption TSRMLS_CC);
+    }
+}
+/* }}} */
+
 /* {{{ restartCipherObject
    restart the cipher holded by a AuthenticatedSymmetricTransformationFilter php object */
 static void restartCipherObject(zval *stfObject TSRMLS_DC) {
@@ -344,6 +355,13 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricTransformationFilter, __construct) {
 
         if (NULL == symmetricEncryptor || NULL == symmetricDecryptor) {
             parentConstructorError = true;
+        } else if (!isCryptoppAuthenticatedSymmetricCipherStreamable(cipherObject, symmetricEncryptor TSRMLS_CC)) {
+            // data is given to the filter piece by piece
+            if (createdPadding) {
+                zval_ptr_dtor(&paddingObject);
+            }
+
+            return;
         }
     } else {
         // create a proxy to the user php object
@@ -452,6 +470,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricTransformationFilter, encryptString) {
 
     // encrypt
     try {
+        ensureNativeCipherObjectIsKeyed(getThis(), true TSRMLS_CC);
         stfEncryptor->GetNextMessage();
 
         // add aad
@@ -515,6 +534,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricTransformationFilter, decryptString) {
 
     // decrypt
     try {
+        ensureNativeCipherObjectIsKeyed(getThis(), false TSRMLS_CC);
         stfDecryptor->GetNextMessage();
 
         // add aad
@@ -0,0 +1,1015 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/exception/php_mac_verification_failed_exception.h"
+#include "src/symmetric/cipher/authenticated/php_authenticated_symmetric_cipher_abstract.h"
+#include "src/utils/zend_object_utils.h"
+#include "php_chunked_authenticated_transformation_filter.h"
+#include <misc.h>
+#include <osrng.h>
+#include <secblock.h>
+#include <zend_exceptions.h>
+#include <algorithm>
+#include <string>
+
+/*
+ * Format of encrypted data:
+ *   - header:
+ *       - version                   1 byte
+ *       - key id length             1 byte
+ *       - key id
+ *       - chunk size                4 bytes, big endian
+ *       - nonce prefix length       1 byte
+ *       - nonce prefix              11 random bytes
+ *   - chunks: ciphertext followed by the MAC tag. each chunk holds chunk size bytes of plaintext, except the last one
+ *     which holds up to chunk size bytes
+ *
+ * the nonce of a chunk (16 bytes) is the nonce prefix followed by the chunk index (4 bytes, big endian) and a flag (1 byte),
+ * set to 1 for the last chunk only. the whole header is the aad of each chunk.
+ * chunks cannot be reordered, and truncation is detected because the last chunk must have its flag set
+ */
+#define CHUNKED_FORMAT_VERSION      1
+#define CHUNKED_MAX_CHUNK_SIZE      8388608
+#define CHUNKED_NONCE_SIZE          16
+#define CHUNKED_NONCE_SUFFIX_SIZE   5
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO_EX(arginfo_ChunkedAuthenticatedTransformationFilter___construct, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, cipher, Cryptopp\\AuthenticatedSymmetricCipherAbstract, 0)
+    ZEND_ARG_INFO(0, keyId)
+    ZEND_ARG_INFO(0, chunkSize)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter___wakeup, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter___sleep, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_getCipher, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_getKeyId, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_getChunkSize, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_readKeyId, 0)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_encryptString, 0)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_decryptString, 0)
+    ZEND_ARG_INFO(0, ciphertext)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_encryptStream, 0)
+    ZEND_ARG_INFO(0, input)
+    ZEND_ARG_INFO(0, output)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_decryptStream, 0)
+    ZEND_ARG_INFO(0, input)
+    ZEND_ARG_INFO(0, output)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_encryptFile, 0)
+    ZEND_ARG_INFO(0, inputPath)
+    ZEND_ARG_INFO(0, outputPath)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_decryptFile, 0)
+    ZEND_ARG_INFO(0, inputPath)
+    ZEND_ARG_INFO(0, outputPath)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_ChunkedAuthenticatedTransformationFilter_decryptRange, 0)
+    ZEND_ARG_INFO(0, input)
+    ZEND_ARG_INFO(0, offset)
+    ZEND_ARG_INFO(0, length)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_ChunkedAuthenticatedTransformationFilter;
+
+static zend_function_entry cryptopp_methods_ChunkedAuthenticatedTransformationFilter[] = {
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, __construct, arginfo_ChunkedAuthenticatedTransformationFilter___construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, __sleep, arginfo_ChunkedAuthenticatedTransformationFilter___sleep, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, __wakeup, arginfo_ChunkedAuthenticatedTransformationFilter___wakeup, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, getCipher, arginfo_ChunkedAuthenticatedTransformationFilter_getCipher, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, getKeyId, arginfo_ChunkedAuthenticatedTransformationFilter_getKeyId, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, getChunkSize, arginfo_ChunkedAuthenticatedTransformationFilter_getChunkSize, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, readKeyId, arginfo_ChunkedAuthenticatedTransformationFilter_readKeyId, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptString, arginfo_ChunkedAuthenticatedTransformationFilter_encryptString, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptString, arginfo_ChunkedAuthenticatedTransformationFilter_decryptString, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptStream, arginfo_ChunkedAuthenticatedTransformationFilter_encryptStream, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptStream, arginfo_ChunkedAuthenticatedTransformationFilter_decryptStream, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptFile, arginfo_ChunkedAuthenticatedTransformationFilter_encryptFile, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptFile, arginfo_ChunkedAuthenticatedTransformationFilter_decryptFile, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptRange, arginfo_ChunkedAuthenticatedTransformationFilter_decryptRange, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_FE_END
+};
+
+void init_class_ChunkedAuthenticatedTransformationFilter(TSRMLS_D) {
+    zend_class_entry ce;
+    INIT_NS_CLASS_ENTRY(ce, "Cryptopp", "ChunkedAuthenticatedTransformationFilter", cryptopp_methods_ChunkedAuthenticatedTransformationFilter);
+    cryptopp_ce_ChunkedAuthenticatedTransformationFilter = zend_register_internal_class(&ce TSRMLS_CC);
+
+    zend_declare_property_null(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, "cipher", 6, ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_string(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, "keyId", 5, "", ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_long(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, "chunkSize", 9, 0, ZEND_ACC_PRIVATE TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ ChunkedHeader
+   header of encrypted data. its bytes are the aad of each chunk */
+struct ChunkedHeader {
+    std::string bytes;
+    std::string keyId;
+    CryptoPP::word32 chunkSize;
+    std::string noncePrefix;
+};
+/* }}} */
+
+/* {{{ ChunkedInput
+   encrypted data held by a string or by a seekable stream */
+struct ChunkedInput {
+    const byte *data;
+    CryptoPP::lword size;
+    php_stream *stream;
+};
+/* }}} */
+
+/* {{{ getCipher
+   returns the cipher object held by a filter object, and its native encryptor or decryptor after checking the key.
+   returns NULL on failure */
+static zval *getCipher(zval *object, bool encryption, CryptoPP::AuthenticatedSymmetricCipher **cipher TSRMLS_DC) {
+    zval *cipherObject = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, object, "cipher", 6, 1 TSRMLS_CC);
+
+    if (IS_OBJECT != Z_TYPE_P(cipherObject)) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\ChunkedAuthenticatedTransformationFilter : constructor was not called");
+        return NULL;
+    }
+
+    if (encryption) {
+        *cipher = getCryptoppAuthenticatedSymmetricCipherEncryptorPtr(cipherObject TSRMLS_CC);
+    } else {
+        *cipher = getCryptoppAuthenticatedSymmetricCipherDecryptorPtr(cipherObject TSRMLS_CC);
+    }
+
+    if (NULL == *cipher || !isCryptoppAuthenticatedSymmetricCipherKeyValid(cipherObject, *cipher TSRMLS_CC)) {
+        return NULL;
+    }
+
+    return cipherObject;
+}
+/* }}} */
+
+/* {{{ getNoncePrefixSize
+   returns the size of the random part of nonces, or 0 if the cipher does not accept 16 bytes nonces.
+   shorter nonces would leave too few random bytes to pick a new prefix for each encryption */
+static int getNoncePrefixSize(zval *cipherObject, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC) {
+    if (isCryptoppSymmetricIvValid(cipherObject, cipher, CHUNKED_NONCE_SIZE TSRMLS_CC, false)) {
+        return CHUNKED_NONCE_SIZE - CHUNKED_NONCE_SUFFIX_SIZE;
+    }
+
+    return 0;
+}
+/* }}} */
+
+/* {{{ createHeader
+   creates the header of new encrypted data, with a random nonce prefix */
+static void createHeader(zval *object, zval *cipherObject, CryptoPP::AuthenticatedSymmetricCipher *cipher, ChunkedHeader &header TSRMLS_DC) {
+    zval *zKeyId        = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, object, "keyId", 5, 1 TSRMLS_CC);
+    zval *zChunkSize    = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, object, "chunkSize", 9, 1 TSRMLS_CC);
+    int prefixSize      = getNoncePrefixSize(cipherObject, cipher TSRMLS_CC);
+
+    CryptoPP::SecByteBlock prefix(prefixSize);
+    CryptoPP::AutoSeededRandomPool rng;
+    rng.GenerateBlock(prefix, prefix.size());
+
+    header.keyId.assign(Z_STRVAL_P(zKeyId), Z_STRLEN_P(zKeyId));
+    header.chunkSize = static_cast<CryptoPP::word32>(Z_LVAL_P(zChunkSize));
+    header.noncePrefix.assign(reinterpret_cast<char*>(prefix.BytePtr()), prefix.size());
+
+    byte chunkSize[4];
+    CryptoPP::PutWord(false, CryptoPP::BIG_ENDIAN_ORDER, chunkSize, header.chunkSize);
+
+    header.bytes.clear();
+    header.bytes.push_back(static_cast<char>(CHUNKED_FORMAT_VERSION));
+    header.bytes.push_back(static_cast<char>(header.keyId.size()));
+    header.bytes.append(header.keyId);
+    header.bytes.append(reinterpret_cast<char*>(chunkSize), 4);
+    header.bytes.push_back(static_cast<char>(prefixSize));
+    header.bytes.append(header.noncePrefix);
+}
+/* }}} */
+
+/* {{{ parseHeader
+   reads the header at the beginning of encrypted data. returns false if it is truncated or not valid */
+static bool parseHeader(const byte *data, size_t size, ChunkedHeader &header) {
+    if (size < 2 || CHUNKED_FORMAT_VERSION != data[0]) {
+        return false;
+    }
+
+    size_t keyIdSize = data[1];
+
+    if (size < 2 + keyIdSize + 5) {
+        return false;
+    }
+
+    size_t prefixSize   = data[2 + keyIdSize + 4];
+    size_t headerSize   = 2 + keyIdSize + 5 + prefixSize;
+
+    if (size < headerSize) {
+        return false;
+    }
+
+    header.bytes.assign(reinterpret_cast<const char*>(data), headerSize);
+    header.keyId.assign(reinterpret_cast<const char*>(data) + 2, keyIdSize);
+    header.chunkSize = CryptoPP::GetWord<CryptoPP::word32>(false, CryptoPP::BIG_ENDIAN_ORDER, data + 2 + keyIdSize);
+    header.noncePrefix.assign(reinterpret_cast<const char*>(data) + 2 + keyIdSize + 5, prefixSize);
+
+    return header.chunkSize > 0 && header.chunkSize <= CHUNKED_MAX_CHUNK_SIZE;
+}
+/* }}} */
+
+/* {{{ readStream
+   reads up to size bytes from a stream. readSize is set to the number of bytes read, lower than size only at the end of the stream.
+   returns false on read error */
+static bool readStream(php_stream *stream, byte *buffer, size_t size, size_t &readSize TSRMLS_DC) {
+    readSize = 0;
+
+    while (readSize < size) {
+        size_t count = php_stream_read(stream, reinterpret_cast<char*>(buffer) + readSize, size - readSize);
+
+        if (0 == count && php_stream_eof(stream)) {
+            break;
+        } else if (0 == count) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : cannot read the input stream", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+            return false;
+        }
+
+        readSize += count;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ writeStream
+   writes data to a stream. returns false on failure */
+static bool writeStream(php_stream *stream, const byte *data, size_t size TSRMLS_DC) {
+    if (size > 0 && php_stream_write(stream, reinterpret_cast<const char*>(data), size) != size) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : cannot write to the output stream", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ readStreamHeader
+   reads the header from the current position of a stream. headerValid is set to false if it is truncated or not valid.
+   returns false on read error */
+static bool readStreamHeader(php_stream *stream, ChunkedHeader &header, bool &headerValid TSRMLS_DC) {
+    // version and key id length, then key id, chunk size and nonce prefix length, then nonce prefix
+    byte buffer[2 + 255 + 5 + 255];
+    size_t size;
+    size_t readSize;
+
+    if (!readStream(stream, buffer, 2, size TSRMLS_CC)) {
+        return false;
+    } else if (2 == size) {
+        size_t keyIdPartSize = buffer[1] + 5;
+
+        if (!readStream(stream, buffer + size, keyIdPartSize, readSize TSRMLS_CC)) {
+            return false;
+        }
+
+        size += readSize;
+
+        if (2 + keyIdPartSize == size) {
+            if (!readStream(stream, buffer + size, buffer[size - 1], readSize TSRMLS_CC)) {
+                return false;
+            }
+
+            size += readSize;
+        }
+    }
+
+    headerValid = parseHeader(buffer, size, header);
+
+    return true;
+}
+/* }}} */
+
+/* {{{ checkHeader
+   verifies that a header can be decrypted by a filter object. returns false on failure */
+static bool checkHeader(zval *object, zval *cipherObject, CryptoPP::AuthenticatedSymmetricCipher *cipher, const ChunkedHeader &header, bool headerValid TSRMLS_DC) {
+    zval *zKeyId = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, object, "keyId", 5, 1 TSRMLS_CC);
+
+    if (!headerValid) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : invalid header", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return false;
+    } else if (header.keyId.size() != static_cast<size_t>(Z_STRLEN_P(zKeyId)) || 0 != header.keyId.compare(0, std::string::npos, Z_STRVAL_P(zKeyId), Z_STRLEN_P(zKeyId))) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : data was encrypted with another key id", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return false;
+    } else if (
+        CHUNKED_NONCE_SIZE != header.noncePrefix.size() + CHUNKED_NONCE_SUFFIX_SIZE ||
+        !isCryptoppSymmetricIvValid(cipherObject, cipher, CHUNKED_NONCE_SIZE TSRMLS_CC, false)
+    ) {
+        // only 16 bytes nonces are produced
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : invalid header", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ getChunkLayout
+   computes the number of chunks and the plaintext size from the size of encrypted data following the header.
+   returns false if that size cannot be the one of a sequence of chunks */
+static bool getChunkLayout(const ChunkedHeader &header, int digestSize, CryptoPP::lword bodySize, CryptoPP::lword &chunkCount, CryptoPP::lword &plaintextSize) {
+    CryptoPP::lword fullChunkSize   = header.chunkSize + digestSize;
+    CryptoPP::lword lastChunkSize   = bodySize % fullChunkSize;
+    chunkCount                      = bodySize / fullChunkSize;
+
+    if (lastChunkSize > 0 && lastChunkSize < static_cast<CryptoPP::lword>(digestSize)) {
+        // truncated tag
+        return false;
+    } else if (lastChunkSize > 0) {
+        chunkCount++;
+    }
+
+    plaintextSize = bodySize - chunkCount * digestSize;
+
+    return chunkCount > 0 && chunkCount <= 0x100000000ULL;
+}
+/* }}} */
+
+/* {{{ invalidDataSize
+   throws the exception of encrypted data whose size is not valid */
+static void invalidDataSize(TSRMLS_D) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : data is truncated or its size is not valid", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+}
+/* }}} */
+
+/* {{{ processChunk
+   encrypts or decrypts a chunk. on encryption, the tag is written right after the ciphertext. on decryption, the input is the
+   ciphertext followed by the tag, and the output is wiped if the tag is not valid. returns false on failure */
+static bool processChunk(
+    zval *cipherObject,
+    CryptoPP::AuthenticatedSymmetricCipher *cipher,
+    bool encryption,
+    const ChunkedHeader &header,
+    CryptoPP::word32 index,
+    bool lastChunk,
+    const byte *input,
+    size_t inputSize,
+    byte *output
+    TSRMLS_DC
+) {
+    int digestSize  = cipher->DigestSize();
+    int dataSize    = static_cast<int>(encryption ? inputSize : inputSize - digestSize);
+    byte nonce[CHUNKED_NONCE_SIZE];
+
+    memcpy(nonce, header.noncePrefix.data(), header.noncePrefix.size());
+    CryptoPP::PutWord(false, CryptoPP::BIG_ENDIAN_ORDER, nonce + header.noncePrefix.size(), index);
+    nonce[CHUNKED_NONCE_SIZE - 1] = lastChunk ? 1 : 0;
+
+    AuthenticatedSymmetricCipherMessage message;
+    message.nonce       = nonce;
+    message.nonceLength = CHUNKED_NONCE_SIZE;
+    message.aad         = reinterpret_cast<const byte*>(header.bytes.data());
+    message.aadLength   = header.bytes.size();
+    message.input       = input;
+    message.length      = dataSize;
+    message.output      = output;
+    message.digest      = encryption ? output + dataSize : const_cast<byte*>(input + dataSize);
+
+    if (!processCryptoppAuthenticatedSymmetricCipherMessages(cipherObject, cipher, encryption, &message, 1 TSRMLS_CC)) {
+        return false;
+    }
+
+    // the output has been wiped if the tag does not match
+    if (!message.valid) {
+        zend_throw_exception_ex(getCryptoppMacVerificationFailedException(), 0 TSRMLS_CC, (char*)"%s : MAC verification failed", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ encryptStream
+   encrypts a stream from its current position to its end, and writes the result to another stream. returns false on failure */
+static bool encryptStream(zval *object, php_stream *input, php_stream *output TSRMLS_DC) {
+    CryptoPP::AuthenticatedSymmetricCipher *cipher;
+    zval *cipherObject = getCipher(object, true, &cipher TSRMLS_CC);
+
+    if (NULL == cipherObject) {
+        return false;
+    }
+
+    ChunkedHeader header;
+    createHeader(object, cipherObject, cipher, header TSRMLS_CC);
+
+    if (!writeStream(output, reinterpret_cast<const byte*>(header.bytes.data()), header.bytes.size() TSRMLS_CC)) {
+        return false;
+    }
+
+    // the next chunk is read before encrypting the current one, to know if the current one is the last one
+    size_t chunkSize = header.chunkSize;
+    CryptoPP::SecByteBlock current(chunkSize);
+    CryptoPP::SecByteBlock next(chunkSize);
+    CryptoPP::SecByteBlock encrypted(chunkSize + cipher->DigestSize());
+    size_t currentSize;
+
+    if (!readStream(input, current, chunkSize, currentSize TSRMLS_CC)) {
+        return false;
+    }
+
+    for (CryptoPP::lword index = 0;; index++) {
+        size_t nextSize = 0;
+
+        if (chunkSize == currentSize && !readStream(input, next, chunkSize, nextSize TSRMLS_CC)) {
+            return false;
+        }
+
+        bool lastChunk = 0 == nextSize;
+
+        if (index > 0xffffffffULL) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : too many chunks", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+            return false;
+        } else if (
+            !processChunk(cipherObject, cipher, true, header, static_cast<CryptoPP::word32>(index), lastChunk, current, currentSize, encrypted TSRMLS_CC) ||
+            !writeStream(output, encrypted, currentSize + cipher->DigestSize() TSRMLS_CC)
+        ) {
+            return false;
+        } else if (lastChunk) {
+            return true;
+        }
+
+        current.swap(next);
+        currentSize = nextSize;
+    }
+}
+/* }}} */
+
+/* {{{ decryptStream
+   decrypts a stream from its current position to its end, and writes the result to another stream.
+   each chunk is written once verified. returns false on failure */
+static bool decryptStream(zval *object, php_stream *input, php_stream *output TSRMLS_DC) {
+    CryptoPP::AuthenticatedSymmetricCipher *cipher;
+    zval *cipherObject = getCipher(object, false, &cipher TSRMLS_CC);
+    ChunkedHeader header;
+    bool headerValid;
+
+    if (NULL == cipherObject) {
+        return false;
+    } else if (!readStreamHeader(input, header, headerValid TSRMLS_CC) || !checkHeader(object, cipherObject, cipher, header, headerValid TSRMLS_CC)) {
+        return false;
+    }
+
+    // the next chunk is read before decrypting the current one, to know if the current one is the last one
+    size_t digestSize       = cipher->DigestSize();
+    size_t fullChunkSize    = header.chunkSize + digestSize;
+    CryptoPP::SecByteBlock current(fullChunkSize);
+    CryptoPP::SecByteBlock next(fullChunkSize);
+    CryptoPP::SecByteBlock decrypted(header.chunkSize);
+    size_t currentSize;
+
+    if (!readStream(input, current, fullChunkSize, currentSize TSRMLS_CC)) {
+        return false;
+    }
+
+    for (CryptoPP::lword index = 0;; index++) {
+        size_t nextSize = 0;
+
+        if (fullChunkSize == currentSize && !readStream(input, next, fullChunkSize, nextSize TSRMLS_CC)) {
+            return false;
+        }
+
+        bool lastChunk = 0 == nextSize;
+
+        if (currentSize < digestSize || index > 0xffffffffULL) {
+            invalidDataSize(TSRMLS_C);
+            return false;
+        } else if (
+            !processChunk(cipherObject, cipher, false, header, static_cast<CryptoPP::word32>(index), lastChunk, current, currentSize, decrypted TSRMLS_CC) ||
+            !writeStream(output, decrypted, currentSize - digestSize TSRMLS_CC)
+        ) {
+            return false;
+        } else if (lastChunk) {
+            return true;
+        }
+
+        current.swap(next);
+        currentSize = nextSize;
+    }
+}
+/* }}} */
+
+/* {{{ openFiles
+   opens the input and output files of encryptFile() and decryptFile(). returns false on failure */
+static bool openFiles(char *inputPath, char *outputPath, php_stream **input, php_stream **output TSRMLS_DC) {
+    *input  = php_stream_open_wrapper(inputPath, const_cast<char*>("rb"), 0, NULL);
+    *output = NULL;
+
+    if (NULL == *input) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : cannot open file %s", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name, inputPath);
+        return false;
+    }
+
+    *output = php_stream_open_wrapper(outputPath, const_cast<char*>("wb"), 0, NULL);
+
+    if (NULL == *output) {
+        php_stream_close(*input);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : cannot open file %s", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name, outputPath);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ readChunkedInput
+   returns a pointer to length bytes of encrypted data starting at offset, read into buffer if data is held by a stream.
+   returns NULL if they cannot be read */
+static const byte *readChunkedInput(ChunkedInput &input, CryptoPP::lword offset, size_t length, byte *buffer TSRMLS_DC) {
+    size_t readSize = 0;
+
+    if (NULL == input.stream && offset + length <= input.size) {
+        return input.data + offset;
+    } else if (NULL == input.stream || offset + length > input.size || 0 != php_stream_seek(input.stream, offset, SEEK_SET)) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : cannot read the input stream", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return NULL;
+    } else if (!readStream(input.stream, buffer, length, readSize TSRMLS_CC)) {
+        return NULL;
+    } else if (length != readSize) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : cannot read the input stream", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return NULL;
+    }
+
+    return buffer;
+}
+/* }}} */
+
+/* {{{ decryptRangeChunk
+   reads and decrypts the chunk at index for decryptRange(). plaintextSize is set to the size of its plaintext.
+   returns false on failure */
+static bool decryptRangeChunk(
+    zval *cipherObject,
+    CryptoPP::AuthenticatedSymmetricCipher *cipher,
+    const ChunkedHeader &header,
+    ChunkedInput &input,
+    CryptoPP::lword chunkCount,
+    CryptoPP::lword index,
+    byte *buffer,
+    byte *output,
+    size_t &plaintextSize
+    TSRMLS_DC
+) {
+    size_t digestSize           = cipher->DigestSize();
+    size_t fullChunkSize        = header.chunkSize + digestSize;
+    CryptoPP::lword bodySize    = input.size - header.bytes.size();
+    CryptoPP::lword chunkOffset = index * fullChunkSize;
+    size_t size                 = static_cast<size_t>(std::min<CryptoPP::lword>(fullChunkSize, bodySize - chunkOffset));
+    const byte *chunk           = readChunkedInput(input, header.bytes.size() + chunkOffset, size, buffer TSRMLS_CC);
+
+    if (NULL == chunk || !processChunk(cipherObject, cipher, false, header, static_cast<CryptoPP::word32>(index), index + 1 == chunkCount, chunk, size, output TSRMLS_CC)) {
+        return false;
+    }
+
+    plaintextSize = size - digestSize;
+
+    return true;
+}
+/* }}} */
+
+/* {{{ proto void ChunkedAuthenticatedTransformationFilter::__sleep(void)
+   Prevents serialization of a ChunkedAuthenticatedTransformationFilter instance */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, __sleep) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\ChunkedAuthenticatedTransformationFilter instances");
+}
+/* }}} */
+
+/* {{{ proto void ChunkedAuthenticatedTransformationFilter::__wakeup(void)
+   Prevents use of a ChunkedAuthenticatedTransformationFilter instance that has been unserialized */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, __wakeup) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\ChunkedAuthenticatedTransformationFilter instances");
+}
+/* }}} */
+
+/* {{{ proto ChunkedAuthenticatedTransformationFilter::__construct(Cryptopp\AuthenticatedSymmetricCipherAbstract cipher [, string keyId [, int chunkSize]]) */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, __construct) {
+    zval *cipherObject;
+    char *keyId     = NULL;
+    int keyIdSize   = 0;
+    long chunkSize  = 65536;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "O|sl", &cipherObject, cryptopp_ce_AuthenticatedSymmetricCipherAbstract, &keyId, &keyIdSize, &chunkSize)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *encryptor = getCryptoppAuthenticatedSymmetricCipherEncryptorPtr(cipherObject TSRMLS_CC);
+
+    if (NULL == encryptor) {
+        return;
+    } else if (keyIdSize > 255) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : the key id cannot be longer than 255 bytes", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        return;
+    } else if (chunkSize < 1 || chunkSize > CHUNKED_MAX_CHUNK_SIZE) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : the chunk size must be between 1 and %d", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name, CHUNKED_MAX_CHUNK_SIZE);
+        return;
+    } else if (1 != encryptor->MandatoryBlockSize() || 0 == getNoncePrefixSize(cipherObject, encryptor TSRMLS_CC)) {
+        zend_class_entry *ce = zend_get_class_entry(cipherObject TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : %s cannot be used, it must accept data of any size and 16 bytes nonces", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name, ce->name);
+        return;
+    }
+
+    zend_update_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, getThis(), "cipher", 6, cipherObject TSRMLS_CC);
+    zend_update_property_stringl(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, getThis(), "keyId", 5, NULL == keyId ? const_cast<char*>("") : keyId, keyIdSize TSRMLS_CC);
+    zend_update_property_long(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, getThis(), "chunkSize", 9, chunkSize TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto Cryptopp\AuthenticatedSymmetricCipherAbstract ChunkedAuthenticatedTransformationFilter::getCipher(void)
+   Returns the cipher object */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, getCipher) {
+    zval *cipherObject = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, getThis(), "cipher", 6, 0 TSRMLS_CC);
+    RETURN_ZVAL(cipherObject, 1, 0)
+}
+/* }}} */
+
+/* {{{ proto string ChunkedAuthenticatedTransformationFilter::getKeyId(void)
+   Returns the key id written in the header of encrypted data */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, getKeyId) {
+    zval *keyId = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, getThis(), "keyId", 5, 0 TSRMLS_CC);
+    RETURN_ZVAL(keyId, 1, 0)
+}
+/* }}} */
+
+/* {{{ proto int ChunkedAuthenticatedTransformationFilter::getChunkSize(void)
+   Returns the size of plaintext chunks */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, getChunkSize) {
+    zval *chunkSize = zend_read_property(cryptopp_ce_ChunkedAuthenticatedTransformationFilter, getThis(), "chunkSize", 9, 0 TSRMLS_CC);
+    RETURN_ZVAL(chunkSize, 1, 0)
+}
+/* }}} */
+
+/* {{{ proto string ChunkedAuthenticatedTransformationFilter::readKeyId(string data)
+   Returns the key id written in the header of encrypted data, to pick the key able to decrypt it.
+   Only the header is needed */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, readKeyId) {
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "s", &data, &dataSize)) {
+        return;
+    }
+
+    ChunkedHeader header;
+
+    if (!parseHeader(reinterpret_cast<byte*>(data), dataSize, header)) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : invalid header", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        RETURN_FALSE
+    }
+
+    RETURN_STRINGL(header.keyId.data(), header.keyId.size(), 1)
+}
+/* }}} */
+
+/* {{{ proto string ChunkedAuthenticatedTransformationFilter::encryptString(string data)
+   Encrypts a string */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptString) {
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "s", &data, &dataSize)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *cipher;
+    zval *cipherObject = getCipher(getThis(), true, &cipher TSRMLS_CC);
+
+    if (NULL == cipherObject) {
+        RETURN_FALSE
+    }
+
+    ChunkedHeader header;
+    createHeader(getThis(), cipherObject, cipher, header TSRMLS_CC);
+
+    // an empty string is encrypted as a single empty chunk
+    size_t digestSize           = cipher->DigestSize();
+    CryptoPP::lword chunkCount  = 0 == dataSize ? 1 : (static_cast<CryptoPP::lword>(dataSize) + header.chunkSize - 1) / header.chunkSize;
+    CryptoPP::lword outputSize  = header.bytes.size() + dataSize + chunkCount * digestSize;
+
+    if (outputSize > INT_MAX) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : data is too large to be encrypted as a string", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        RETURN_FALSE
+    }
+
+    // output is handed over to php as is, without copy
+    byte *output        = reinterpret_cast<byte*>(emalloc(outputSize + 1));
+    output[outputSize]  = '\0';
+    memcpy(output, header.bytes.data(), header.bytes.size());
+    byte *outputChunk   = output + header.bytes.size();
+
+    for (CryptoPP::lword index = 0; index < chunkCount; index++) {
+        CryptoPP::lword offset  = index * header.chunkSize;
+        size_t size             = static_cast<size_t>(std::min<CryptoPP::lword>(header.chunkSize, dataSize - offset));
+
+        if (!processChunk(cipherObject, cipher, true, header, static_cast<CryptoPP::word32>(index), index + 1 == chunkCount, reinterpret_cast<byte*>(data) + offset, size, outputChunk TSRMLS_CC)) {
+            efree(output);
+            RETURN_FALSE
+        }
+
+        outputChunk += size + digestSize;
+    }
+
+    RETURN_STRINGL(reinterpret_cast<char*>(output), outputSize, 0)
+}
+/* }}} */
+
+/* {{{ proto string ChunkedAuthenticatedTransformationFilter::decryptString(string ciphertext)
+   Verifies and decrypts a string produced by encryptString(), encryptStream() or encryptFile() */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptString) {
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "s", &data, &dataSize)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *cipher;
+    zval *cipherObject = getCipher(getThis(), false, &cipher TSRMLS_CC);
+    ChunkedHeader header;
+
+    if (NULL == cipherObject) {
+        RETURN_FALSE
+    } else if (!checkHeader(getThis(), cipherObject, cipher, header, parseHeader(reinterpret_cast<byte*>(data), dataSize, header) TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    size_t digestSize           = cipher->DigestSize();
+    size_t fullChunkSize        = header.chunkSize + digestSize;
+    CryptoPP::lword bodySize    = dataSize - header.bytes.size();
+    CryptoPP::lword chunkCount;
+    CryptoPP::lword outputSize;
+
+    if (!getChunkLayout(header, digestSize, bodySize, chunkCount, outputSize)) {
+        invalidDataSize(TSRMLS_C);
+        RETURN_FALSE
+    }
+
+    byte *output        = reinterpret_cast<byte*>(emalloc(outputSize + 1));
+    output[outputSize]  = '\0';
+    const byte *input   = reinterpret_cast<byte*>(data) + header.bytes.size();
+
+    for (CryptoPP::lword index = 0; index < chunkCount; index++) {
+        CryptoPP::lword offset  = index * fullChunkSize;
+        size_t size             = static_cast<size_t>(std::min<CryptoPP::lword>(fullChunkSize, bodySize - offset));
+
+        if (!processChunk(cipherObject, cipher, false, header, static_cast<CryptoPP::word32>(index), index + 1 == chunkCount, input + offset, size, output + index * header.chunkSize TSRMLS_CC)) {
+            memset(output, 0, outputSize);
+            efree(output);
+            RETURN_FALSE
+        }
+    }
+
+    RETURN_STRINGL(reinterpret_cast<char*>(output), outputSize, 0)
+}
+/* }}} */
+
+/* {{{ proto bool ChunkedAuthenticatedTransformationFilter::encryptStream(resource input, resource output)
+   Encrypts a stream from its current position to its end, and writes the result to another stream.
+   Only one chunk at a time is held in memory */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptStream) {
+    zval *zInput;
+    zval *zOutput;
+    php_stream *input;
+    php_stream *output;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "rr", &zInput, &zOutput)) {
+        return;
+    }
+
+    php_stream_from_zval(input, &zInput);
+    php_stream_from_zval(output, &zOutput);
+
+    if (!encryptStream(getThis(), input, output TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    RETURN_TRUE
+}
+/* }}} */
+
+/* {{{ proto bool ChunkedAuthenticatedTransformationFilter::decryptStream(resource input, resource output)
+   Verifies and decrypts a stream from its current position to its end, and writes the result to another stream.
+   Each chunk is written as soon as it is verified: if an exception is thrown, the chunks before the faulty one are already written */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptStream) {
+    zval *zInput;
+    zval *zOutput;
+    php_stream *input;
+    php_stream *output;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "rr", &zInput, &zOutput)) {
+        return;
+    }
+
+    php_stream_from_zval(input, &zInput);
+    php_stream_from_zval(output, &zOutput);
+
+    if (!decryptStream(getThis(), input, output TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    RETURN_TRUE
+}
+/* }}} */
+
+/* {{{ proto bool ChunkedAuthenticatedTransformationFilter::encryptFile(string inputPath, string outputPath)
+   Encrypts a file into another one */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptFile) {
+    char *inputPath     = NULL;
+    int inputPathSize   = 0;
+    char *outputPath    = NULL;
+    int outputPathSize  = 0;
+    php_stream *input;
+    php_stream *output;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ss", &inputPath, &inputPathSize, &outputPath, &outputPathSize)) {
+        return;
+    } else if (!openFiles(inputPath, outputPath, &input, &output TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    bool success = encryptStream(getThis(), input, output TSRMLS_CC);
+    php_stream_close(input);
+    php_stream_close(output);
+
+    RETURN_BOOL(success)
+}
+/* }}} */
+
+/* {{{ proto bool ChunkedAuthenticatedTransformationFilter::decryptFile(string inputPath, string outputPath)
+   Verifies and decrypts a file into another one. As with decryptStream(), if an exception is thrown, the output file holds
+   the chunks before the faulty one */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptFile) {
+    char *inputPath     = NULL;
+    int inputPathSize   = 0;
+    char *outputPath    = NULL;
+    int outputPathSize  = 0;
+    php_stream *input;
+    php_stream *output;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ss", &inputPath, &inputPathSize, &outputPath, &outputPathSize)) {
+        return;
+    } else if (!openFiles(inputPath, outputPath, &input, &output TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    bool success = decryptStream(getThis(), input, output TSRMLS_CC);
+    php_stream_close(input);
+    php_stream_close(output);
+
+    RETURN_BOOL(success)
+}
+/* }}} */
+
+/* {{{ proto string ChunkedAuthenticatedTransformationFilter::decryptRange(string|resource input, int offset, int length)
+   Verifies and decrypts length bytes of plaintext starting at offset. Only the chunks holding them and the last chunk are read
+   and decrypted. input is either encrypted data or a seekable stream, whose beginning is the beginning of encrypted data.
+   As with substr(), the result is shorter if the range goes past the end of the plaintext */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptRange) {
+    zval *zInput;
+    long offset;
+    long length;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "zll", &zInput, &offset, &length)) {
+        return;
+    }
+
+    if (offset < 0 || length < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : offset and length cannot be negative", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        RETURN_FALSE
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *cipher;
+    zval *cipherObject = getCipher(getThis(), false, &cipher TSRMLS_CC);
+
+    if (NULL == cipherObject) {
+        RETURN_FALSE
+    }
+
+    // read the header
+    ChunkedInput input;
+    ChunkedHeader header;
+    bool headerValid;
+
+    if (IS_STRING == Z_TYPE_P(zInput)) {
+        input.data      = reinterpret_cast<byte*>(Z_STRVAL_P(zInput));
+        input.size      = Z_STRLEN_P(zInput);
+        input.stream    = NULL;
+        headerValid     = parseHeader(input.data, input.size, header);
+    } else if (IS_RESOURCE == Z_TYPE_P(zInput)) {
+        php_stream_from_zval(input.stream, &zInput);
+
+        if (0 != php_stream_seek(input.stream, 0, SEEK_END)) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : the stream must be seekable", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+            RETURN_FALSE
+        }
+
+        input.data  = NULL;
+        input.size  = php_stream_tell(input.stream);
+        headerValid = false;
+
+        if (0 == php_stream_seek(input.stream, 0, SEEK_SET) && !readStreamHeader(input.stream, header, headerValid TSRMLS_CC)) {
+            RETURN_FALSE
+        }
+    } else {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : input must be a string or a stream", cryptopp_ce_ChunkedAuthenticatedTransformationFilter->name);
+        RETURN_FALSE
+    }
+
+    if (!checkHeader(getThis(), cipherObject, cipher, header, headerValid TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    // find chunks holding the range. as with substr(), the range is empty if it starts past the end of the plaintext
+    size_t digestSize           = cipher->DigestSize();
+    CryptoPP::lword bodySize    = input.size - header.bytes.size();
+    CryptoPP::lword chunkCount;
+    CryptoPP::lword plaintextSize;
+
+    if (!getChunkLayout(header, digestSize, bodySize, chunkCount, plaintextSize)) {
+        invalidDataSize(TSRMLS_C);
+        RETURN_FALSE
+    }
+
+    CryptoPP::lword begin       = std::min<CryptoPP::lword>(offset, plaintextSize);
+    CryptoPP::lword end         = std::min<CryptoPP::lword>(begin + static_cast<CryptoPP::lword>(length), plaintextSize);
+    size_t outputSize           = static_cast<size_t>(end - begin);
+    byte *output                = reinterpret_cast<byte*>(emalloc(outputSize + 1));
+    output[outputSize]          = '\0';
+    bool lastChunkVerified      = false;
+
+    // decrypt them, and keep the requested part of each one
+    CryptoPP::SecByteBlock encrypted(NULL == input.stream ? 0 : header.chunkSize + digestSize);
+    CryptoPP::SecByteBlock decrypted(header.chunkSize);
+
+    for (CryptoPP::lword index = begin / header.chunkSize; begin < end && index <= (end - 1) / header.chunkSize; index++) {
+        size_t size;
+
+        if (!decryptRangeChunk(cipherObject, cipher, header, input, chunkCount, index, encrypted, decrypted, size TSRMLS_CC)) {
+            memset(output, 0, outputSize);
+            efree(output);
+            RETURN_FALSE
+        }
+
+        CryptoPP::lword plaintextOffset = index * header.chunkSize;
+        CryptoPP::lword from            = std::max<CryptoPP::lword>(begin, plaintextOffset);
+        CryptoPP::lword to              = std::min<CryptoPP::lword>(end, plaintextOffset + size);
+        memcpy(output + (from - begin), decrypted.BytePtr() + (from - plaintextOffset), static_cast<size_t>(to - from));
+        lastChunkVerified               = index + 1 == chunkCount;
+    }
+
+    // the last chunk is verified even if the range does not reach it: data truncated at a chunk boundary is a sequence of
+    // authentic chunks, but the last one of them does not have the last chunk flag
+    size_t lastChunkSize;
+
+    if (!lastChunkVerified && !decryptRangeChunk(cipherObject, cipher, header, input, chunkCount, chunkCount - 1, encrypted, decrypted, lastChunkSize TSRMLS_CC)) {
+        memset(output, 0, outputSize);
+        efree(output);
+        RETURN_FALSE
+    }
+
+    RETURN_STRINGL(reinterpret_cast<char*>(output), outputSize, 0)
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
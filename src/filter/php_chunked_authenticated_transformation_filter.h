@@ -0,0 +1,44 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_CHUNKED_AUTHENTICATED_TRANSFORMATION_FILTER_H
+#define PHP_CHUNKED_AUTHENTICATED_TRANSFORMATION_FILTER_H
+
+#include "src/php_cryptopp.h"
+
+extern zend_class_entry *cryptopp_ce_ChunkedAuthenticatedTransformationFilter;
+void init_class_ChunkedAuthenticatedTransformationFilter(TSRMLS_D);
+
+/* {{{ methods declarations */
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, __construct);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, __sleep);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, __wakeup);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, getCipher);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, getKeyId);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, getChunkSize);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, readKeyId);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptString);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptString);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptStream);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptStream);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, encryptFile);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptFile);
+PHP_METHOD(Cryptopp_ChunkedAuthenticatedTransformationFilter, decryptRange);
+/* }}} */
+
+#endif /* PHP_CHUNKED_AUTHENTICATED_TRANSFORMATION_FILTER_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
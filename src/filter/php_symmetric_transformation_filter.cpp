@@ -409,6 +409,17 @@ static bool isNativeSymmetricTransformationObjectValid(zval *stfObject TSRMLS_DC
 }
 /* }}} */
 
+/* {{{ ensureNativeSymmetricTransformationObjectIsKeyed
+   keys the direction about to be used of the native mode object holded by a stf object */
+static void ensureNativeSymmetricTransformationObjectIsKeyed(zval *stfObject, bool encryption TSRMLS_DC) {
+    zval *cipherObject = zend_read_property(cryptopp_ce_SymmetricTransformationFilter, stfObject, "cipher", 6, 0 TSRMLS_CC);
+
+    if (IS_OBJECT == Z_TYPE_P(cipherObject) && instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_SymmetricModeAbstract TSRMLS_CC)) {
+        ensureCryptoppSymmetricModeKeyed(cipherObject, encryption TSRMLS_CC);
+    }
+}
+/* }}} */
+
 /* {{{ restartSymmetricCipherObject
    restart the cipher holded by a SymmetricTransformationFilter php object */
 static void restartSymmetricCipherObject(zval *stfObject TSRMLS_DC) {
@@ -576,6 +587,8 @@ PHP_METHOD(Cryptopp_SymmetricTransformationFilter, encryptString) {
         RETURN_FALSE
     }
 
+    ensureNativeSymmetricTransformationObjectIsKeyed(getThis(), true TSRMLS_CC);
+
     // encrypt
     try {
         stfEncryptor->GetNextMessage();
@@ -621,6 +634,8 @@ PHP_METHOD(Cryptopp_SymmetricTransformationFilter, decryptString) {
         RETURN_FALSE
     }
 
+    ensureNativeSymmetricTransformationObjectIsKeyed(getThis(), false TSRMLS_CC);
+
     // decrypt
     try {
         stfDecryptor->GetNextMessage();
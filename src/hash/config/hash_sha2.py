@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # check if sha2 is supported by installed crypto++
+    if not os.path.isfile(cryptoppDir + "/sha.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]                       = True
+    config["srcFileList"]                   = ["hash/php_sha2.cpp"]
+    config["headerFileList"]                = ["hash/php_sha2.h"]
+    config["phpMinitStatements"]            = ["init_classes_HashSha2(TSRMLS_C);"]
+
+    return config
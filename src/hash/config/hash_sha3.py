@@ -12,5 +12,6 @@ def getConfig(cryptoppDir):
     config["srcFileList"]                   = ["hash/php_sha3.cpp"]
     config["headerFileList"]                = ["hash/php_sha3.h"]
     config["phpMinitStatements"]            = ["init_classes_HashSha3(TSRMLS_C);"]
+    config["defineList"]                    = ["PHP_CRYPTOPP_HASH_SHA3"]
 
     return config
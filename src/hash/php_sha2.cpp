@@ -0,0 +1,84 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "php_hash_abstract.h"
+#include "php_sha2.h"
+#include <sha.h>
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_HashSha256_construct, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_HashSha384_construct, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_HashSha512_construct, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP classes declaration */
+zend_class_entry *cryptopp_ce_HashSha256;
+zend_class_entry *cryptopp_ce_HashSha384;
+zend_class_entry *cryptopp_ce_HashSha512;
+
+static zend_function_entry cryptopp_methods_HashSha256[] = {
+    PHP_ME(Cryptopp_HashSha256, __construct, arginfo_HashSha256_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_FE_END
+};
+
+static zend_function_entry cryptopp_methods_HashSha384[] = {
+    PHP_ME(Cryptopp_HashSha384, __construct, arginfo_HashSha384_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_FE_END
+};
+
+static zend_function_entry cryptopp_methods_HashSha512[] = {
+    PHP_ME(Cryptopp_HashSha512, __construct, arginfo_HashSha512_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_FE_END
+};
+
+void init_classes_HashSha2(TSRMLS_D)
+{
+    init_class_HashAbstractChild("sha256", "HashSha256", &cryptopp_ce_HashSha256, cryptopp_methods_HashSha256 TSRMLS_CC);
+    init_class_HashAbstractChild("sha384", "HashSha384", &cryptopp_ce_HashSha384, cryptopp_methods_HashSha384 TSRMLS_CC);
+    init_class_HashAbstractChild("sha512", "HashSha512", &cryptopp_ce_HashSha512, cryptopp_methods_HashSha512 TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto HashSha*::__construct(void) */
+PHP_METHOD(Cryptopp_HashSha256, __construct) {
+    CryptoPP::SHA256 *hash = new CryptoPP::SHA256();
+    setCryptoppHashNativePtr(getThis(), hash TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_HashAbstract, getThis(), "name", 4, "sha256", 6 TSRMLS_CC);
+}
+
+PHP_METHOD(Cryptopp_HashSha384, __construct) {
+    CryptoPP::SHA384 *hash = new CryptoPP::SHA384();
+    setCryptoppHashNativePtr(getThis(), hash TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_HashAbstract, getThis(), "name", 4, "sha384", 6 TSRMLS_CC);
+}
+
+PHP_METHOD(Cryptopp_HashSha512, __construct) {
+    CryptoPP::SHA512 *hash = new CryptoPP::SHA512();
+    setCryptoppHashNativePtr(getThis(), hash TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_HashAbstract, getThis(), "name", 4, "sha512", 6 TSRMLS_CC);
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
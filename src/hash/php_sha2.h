@@ -0,0 +1,29 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_HASH_SHA2_H
+#define PHP_HASH_SHA2_H
+
+#include "src/php_cryptopp.h"
+
+void init_classes_HashSha2(TSRMLS_D);
+PHP_METHOD(Cryptopp_HashSha256, __construct);
+PHP_METHOD(Cryptopp_HashSha384, __construct);
+PHP_METHOD(Cryptopp_HashSha512, __construct);
+
+#endif /* PHP_HASH_SHA2_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
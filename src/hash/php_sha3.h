@@ -23,25 +23,29 @@ PHP_METHOD(Cryptopp_HashSha3_512, __construct);
 class SHA3_224 : public CryptoPP::SHA3_224
 {
 public:
-    unsigned int BlockSize() const {return 72;}
+    CRYPTOPP_CONSTANT(BLOCKSIZE = 72)
+    unsigned int BlockSize() const {return BLOCKSIZE;}
 };
 
 class SHA3_256 : public CryptoPP::SHA3_256
 {
 public:
-    unsigned int BlockSize() const {return 104;}
+    CRYPTOPP_CONSTANT(BLOCKSIZE = 104)
+    unsigned int BlockSize() const {return BLOCKSIZE;}
 };
 
 class SHA3_384 : public CryptoPP::SHA3_384
 {
 public:
-    unsigned int BlockSize() const {return 136;}
+    CRYPTOPP_CONSTANT(BLOCKSIZE = 136)
+    unsigned int BlockSize() const {return BLOCKSIZE;}
 };
 
 class SHA3_512 : public CryptoPP::SHA3_512
 {
 public:
-    unsigned int BlockSize() const {return 144;}
+    CRYPTOPP_CONSTANT(BLOCKSIZE = 144)
+    unsigned int BlockSize() const {return BLOCKSIZE;}
 };
 /* }}} */
 
@@ -0,0 +1,11 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    config["enabled"]               = True
+    config["srcFileList"]           = ["mac/php_jws.cpp"]
+    config["headerFileList"]        = ["mac/php_jws.h"]
+    config["phpMinitStatements"]    = ["init_class_Jws(TSRMLS_C);"]
+
+    return config
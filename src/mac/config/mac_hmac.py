@@ -12,5 +12,6 @@ def getConfig(cryptoppDir):
     config["srcFileList"]           = ["mac/php_hmac.cpp"]
     config["headerFileList"]        = ["mac/php_hmac.h"]
     config["phpMinitStatements"]    = ["init_class_MacHmac(TSRMLS_C);"]
+    config["defineList"]            = ["PHP_CRYPTOPP_MAC_HMAC"]
 
     return config
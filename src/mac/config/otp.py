@@ -0,0 +1,11 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    config["enabled"]               = True
+    config["srcFileList"]           = ["mac/php_otp.cpp"]
+    config["headerFileList"]        = ["mac/php_otp.h"]
+    config["phpMinitStatements"]    = ["init_class_Otp(TSRMLS_C);"]
+
+    return config
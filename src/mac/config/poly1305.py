@@ -0,0 +1,10 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    config["enabled"]               = True
+    config["srcFileList"]           = ["mac/poly1305.cpp"]
+    config["headerFileList"]        = ["mac/poly1305.h"]
+
+    return config
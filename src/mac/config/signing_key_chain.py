@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # the key chain is built on hmac
+    if not os.path.isfile(cryptoppDir + "/hmac.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]               = True
+    config["srcFileList"]           = ["mac/php_signing_key_chain.cpp"]
+    config["headerFileList"]        = ["mac/php_signing_key_chain.h"]
+    config["phpMinitStatements"]    = ["init_class_SigningKeyChain(TSRMLS_C);"]
+
+    return config
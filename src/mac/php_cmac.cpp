@@ -15,6 +15,7 @@
 #include "src/utils/zval_utils.h"
 #include "php_mac_abstract.h"
 #include "php_cmac.h"
+#include <aes.h>
 #include <cmac.h>
 #include <string>
 #include <zend_exceptions.h>
@@ -45,28 +46,51 @@ bool Cmac::IsValidKeyLength(size_t n) const
 void Cmac::UncheckedSetKey(const byte *userKey, unsigned int keylength, const CryptoPP::NameValuePairs &params)
 {
     CryptoPP::CMAC_Base::UncheckedSetKey(userKey, keylength, params);
+    setCryptoppCmacCipherKey(m_zThis, userKey, keylength M_TSRMLS_CC);
+}
+
+zval *Cmac::GetUnderlyingKey()
+{
+    return getCryptoppCmacCipherKey(m_zThis M_TSRMLS_CC);
+}
+/* }}} */
 
-    // update cipher key
-    zval *zCipher   = zend_read_property(cryptopp_ce_MacCmac, m_zThis, "cipher", 6, 1 M_TSRMLS_CC);
+/* {{{ setCryptoppCmacCipherKey
+   update the key of the php cipher object held by a MacCmac object */
+void setCryptoppCmacCipherKey(zval *object, const byte *key, unsigned int keyLength TSRMLS_DC) {
+    zval *zCipher   = zend_read_property(cryptopp_ce_MacCmac, object, "cipher", 6, 1 TSRMLS_CC);
     zval *funcname  = makeZval("setKey");
-    zval *zKey      = makeZval(reinterpret_cast<const char*>(userKey), keylength);
-    zval *output    = call_user_method(zCipher, funcname, zKey M_TSRMLS_CC);
+    zval *zKey      = makeZval(reinterpret_cast<const char*>(key), keyLength);
+    zval *output    = call_user_method(zCipher, funcname, zKey TSRMLS_CC);
     zval_ptr_dtor(&funcname);
     zval_ptr_dtor(&zKey);
     zval_ptr_dtor(&output);
 }
+/* }}} */
 
-zval *Cmac::GetUnderlyingKey()
-{
-    zval *zCipher   = zend_read_property(cryptopp_ce_MacCmac, m_zThis, "cipher", 6, 1 M_TSRMLS_CC);
+/* {{{ getCryptoppCmacCipherKey
+   returns the key of the php cipher object held by a MacCmac object */
+zval *getCryptoppCmacCipherKey(zval *object TSRMLS_DC) {
+    zval *zCipher   = zend_read_property(cryptopp_ce_MacCmac, object, "cipher", 6, 1 TSRMLS_CC);
     zval *funcname  = makeZval("getKey");
-    zval *output    = call_user_method(zCipher, funcname M_TSRMLS_CC);
+    zval *output    = call_user_method(zCipher, funcname TSRMLS_CC);
     zval_ptr_dtor(&funcname);
 
     return output;
 }
 /* }}} */
 
+/* {{{ createNativeCmac
+   returns a CryptoPP::CMAC specialization matching the native cipher, or NULL if the cipher type is not known */
+static CryptoPP::MessageAuthenticationCode *createNativeCmac(CryptoPP::BlockCipher *cipher, zval *zThis TSRMLS_DC) {
+    if (0 != dynamic_cast<CryptoPP::AES::Encryption*>(cipher)) {
+        return new CmacNative<CryptoPP::AES>(zThis TSRMLS_CC);
+    }
+
+    return NULL;
+}
+/* }}} */
+
 /* {{{ arginfo */
 ZEND_BEGIN_ARG_INFO(arginfo_MacCmac_construct, 0)
     ZEND_ARG_OBJ_INFO(0, cipher, Cryptopp\\BlockCipherInterface, 0)
@@ -99,7 +123,11 @@ PHP_METHOD(Cryptopp_MacCmac, __construct) {
     if (instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_BlockCipherAbstract TSRMLS_CC)) {
         // retrieve native cipher object
         cipher  = getCryptoppBlockCipherEncryptorPtr(cipherObject TSRMLS_CC);
-        mac     = new Cmac(cipher, false, getThis() TSRMLS_CC);
+        mac     = createNativeCmac(cipher, getThis() TSRMLS_CC);
+
+        if (NULL == mac) {
+            mac = new Cmac(cipher, false, getThis() TSRMLS_CC);
+        }
     } else {
         // create a proxy to the user php object
         try {
@@ -15,6 +15,8 @@
 #include <cmac.h>
 
 void init_class_MacCmac(TSRMLS_D);
+void setCryptoppCmacCipherKey(zval *object, const byte *key, unsigned int keyLength TSRMLS_DC);
+zval *getCryptoppCmacCipherKey(zval *object TSRMLS_DC);
 PHP_METHOD(Cryptopp_MacCmac, __construct);
 
 /* {{{ fork of CryptoPP::CMAC that take a cipher as parameter instead of a template parameter */
@@ -48,6 +50,27 @@ private:
 };
 /* }}} */
 
+/* {{{ CryptoPP::CMAC specialization used with native ciphers of a known type.
+   it holds its own cipher instance and only forwards the key to the php cipher object */
+template <class T>
+class CmacNative : public CryptoPP::CMAC<T>, public MacUnderlyingKeyInterface
+{
+public:
+    CmacNative(zval *zThis TSRMLS_DC) : m_zThis(zThis) {SET_M_TSRMLS_C();}
+
+    void UncheckedSetKey(const byte *userKey, unsigned int keylength, const CryptoPP::NameValuePairs &params) {
+        CryptoPP::CMAC<T>::UncheckedSetKey(userKey, keylength, params);
+        setCryptoppCmacCipherKey(m_zThis, userKey, keylength M_TSRMLS_CC);
+    }
+
+    zval *GetUnderlyingKey() {return getCryptoppCmacCipherKey(m_zThis M_TSRMLS_CC);}
+
+private:
+    zval *m_zThis;
+    M_TSRMLS_D;
+};
+/* }}} */
+
 #endif /* PHP_MAC_CMAC_H */
 
 /*
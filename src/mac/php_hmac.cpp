@@ -16,9 +16,15 @@
 #include "php_mac_abstract.h"
 #include "php_hmac.h"
 #include <hmac.h>
+#include <md5.h>
+#include <sha.h>
 #include <string>
 #include <zend_exceptions.h>
 
+#ifdef PHP_CRYPTOPP_HASH_SHA3
+#include "src/hash/php_sha3.h"
+#endif
+
 zend_class_entry *cryptopp_ce_MacHmac;
 
 /* {{{ fork of CryptoPP::HMAC that take a hash as parameter instead of a template parameter */
@@ -38,6 +44,71 @@ Hmac::~Hmac()
 }
 /* }}} */
 
+/* {{{ createNativeHmac
+   returns a CryptoPP::HMAC specialization matching the native hash, or NULL if the hash type is not known.
+   the specialization holds its own hash instance, so no virtual dispatch through an external hash object is needed */
+static CryptoPP::MessageAuthenticationCode *createNativeHmac(CryptoPP::HashTransformation *hash) {
+    if (0 != dynamic_cast<CryptoPP::SHA1*>(hash)) {
+        return new CryptoPP::HMAC<CryptoPP::SHA1>();
+    } else if (0 != dynamic_cast<CryptoPP::SHA256*>(hash)) {
+        return new CryptoPP::HMAC<CryptoPP::SHA256>();
+    } else if (0 != dynamic_cast<CryptoPP::SHA384*>(hash)) {
+        return new CryptoPP::HMAC<CryptoPP::SHA384>();
+    } else if (0 != dynamic_cast<CryptoPP::SHA512*>(hash)) {
+        return new CryptoPP::HMAC<CryptoPP::SHA512>();
+    } else if (0 != dynamic_cast<CryptoPP::Weak::MD5*>(hash)) {
+        return new CryptoPP::HMAC<CryptoPP::Weak::MD5>();
+    }
+
+#ifdef PHP_CRYPTOPP_HASH_SHA3
+    // sha3.h is only available from crypto++ 5.6.2
+    if (0 != dynamic_cast<SHA3_224*>(hash)) {
+        return new CryptoPP::HMAC<SHA3_224>();
+    } else if (0 != dynamic_cast<SHA3_256*>(hash)) {
+        return new CryptoPP::HMAC<SHA3_256>();
+    } else if (0 != dynamic_cast<SHA3_384*>(hash)) {
+        return new CryptoPP::HMAC<SHA3_384>();
+    } else if (0 != dynamic_cast<SHA3_512*>(hash)) {
+        return new CryptoPP::HMAC<SHA3_512>();
+    }
+#endif
+
+    return NULL;
+}
+/* }}} */
+
+/* {{{ copyHmac
+   returns a copy of mac if it is a T, NULL otherwise */
+template <class T>
+static CryptoPP::MessageAuthenticationCode *copyHmac(CryptoPP::MessageAuthenticationCode *mac) {
+    T *hmac = dynamic_cast<T*>(mac);
+    return NULL == hmac ? NULL : new T(*hmac);
+}
+/* }}} */
+
+/* {{{ copyCryptoppNativeHmac
+   returns a copy of a mac created by createNativeHmac(), with its key and its pending data, or NULL if mac is not one of them.
+   CryptoPP::HMAC does not implement Clone() */
+CryptoPP::MessageAuthenticationCode *copyCryptoppNativeHmac(CryptoPP::MessageAuthenticationCode *mac) {
+    CryptoPP::MessageAuthenticationCode *copy = NULL;
+
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<CryptoPP::SHA1> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<CryptoPP::SHA256> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<CryptoPP::SHA384> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<CryptoPP::SHA512> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<CryptoPP::Weak::MD5> >(mac);
+
+#ifdef PHP_CRYPTOPP_HASH_SHA3
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<SHA3_224> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<SHA3_256> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<SHA3_384> >(mac);
+    if (NULL == copy) copy = copyHmac<CryptoPP::HMAC<SHA3_512> >(mac);
+#endif
+
+    return copy;
+}
+/* }}} */
+
 /* {{{ arginfo */
 ZEND_BEGIN_ARG_INFO(arginfo_MacHmac_construct, 0)
     ZEND_ARG_OBJ_INFO(0, hashAlgo, Cryptopp\\HashInterface, 0)
@@ -70,7 +141,11 @@ PHP_METHOD(Cryptopp_MacHmac, __construct) {
     if (instanceof_function(Z_OBJCE_P(hashObject), cryptopp_ce_HashAbstract TSRMLS_CC)) {
         // retrieve native hash object
         hash    = getCryptoppHashNativePtr(hashObject TSRMLS_CC);
-        mac     = new Hmac(hash, false, getThis() TSRMLS_CC);
+        mac     = createNativeHmac(hash);
+
+        if (NULL == mac) {
+            mac = new Hmac(hash, false, getThis() TSRMLS_CC);
+        }
     } else {
         // create a proxy to the user php object
         hash    = new HashProxy(hashObject TSRMLS_CC);
@@ -15,8 +15,10 @@
 #include <hmac.h>
 #include <seckey.h>
 
+extern zend_class_entry *cryptopp_ce_MacHmac;
 void init_class_MacHmac(TSRMLS_D);
 PHP_METHOD(Cryptopp_MacHmac, __construct);
+CryptoPP::MessageAuthenticationCode *copyCryptoppNativeHmac(CryptoPP::MessageAuthenticationCode *mac);
 
 /* {{{ fork of CryptoPP::HMAC that take a hash as parameter instead of a template parameter */
 class Hmac : public CryptoPP::MessageAuthenticationCodeImpl<CryptoPP::HMAC_Base, Hmac>
@@ -0,0 +1,531 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/utils/php_digest_utils.h"
+#include "src/utils/zval_utils.h"
+#include "mac_proxy.h"
+#include "php_mac_interface.h"
+#include "php_mac_abstract.h"
+#include "php_jws.h"
+#ifdef PHP_CRYPTOPP_MAC_HMAC
+#include "php_hmac.h"
+#endif
+#include <string>
+#include <zend_exceptions.h>
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_Jws_sign, 0)
+    ZEND_ARG_INFO(0, payload)
+    ZEND_ARG_OBJ_INFO(0, mac, Cryptopp\\MacInterface, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Jws_verify, 0)
+    ZEND_ARG_INFO(0, token)
+    ZEND_ARG_OBJ_INFO(0, mac, Cryptopp\\MacInterface, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Jws_verifyBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, tokens, 0)
+    ZEND_ARG_OBJ_INFO(0, mac, Cryptopp\\MacInterface, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_Jws;
+
+static zend_function_entry cryptopp_methods_Jws[] = {
+    PHP_ME(Cryptopp_Jws, sign, arginfo_Jws_sign, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Cryptopp_Jws, verify, arginfo_Jws_verify, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Cryptopp_Jws, verifyBatch, arginfo_Jws_verifyBatch, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_FE_END
+};
+
+void init_class_Jws(TSRMLS_D) {
+    zend_class_entry ce;
+    INIT_NS_CLASS_ENTRY(ce, "Cryptopp", "Jws", cryptopp_methods_Jws);
+    cryptopp_ce_Jws             = zend_register_internal_class(&ce TSRMLS_CC);
+    cryptopp_ce_Jws->ce_flags  |= ZEND_ACC_EXPLICIT_ABSTRACT_CLASS;
+}
+/* }}} */
+
+/* {{{ base64url (RFC 4648 section 5, without padding) */
+static const char base64UrlAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static void base64UrlEncode(const byte *data, size_t length, std::string &output) {
+    output.reserve(output.length() + (length * 4 + 2) / 3);
+    size_t i = 0;
+
+    for (; i + 2 < length; i += 3) {
+        output.push_back(base64UrlAlphabet[data[i] >> 2]);
+        output.push_back(base64UrlAlphabet[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)]);
+        output.push_back(base64UrlAlphabet[((data[i + 1] & 0x0f) << 2) | (data[i + 2] >> 6)]);
+        output.push_back(base64UrlAlphabet[data[i + 2] & 0x3f]);
+    }
+
+    if (length - i == 1) {
+        output.push_back(base64UrlAlphabet[data[i] >> 2]);
+        output.push_back(base64UrlAlphabet[(data[i] & 0x03) << 4]);
+    } else if (length - i == 2) {
+        output.push_back(base64UrlAlphabet[data[i] >> 2]);
+        output.push_back(base64UrlAlphabet[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)]);
+        output.push_back(base64UrlAlphabet[(data[i + 1] & 0x0f) << 2]);
+    }
+}
+
+static inline int base64UrlValue(char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    } else if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    } else if ('-' == c) {
+        return 62;
+    } else if ('_' == c) {
+        return 63;
+    }
+
+    return -1;
+}
+
+static bool base64UrlDecode(const char *data, size_t length, std::string &output) {
+    if (1 == length % 4) {
+        return false;
+    }
+
+    output.clear();
+    output.reserve(length * 3 / 4);
+    unsigned int buffer = 0;
+    int bits            = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        int value = base64UrlValue(data[i]);
+
+        if (value < 0) {
+            return false;
+        }
+
+        buffer  = (buffer << 6) | static_cast<unsigned int>(value);
+        bits   += 6;
+
+        if (bits >= 8) {
+            bits -= 8;
+            output.push_back(static_cast<char>((buffer >> bits) & 0xff));
+        }
+    }
+
+    // unused trailing bits must be zero (RFC 7515 section 2, RFC 4648 section 3.5)
+    if (0 != (buffer & ((1u << bits) - 1))) {
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ callPhpFunction
+   call a php function with one or two arguments */
+static zval *callPhpFunction(const char *name, zval *arg1, zval *arg2 TSRMLS_DC) {
+    zval *funcname  = makeZval(name);
+    zval *args[2];
+    args[0]         = arg1;
+    args[1]         = arg2;
+
+    zval *output;
+    MAKE_STD_ZVAL(output);
+    call_user_function(EG(function_table), NULL, funcname, output, NULL == arg2 ? 1 : 2, args TSRMLS_CC);
+    zval_ptr_dtor(&funcname);
+
+    return output;
+}
+/* }}} */
+
+/* {{{ getJwsAlgorithm
+   returns the JWS algorithm name matching a MAC name, or an empty string if not supported */
+static std::string getJwsAlgorithm(const char *macName, int macNameLength) {
+    std::string name(macName, macNameLength);
+
+    if ("hmac(sha256)" == name) {
+        return "HS256";
+    } else if ("hmac(sha384)" == name) {
+        return "HS384";
+    } else if ("hmac(sha512)" == name) {
+        return "HS512";
+    }
+
+    return "";
+}
+/* }}} */
+
+/* {{{ getJwsMac
+   retrieve the native mac object and the JWS algorithm to use. the mac object is shared with php code: a native mac
+   is copied, so that data pending in the shared object is neither used nor discarded. a user mac is only called
+   through calculateDigest() */
+static bool getJwsMac(zval *macObject, CryptoPP::MessageAuthenticationCode **mac, bool &macMustBeDestructed, std::string &alg TSRMLS_DC) {
+    macMustBeDestructed = false;
+
+    if (instanceof_function(Z_OBJCE_P(macObject), cryptopp_ce_MacAbstract TSRMLS_CC)) {
+        // retrieve native mac object
+        *mac = getCryptoppMacNativePtr(macObject TSRMLS_CC);
+
+        if (NULL == *mac || !isCryptoppMacKeyValid(macObject, *mac TSRMLS_CC)) {
+            return false;
+        }
+
+        zval *name  = zend_read_property(cryptopp_ce_MacAbstract, macObject, "name", 4, 0 TSRMLS_CC);
+        alg         = getJwsAlgorithm(Z_STRVAL_P(name), Z_STRLEN_P(name));
+
+        if (!alg.empty()) {
+#ifdef PHP_CRYPTOPP_MAC_HMAC
+            *mac = copyCryptoppNativeHmac(*mac);
+#else
+            *mac = NULL;
+#endif
+
+            if (NULL == *mac) {
+                // hmac of a user hash, whose state lives in the php hash object
+                zend_class_entry *ce = zend_get_class_entry(macObject TSRMLS_CC);
+                zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: %s cannot be used, its state cannot be copied", cryptopp_ce_Jws->name, ce->name);
+                return false;
+            }
+
+            (*mac)->Restart();
+            macMustBeDestructed = true;
+        }
+    } else {
+        // create a proxy to the user php object
+        try {
+            *mac                = new MacProxy(macObject TSRMLS_CC);
+            macMustBeDestructed = true;
+        } catch (bool e) {
+            return false;
+        } catch (const char *e) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp internal error: Jws: %s", e);
+            return false;
+        }
+
+        zval *funcName  = makeZval("getName");
+        zval *name      = call_user_method(macObject, funcName TSRMLS_CC);
+        alg             = IS_STRING == Z_TYPE_P(name) ? getJwsAlgorithm(Z_STRVAL_P(name), Z_STRLEN_P(name)) : "";
+        zval_ptr_dtor(&funcName);
+        zval_ptr_dtor(&name);
+    }
+
+    if (alg.empty()) {
+        zend_class_entry *ce = zend_get_class_entry(macObject TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: %s is not supported, only HMAC-SHA256/384/512 can be used", cryptopp_ce_Jws->name, ce->name);
+
+        if (macMustBeDestructed) {
+            delete *mac;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ getJwsEncodedHeader
+   returns the base64url encoded header emitted by Jws::sign() */
+static std::string getJwsEncodedHeader(const std::string &alg) {
+    std::string header("{\"alg\":\"");
+    header.append(alg);
+    header.append("\",\"typ\":\"JWT\"}");
+
+    std::string encodedHeader;
+    base64UrlEncode(reinterpret_cast<const byte*>(header.data()), header.length(), encodedHeader);
+
+    return encodedHeader;
+}
+/* }}} */
+
+/* {{{ isJwsHeaderValid
+   indicates if a decoded JOSE header declares the expected algorithm, and no critical extension */
+static bool isJwsHeaderValid(const std::string &header, const std::string &alg TSRMLS_DC) {
+    zval *zHeader   = makeZval(header.data(), header.length());
+    zval *zAssoc;
+    MAKE_STD_ZVAL(zAssoc);
+    ZVAL_BOOL(zAssoc, 1);
+
+    zval *decoded   = callPhpFunction("json_decode", zHeader, zAssoc TSRMLS_CC);
+    bool result     = false;
+    zval **zAlg;
+
+    if (IS_ARRAY == Z_TYPE_P(decoded) &&
+        SUCCESS == zend_hash_find(Z_ARRVAL_P(decoded), "alg", 4, reinterpret_cast<void**>(&zAlg)) &&
+        IS_STRING == Z_TYPE_PP(zAlg) &&
+        alg == std::string(Z_STRVAL_PP(zAlg), Z_STRLEN_PP(zAlg)) &&
+        !zend_hash_exists(Z_ARRVAL_P(decoded), "crit", 5)
+    ) {
+        result = true;
+    }
+
+    zval_ptr_dtor(&zHeader);
+    zval_ptr_dtor(&zAssoc);
+    zval_ptr_dtor(&decoded);
+
+    return result;
+}
+/* }}} */
+
+/* {{{ verifyJwsToken
+   verify a compact JWS token. on success, payload holds the decoded payload */
+static bool verifyJwsToken(
+    CryptoPP::MessageAuthenticationCode *mac,
+    const std::string &alg,
+    const std::string &encodedHeader,
+    const char *token,
+    int tokenLength,
+    std::string &payload
+    TSRMLS_DC
+) {
+    // exactly 3 parts
+    const char *firstDot    = static_cast<const char*>(memchr(token, '.', tokenLength));
+
+    if (NULL == firstDot) {
+        return false;
+    }
+
+    const char *payloadStart    = firstDot + 1;
+    const char *secondDot       = static_cast<const char*>(memchr(payloadStart, '.', token + tokenLength - payloadStart));
+
+    if (NULL == secondDot) {
+        return false;
+    }
+
+    const char *signatureStart  = secondDot + 1;
+    size_t signatureLength      = token + tokenLength - signatureStart;
+
+    if (NULL != memchr(signatureStart, '.', signatureLength)) {
+        return false;
+    }
+
+    // header. the one emitted by Jws::sign() does not need to be decoded
+    size_t headerLength = firstDot - token;
+
+    if (headerLength != encodedHeader.length() || 0 != memcmp(token, encodedHeader.data(), headerLength)) {
+        std::string header;
+
+        if (!base64UrlDecode(token, headerLength, header) || !isJwsHeaderValid(header, alg TSRMLS_CC)) {
+            return false;
+        }
+    }
+
+    // signature
+    std::string signature;
+
+    if (!base64UrlDecode(signatureStart, signatureLength, signature)) {
+        return false;
+    }
+
+    unsigned int digestSize = mac->DigestSize();
+    byte digest[digestSize];
+    mac->CalculateDigest(digest, reinterpret_cast<const byte*>(token), secondDot - token);
+
+    if (!cryptoppDigestEquals(reinterpret_cast<char*>(digest), digestSize, const_cast<char*>(signature.data()), signature.length())) {
+        return false;
+    }
+
+    // payload
+    return base64UrlDecode(payloadStart, secondDot - payloadStart, payload);
+}
+/* }}} */
+
+/* {{{ proto string Jws::sign(array|string payload, Cryptopp\MacInterface mac)
+   Returns a compact JWS token. Arrays are json encoded */
+PHP_METHOD(Cryptopp_Jws, sign) {
+    zval *zPayload;
+    zval *macObject;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "zO", &zPayload, &macObject, cryptopp_ce_MacInterface)) {
+        return;
+    }
+
+    if (IS_STRING != Z_TYPE_P(zPayload) && IS_ARRAY != Z_TYPE_P(zPayload)) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: payload must be a string or an array, %s given", cryptopp_ce_Jws->name, zend_zval_type_name(zPayload));
+        RETURN_FALSE
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    bool macMustBeDestructed;
+    std::string alg;
+
+    if (!getJwsMac(macObject, &mac, macMustBeDestructed, alg TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    // build signing input
+    std::string token(getJwsEncodedHeader(alg));
+    token.push_back('.');
+
+    if (IS_ARRAY == Z_TYPE_P(zPayload)) {
+        zval *json = callPhpFunction("json_encode", zPayload, NULL TSRMLS_CC);
+
+        if (IS_STRING != Z_TYPE_P(json)) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: payload cannot be json encoded", cryptopp_ce_Jws->name);
+            zval_ptr_dtor(&json);
+
+            if (macMustBeDestructed) {
+                delete mac;
+            }
+
+            RETURN_FALSE
+        }
+
+        base64UrlEncode(reinterpret_cast<byte*>(Z_STRVAL_P(json)), Z_STRLEN_P(json), token);
+        zval_ptr_dtor(&json);
+    } else {
+        base64UrlEncode(reinterpret_cast<byte*>(Z_STRVAL_P(zPayload)), Z_STRLEN_P(zPayload), token);
+    }
+
+    // sign
+    unsigned int digestSize = mac->DigestSize();
+    byte digest[digestSize];
+    bool error              = false;
+
+    try {
+        mac->CalculateDigest(digest, reinterpret_cast<const byte*>(token.data()), token.length());
+    } catch (bool e) {
+        error = true;
+    }
+
+    if (macMustBeDestructed) {
+        delete mac;
+    }
+
+    if (error) {
+        RETURN_FALSE
+    }
+
+    token.push_back('.');
+    base64UrlEncode(digest, digestSize, token);
+
+    RETURN_STRINGL(token.data(), token.length(), 1)
+}
+/* }}} */
+
+/* {{{ proto string|bool Jws::verify(string token, Cryptopp\MacInterface mac)
+   Verify a compact JWS token. Returns the decoded payload, or false if the token is not valid */
+PHP_METHOD(Cryptopp_Jws, verify) {
+    char *token     = NULL;
+    int tokenSize   = 0;
+    zval *macObject;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "sO", &token, &tokenSize, &macObject, cryptopp_ce_MacInterface)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    bool macMustBeDestructed;
+    std::string alg;
+
+    if (!getJwsMac(macObject, &mac, macMustBeDestructed, alg TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    std::string payload;
+    bool valid = false;
+
+    try {
+        valid = verifyJwsToken(mac, alg, getJwsEncodedHeader(alg), token, tokenSize, payload TSRMLS_CC);
+    } catch (bool e) {
+        valid = false;
+    }
+
+    if (macMustBeDestructed) {
+        delete mac;
+    }
+
+    if (!valid) {
+        RETURN_FALSE
+    }
+
+    RETURN_STRINGL(payload.data(), payload.length(), 1)
+}
+/* }}} */
+
+/* {{{ proto array Jws::verifyBatch(array tokens, Cryptopp\MacInterface mac)
+   Verify several compact JWS tokens with the same MAC. Keys are preserved, each value is
+   the decoded payload or false */
+PHP_METHOD(Cryptopp_Jws, verifyBatch) {
+    zval *tokens;
+    zval *macObject;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "aO", &tokens, &macObject, cryptopp_ce_MacInterface)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    bool macMustBeDestructed;
+    std::string alg;
+
+    if (!getJwsMac(macObject, &mac, macMustBeDestructed, alg TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    std::string encodedHeader(getJwsEncodedHeader(alg));
+    std::string payload;
+    HashTable *tokenList = Z_ARRVAL_P(tokens);
+    HashPosition pos;
+    zval **zToken;
+
+    array_init(return_value);
+
+    for (
+        zend_hash_internal_pointer_reset_ex(tokenList, &pos);
+        SUCCESS == zend_hash_get_current_data_ex(tokenList, reinterpret_cast<void**>(&zToken), &pos);
+        zend_hash_move_forward_ex(tokenList, &pos)
+    ) {
+        bool valid = false;
+
+        if (IS_STRING == Z_TYPE_PP(zToken)) {
+            try {
+                valid = verifyJwsToken(mac, alg, encodedHeader, Z_STRVAL_PP(zToken), Z_STRLEN_PP(zToken), payload TSRMLS_CC);
+            } catch (bool e) {
+                valid = false;
+            }
+        }
+
+        zval *result;
+        MAKE_STD_ZVAL(result);
+
+        if (valid) {
+            ZVAL_STRINGL(result, payload.data(), payload.length(), 1);
+        } else {
+            ZVAL_FALSE(result);
+        }
+
+        char *key;
+        uint keyLength;
+        ulong index;
+
+        if (HASH_KEY_IS_STRING == zend_hash_get_current_key_ex(tokenList, &key, &keyLength, &index, 0, &pos)) {
+            add_assoc_zval_ex(return_value, key, keyLength, result);
+        } else {
+            add_index_zval(return_value, index, result);
+        }
+    }
+
+    if (macMustBeDestructed) {
+        delete mac;
+    }
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,543 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/utils/php_digest_utils.h"
+#include "src/utils/zend_object_utils.h"
+#include "src/utils/zval_utils.h"
+#include "mac_proxy.h"
+#include "php_mac_interface.h"
+#include "php_mac_abstract.h"
+#include "php_otp.h"
+#ifdef PHP_CRYPTOPP_MAC_HMAC
+#include "php_hmac.h"
+#endif
+#include <limits.h>
+#include <stdio.h>
+#include <time.h>
+#include <zend_exceptions.h>
+
+/* {{{ maximum number of counters or time steps accepted on each side by verifyHotp() and verify() */
+#define OTP_MAX_WINDOW 100
+/* }}} */
+
+/* {{{ arg info */
+ZEND_BEGIN_ARG_INFO_EX(arginfo_Otp___construct, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, mac, Cryptopp\\MacInterface, 0)
+    ZEND_ARG_INFO(0, digits)
+    ZEND_ARG_INFO(0, period)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Otp___wakeup, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Otp___sleep, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Otp_getMac, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Otp_getDigits, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Otp_getPeriod, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_Otp_generateHotp, 0)
+    ZEND_ARG_INFO(0, counter)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_Otp_generateTotp, 0, 0, 0)
+    ZEND_ARG_INFO(0, timestamp)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_Otp_verifyHotp, 0, 0, 2)
+    ZEND_ARG_INFO(0, code)
+    ZEND_ARG_INFO(0, counter)
+    ZEND_ARG_INFO(0, window)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_Otp_verify, 0, 0, 1)
+    ZEND_ARG_INFO(0, code)
+    ZEND_ARG_INFO(0, window)
+    ZEND_ARG_INFO(0, timestamp)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ Otp_free_storage
+   custom object free handler */
+void Otp_free_storage(void *object TSRMLS_DC) {
+    OtpContainer *obj = static_cast<OtpContainer *>(object);
+
+    if (obj->macMustBeDestructed) {
+        delete obj->mac;
+    }
+
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+    efree(obj);
+}
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_object_handlers Otp_object_handlers;
+zend_class_entry *cryptopp_ce_Otp;
+
+static zend_function_entry cryptopp_methods_Otp[] = {
+    PHP_ME(Cryptopp_Otp, __construct, arginfo_Otp___construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_Otp, __sleep, arginfo_Otp___sleep, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, __wakeup, arginfo_Otp___wakeup, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, getMac, arginfo_Otp_getMac, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, getDigits, arginfo_Otp_getDigits, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, getPeriod, arginfo_Otp_getPeriod, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, generateHotp, arginfo_Otp_generateHotp, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, generateTotp, arginfo_Otp_generateTotp, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, verifyHotp, arginfo_Otp_verifyHotp, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_Otp, verify, arginfo_Otp_verify, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_FE_END
+};
+
+void init_class_Otp(TSRMLS_D) {
+    zend_class_entry ce;
+    INIT_NS_CLASS_ENTRY(ce, "Cryptopp", "Otp", cryptopp_methods_Otp);
+    cryptopp_ce_Otp                 = zend_register_internal_class(&ce TSRMLS_CC);
+
+    cryptopp_ce_Otp->create_object  = zend_custom_create_handler<OtpContainer, Otp_free_storage, &Otp_object_handlers>;
+    memcpy(&Otp_object_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    Otp_object_handlers.clone_obj   = NULL;
+
+    zend_declare_property_null(cryptopp_ce_Otp, "mac", 3, ZEND_ACC_PRIVATE TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ getCryptoppOtpNativePtr
+   get the pointer to the native mac object of the php class */
+static CryptoPP::MessageAuthenticationCode *getCryptoppOtpNativePtr(zval *this_ptr TSRMLS_DC) {
+    CryptoPP::MessageAuthenticationCode *mac = static_cast<OtpContainer *>(zend_object_store_get_object(this_ptr TSRMLS_CC))->mac;
+
+    if (NULL == mac) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\Otp : constructor was not called");
+    }
+
+    return mac;
+}
+/* }}} */
+
+/* {{{ isNativeMacObjectValid
+   if the mac object holded by an Otp object is a native mac object, ensure that its key is valid */
+static bool isNativeMacObjectValid(zval *otpObject, CryptoPP::MessageAuthenticationCode *mac TSRMLS_DC) {
+    zval *macObject = zend_read_property(cryptopp_ce_Otp, otpObject, "mac", 3, 0 TSRMLS_CC);
+
+    if (instanceof_function(Z_OBJCE_P(macObject), cryptopp_ce_MacAbstract TSRMLS_CC)) {
+        return isCryptoppMacKeyValid(macObject, mac TSRMLS_CC);
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ copyOtpNativeMac
+   returns a copy of a native mac, with its key, or NULL if it cannot be copied, such as a hmac of a user hash,
+   whose state lives in the php hash object */
+static CryptoPP::MessageAuthenticationCode *copyOtpNativeMac(CryptoPP::MessageAuthenticationCode *mac) {
+    CryptoPP::MessageAuthenticationCode *copy = NULL;
+
+#ifdef PHP_CRYPTOPP_MAC_HMAC
+    copy = copyCryptoppNativeHmac(mac);
+#endif
+
+    if (NULL == copy) {
+        try {
+            copy = dynamic_cast<CryptoPP::MessageAuthenticationCode*>(mac->Clone());
+        } catch (CryptoPP::NotImplemented &e) {
+            copy = NULL;
+        }
+    }
+
+    return copy;
+}
+/* }}} */
+
+/* {{{ OtpMac
+   mac used to compute codes. the mac object is shared with php code: a native mac is copied, so that data pending
+   in the shared object is neither used nor discarded. a user mac is only called through calculateDigest().
+   native macs that cannot be copied are rejected by the constructor of Otp */
+class OtpMac
+{
+public:
+    OtpMac(CryptoPP::MessageAuthenticationCode *mac) {
+        m_mac   = mac;
+        m_copy  = NULL;
+
+        if (NULL == dynamic_cast<MacProxy*>(mac)) {
+            m_copy = copyOtpNativeMac(mac);
+        }
+    }
+
+    ~OtpMac() {
+        delete m_copy;
+    }
+
+    void Compute(CryptoPP::word64 counter, unsigned int digits, char *output);
+
+private:
+    CryptoPP::MessageAuthenticationCode *m_mac;
+    CryptoPP::MessageAuthenticationCode *m_copy;
+};
+/* }}} */
+
+/* {{{ OtpMac::Compute
+   computes the HOTP value of a counter (RFC 4226), formatted as a zero padded string.
+   output must be at least digits + 1 bytes long */
+void OtpMac::Compute(CryptoPP::word64 counter, unsigned int digits, char *output) {
+    // counter is hashed as a 8 bytes big endian integer
+    byte message[8];
+
+    for (int i = 7; i >= 0; i--) {
+        message[i]  = static_cast<byte>(counter & 0xff);
+        counter   >>= 8;
+    }
+
+    unsigned int digestSize = m_mac->DigestSize();
+    byte digest[digestSize];
+
+    if (NULL != m_copy) {
+        m_copy->Restart();
+        m_copy->CalculateDigest(digest, message, sizeof(message));
+    } else {
+        m_mac->CalculateDigest(digest, message, sizeof(message));
+    }
+
+    // dynamic truncation
+    unsigned int offset = digest[digestSize - 1] & 0x0f;
+    unsigned long code  = (static_cast<unsigned long>(digest[offset] & 0x7f) << 24)
+        | (static_cast<unsigned long>(digest[offset + 1]) << 16)
+        | (static_cast<unsigned long>(digest[offset + 2]) << 8)
+        | static_cast<unsigned long>(digest[offset + 3]);
+
+    unsigned long modulus = 1;
+
+    for (unsigned int i = 0; i < digits; i++) {
+        modulus *= 10;
+    }
+
+    snprintf(output, digits + 1, "%0*lu", digits, code % modulus);
+}
+/* }}} */
+
+/* {{{ isWindowValid
+   checks that a window is between 0 and OTP_MAX_WINDOW, and that the last counter it covers can be represented */
+static bool isWindowValid(long window, long counter TSRMLS_DC) {
+    if (window < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: window cannot be negative", cryptopp_ce_Otp->name);
+        return false;
+    } else if (window > OTP_MAX_WINDOW) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: window cannot be greater than %d", cryptopp_ce_Otp->name, OTP_MAX_WINDOW);
+        return false;
+    } else if (counter > LONG_MAX - window) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: counter + window is too large", cryptopp_ce_Otp->name);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ proto void Otp::__sleep(void)
+   Prevents serialization of a Otp instance */
+PHP_METHOD(Cryptopp_Otp, __sleep) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\Otp instances");
+}
+/* }}} */
+
+/* {{{ proto void Otp::__wakeup(void)
+   Prevents use of a Otp instance that has been unserialized */
+PHP_METHOD(Cryptopp_Otp, __wakeup) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\Otp instances");
+}
+/* }}} */
+
+/* {{{ proto Otp::__construct(Cryptopp\MacInterface mac [, int digits = 6 [, int period = 30]]) */
+PHP_METHOD(Cryptopp_Otp, __construct) {
+    zval *macObject;
+    long digits = 6;
+    long period = 30;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "O|ll", &macObject, cryptopp_ce_MacInterface, &digits, &period)) {
+        return;
+    }
+
+    if (digits < 6 || digits > 8) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: digits must be between 6 and 8, %ld given", cryptopp_ce_Otp->name, digits);
+        return;
+    } else if (period <= 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: period must be greater than 0", cryptopp_ce_Otp->name);
+        return;
+    }
+
+    // retrieve native mac object
+    CryptoPP::MessageAuthenticationCode *mac;
+    bool macMustBeDestructed = false;
+
+    if (instanceof_function(Z_OBJCE_P(macObject), cryptopp_ce_MacAbstract TSRMLS_CC)) {
+        mac = getCryptoppMacNativePtr(macObject TSRMLS_CC);
+
+        if (NULL == mac) {
+            return;
+        }
+
+        // codes are computed with a copy of the mac, so that the state of the shared object is not reset
+        CryptoPP::MessageAuthenticationCode *copy = copyOtpNativeMac(mac);
+
+        if (NULL == copy) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: %s cannot be used, its state cannot be copied", cryptopp_ce_Otp->name, Z_OBJCE_P(macObject)->name);
+            return;
+        }
+
+        delete copy;
+    } else {
+        // create a proxy to the user php object
+        try {
+            mac                 = new MacProxy(macObject TSRMLS_CC);
+            macMustBeDestructed = true;
+        } catch (bool e) {
+            return;
+        } catch (const char *e) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp internal error: Otp: %s", e);
+            return;
+        }
+    }
+
+    // dynamic truncation reads 4 bytes at an offset up to 15
+    if (mac->DigestSize() < 20) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: MAC digest size must be at least 20 bytes, %d given", cryptopp_ce_Otp->name, mac->DigestSize());
+
+        if (macMustBeDestructed) {
+            delete mac;
+        }
+
+        return;
+    }
+
+    OtpContainer *container         = static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC));
+    container->mac                  = mac;
+    container->macMustBeDestructed  = macMustBeDestructed;
+    container->digits               = static_cast<unsigned int>(digits);
+    container->period               = static_cast<unsigned int>(period);
+
+    // hold the mac object. if not, it can be deleted.
+    zend_update_property(cryptopp_ce_Otp, getThis(), "mac", 3, macObject TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto Cryptopp\MacInterface Otp::getMac(void)
+   Returns the MAC object */
+PHP_METHOD(Cryptopp_Otp, getMac) {
+    zval *macObject = zend_read_property(cryptopp_ce_Otp, getThis(), "mac", 3, 0 TSRMLS_CC);
+    RETURN_ZVAL(macObject, 1, 0)
+}
+/* }}} */
+
+/* {{{ proto int Otp::getDigits(void)
+   Returns the number of digits of generated codes */
+PHP_METHOD(Cryptopp_Otp, getDigits) {
+    CryptoPP::MessageAuthenticationCode *mac;
+    CRYPTOPP_OTP_GET_NATIVE_PTR(mac)
+
+    RETURN_LONG(static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->digits)
+}
+/* }}} */
+
+/* {{{ proto int Otp::getPeriod(void)
+   Returns the TOTP time step, in seconds */
+PHP_METHOD(Cryptopp_Otp, getPeriod) {
+    CryptoPP::MessageAuthenticationCode *mac;
+    CRYPTOPP_OTP_GET_NATIVE_PTR(mac)
+
+    RETURN_LONG(static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->period)
+}
+/* }}} */
+
+/* {{{ proto string Otp::generateHotp(int counter)
+   Generates a counter based code (RFC 4226) */
+PHP_METHOD(Cryptopp_Otp, generateHotp) {
+    long counter = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &counter)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    CRYPTOPP_OTP_GET_NATIVE_PTR(mac)
+
+    if (counter < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: counter cannot be negative", cryptopp_ce_Otp->name);
+        RETURN_FALSE
+    } else if (!isNativeMacObjectValid(getThis(), mac TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    unsigned int digits = static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->digits;
+    char code[digits + 1];
+    OtpMac otpMac(mac);
+
+    try {
+        otpMac.Compute(static_cast<CryptoPP::word64>(counter), digits, code);
+    } catch (bool e) {
+        RETURN_FALSE
+    }
+
+    RETURN_STRINGL(code, digits, 1)
+}
+/* }}} */
+
+/* {{{ proto string Otp::generateTotp([int timestamp])
+   Generates a time based code (RFC 6238). timestamp defaults to the current time */
+PHP_METHOD(Cryptopp_Otp, generateTotp) {
+    long timestamp = static_cast<long>(time(NULL));
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "|l", &timestamp)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    CRYPTOPP_OTP_GET_NATIVE_PTR(mac)
+
+    if (timestamp < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: timestamp cannot be negative", cryptopp_ce_Otp->name);
+        RETURN_FALSE
+    } else if (!isNativeMacObjectValid(getThis(), mac TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    OtpContainer *container = static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC));
+    char code[container->digits + 1];
+    OtpMac otpMac(mac);
+
+    try {
+        otpMac.Compute(static_cast<CryptoPP::word64>(timestamp / container->period), container->digits, code);
+    } catch (bool e) {
+        RETURN_FALSE
+    }
+
+    RETURN_STRINGL(code, container->digits, 1)
+}
+/* }}} */
+
+/* {{{ proto int|bool Otp::verifyHotp(string code, int counter [, int window = 0])
+   Verifies a counter based code against counters [counter, counter + window].
+   Returns the matching counter, or false if none matches */
+PHP_METHOD(Cryptopp_Otp, verifyHotp) {
+    char *userCode      = NULL;
+    int userCodeSize    = 0;
+    long counter        = 0;
+    long window         = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "sl|l", &userCode, &userCodeSize, &counter, &window)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    CRYPTOPP_OTP_GET_NATIVE_PTR(mac)
+
+    if (counter < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: counter cannot be negative", cryptopp_ce_Otp->name);
+        RETURN_FALSE
+    } else if (!isWindowValid(window, counter TSRMLS_CC)) {
+        RETURN_FALSE
+    } else if (!isNativeMacObjectValid(getThis(), mac TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    unsigned int digits = static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->digits;
+    char code[digits + 1];
+    OtpMac otpMac(mac);
+    bool matched        = false;
+    long matchedCounter = 0;
+
+    // every counter of the window is computed, whether a match was found or not
+    try {
+        for (long i = 0; i <= window; i++) {
+            otpMac.Compute(static_cast<CryptoPP::word64>(counter + i), digits, code);
+            bool equals = cryptoppDigestEquals(code, digits, userCode, userCodeSize);
+
+            if (equals && !matched) {
+                matched         = true;
+                matchedCounter  = counter + i;
+            }
+        }
+    } catch (bool e) {
+        RETURN_FALSE
+    }
+
+    if (matched) {
+        RETURN_LONG(matchedCounter)
+    } else {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
+/* {{{ proto bool Otp::verify(string code [, int window = 0 [, int timestamp]])
+   Verifies a time based code, accepting up to window time steps before and after the current one */
+PHP_METHOD(Cryptopp_Otp, verify) {
+    char *userCode      = NULL;
+    int userCodeSize    = 0;
+    long window         = 0;
+    long timestamp      = static_cast<long>(time(NULL));
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "s|ll", &userCode, &userCodeSize, &window, &timestamp)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac;
+    CRYPTOPP_OTP_GET_NATIVE_PTR(mac)
+
+    OtpContainer *container = static_cast<OtpContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC));
+    long step               = timestamp / container->period;
+
+    if (timestamp < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: timestamp cannot be negative", cryptopp_ce_Otp->name);
+        RETURN_FALSE
+    } else if (!isWindowValid(window, step TSRMLS_CC)) {
+        RETURN_FALSE
+    } else if (!isNativeMacObjectValid(getThis(), mac TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    char code[container->digits + 1];
+    OtpMac otpMac(mac);
+    bool matched            = false;
+
+    // every step of the window is computed, whether a match was found or not
+    try {
+        for (long i = -window; i <= window; i++) {
+            if (step + i < 0) {
+                continue;
+            }
+
+            otpMac.Compute(static_cast<CryptoPP::word64>(step + i), container->digits, code);
+            matched |= cryptoppDigestEquals(code, container->digits, userCode, userCodeSize);
+        }
+    } catch (bool e) {
+        RETURN_FALSE
+    }
+
+    RETURN_BOOL(matched)
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,63 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_MAC_OTP_H
+#define PHP_MAC_OTP_H
+
+#include "src/php_cryptopp.h"
+
+extern zend_class_entry *cryptopp_ce_Otp;
+void init_class_Otp(TSRMLS_D);
+
+/* {{{ CRYPTOPP_OTP_GET_NATIVE_PTR
+   get the pointer to the native mac object of the php class */
+#define CRYPTOPP_OTP_GET_NATIVE_PTR(ptrName)                    \
+    ptrName = getCryptoppOtpNativePtr(getThis() TSRMLS_CC);     \
+                                                                \
+    if (NULL == ptrName) {                                      \
+        RETURN_FALSE;                                           \
+    }                                                           \
+/* }}} */
+
+/* {{{ object creation related stuff */
+struct OtpContainer {
+    zend_object std;
+    CryptoPP::MessageAuthenticationCode *mac;
+    bool macMustBeDestructed;
+    unsigned int digits;
+    unsigned int period;
+};
+
+extern zend_object_handlers Otp_object_handlers;
+void Otp_free_storage(void *object TSRMLS_DC);
+/* }}} */
+
+/* {{{ methods declarations */
+PHP_METHOD(Cryptopp_Otp, __construct);
+PHP_METHOD(Cryptopp_Otp, __sleep);
+PHP_METHOD(Cryptopp_Otp, __wakeup);
+PHP_METHOD(Cryptopp_Otp, getMac);
+PHP_METHOD(Cryptopp_Otp, getDigits);
+PHP_METHOD(Cryptopp_Otp, getPeriod);
+PHP_METHOD(Cryptopp_Otp, generateHotp);
+PHP_METHOD(Cryptopp_Otp, generateTotp);
+PHP_METHOD(Cryptopp_Otp, verifyHotp);
+PHP_METHOD(Cryptopp_Otp, verify);
+/* }}} */
+
+#endif /* PHP_MAC_OTP_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,320 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/utils/zend_object_utils.h"
+#include "php_mac_abstract.h"
+#include "php_hmac.h"
+#include "php_signing_key_chain.h"
+#include <zend_exceptions.h>
+
+/* {{{ SigningKeyChain */
+SigningKeyChain::SigningKeyChain(CryptoPP::MessageAuthenticationCode *mac, const byte *secret, size_t secretLength, const std::string &terminator)
+    : m_mac(mac)
+    , m_secret(secret, secretLength)
+    , m_terminator(terminator)
+{
+}
+
+void SigningKeyChain::Derive(CryptoPP::SecByteBlock &key, const std::string &data)
+{
+    m_mac->SetKey(key.BytePtr(), key.size());
+    key.resize(m_mac->DigestSize());
+    m_mac->CalculateDigest(key.BytePtr(), reinterpret_cast<const byte*>(data.data()), data.length());
+}
+
+const CryptoPP::SecByteBlock &SigningKeyChain::GetSigningKey(const std::string &date, const std::string &region, const std::string &service)
+{
+    Scope scope(region, service);
+    std::map<std::string, ScopeCache>::iterator dateIt = m_cache.find(date);
+
+    if (m_cache.end() != dateIt) {
+        ScopeCache::iterator scopeIt = dateIt->second.find(scope);
+
+        if (dateIt->second.end() != scopeIt) {
+            return scopeIt->second;
+        }
+    }
+
+    // derive the key
+    CryptoPP::SecByteBlock key(m_secret);
+    Derive(key, date);
+    Derive(key, region);
+    Derive(key, service);
+    Derive(key, m_terminator);
+
+    // dates are ordered, keep only the two most recent ones
+    if (m_cache.end() == dateIt) {
+        if (m_cache.size() >= 2 && date < m_cache.begin()->first) {
+            // older than every cached date: not worth caching
+            m_uncachedKey.swap(key);
+            return m_uncachedKey;
+        }
+
+        dateIt = m_cache.insert(std::make_pair(date, ScopeCache())).first;
+
+        while (m_cache.size() > 2) {
+            m_cache.erase(m_cache.begin());
+        }
+    }
+
+    if (dateIt->second.size() >= SIGNING_KEY_CHAIN_MAX_SCOPES) {
+        m_uncachedKey.swap(key);
+        return m_uncachedKey;
+    }
+
+    CryptoPP::SecByteBlock &cached = dateIt->second[scope];
+    cached.swap(key);
+
+    return cached;
+}
+
+void SigningKeyChain::Sign(byte *digest, const CryptoPP::SecByteBlock &signingKey, const byte *data, size_t length)
+{
+    m_mac->SetKey(signingKey.BytePtr(), signingKey.size());
+    m_mac->CalculateDigest(digest, data, length);
+}
+/* }}} */
+
+/* {{{ arg info */
+ZEND_BEGIN_ARG_INFO_EX(arginfo_SigningKeyChain___construct, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, mac, Cryptopp\\MacHmac, 0)
+    ZEND_ARG_INFO(0, secret)
+    ZEND_ARG_INFO(0, terminator)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SigningKeyChain___wakeup, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SigningKeyChain___sleep, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SigningKeyChain_getMac, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SigningKeyChain_getSigningKey, 0)
+    ZEND_ARG_INFO(0, date)
+    ZEND_ARG_INFO(0, region)
+    ZEND_ARG_INFO(0, service)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SigningKeyChain_sign, 0)
+    ZEND_ARG_INFO(0, date)
+    ZEND_ARG_INFO(0, region)
+    ZEND_ARG_INFO(0, service)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SigningKeyChain_clearCache, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ SigningKeyChain_free_storage
+   custom object free handler */
+void SigningKeyChain_free_storage(void *object TSRMLS_DC) {
+    SigningKeyChainContainer *obj = static_cast<SigningKeyChainContainer *>(object);
+    delete obj->chain;
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+    efree(obj);
+}
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_object_handlers SigningKeyChain_object_handlers;
+zend_class_entry *cryptopp_ce_SigningKeyChain;
+
+static zend_function_entry cryptopp_methods_SigningKeyChain[] = {
+    PHP_ME(Cryptopp_SigningKeyChain, __construct, arginfo_SigningKeyChain___construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_SigningKeyChain, __sleep, arginfo_SigningKeyChain___sleep, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SigningKeyChain, __wakeup, arginfo_SigningKeyChain___wakeup, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SigningKeyChain, getMac, arginfo_SigningKeyChain_getMac, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SigningKeyChain, getSigningKey, arginfo_SigningKeyChain_getSigningKey, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SigningKeyChain, sign, arginfo_SigningKeyChain_sign, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SigningKeyChain, clearCache, arginfo_SigningKeyChain_clearCache, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_FE_END
+};
+
+void init_class_SigningKeyChain(TSRMLS_D) {
+    zend_class_entry ce;
+    INIT_NS_CLASS_ENTRY(ce, "Cryptopp", "SigningKeyChain", cryptopp_methods_SigningKeyChain);
+    cryptopp_ce_SigningKeyChain                 = zend_register_internal_class(&ce TSRMLS_CC);
+
+    cryptopp_ce_SigningKeyChain->create_object  = zend_custom_create_handler<SigningKeyChainContainer, SigningKeyChain_free_storage, &SigningKeyChain_object_handlers>;
+    memcpy(&SigningKeyChain_object_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    SigningKeyChain_object_handlers.clone_obj   = NULL;
+
+    zend_declare_property_null(cryptopp_ce_SigningKeyChain, "mac", 3, ZEND_ACC_PRIVATE TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ getCryptoppSigningKeyChainNativePtr
+   get the pointer to the native key chain object of the php class */
+static SigningKeyChain *getCryptoppSigningKeyChainNativePtr(zval *this_ptr TSRMLS_DC) {
+    SigningKeyChain *chain = static_cast<SigningKeyChainContainer *>(zend_object_store_get_object(this_ptr TSRMLS_CC))->chain;
+
+    if (NULL == chain) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\SigningKeyChain : constructor was not called");
+    }
+
+    return chain;
+}
+/* }}} */
+
+/* {{{ restoreMacKey
+   the chain rekeys the mac object: restore the key owned by the php mac object */
+static void restoreMacKey(zval *object TSRMLS_DC) {
+    zval *macObject = zend_read_property(cryptopp_ce_SigningKeyChain, object, "mac", 3, 0 TSRMLS_CC);
+    zval *key       = zend_read_property(cryptopp_ce_MacAbstract, macObject, "key", 3, 1 TSRMLS_CC);
+    CryptoPP::MessageAuthenticationCode *mac = getCryptoppMacNativePtr(macObject TSRMLS_CC);
+
+    if (NULL != mac && IS_STRING == Z_TYPE_P(key)) {
+        try {
+            mac->SetKey(reinterpret_cast<byte*>(Z_STRVAL_P(key)), Z_STRLEN_P(key));
+        } catch (bool e) {
+            // a php exception was thrown by a user hash
+        }
+    }
+}
+/* }}} */
+
+/* {{{ proto void SigningKeyChain::__sleep(void)
+   Prevents serialization of a SigningKeyChain instance */
+PHP_METHOD(Cryptopp_SigningKeyChain, __sleep) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\SigningKeyChain instances");
+}
+/* }}} */
+
+/* {{{ proto void SigningKeyChain::__wakeup(void)
+   Prevents use of a SigningKeyChain instance that has been unserialized */
+PHP_METHOD(Cryptopp_SigningKeyChain, __wakeup) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\SigningKeyChain instances");
+}
+/* }}} */
+
+/* {{{ proto SigningKeyChain::__construct(Cryptopp\MacHmac mac, string secret [, string terminator = "aws4_request"]) */
+PHP_METHOD(Cryptopp_SigningKeyChain, __construct) {
+    zval *macObject;
+    char *secret            = NULL;
+    int secretSize          = 0;
+    char *terminator        = const_cast<char*>("aws4_request");
+    int terminatorSize      = 12;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "Os|s", &macObject, cryptopp_ce_MacHmac, &secret, &secretSize, &terminator, &terminatorSize)) {
+        return;
+    }
+
+    CryptoPP::MessageAuthenticationCode *mac = getCryptoppMacNativePtr(macObject TSRMLS_CC);
+
+    if (NULL == mac) {
+        return;
+    }
+
+    SigningKeyChain *chain = new SigningKeyChain(mac, reinterpret_cast<byte*>(secret), secretSize, std::string(terminator, terminatorSize));
+    static_cast<SigningKeyChainContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->chain = chain;
+
+    // hold the mac object. if not, it can be deleted.
+    zend_update_property(cryptopp_ce_SigningKeyChain, getThis(), "mac", 3, macObject TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto Cryptopp\MacHmac SigningKeyChain::getMac(void)
+   Returns the MAC object */
+PHP_METHOD(Cryptopp_SigningKeyChain, getMac) {
+    zval *macObject = zend_read_property(cryptopp_ce_SigningKeyChain, getThis(), "mac", 3, 0 TSRMLS_CC);
+    RETURN_ZVAL(macObject, 1, 0)
+}
+/* }}} */
+
+/* {{{ proto string SigningKeyChain::getSigningKey(string date, string region, string service)
+   Returns the signing key of a scope */
+PHP_METHOD(Cryptopp_SigningKeyChain, getSigningKey) {
+    char *date          = NULL;
+    int dateSize        = 0;
+    char *region        = NULL;
+    int regionSize      = 0;
+    char *service       = NULL;
+    int serviceSize     = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "sss", &date, &dateSize, &region, &regionSize, &service, &serviceSize)) {
+        return;
+    }
+
+    SigningKeyChain *chain;
+    CRYPTOPP_SIGNING_KEY_CHAIN_GET_NATIVE_PTR(chain)
+
+    const CryptoPP::SecByteBlock *key;
+
+    try {
+        key = &chain->GetSigningKey(std::string(date, dateSize), std::string(region, regionSize), std::string(service, serviceSize));
+    } catch (bool e) {
+        restoreMacKey(getThis() TSRMLS_CC);
+        RETURN_FALSE;
+    }
+
+    restoreMacKey(getThis() TSRMLS_CC);
+
+    RETURN_STRINGL(reinterpret_cast<const char*>(key->BytePtr()), key->size(), 1)
+}
+/* }}} */
+
+/* {{{ proto string SigningKeyChain::sign(string date, string region, string service, string data)
+   Calculates the MAC of data with the signing key of a scope */
+PHP_METHOD(Cryptopp_SigningKeyChain, sign) {
+    char *date          = NULL;
+    int dateSize        = 0;
+    char *region        = NULL;
+    int regionSize      = 0;
+    char *service       = NULL;
+    int serviceSize     = 0;
+    char *data          = NULL;
+    int dataSize        = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ssss", &date, &dateSize, &region, &regionSize, &service, &serviceSize, &data, &dataSize)) {
+        return;
+    }
+
+    SigningKeyChain *chain;
+    CRYPTOPP_SIGNING_KEY_CHAIN_GET_NATIVE_PTR(chain)
+
+    unsigned int digestSize = chain->DigestSize();
+    byte digest[digestSize];
+
+    try {
+        const CryptoPP::SecByteBlock &key = chain->GetSigningKey(std::string(date, dateSize), std::string(region, regionSize), std::string(service, serviceSize));
+        chain->Sign(digest, key, reinterpret_cast<byte*>(data), dataSize);
+    } catch (bool e) {
+        restoreMacKey(getThis() TSRMLS_CC);
+        RETURN_FALSE;
+    }
+
+    restoreMacKey(getThis() TSRMLS_CC);
+
+    RETURN_STRINGL(reinterpret_cast<char*>(digest), digestSize, 1)
+}
+/* }}} */
+
+/* {{{ proto void SigningKeyChain::clearCache(void)
+   Removes all cached signing keys */
+PHP_METHOD(Cryptopp_SigningKeyChain, clearCache) {
+    SigningKeyChain *chain;
+    CRYPTOPP_SIGNING_KEY_CHAIN_GET_NATIVE_PTR(chain)
+
+    chain->ClearCache();
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,93 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_MAC_SIGNING_KEY_CHAIN_H
+#define PHP_MAC_SIGNING_KEY_CHAIN_H
+
+#include "src/php_cryptopp.h"
+#include <secblock.h>
+#include <map>
+#include <string>
+#include <utility>
+
+extern zend_class_entry *cryptopp_ce_SigningKeyChain;
+void init_class_SigningKeyChain(TSRMLS_D);
+
+/* {{{ maximum number of (region, service) scopes cached for each date */
+#define SIGNING_KEY_CHAIN_MAX_SCOPES 64
+/* }}} */
+
+/* {{{ SigningKeyChain
+   derives signing keys with a HMAC chain: secret -> date -> region -> service -> terminator.
+   derived keys are cached per scope. only the two most recent dates, and SIGNING_KEY_CHAIN_MAX_SCOPES scopes
+   per date, are kept in the cache */
+class SigningKeyChain
+{
+public:
+    SigningKeyChain(CryptoPP::MessageAuthenticationCode *mac, const byte *secret, size_t secretLength, const std::string &terminator);
+
+    const CryptoPP::SecByteBlock &GetSigningKey(const std::string &date, const std::string &region, const std::string &service);
+    void Sign(byte *digest, const CryptoPP::SecByteBlock &signingKey, const byte *data, size_t length);
+    void ClearCache() {m_cache.clear();}
+    unsigned int DigestSize() const {return m_mac->DigestSize();}
+
+private:
+    typedef std::pair<std::string, std::string> Scope;
+    typedef std::map<Scope, CryptoPP::SecByteBlock> ScopeCache;
+
+    void Derive(CryptoPP::SecByteBlock &key, const std::string &data);
+
+    CryptoPP::MessageAuthenticationCode *m_mac;
+    CryptoPP::SecByteBlock m_secret;
+    CryptoPP::SecByteBlock m_uncachedKey;
+    std::string m_terminator;
+    std::map<std::string, ScopeCache> m_cache;
+};
+/* }}} */
+
+/* {{{ CRYPTOPP_SIGNING_KEY_CHAIN_GET_NATIVE_PTR
+   get the pointer to the native key chain object of the php class */
+#define CRYPTOPP_SIGNING_KEY_CHAIN_GET_NATIVE_PTR(ptrName)                  \
+    ptrName = getCryptoppSigningKeyChainNativePtr(getThis() TSRMLS_CC);     \
+                                                                            \
+    if (NULL == ptrName) {                                                  \
+        RETURN_FALSE;                                                       \
+    }                                                                       \
+/* }}} */
+
+/* {{{ object creation related stuff */
+struct SigningKeyChainContainer {
+    zend_object std;
+    SigningKeyChain *chain;
+};
+
+extern zend_object_handlers SigningKeyChain_object_handlers;
+void SigningKeyChain_free_storage(void *object TSRMLS_DC);
+/* }}} */
+
+/* {{{ methods declarations */
+PHP_METHOD(Cryptopp_SigningKeyChain, __construct);
+PHP_METHOD(Cryptopp_SigningKeyChain, __sleep);
+PHP_METHOD(Cryptopp_SigningKeyChain, __wakeup);
+PHP_METHOD(Cryptopp_SigningKeyChain, getMac);
+PHP_METHOD(Cryptopp_SigningKeyChain, getSigningKey);
+PHP_METHOD(Cryptopp_SigningKeyChain, sign);
+PHP_METHOD(Cryptopp_SigningKeyChain, clearCache);
+/* }}} */
+
+#endif /* PHP_MAC_SIGNING_KEY_CHAIN_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,207 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "poly1305.h"
+#include <string.h>
+
+using CryptoPP::word32;
+using CryptoPP::word64;
+
+/* {{{ little endian helpers */
+static inline word32 poly1305Load32(const byte *p) {
+    return (word32)p[0] | ((word32)p[1] << 8) | ((word32)p[2] << 16) | ((word32)p[3] << 24);
+}
+
+static inline void poly1305Store32(byte *p, word32 v) {
+    p[0] = (byte)v;
+    p[1] = (byte)(v >> 8);
+    p[2] = (byte)(v >> 16);
+    p[3] = (byte)(v >> 24);
+}
+/* }}} */
+
+/* {{{ Poly1305 */
+Poly1305::Poly1305() : m_bufferedLength(0)
+{
+    memset(m_r, 0, sizeof(m_r));
+    memset(m_h, 0, sizeof(m_h));
+    memset(m_pad, 0, sizeof(m_pad));
+}
+
+Poly1305::~Poly1305()
+{
+    volatile byte *p = reinterpret_cast<volatile byte*>(this);
+
+    for (size_t i = 0; i < sizeof(*this); i++) {
+        p[i] = 0;
+    }
+}
+
+void Poly1305::SetKey(const byte *key) {
+    // r is clamped
+    m_r[0] = (poly1305Load32(key)      ) & 0x3ffffff;
+    m_r[1] = (poly1305Load32(key +  3) >> 2) & 0x3ffff03;
+    m_r[2] = (poly1305Load32(key +  6) >> 4) & 0x3ffc0ff;
+    m_r[3] = (poly1305Load32(key +  9) >> 6) & 0x3f03fff;
+    m_r[4] = (poly1305Load32(key + 12) >> 8) & 0x00fffff;
+
+    for (int i = 0; i < 4; i++) {
+        m_pad[i] = poly1305Load32(key + 16 + 4 * i);
+    }
+
+    memset(m_h, 0, sizeof(m_h));
+    m_bufferedLength = 0;
+}
+
+void Poly1305::ProcessBlocks(const byte *input, size_t length, bool lastBlock) {
+    const word32 hibit = lastBlock ? 0 : (1 << 24);
+    word32 r0 = m_r[0], r1 = m_r[1], r2 = m_r[2], r3 = m_r[3], r4 = m_r[4];
+    word32 s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    word32 h0 = m_h[0], h1 = m_h[1], h2 = m_h[2], h3 = m_h[3], h4 = m_h[4];
+
+    while (length >= 16) {
+        // h += m[i]
+        h0 += (poly1305Load32(input)      ) & 0x3ffffff;
+        h1 += (poly1305Load32(input +  3) >> 2) & 0x3ffffff;
+        h2 += (poly1305Load32(input +  6) >> 4) & 0x3ffffff;
+        h3 += (poly1305Load32(input +  9) >> 6) & 0x3ffffff;
+        h4 += (poly1305Load32(input + 12) >> 8) | hibit;
+
+        // h *= r
+        word64 d0 = (word64)h0 * r0 + (word64)h1 * s4 + (word64)h2 * s3 + (word64)h3 * s2 + (word64)h4 * s1;
+        word64 d1 = (word64)h0 * r1 + (word64)h1 * r0 + (word64)h2 * s4 + (word64)h3 * s3 + (word64)h4 * s2;
+        word64 d2 = (word64)h0 * r2 + (word64)h1 * r1 + (word64)h2 * r0 + (word64)h3 * s4 + (word64)h4 * s3;
+        word64 d3 = (word64)h0 * r3 + (word64)h1 * r2 + (word64)h2 * r1 + (word64)h3 * r0 + (word64)h4 * s4;
+        word64 d4 = (word64)h0 * r4 + (word64)h1 * r3 + (word64)h2 * r2 + (word64)h3 * r1 + (word64)h4 * r0;
+
+        // partial h %= p
+        word32 c;
+        c = (word32)(d0 >> 26); h0 = (word32)d0 & 0x3ffffff;
+        d1 += c; c = (word32)(d1 >> 26); h1 = (word32)d1 & 0x3ffffff;
+        d2 += c; c = (word32)(d2 >> 26); h2 = (word32)d2 & 0x3ffffff;
+        d3 += c; c = (word32)(d3 >> 26); h3 = (word32)d3 & 0x3ffffff;
+        d4 += c; c = (word32)(d4 >> 26); h4 = (word32)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        input  += 16;
+        length -= 16;
+    }
+
+    m_h[0] = h0;
+    m_h[1] = h1;
+    m_h[2] = h2;
+    m_h[3] = h3;
+    m_h[4] = h4;
+}
+
+void Poly1305::Update(const byte *input, size_t length) {
+    if (m_bufferedLength > 0) {
+        size_t count = 16 - m_bufferedLength;
+
+        if (count > length) {
+            count = length;
+        }
+
+        memcpy(m_buffer + m_bufferedLength, input, count);
+        m_bufferedLength += count;
+        input            += count;
+        length           -= count;
+
+        if (m_bufferedLength < 16) {
+            return;
+        }
+
+        ProcessBlocks(m_buffer, 16, false);
+        m_bufferedLength = 0;
+    }
+
+    if (length >= 16) {
+        size_t count = length & ~(size_t)15;
+        ProcessBlocks(input, count, false);
+        input  += count;
+        length -= count;
+    }
+
+    memcpy(m_buffer, input, length);
+    m_bufferedLength = length;
+}
+
+void Poly1305::Final(byte *mac) {
+    // last partial block is padded with a one then zeros
+    if (m_bufferedLength > 0) {
+        m_buffer[m_bufferedLength] = 1;
+        memset(m_buffer + m_bufferedLength + 1, 0, 16 - m_bufferedLength - 1);
+        ProcessBlocks(m_buffer, 16, true);
+    }
+
+    word32 h0 = m_h[0], h1 = m_h[1], h2 = m_h[2], h3 = m_h[3], h4 = m_h[4];
+    word32 c;
+
+    // fully carry h
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // g = h + -p
+    word32 g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    word32 g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    word32 g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    word32 g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    word32 g4 = h4 + c - (1 << 26);
+
+    // select h if h < p, or h + -p if h >= p, in constant time
+    word32 mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    // h = h % 2^128
+    h0 = (h0      ) | (h1 << 26);
+    h1 = (h1 >>  6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 <<  8);
+
+    // mac = (h + s) % 2^128
+    word64 f;
+    f = (word64)h0 + m_pad[0];             h0 = (word32)f;
+    f = (word64)h1 + m_pad[1] + (f >> 32); h1 = (word32)f;
+    f = (word64)h2 + m_pad[2] + (f >> 32); h2 = (word32)f;
+    f = (word64)h3 + m_pad[3] + (f >> 32); h3 = (word32)f;
+
+    poly1305Store32(mac,      h0);
+    poly1305Store32(mac +  4, h1);
+    poly1305Store32(mac +  8, h2);
+    poly1305Store32(mac + 12, h3);
+
+    // the key cannot be used again
+    memset(m_r, 0, sizeof(m_r));
+    memset(m_h, 0, sizeof(m_h));
+    memset(m_pad, 0, sizeof(m_pad));
+    memset(m_buffer, 0, sizeof(m_buffer));
+    m_bufferedLength = 0;
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
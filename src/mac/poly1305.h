@@ -0,0 +1,51 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_MAC_POLY1305_H
+#define PHP_MAC_POLY1305_H
+
+#include "src/php_cryptopp.h"
+
+/* {{{ Poly1305
+   one-time authenticator of RFC 8439, with 26 bits limbs. a key (r, s) must never be used for more than one message,
+   so it is not exposed as a MAC class: it is only used by constructions that derive a new key for each message */
+class Poly1305
+{
+public:
+    Poly1305();
+    ~Poly1305();
+
+    void SetKey(const byte *key);
+    void Update(const byte *input, size_t length);
+    void Final(byte *mac);
+
+    static const unsigned int KEYLENGTH     = 32;
+    static const unsigned int DIGESTSIZE    = 16;
+
+private:
+    void ProcessBlocks(const byte *input, size_t length, bool lastBlock);
+
+    CryptoPP::word32 m_r[5];
+    CryptoPP::word32 m_h[5];
+    CryptoPP::word32 m_pad[4];
+    byte m_buffer[16];
+    size_t m_bufferedLength;
+};
+/* }}} */
+
+#endif /* PHP_MAC_POLY1305_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -15,6 +15,7 @@
 #include "src/hash/php_hash.h"
 #include "src/mac/php_mac.h"
 #include "src/symmetric/cipher/authenticated/php_authenticated_symmetric_cipher.h"
+#include "src/symmetric/cipher/key_schedule_cache.h"
 #include "src/symmetric/cipher/block/php_block_cipher.h"
 #include "src/symmetric/cipher/stream/php_stream_cipher.h"
 #include "src/symmetric/mode/php_symmetric_mode.h"
@@ -35,6 +36,14 @@ static PHP_MINIT_FUNCTION(cryptopp) {
 }
 /* }}} */
 
+/* {{{ PHP_MSHUTDOWN_FUNCTION */
+static PHP_MSHUTDOWN_FUNCTION(cryptopp) {
+    KeyScheduleCache::Clear();
+
+    return SUCCESS;
+}
+/* }}} */
+
 /* {{{ PHP_MINFO_FUNCTION */
 static string getAlgoList(vector<string> algoList) {
     string strAlgoList;
@@ -81,7 +90,7 @@ zend_module_entry cryptopp_module_entry = {
     PHP_CRYPTOPP_EXTNAME,
     php_cryptopp_functions,
     PHP_MINIT(cryptopp),
-    NULL,
+    PHP_MSHUTDOWN(cryptopp),
     NULL,
     NULL,
     PHP_MINFO(cryptopp),
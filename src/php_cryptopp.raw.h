@@ -13,6 +13,10 @@
 #define PHP_CRYPTOPP_EXTNAME "crypto++"
 #define PHP_CRYPTOPP_VERSION "%ext_version%"
 
+/* {{{ features enabled by config.py */
+//%configure_defines%
+/* }}} */
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -0,0 +1,85 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_AUTHENTICATED_SYMMETRIC_CIPHER_MESSAGE_BATCH_H
+#define PHP_AUTHENTICATED_SYMMETRIC_CIPHER_MESSAGE_BATCH_H
+
+#include <cryptlib.h>
+#include <secblock.h>
+#include <misc.h>
+
+/* {{{ messages up to this size are interleaved with other ones. larger messages are processed one by one */
+#define AUTHENTICATED_SYMMETRIC_CIPHER_BATCH_MESSAGE_SIZE 4096
+/* }}} */
+
+/* {{{ maximum size of the blocks of several messages passed to the block cipher at once */
+#define AUTHENTICATED_SYMMETRIC_CIPHER_BATCH_SIZE 16384
+/* }}} */
+
+/* {{{ AuthenticatedSymmetricCipherMessage
+   a whole message, with its own nonce and additional authenticated data. on encryption, the tag is written to digest.
+   on decryption, digest is the tag to verify, valid tells if it matches, and the output of a message that is not authentic is wiped */
+struct AuthenticatedSymmetricCipherMessage {
+    const byte *nonce;
+    size_t nonceLength;
+    const byte *aad;
+    size_t aadLength;
+    const byte *input;
+    size_t length;
+    byte *output;
+    byte *digest;
+    bool valid;
+};
+/* }}} */
+
+/* {{{ AuthenticatedSymmetricCipherMessageBatch
+   implemented by native ciphers that process a list of whole messages in one call. the key is set before, the nonce of each
+   message is given with the message. if NeedsWholeMessages() is true, the cipher cannot be used for incremental processing */
+class AuthenticatedSymmetricCipherMessageBatch
+{
+public:
+    virtual ~AuthenticatedSymmetricCipherMessageBatch(){}
+    virtual bool NeedsWholeMessages() const =0;
+    virtual void ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count) =0;
+};
+/* }}} */
+
+/* {{{ processAuthenticatedSymmetricCipherMessage
+   processes a single message with the incremental interface of a keyed cipher */
+inline void processAuthenticatedSymmetricCipherMessage(CryptoPP::AuthenticatedSymmetricCipher &cipher, AuthenticatedSymmetricCipherMessage &message)
+{
+    CryptoPP::SecByteBlock digest(cipher.DigestSize());
+
+    cipher.Resynchronize(message.nonce, static_cast<int>(message.nonceLength));
+
+    if (message.aadLength > 0) {
+        cipher.Update(message.aad, message.aadLength);
+    }
+
+    cipher.ProcessData(message.output, message.input, message.length);
+    cipher.Final(cipher.IsForwardTransformation() ? message.digest : digest.BytePtr());
+
+    message.valid = cipher.IsForwardTransformation() || CryptoPP::VerifyBufsEqual(digest, message.digest, digest.size());
+
+    if (!message.valid) {
+        memset(message.output, 0, message.length);
+    }
+}
+/* }}} */
+
+#endif /* PHP_AUTHENTICATED_SYMMETRIC_CIPHER_MESSAGE_BATCH_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # siv is not provided by crypto++, it is built on aes and on the authenticated cipher interface
+    if not os.path.isfile(cryptoppDir + "/aes.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/cipher/authenticated/php_aes_siv.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/authenticated/php_aes_siv.h"]
+    config["phpMinitStatements"]        = ["init_class_AuthenticatedSymmetricCipherAesSiv(TSRMLS_C);"]
+
+    return config
@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # chacha20-poly1305 is implemented by the extension on top of the authenticated cipher base of crypto++
+    if not os.path.isfile(cryptoppDir + "/authenc.h") or not os.path.isfile(cryptoppDir + "/strciphr.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/cipher/authenticated/php_chacha20_poly1305.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/authenticated/php_chacha20_poly1305.h"]
+    config["phpMinitStatements"]        = ["init_class_AuthenticatedSymmetricCipherChaCha20Poly1305(TSRMLS_C);"]
+
+    return config
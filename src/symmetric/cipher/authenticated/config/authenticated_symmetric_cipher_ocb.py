@@ -0,0 +1,12 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # ocb is not provided by crypto++, it is built on the block cipher interface
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/cipher/authenticated/php_ocb.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/authenticated/php_ocb.h"]
+    config["phpMinitStatements"]        = ["init_class_AuthenticatedSymmetricCipherOcb(TSRMLS_C);"]
+
+    return config
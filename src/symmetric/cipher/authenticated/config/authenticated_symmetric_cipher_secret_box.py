@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # secretbox is built on xsalsa20
+    if not os.path.isfile(cryptoppDir + "/salsa.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/cipher/authenticated/php_secret_box.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/authenticated/php_secret_box.h"]
+    config["phpMinitStatements"]        = ["init_class_SecretBox(TSRMLS_C);"]
+
+    return config
@@ -0,0 +1,325 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "php_authenticated_symmetric_cipher_abstract.h"
+#include "php_aes_siv.h"
+#include <misc.h>
+#include <vector>
+
+/* {{{ number of messages whose CMAC chains, or counter blocks, are passed to the block cipher at once */
+#define AES_SIV_LANES 8
+/* }}} */
+
+/* {{{ sivDouble
+   multiplication by x in GF(2^128), as defined for CMAC and S2V */
+static void sivDouble(byte *block) {
+    byte carry = block[0] >> 7;
+
+    for (int i = 0; i < 15; i++) {
+        block[i] = (block[i] << 1) | (block[i + 1] >> 7);
+    }
+
+    block[15] = (block[15] << 1) ^ (0x87 & (0 - carry));
+}
+/* }}} */
+
+/* {{{ AesSivCtrLanes
+   counter blocks waiting to be encrypted, with the message position of each one */
+struct AesSivCtrLanes {
+    size_t items[AES_SIV_LANES];
+    size_t offsets[AES_SIV_LANES];
+    CryptoPP::FixedSizeSecBlock<byte, AES_SIV_LANES * 16> counters;
+    CryptoPP::FixedSizeSecBlock<byte, AES_SIV_LANES * 16> keystream;
+    size_t count;
+};
+/* }}} */
+
+/* {{{ flushCtrLanes
+   encrypts pending counters and xors the keystream with the corresponding message blocks */
+static void flushCtrLanes(AesSivCtrLanes &lanes, const CryptoPP::BlockCipher &cipher, byte *const *outputs, const byte *const *inputs, const size_t *lengths) {
+    if (0 == lanes.count) {
+        return;
+    }
+
+    cipher.AdvancedProcessBlocks(lanes.counters, NULL, lanes.keystream, 16 * lanes.count, CryptoPP::BlockTransformation::BT_AllowParallel);
+
+    for (size_t i = 0; i < lanes.count; i++) {
+        size_t item         = lanes.items[i];
+        size_t offset       = lanes.offsets[i];
+        size_t blockLength  = CryptoPP::STDMIN<size_t>(16, lengths[item] - offset);
+        CryptoPP::xorbuf(outputs[item] + offset, inputs[item] + offset, lanes.keystream + 16 * i, blockLength);
+    }
+
+    lanes.count = 0;
+}
+/* }}} */
+
+/* {{{ AES-SIV deterministic authenticated encryption of RFC 5297 */
+void AesSiv::Base::UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs &params)
+{
+    // first half of the key is used by S2V, second half by CTR
+    size_t halfLength = length / 2;
+    m_macCipher.SetKey(key, halfLength);
+    m_ctrCipher.SetKey(key + halfLength, halfLength);
+
+    // CMAC subkeys
+    memset(m_k1, 0, m_k1.size());
+    m_macCipher.ProcessBlock(m_k1);
+    sivDouble(m_k1);
+    memcpy(m_k2, m_k1, m_k2.size());
+    sivDouble(m_k2);
+
+    // first step of S2V does not depend on the data
+    byte zero[16] = {0};
+    Cmac(m_d0, zero, sizeof(zero));
+}
+
+void AesSiv::Base::Cmac(byte *mac, const byte *data, size_t length) const
+{
+    size_t blockCount = 0 == length ? 1 : (length + 15) / 16;
+    size_t lastLength = length - 16 * (blockCount - 1);
+    memset(mac, 0, 16);
+
+    for (size_t i = 0; i + 1 < blockCount; i++) {
+        CryptoPP::xorbuf(mac, data + 16 * i, 16);
+        m_macCipher.ProcessBlock(mac);
+    }
+
+    CryptoPP::xorbuf(mac, data + 16 * (blockCount - 1), lastLength);
+
+    if (16 == lastLength) {
+        CryptoPP::xorbuf(mac, m_k1, 16);
+    } else {
+        mac[lastLength] ^= 0x80;
+        CryptoPP::xorbuf(mac, m_k2, 16);
+    }
+
+    m_macCipher.ProcessBlock(mac);
+}
+
+void AesSiv::Base::AddHeaderComponent(byte *d, const byte *component, size_t length) const
+{
+    // D = dbl(D) xor CMAC(Si)
+    byte mac[16];
+    Cmac(mac, component, length);
+    sivDouble(d);
+    CryptoPP::xorbuf(d, mac, 16);
+}
+
+void AesSiv::Base::SynthesizeIvs(byte *const *sivs, const byte *const *data, const size_t *lengths, const byte *headerDigests, size_t count) const
+{
+    // each lane holds the CBC state of a message. when a message is done, its lane is given to the next one
+    CryptoPP::FixedSizeSecBlock<byte, AES_SIV_LANES * 16> states;
+    CryptoPP::FixedSizeSecBlock<byte, 16> dDouble;
+    size_t laneItems[AES_SIV_LANES];
+    size_t laneBlocks[AES_SIV_LANES];
+    size_t laneCount    = 0;
+    size_t next         = 0;
+
+    while (laneCount > 0 || next < count) {
+        while (laneCount < AES_SIV_LANES && next < count) {
+            laneItems[laneCount]    = next++;
+            laneBlocks[laneCount]   = 0;
+            memset(states + 16 * laneCount, 0, 16);
+            laneCount++;
+        }
+
+        for (size_t lane = 0; lane < laneCount; lane++) {
+            byte *state         = states + 16 * lane;
+            const byte *input   = data[laneItems[lane]];
+            const byte *d       = headerDigests + 16 * laneItems[lane];
+            size_t length       = lengths[laneItems[lane]];
+            size_t offset       = 16 * laneBlocks[lane];
+
+            if (length < 16) {
+                // T = dbl(D) xor pad(Sn), a single complete block
+                memcpy(dDouble, d, 16);
+                sivDouble(dDouble);
+                CryptoPP::xorbuf(state, input, length);
+                state[length] ^= 0x80;
+                CryptoPP::xorbuf(state, dDouble, 16);
+                CryptoPP::xorbuf(state, m_k1, 16);
+            } else if (offset + 32 <= length) {
+                // neither the last block nor a block touched by D
+                CryptoPP::xorbuf(state, input + offset, 16);
+            } else {
+                // T = Sn xorend D
+                size_t blockLength = CryptoPP::STDMIN<size_t>(16, length - offset);
+                CryptoPP::xorbuf(state, input + offset, blockLength);
+
+                for (size_t i = CryptoPP::STDMAX<size_t>(offset, length - 16); i < offset + blockLength; i++) {
+                    state[i - offset] ^= d[i - length + 16];
+                }
+
+                if (offset + 16 == length) {
+                    CryptoPP::xorbuf(state, m_k1, 16);
+                } else if (offset + 16 > length) {
+                    state[blockLength] ^= 0x80;
+                    CryptoPP::xorbuf(state, m_k2, 16);
+                }
+            }
+        }
+
+        m_macCipher.AdvancedProcessBlocks(states, NULL, states, 16 * laneCount, CryptoPP::BlockTransformation::BT_AllowParallel);
+
+        for (size_t lane = 0; lane < laneCount;) {
+            size_t item = laneItems[lane];
+
+            if (16 * ++laneBlocks[lane] < lengths[item]) {
+                lane++;
+                continue;
+            }
+
+            // the message is done: its last lane takes its place
+            memcpy(sivs[item], states + 16 * lane, 16);
+            laneCount--;
+
+            if (lane != laneCount) {
+                laneItems[lane]     = laneItems[laneCount];
+                laneBlocks[lane]    = laneBlocks[laneCount];
+                memcpy(states + 16 * lane, states + 16 * laneCount, 16);
+            }
+        }
+    }
+}
+
+void AesSiv::Base::ProcessCtr(byte *const *outputs, const byte *const *inputs, const size_t *lengths, const byte *const *sivs, size_t count) const
+{
+    // counter blocks of consecutive messages are encrypted together
+    AesSivCtrLanes lanes;
+    lanes.count = 0;
+    CryptoPP::FixedSizeSecBlock<byte, 16> counter;
+
+    for (size_t item = 0; item < count; item++) {
+        // Q = V with the 31th and 63th bits cleared
+        memcpy(counter, sivs[item], 16);
+        counter[8]  &= 0x7f;
+        counter[12] &= 0x7f;
+
+        for (size_t offset = 0; offset < lengths[item]; offset += 16) {
+            lanes.items[lanes.count]    = item;
+            lanes.offsets[lanes.count]  = offset;
+            memcpy(lanes.counters + 16 * lanes.count, counter, 16);
+            CryptoPP::IncrementCounterByOne(counter, 16);
+
+            if (AES_SIV_LANES == ++lanes.count) {
+                flushCtrLanes(lanes, m_ctrCipher, outputs, inputs, lengths);
+            }
+        }
+    }
+
+    flushCtrLanes(lanes, m_ctrCipher, outputs, inputs, lengths);
+}
+
+void AesSiv::Base::ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count)
+{
+    CryptoPP::SecByteBlock headerDigests(16 * count);
+    CryptoPP::SecByteBlock computedSivs(16 * count);
+    CryptoPP::FixedSizeSecBlock<byte, 16> aadDigest;
+    std::vector<byte*> sivs(count);
+    std::vector<const byte*> ctrSivs(count);
+    std::vector<byte*> outputs(count);
+    std::vector<const byte*> inputs(count);
+    std::vector<size_t> lengths(count);
+    bool encryption = IsForwardTransformation();
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message = messages[i];
+
+        // the aad is often the same for all messages of a batch
+        bool sameAad = i > 0 && message.aadLength == messages[i - 1].aadLength &&
+            (0 == message.aadLength || message.aad == messages[i - 1].aad || 0 == memcmp(message.aad, messages[i - 1].aad, message.aadLength));
+
+        if (!sameAad) {
+            memcpy(aadDigest, m_d0, 16);
+
+            if (message.aadLength > 0) {
+                AddHeaderComponent(aadDigest, message.aad, message.aadLength);
+            }
+        }
+
+        byte *d = headerDigests + 16 * i;
+        memcpy(d, aadDigest, 16);
+
+        if (message.nonceLength > 0) {
+            AddHeaderComponent(d, message.nonce, message.nonceLength);
+        }
+
+        // on decryption, the tag is the synthetic iv used by CTR. the synthetic iv of the plaintext is computed afterward
+        sivs[i]     = encryption ? message.digest : computedSivs + 16 * i;
+        ctrSivs[i]  = message.digest;
+        outputs[i]  = message.output;
+        inputs[i]   = message.input;
+        lengths[i]  = message.length;
+    }
+
+    if (encryption) {
+        SynthesizeIvs(&sivs[0], &inputs[0], &lengths[0], headerDigests, count);
+        ProcessCtr(&outputs[0], &inputs[0], &lengths[0], &ctrSivs[0], count);
+
+        for (size_t i = 0; i < count; i++) {
+            messages[i].valid = true;
+        }
+
+        return;
+    }
+
+    std::vector<const byte*> plaintexts(outputs.begin(), outputs.end());
+    ProcessCtr(&outputs[0], &inputs[0], &lengths[0], &ctrSivs[0], count);
+    SynthesizeIvs(&sivs[0], &plaintexts[0], &lengths[0], headerDigests, count);
+
+    for (size_t i = 0; i < count; i++) {
+        messages[i].valid = CryptoPP::VerifyBufsEqual(sivs[i], messages[i].digest, 16);
+
+        if (!messages[i].valid) {
+            memset(outputs[i], 0, lengths[i]);
+        }
+    }
+}
+/* }}} */
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherAesSiv_construct, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_AuthenticatedSymmetricCipherAesSiv;
+
+static zend_function_entry cryptopp_methods_AuthenticatedSymmetricCipherAesSiv[] = {
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAesSiv, __construct, arginfo_AuthenticatedSymmetricCipherAesSiv_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_FE_END
+};
+
+void init_class_AuthenticatedSymmetricCipherAesSiv(TSRMLS_D) {
+    init_class_AuthenticatedSymmetricCipherAbstractChild("aes-siv", "AuthenticatedSymmetricCipherAesSiv", &cryptopp_ce_AuthenticatedSymmetricCipherAesSiv, cryptopp_methods_AuthenticatedSymmetricCipherAesSiv TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto AuthenticatedSymmetricCipherAesSiv::__construct(void) */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAesSiv, __construct) {
+    // the key is made of two AES keys, it is held by the current object instead of an underlying cipher object
+    AesSiv::Encryption *encryptor = new AesSiv::Encryption();
+    AesSiv::Decryption *decryptor = new AesSiv::Decryption();
+    setCryptoppAuthenticatedSymmetricCipherEncryptorPtr(getThis(), encryptor TSRMLS_CC);
+    setCryptoppAuthenticatedSymmetricCipherDecryptorPtr(getThis(), decryptor TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "name", 4, "aes-siv", 7 TSRMLS_CC);
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
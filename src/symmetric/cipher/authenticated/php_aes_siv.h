@@ -0,0 +1,106 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_AUTHENTICATED_SYMMETRIC_CIPHER_AES_SIV_H
+#define PHP_AUTHENTICATED_SYMMETRIC_CIPHER_AES_SIV_H
+
+#include "src/php_cryptopp.h"
+#include "authenticated_symmetric_cipher_message_batch.h"
+#include <aes.h>
+#include <secblock.h>
+#include <climits>
+
+void init_class_AuthenticatedSymmetricCipherAesSiv(TSRMLS_D);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAesSiv, __construct);
+
+/* {{{ AES-SIV deterministic authenticated encryption of RFC 5297.
+   the synthetic iv is the S2V of the aad, the nonce and the plaintext, it is used as the tag. as it depends on the whole plaintext,
+   messages can only be processed whole, through ProcessMessages(). an empty aad or nonce is not given to S2V, so that a message
+   sealed with an empty nonce is encrypted deterministically.
+   the CMAC chains of AES_SIV_LANES messages are walked together so that each block cipher call processes several independent
+   blocks, and the CMAC of an aad shared by consecutive messages is only computed once */
+class AesSiv
+{
+public:
+    /* {{{ base class */
+    class Base : public CryptoPP::AuthenticatedSymmetricCipher, public AuthenticatedSymmetricCipherMessageBatch
+    {
+    public:
+        static std::string StaticAlgorithmName() {return std::string("AES/SIV");}
+        std::string AlgorithmName() const {return StaticAlgorithmName();}
+        size_t MinKeyLength() const {return 32;}
+        size_t MaxKeyLength() const {return 64;}
+        size_t DefaultKeyLength() const {return 32;}
+        size_t GetValidKeyLength(size_t n) const {return n < 48 ? 32 : (n < 64 ? 48 : 64);}
+        IV_Requirement IVRequirement() const {return UNIQUE_IV;}
+        unsigned int IVSize() const {return 16;}
+        unsigned int MinIVLength() const {return 0;}
+        unsigned int MaxIVLength() const {return INT_MAX;}
+        unsigned int DigestSize() const {return 16;}
+        CryptoPP::lword MaxHeaderLength() const {return CryptoPP::LWORD_MAX;}
+        CryptoPP::lword MaxMessageLength() const {return CryptoPP::LWORD_MAX;}
+        bool IsRandomAccess() const {return false;}
+        bool IsSelfInverting() const {return false;}
+
+        // the nonce is given with each message
+        void Resynchronize(const byte *iv, int ivLength = -1) {}
+        void Restart() {}
+
+        // messages can not be processed piece by piece
+        bool NeedsWholeMessages() const {return true;}
+        void Update(const byte *input, size_t length) {throw CryptoPP::NotImplemented("AES/SIV: messages can only be processed whole");}
+        void ProcessData(byte *outString, const byte *inString, size_t length) {throw CryptoPP::NotImplemented("AES/SIV: messages can only be processed whole");}
+        void TruncatedFinal(byte *mac, size_t macSize) {throw CryptoPP::NotImplemented("AES/SIV: messages can only be processed whole");}
+        void ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count);
+
+    protected:
+        void UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs &params);
+
+    private:
+        void Cmac(byte *mac, const byte *data, size_t length) const;
+        void AddHeaderComponent(byte *d, const byte *component, size_t length) const;
+        void SynthesizeIvs(byte *const *sivs, const byte *const *data, const size_t *lengths, const byte *headerDigests, size_t count) const;
+        void ProcessCtr(byte *const *outputs, const byte *const *inputs, const size_t *lengths, const byte *const *sivs, size_t count) const;
+
+        CryptoPP::AES::Encryption m_macCipher;
+        CryptoPP::AES::Encryption m_ctrCipher;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_k1;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_k2;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_d0;
+    };
+    /* }}} */
+
+    /* {{{ encryption class */
+    class Encryption : public Base
+    {
+    public:
+        bool IsForwardTransformation() const {return true;}
+    };
+    /* }}} */
+
+    /* {{{ decryption class */
+    class Decryption : public Base
+    {
+    public:
+        bool IsForwardTransformation() const {return false;}
+    };
+    /* }}} */
+};
+/* }}} */
+
+#endif /* PHP_AUTHENTICATED_SYMMETRIC_CIPHER_AES_SIV_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -9,6 +9,7 @@
 
 #include "src/php_cryptopp.h"
 #include "src/exception/php_exception.h"
+#include "src/exception/php_mac_verification_failed_exception.h"
 #include "src/utils/zend_object_utils.h"
 #include "src/utils/zval_utils.h"
 #include "src/symmetric/cipher/block/block_cipher_proxy.h"
@@ -23,7 +24,9 @@
 #include "php_authenticated_symmetric_cipher_generic.h"
 #include "authenticated_symmetric_cipher_prespecified_lengths.h"
 #include <zend_exceptions.h>
+#include <misc.h>
 #include <string>
+#include <vector>
 
 /* {{{ AuthenticatedSymmetricCipherAbstract_free_storage
    custom object free handler */
@@ -59,6 +62,10 @@ static zend_function_entry cryptopp_methods_AuthenticatedSymmetricCipherAbstract
     PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeEncryption, arginfo_AuthenticatedSymmetricCipherInterface_finalizeEncryption, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeDecryption, arginfo_AuthenticatedSymmetricCipherInterface_finalizeDecryption, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, restart, arginfo_SymmetricTransformationInterface_restart, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, seal, arginfo_AuthenticatedSymmetricCipherAbstract_seal, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, open, arginfo_AuthenticatedSymmetricCipherAbstract_open, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, sealBatch, arginfo_AuthenticatedSymmetricCipherAbstract_sealBatch, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherAbstract, openBatch, arginfo_AuthenticatedSymmetricCipherAbstract_openBatch, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
@@ -76,10 +83,8 @@ void init_class_AuthenticatedSymmetricCipherAbstract(TSRMLS_D) {
 
     zend_declare_property_null(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "cipher", 6, ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_string(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "name", 4, "",  ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_string(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "key", 3, "",  ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_string(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "iv", 2, "",  ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "ivSetted", 8, 0, ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "encryptionStarted", 17, 0, ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, "decryptionStarted", 17, 0, ZEND_ACC_PRIVATE TSRMLS_CC);
 }
 /* }}} */
 
@@ -152,9 +157,11 @@ bool cryptoppAuthenticatedSymmetricCipherGetCipherElements(
     cipherMustBeDestructed = false;
 
     if (instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_BlockCipherAbstract TSRMLS_CC)) {
-        // retrieve native objects
-        *cipherEncryptor = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(cipherObject TSRMLS_CC))->encryptor;
-        *cipherDecryptor = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(cipherObject TSRMLS_CC))->decryptor;
+        // retrieve native objects. the key length of a native cipher is then read without calling php code
+        BlockCipherAbstractContainer *cipherContainer = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(cipherObject TSRMLS_CC));
+        *cipherEncryptor = cipherContainer->encryptor;
+        *cipherDecryptor = cipherContainer->decryptor;
+        static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(authenticatedCipherObject TSRMLS_CC))->nativeCipher = cipherContainer;
     } else if (instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_BlockCipherInterface TSRMLS_CC)) {
         // create a proxy to the user php object
         *cipherEncryptor        = new BlockCipherProxy::Encryption(cipherObject TSRMLS_CC);
@@ -192,9 +199,16 @@ bool cryptoppAuthenticatedSymmetricCipherGetCipherElements(
 /* }}} */
 
 /* {{{ getCipherKey
-   returns the cipher key */
+   returns the cipher key. ciphers that are not built on an underlying cipher object hold their key themselves */
 static inline zval *getCipherKey(zval *object TSRMLS_DC) {
-    zval *cipher            = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "cipher", 6, 1 TSRMLS_CC);
+    zval *cipher = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "cipher", 6, 1 TSRMLS_CC);
+
+    if (IS_OBJECT != Z_TYPE_P(cipher)) {
+        zval *key = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "key", 3, 1 TSRMLS_CC);
+        Z_ADDREF_P(key);
+        return key;
+    }
+
     zval *funcname          = makeZval("getKey");
     zval *key               = call_user_method(cipher, funcname TSRMLS_CC);
     zval_ptr_dtor(&funcname);
@@ -205,11 +219,10 @@ static inline zval *getCipherKey(zval *object TSRMLS_DC) {
 /* {{{ getCipherIv
    returns the cipher iv */
 static inline zval *getCipherIv(zval *object TSRMLS_DC) {
-    zval *cipher            = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "cipher", 6, 1 TSRMLS_CC);
-    zend_class_entry *ce    = zend_get_class_entry(cipher TSRMLS_CC);
+    zval *cipher = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "cipher", 6, 1 TSRMLS_CC);
     zval *iv;
 
-    if (instanceof_function(ce, cryptopp_ce_SymmetricTransformationInterface TSRMLS_CC)) {
+    if (IS_OBJECT == Z_TYPE_P(cipher) && instanceof_function(Z_OBJCE_P(cipher), cryptopp_ce_SymmetricTransformationInterface TSRMLS_CC)) {
         // retrieve from the underlying cipher
         zval *funcname  = makeZval("getIv");
         iv              = call_user_method(cipher, funcname TSRMLS_CC);
@@ -226,10 +239,9 @@ static inline zval *getCipherIv(zval *object TSRMLS_DC) {
 /* {{{ ivDtor
    destruct an IV zval if it was retrieved from an underlying cipher object */
 static inline void ivDtor(zval *object, zval *iv TSRMLS_DC) {
-    zval *cipher            = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "cipher", 6, 1 TSRMLS_CC);
-    zend_class_entry *ce    = zend_get_class_entry(cipher TSRMLS_CC);
+    zval *cipher = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "cipher", 6, 1 TSRMLS_CC);
 
-    if (instanceof_function(ce, cryptopp_ce_SymmetricTransformationInterface TSRMLS_CC)) {
+    if (IS_OBJECT == Z_TYPE_P(cipher) && instanceof_function(Z_OBJCE_P(cipher), cryptopp_ce_SymmetricTransformationInterface TSRMLS_CC)) {
         zval_ptr_dtor(&iv);
     }
 }
@@ -238,9 +250,16 @@ static inline void ivDtor(zval *object, zval *iv TSRMLS_DC) {
 /* {{{ isCryptoppAuthenticatedSymmetricCipherKeyValid
    verify that a key size is valid for an AuthenticatedSymmetricCipherAbstract instance */
 bool isCryptoppAuthenticatedSymmetricCipherKeyValid(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC) {
-    zval *key   = getCipherKey(object TSRMLS_CC);
-    int keySize = IS_STRING == Z_TYPE_P(key) ? Z_STRLEN_P(key) : 0;
-    zval_ptr_dtor(&key);
+    AuthenticatedSymmetricCipherAbstractContainer *container    = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    int keySize                                                 = 0;
+
+    if (NULL != container->nativeCipher) {
+        keySize = container->nativeCipher->keyLength;
+    } else {
+        zval *key   = getCipherKey(object TSRMLS_CC);
+        keySize     = IS_STRING == Z_TYPE_P(key) ? Z_STRLEN_P(key) : 0;
+        zval_ptr_dtor(&key);
+    }
 
     return isCryptoppSymmetricKeyValid(object, cipher, keySize TSRMLS_CC) && isCryptoppAuthenticatedSymmetricCipherGenericMacKeyValid(object, cipher TSRMLS_CC);
 }
@@ -249,48 +268,251 @@ bool isCryptoppAuthenticatedSymmetricCipherKeyValid(zval *object, CryptoPP::Auth
 /* {{{ isCryptoppAuthenticatedSymmetricCipherIvValid
    verify that an iv size is valid for an AuthenticatedSymmetricCipherAbstract instance */
 bool isCryptoppAuthenticatedSymmetricCipherIvValid(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC) {
-    zval *iv                = getCipherIv(object TSRMLS_CC);
-    int ivSize              = IS_STRING == Z_TYPE_P(iv) ? Z_STRLEN_P(iv) : 0;
-    ivDtor(object, iv TSRMLS_CC);
+    AuthenticatedSymmetricCipherAbstractContainer *container    = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    int ivSize                                                  = 0;
+
+    if (NULL != container->nativeCipher) {
+        // the iv is held by the current object
+        ivSize = container->ivLength;
+    } else {
+        zval *iv    = getCipherIv(object TSRMLS_CC);
+        ivSize      = IS_STRING == Z_TYPE_P(iv) ? Z_STRLEN_P(iv) : 0;
+        ivDtor(object, iv TSRMLS_CC);
+    }
 
     return isCryptoppSymmetricIvValid(object, cipher, ivSize TSRMLS_CC);
 }
 /* }}} */
 
 /* {{{ setKeyWithIv
-   sets the key and the iv (if applicable) of the native cipher objects of a cipher php object */
-static void setKeyWithIv(zval *object, CryptoPP::AuthenticatedSymmetricCipher *encryptor, CryptoPP::AuthenticatedSymmetricCipher *decryptor TSRMLS_DC) {
+   sets the key and the iv (if applicable) of the native cipher objects of a cipher php object.
+   returns false if the key or the iv is not set yet */
+static bool setKeyWithIv(zval *object, CryptoPP::AuthenticatedSymmetricCipher *encryptor, CryptoPP::AuthenticatedSymmetricCipher *decryptor TSRMLS_DC) {
     zval *zKey              = getCipherKey(object TSRMLS_CC);
     zval *zIv               = getCipherIv(object TSRMLS_CC);
     bool ivSetted           = setSymmetricCipherKeyIv(object, encryptor, decryptor, zKey, zIv TSRMLS_CC);
     zval_ptr_dtor(&zKey);
     ivDtor(object, zIv TSRMLS_CC);
 
-    if (ivSetted) {
-        zend_update_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "ivSetted", 8, 1 TSRMLS_CC);
-    }
+    return ivSetted;
 }
 /* }}} */
 
 /* {{{ restart
-   resets the mac and the iv of the cipher to their initial state */
-static inline void restart(zval *object, CryptoPP::AuthenticatedSymmetricCipher *encryptor, CryptoPP::AuthenticatedSymmetricCipher *decryptor TSRMLS_DC) {
-    setKeyWithIv(object, encryptor, decryptor TSRMLS_CC);
+   resets the mac and the iv of the cipher to their initial state. native objects are resynchronized on their next use */
+static inline void restart(zval *object TSRMLS_DC) {
+    AuthenticatedSymmetricCipherAbstractContainer *container    = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    container->encryptorIvSynchronized                          = false;
+    container->decryptorIvSynchronized                          = false;
+}
+/* }}} */
+
+/* {{{ invalidateNativeKeys
+   indicates that native objects must be keyed again with the current key and iv before their next use */
+static inline void invalidateNativeKeys(zval *object TSRMLS_DC) {
+    AuthenticatedSymmetricCipherAbstractContainer *container    = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    container->encryptorKeyed                                   = false;
+    container->decryptorKeyed                                   = false;
+    restart(object TSRMLS_CC);
 }
 /* }}} */
 
-/* {{{ ensureIvIsSet
-   ensure the iv is set.
-   If cipher's setKey() is called after setIv(), the internal iv of the native cryptopp object may not be set. */
-static inline void ensureIvIsSet(zval *object, CryptoPP::AuthenticatedSymmetricCipher *encryptor, CryptoPP::AuthenticatedSymmetricCipher *decryptor TSRMLS_DC) {
-    zval *ivSetted = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "ivSetted", 8, 1 TSRMLS_CC);
+/* {{{ keyWithIv
+   keys a native direction, or only loads the iv into it when its key dependent state (key schedule, hash tables) is still valid.
+   that state is only known to be valid for native block ciphers, whose key changes are tracked by their key generation */
+static bool keyWithIv(
+    zval *object,
+    CryptoPP::AuthenticatedSymmetricCipher *cipher,
+    bool encryption,
+    bool keyed,
+    unsigned int &keyGeneration
+    TSRMLS_DC
+) {
+    AuthenticatedSymmetricCipherAbstractContainer *container = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
 
-    if (!Z_BVAL_P(ivSetted)) {
-        setKeyWithIv(object, encryptor, decryptor TSRMLS_CC);
+    if (!keyed || NULL == container->nativeCipher || keyGeneration != container->nativeCipher->keyGeneration) {
+        if (NULL != container->nativeCipher) {
+            keyGeneration = container->nativeCipher->keyGeneration;
+        }
+
+        return setKeyWithIv(object, encryption ? cipher : NULL, encryption ? NULL : cipher TSRMLS_CC);
+    }
+
+    // the iv of a native block cipher based object is held by the current object
+    zval *zIv = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, object, "iv", 2, 1 TSRMLS_CC);
+    cipher->Resynchronize(reinterpret_cast<byte*>(Z_STRVAL_P(zIv)), Z_STRLEN_P(zIv));
+
+    return true;
+}
+/* }}} */
+
+/* {{{ ensureCryptoppAuthenticatedSymmetricCipherKeyed
+   keys the native encryptor or decryptor of an AuthenticatedSymmetricCipherAbstract instance if the key or the iv changed
+   since its last use. each direction is keyed on its first use, so that encrypting never computes the tables of the decryptor.
+   after a restart or a new iv, the direction is only resynchronized if its key did not change */
+void ensureCryptoppAuthenticatedSymmetricCipherKeyed(zval *object, bool encryption TSRMLS_DC) {
+    AuthenticatedSymmetricCipherAbstractContainer *container = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+
+    if (encryption && !container->encryptorIvSynchronized) {
+        container->encryptorKeyed           = keyWithIv(object, container->encryptor, true, container->encryptorKeyed, container->encryptorKeyGeneration TSRMLS_CC);
+        container->encryptorIvSynchronized  = container->encryptorKeyed;
+    } else if (!encryption && !container->decryptorIvSynchronized) {
+        container->decryptorKeyed           = keyWithIv(object, container->decryptor, false, container->decryptorKeyed, container->decryptorKeyGeneration TSRMLS_CC);
+        container->decryptorIvSynchronized  = container->decryptorKeyed;
     }
 }
 /* }}} */
 
+/* {{{ keyWithNonce
+   keys a native direction with an explicit nonce instead of the current iv. as with restart(), the direction is only
+   resynchronized if its key did not change. the current iv is loaded again on the next streaming call */
+static void keyWithNonce(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher, bool encryption, const byte *nonce, int nonceSize TSRMLS_DC) {
+    AuthenticatedSymmetricCipherAbstractContainer *container    = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    bool *keyed                                                 = encryption ? &container->encryptorKeyed : &container->decryptorKeyed;
+    unsigned int *keyGeneration                                 = encryption ? &container->encryptorKeyGeneration : &container->decryptorKeyGeneration;
+
+    if (!*keyed || NULL == container->nativeCipher || *keyGeneration != container->nativeCipher->keyGeneration) {
+        zval *zKey = getCipherKey(object TSRMLS_CC);
+        cipher->SetKeyWithIV(reinterpret_cast<byte*>(Z_STRVAL_P(zKey)), Z_STRLEN_P(zKey), nonce, nonceSize);
+        zval_ptr_dtor(&zKey);
+
+        if (NULL != container->nativeCipher) {
+            *keyGeneration = container->nativeCipher->keyGeneration;
+        }
+
+        *keyed = true;
+    } else {
+        cipher->Resynchronize(nonce, nonceSize);
+    }
+
+    // a message processed with the current iv is discarded
+    if (encryption) {
+        container->encryptorIvSynchronized  = false;
+        container->encryptionStarted        = false;
+    } else {
+        container->decryptorIvSynchronized  = false;
+        container->decryptionStarted        = false;
+    }
+}
+/* }}} */
+
+/* {{{ isCryptoppAuthenticatedSymmetricCipherStreamable
+   indicates if a native cipher can process messages piece by piece. throws an exception if it cannot */
+bool isCryptoppAuthenticatedSymmetricCipherStreamable(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC) {
+    AuthenticatedSymmetricCipherMessageBatch *batch = dynamic_cast<AuthenticatedSymmetricCipherMessageBatch*>(cipher);
+
+    if (NULL != batch && batch->NeedsWholeMessages()) {
+        zend_class_entry *ce = zend_get_class_entry(object TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: messages can only be processed whole, use seal() and open()", ce->name);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ throwCryptoppAuthenticatedSymmetricCipherMessagesException
+   reports a crypto++ exception thrown by a native cipher while processing messages (invalid nonce length, length limit...).
+   the native object of that direction is left in an unknown state, so it is keyed again on its next use */
+static void throwCryptoppAuthenticatedSymmetricCipherMessagesException(zval *object, bool encryption, const CryptoPP::Exception &e TSRMLS_DC) {
+    AuthenticatedSymmetricCipherAbstractContainer *container = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+
+    if (encryption) {
+        container->encryptorKeyed           = false;
+        container->encryptorIvSynchronized  = false;
+        container->encryptionStarted        = false;
+    } else {
+        container->decryptorKeyed           = false;
+        container->decryptorIvSynchronized  = false;
+        container->decryptionStarted        = false;
+    }
+
+    zend_class_entry *ce = zend_get_class_entry(object TSRMLS_CC);
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : %s", ce->name, e.what());
+}
+/* }}} */
+
+/* {{{ processCryptoppAuthenticatedSymmetricCipherMessages
+   authenticates aad, then encrypts or decrypts whole messages, each one with its own nonce instead of the current iv.
+   on decryption, tags are verified in constant time and the plaintext of a message that is not authentic is wiped.
+   returns false if a user class threw an exception, or if a native cipher threw a crypto++ exception, which is then
+   reported as a php exception */
+bool processCryptoppAuthenticatedSymmetricCipherMessages(
+    zval *object,
+    CryptoPP::AuthenticatedSymmetricCipher *cipher,
+    bool encryption,
+    AuthenticatedSymmetricCipherMessage *messages,
+    size_t count
+    TSRMLS_DC
+) {
+    if (0 == count) {
+        return true;
+    }
+
+    AuthenticatedSymmetricCipherMessageBatch *batch = dynamic_cast<AuthenticatedSymmetricCipherMessageBatch*>(cipher);
+
+    if (NULL != batch) {
+        // the key is set with the nonce of the first message, then each message is processed with its own nonce
+        try {
+            keyWithNonce(object, cipher, encryption, messages[0].nonce, static_cast<int>(messages[0].nonceLength) TSRMLS_CC);
+            batch->ProcessMessages(messages, count);
+        } catch (bool e) {
+            return false;
+        } catch (CryptoPP::Exception &e) {
+            throwCryptoppAuthenticatedSymmetricCipherMessagesException(object, encryption, e TSRMLS_CC);
+            return false;
+        }
+
+        return true;
+    }
+
+    CryptoPP::SecByteBlock digest(cipher->DigestSize());
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message    = messages[i];
+        byte *tag                                       = encryption ? message.digest : digest.BytePtr();
+
+        try {
+            keyWithNonce(object, cipher, encryption, message.nonce, static_cast<int>(message.nonceLength) TSRMLS_CC);
+
+            if (cipher->NeedsPrespecifiedDataLengths()) {
+                // lengths are known, no need to call specifyDataSize()
+                cipher->SpecifyDataLengths(message.aadLength, message.length);
+                AuthenticatedSymmetricCipherPrespecifiedLengths *prespecified = dynamic_cast<AuthenticatedSymmetricCipherPrespecifiedLengths*>(cipher);
+
+                if (message.aadLength > 0) {
+                    prespecified->Update(message.aad, message.aadLength);
+                }
+
+                prespecified->ProcessData(message.output, message.input, message.length);
+                prespecified->Final(tag);
+            } else {
+                if (message.aadLength > 0) {
+                    cipher->Update(message.aad, message.aadLength);
+                }
+
+                cipher->ProcessData(message.output, message.input, message.length);
+                cipher->Final(tag);
+            }
+        } catch (bool e) {
+            return false;
+        } catch (CryptoPP::Exception &e) {
+            throwCryptoppAuthenticatedSymmetricCipherMessagesException(object, encryption, e TSRMLS_CC);
+            return false;
+        }
+
+        // the plaintext is not returned if the tag does not match
+        message.valid = encryption || CryptoPP::VerifyBufsEqual(digest, message.digest, digest.size());
+
+        if (!message.valid) {
+            memset(message.output, 0, message.length);
+        }
+    }
+
+    return true;
+}
+/* }}} */
+
 /* {{{ proto void AuthenticatedSymmetricCipherAbstract::__sleep(void)
    Prevents serialization of an AuthenticatedSymmetricCipherAbstract instance */
 PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, __sleep) {
@@ -395,16 +617,21 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, setKey) {
         RETURN_FALSE;
     }
 
-    // set the key on both the php object and the native cryptopp object
-    zval *funcname  = makeZval("setKey");
-    zval *zKey      = makeZval(key, keySize);
-    zval *cipher    = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, 1 TSRMLS_CC);
-    zval *output    = call_user_method(cipher, funcname, zKey TSRMLS_CC);
-    zval_ptr_dtor(&funcname);
-    zval_ptr_dtor(&zKey);
-    zval_ptr_dtor(&output);
+    // set the key on the php object. native objects will be keyed on their next use
+    zval *cipher = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, 1 TSRMLS_CC);
 
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    if (IS_OBJECT == Z_TYPE_P(cipher)) {
+        zval *funcname  = makeZval("setKey");
+        zval *zKey      = makeZval(key, keySize);
+        zval *output    = call_user_method(cipher, funcname, zKey TSRMLS_CC);
+        zval_ptr_dtor(&funcname);
+        zval_ptr_dtor(&zKey);
+        zval_ptr_dtor(&output);
+    } else {
+        zend_update_property_stringl(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "key", 3, key, keySize TSRMLS_CC);
+    }
+
+    invalidateNativeKeys(getThis() TSRMLS_CC);
 }
 /* }}} */
 
@@ -428,15 +655,13 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, setIv) {
         RETURN_FALSE;
     }
 
-    // set the iv on both the php object and the native cryptopp object
-    zval *cipher            = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, 1 TSRMLS_CC);
-    zend_class_entry *ce    = zend_get_class_entry(cipher TSRMLS_CC);
+    // set the iv on the php object. native objects will be resynchronized on their next use
+    zval *cipher = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, 1 TSRMLS_CC);
 
-    if (instanceof_function(ce, cryptopp_ce_SymmetricTransformationInterface TSRMLS_CC)) {
+    if (IS_OBJECT == Z_TYPE_P(cipher) && instanceof_function(Z_OBJCE_P(cipher), cryptopp_ce_SymmetricTransformationInterface TSRMLS_CC)) {
         // set the iv on the underlying cipher
         zval *funcname  = makeZval("setIv");
         zval *zIv       = makeZval(iv, ivSize);
-        zval *cipher    = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, 1 TSRMLS_CC);
         zval *output    = call_user_method(cipher, funcname, zIv TSRMLS_CC);
         zval_ptr_dtor(&funcname);
         zval_ptr_dtor(&zIv);
@@ -444,9 +669,10 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, setIv) {
     } else {
         // set the iv on the current object
         zend_update_property_stringl(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "iv", 2, iv, ivSize TSRMLS_CC);
+        static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->ivLength = ivSize;
     }
 
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    restart(getThis() TSRMLS_CC);
 }
 /* }}} */
 
@@ -481,11 +707,11 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, encrypt) {
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
 
     // check key and iv
-    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherIvValid(getThis(), encryptor TSRMLS_CC)) {
+    if (!isCryptoppAuthenticatedSymmetricCipherStreamable(getThis(), encryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherIvValid(getThis(), encryptor TSRMLS_CC)) {
         RETURN_FALSE
     }
 
-    ensureIvIsSet(getThis(), encryptor, NULL TSRMLS_CC);
+    ensureCryptoppAuthenticatedSymmetricCipherKeyed(getThis(), true TSRMLS_CC);
 
     // check dataSize against block size
     int blockSize = static_cast<int>(encryptor->MandatoryBlockSize());
@@ -513,7 +739,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, encrypt) {
     delete[] output;
 
     // indicate that encryption has started
-    zend_update_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "encryptionStarted", 17, 1 TSRMLS_CC);
+    static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->encryptionStarted = true;
 }
 /* }}} */
 
@@ -531,11 +757,11 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, decrypt) {
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
 
     // check key and iv
-    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherIvValid(getThis(), decryptor TSRMLS_CC)) {
+    if (!isCryptoppAuthenticatedSymmetricCipherStreamable(getThis(), decryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherIvValid(getThis(), decryptor TSRMLS_CC)) {
         RETURN_FALSE
     }
 
-    ensureIvIsSet(getThis(), NULL, decryptor TSRMLS_CC);
+    ensureCryptoppAuthenticatedSymmetricCipherKeyed(getThis(), false TSRMLS_CC);
 
     // check dataSize against block size
     int blockSize = static_cast<int>(decryptor->MandatoryBlockSize());
@@ -563,7 +789,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, decrypt) {
     delete[] output;
 
     // indicate that decryption has started
-    zend_update_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "decryptionStarted", 17, 1 TSRMLS_CC);
+    static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->decryptionStarted = true;
 }
 /* }}} */
 
@@ -578,9 +804,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, addEncryptionAdditiona
     }
 
     // ensure that decryption has not started
-    zval *encryptionStarted = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "encryptionStarted", 17, 1 TSRMLS_CC);
-
-    if (1 == Z_BVAL_P(encryptionStarted)) {
+    if (static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->encryptionStarted) {
         zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
         zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: additional authenticated data must be added before any encryption", ce->name);
         RETURN_FALSE
@@ -590,11 +814,13 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, addEncryptionAdditiona
     CryptoPP::AuthenticatedSymmetricCipher *encryptor;
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
 
-    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC)) {
+    if (!isCryptoppAuthenticatedSymmetricCipherStreamable(getThis(), encryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC)) {
         RETURN_FALSE;
     }
 
     try {
+        ensureCryptoppAuthenticatedSymmetricCipherKeyed(getThis(), true TSRMLS_CC);
+
         if (encryptor->NeedsPrespecifiedDataLengths()) {
             dynamic_cast<AuthenticatedSymmetricCipherPrespecifiedLengths*>(encryptor)->Update(reinterpret_cast<byte*>(msg), msgSize);
         } else {
@@ -617,9 +843,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, addDecryptionAdditiona
     }
 
     // ensure that decryption has not started
-    zval *decryptionStarted = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "decryptionStarted", 17, 1 TSRMLS_CC);
-
-    if (1 == Z_BVAL_P(decryptionStarted)) {
+    if (static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->decryptionStarted) {
         zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
         zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: additional authenticated data must be added before any decryption", ce->name);
         RETURN_FALSE
@@ -629,11 +853,13 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, addDecryptionAdditiona
     CryptoPP::AuthenticatedSymmetricCipher *decryptor;
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
 
-    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC)) {
+    if (!isCryptoppAuthenticatedSymmetricCipherStreamable(getThis(), decryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC)) {
         RETURN_FALSE;
     }
 
     try {
+        ensureCryptoppAuthenticatedSymmetricCipherKeyed(getThis(), false TSRMLS_CC);
+
         if (decryptor->NeedsPrespecifiedDataLengths()) {
             dynamic_cast<AuthenticatedSymmetricCipherPrespecifiedLengths*>(decryptor)->Update(reinterpret_cast<byte*>(msg), msgSize);
         } else {
@@ -651,13 +877,15 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeEncryption) {
     CryptoPP::AuthenticatedSymmetricCipher *encryptor;
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
 
-    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC)) {
+    if (!isCryptoppAuthenticatedSymmetricCipherStreamable(getThis(), encryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC)) {
         RETURN_FALSE;
     }
 
     byte digest[encryptor->DigestSize()];
 
     try {
+        ensureCryptoppAuthenticatedSymmetricCipherKeyed(getThis(), true TSRMLS_CC);
+
         if (encryptor->NeedsPrespecifiedDataLengths()) {
             dynamic_cast<AuthenticatedSymmetricCipherPrespecifiedLengths*>(encryptor)->Final(digest);
         } else {
@@ -665,9 +893,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeEncryption) {
         }
 
         // restart
-        CryptoPP::AuthenticatedSymmetricCipher *decryptor;
-        CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
-        restart(getThis(), encryptor, decryptor TSRMLS_CC);
+        restart(getThis() TSRMLS_CC);
     } catch (bool e) {
         RETURN_FALSE;
     }
@@ -682,13 +908,15 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeDecryption) {
     CryptoPP::AuthenticatedSymmetricCipher *decryptor;
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
 
-    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC)) {
+    if (!isCryptoppAuthenticatedSymmetricCipherStreamable(getThis(), decryptor TSRMLS_CC) || !isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC)) {
         RETURN_FALSE;
     }
 
     byte digest[decryptor->DigestSize()];
 
     try {
+        ensureCryptoppAuthenticatedSymmetricCipherKeyed(getThis(), false TSRMLS_CC);
+
         if (decryptor->NeedsPrespecifiedDataLengths()) {
             dynamic_cast<AuthenticatedSymmetricCipherPrespecifiedLengths*>(decryptor)->Final(digest);
         } else {
@@ -696,9 +924,7 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeDecryption) {
         }
 
         // restart
-        CryptoPP::AuthenticatedSymmetricCipher *encryptor;
-        CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
-        restart(getThis(), encryptor, decryptor TSRMLS_CC);
+        restart(getThis() TSRMLS_CC);
     } catch (bool e) {
         RETURN_FALSE;
     }
@@ -714,11 +940,312 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, restart) {
     CryptoPP::AuthenticatedSymmetricCipher *decryptor;
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor);
     CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor);
-    restart(getThis(), encryptor, decryptor TSRMLS_CC);
+    restart(getThis() TSRMLS_CC);
 
     // indicate that encryption/decryption has not started
-    zend_update_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "encryptionStarted", 17, 0 TSRMLS_CC);
-    zend_update_property_bool(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "decryptionStarted", 17, 0 TSRMLS_CC);
+    AuthenticatedSymmetricCipherAbstractContainer *container    = static_cast<AuthenticatedSymmetricCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC));
+    container->encryptionStarted                                = false;
+    container->decryptionStarted                                = false;
+}
+/* }}} */
+
+/* {{{ proto string AuthenticatedSymmetricCipherAbstract::seal(string nonce, string plaintext [, string aad])
+   Encrypts a whole message with the given nonce and returns the ciphertext followed by the MAC tag.
+   The current iv is left unchanged */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, seal) {
+    char *nonce         = NULL;
+    int nonceSize       = 0;
+    char *plaintext     = NULL;
+    int plaintextSize   = 0;
+    char *aad           = NULL;
+    int aadSize         = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ss|s", &nonce, &nonceSize, &plaintext, &plaintextSize, &aad, &aadSize)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *encryptor;
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+
+    // check key and nonce
+    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), encryptor TSRMLS_CC) || !isCryptoppSymmetricIvValid(getThis(), encryptor, nonceSize TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    // check plaintext size against block size
+    int blockSize = static_cast<int>(encryptor->MandatoryBlockSize());
+
+    if (0 != plaintextSize % blockSize) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: data size (%d) is not a multiple of block size (%d)", ce->name, plaintextSize, blockSize);
+        RETURN_FALSE
+    }
+
+    // the tag is written right after the ciphertext
+    int digestSize  = encryptor->DigestSize();
+    byte *output    = new byte[plaintextSize + digestSize];
+
+    AuthenticatedSymmetricCipherMessage message;
+    message.nonce       = reinterpret_cast<byte*>(nonce);
+    message.nonceLength = nonceSize;
+    message.aad         = reinterpret_cast<byte*>(aad);
+    message.aadLength   = aadSize;
+    message.input       = reinterpret_cast<byte*>(plaintext);
+    message.length      = plaintextSize;
+    message.output      = output;
+    message.digest      = output + plaintextSize;
+
+    if (!processCryptoppAuthenticatedSymmetricCipherMessages(getThis(), encryptor, true, &message, 1 TSRMLS_CC)) {
+        delete[] output;
+        RETURN_FALSE
+    }
+
+    RETVAL_STRINGL(reinterpret_cast<char*>(output), plaintextSize + digestSize, 1);
+    delete[] output;
+}
+/* }}} */
+
+/* {{{ proto string AuthenticatedSymmetricCipherAbstract::open(string nonce, string ciphertext [, string aad])
+   Verifies and decrypts a message produced by seal(). Throws a CryptoppMacVerificationFailedException if the MAC tag is not valid.
+   The current iv is left unchanged */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, open) {
+    char *nonce         = NULL;
+    int nonceSize       = 0;
+    char *ciphertext    = NULL;
+    int ciphertextSize  = 0;
+    char *aad           = NULL;
+    int aadSize         = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ss|s", &nonce, &nonceSize, &ciphertext, &ciphertextSize, &aad, &aadSize)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *decryptor;
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    // check key and nonce
+    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(getThis(), decryptor TSRMLS_CC) || !isCryptoppSymmetricIvValid(getThis(), decryptor, nonceSize TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    // the ciphertext is followed by the tag
+    int digestSize = decryptor->DigestSize();
+
+    if (ciphertextSize < digestSize) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: data size (%d) is lower than the MAC tag size (%d)", ce->name, ciphertextSize, digestSize);
+        RETURN_FALSE
+    }
+
+    int dataSize    = ciphertextSize - digestSize;
+    int blockSize   = static_cast<int>(decryptor->MandatoryBlockSize());
+
+    if (0 != dataSize % blockSize) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: data size (%d) is not a multiple of block size (%d)", ce->name, dataSize, blockSize);
+        RETURN_FALSE
+    }
+
+    byte *output = new byte[dataSize];
+
+    AuthenticatedSymmetricCipherMessage message;
+    message.nonce       = reinterpret_cast<byte*>(nonce);
+    message.nonceLength = nonceSize;
+    message.aad         = reinterpret_cast<byte*>(aad);
+    message.aadLength   = aadSize;
+    message.input       = reinterpret_cast<byte*>(ciphertext);
+    message.length      = dataSize;
+    message.output      = output;
+    message.digest      = reinterpret_cast<byte*>(ciphertext + dataSize);
+
+    if (!processCryptoppAuthenticatedSymmetricCipherMessages(getThis(), decryptor, false, &message, 1 TSRMLS_CC)) {
+        delete[] output;
+        RETURN_FALSE
+    }
+
+    // the plaintext has been wiped if the tag does not match
+    if (!message.valid) {
+        delete[] output;
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppMacVerificationFailedException(), 0 TSRMLS_CC, (char*)"%s : MAC verification failed", ce->name);
+        RETURN_FALSE
+    }
+
+    RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
+    delete[] output;
+}
+/* }}} */
+
+/* {{{ processMessageBatch
+   seals or opens a list of array(nonce, data [, aad]) items with the current key. keys of the list are preserved.
+   all items are checked before the first one is processed. ciphers implementing AuthenticatedSymmetricCipherMessageBatch
+   are keyed once and get all messages in one call. other native ciphers are keyed once, then only resynchronized with the
+   nonce of each message, while ciphers built on user classes are keyed again with the nonce of each message.
+   on decryption, messages that are not authentic are replaced by false. returns false on failure, crypto++ exceptions
+   being reported as php exceptions by processCryptoppAuthenticatedSymmetricCipherMessages() */
+static bool processMessageBatch(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher, bool encryption, zval *items, zval *return_value TSRMLS_DC) {
+    if (!isCryptoppAuthenticatedSymmetricCipherKeyValid(object, cipher TSRMLS_CC)) {
+        return false;
+    }
+
+    zend_class_entry *ce    = zend_get_class_entry(object TSRMLS_CC);
+    int digestSize          = cipher->DigestSize();
+    int blockSize           = static_cast<int>(cipher->MandatoryBlockSize());
+    HashTable *itemList     = Z_ARRVAL_P(items);
+    HashPosition pos;
+    zval **zItem;
+    std::vector<AuthenticatedSymmetricCipherMessage> messages;
+    messages.reserve(zend_hash_num_elements(itemList));
+
+    // check items
+    for (
+        zend_hash_internal_pointer_reset_ex(itemList, &pos);
+        SUCCESS == zend_hash_get_current_data_ex(itemList, reinterpret_cast<void**>(&zItem), &pos);
+        zend_hash_move_forward_ex(itemList, &pos)
+    ) {
+        zval **zNonce   = NULL;
+        zval **zData    = NULL;
+        zval **zAad     = NULL;
+
+        if (
+            IS_ARRAY != Z_TYPE_PP(zItem) ||
+            SUCCESS != zend_hash_index_find(Z_ARRVAL_PP(zItem), 0, reinterpret_cast<void**>(&zNonce)) ||
+            SUCCESS != zend_hash_index_find(Z_ARRVAL_PP(zItem), 1, reinterpret_cast<void**>(&zData)) ||
+            IS_STRING != Z_TYPE_PP(zNonce) ||
+            IS_STRING != Z_TYPE_PP(zData) ||
+            (SUCCESS == zend_hash_index_find(Z_ARRVAL_PP(zItem), 2, reinterpret_cast<void**>(&zAad)) && IS_STRING != Z_TYPE_PP(zAad))
+        ) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : each item must be an array of 2 or 3 strings: nonce, data and additional authenticated data", ce->name);
+            return false;
+        } else if (!isCryptoppSymmetricIvValid(object, cipher, Z_STRLEN_PP(zNonce) TSRMLS_CC)) {
+            return false;
+        }
+
+        int inputSize   = Z_STRLEN_PP(zData);
+        bool sizeValid  = true;
+
+        if (encryption && 0 != inputSize % blockSize) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: data size (%d) is not a multiple of block size (%d)", ce->name, inputSize, blockSize);
+            return false;
+        } else if (!encryption) {
+            // a message that is too short or whose size is not valid cannot be authentic
+            sizeValid = inputSize >= digestSize && 0 == (inputSize - digestSize) % blockSize;
+        }
+
+        AuthenticatedSymmetricCipherMessage message;
+        message.nonce       = reinterpret_cast<byte*>(Z_STRVAL_PP(zNonce));
+        message.nonceLength = Z_STRLEN_PP(zNonce);
+        message.aad         = NULL == zAad ? NULL : reinterpret_cast<byte*>(Z_STRVAL_PP(zAad));
+        message.aadLength   = NULL == zAad ? 0 : Z_STRLEN_PP(zAad);
+        message.input       = reinterpret_cast<byte*>(Z_STRVAL_PP(zData));
+        message.length      = encryption ? inputSize : (sizeValid ? inputSize - digestSize : 0);
+        message.output      = NULL;
+        message.digest      = NULL;
+        message.valid       = sizeValid;
+        messages.push_back(message);
+    }
+
+    // output strings are handed over to php as is, without copy. the tag is written right after the ciphertext
+    std::vector<AuthenticatedSymmetricCipherMessage> processed;
+    processed.reserve(messages.size());
+
+    for (std::vector<AuthenticatedSymmetricCipherMessage>::iterator it = messages.begin(); it != messages.end(); ++it) {
+        if (!it->valid) {
+            continue;
+        }
+
+        size_t outputSize       = encryption ? it->length + digestSize : it->length;
+        it->output              = reinterpret_cast<byte*>(emalloc(outputSize + 1));
+        it->output[outputSize]  = '\0';
+        it->digest              = encryption ? it->output + it->length : const_cast<byte*>(it->input + it->length);
+        processed.push_back(*it);
+    }
+
+    bool success = processCryptoppAuthenticatedSymmetricCipherMessages(object, cipher, encryption, processed.empty() ? NULL : &processed[0], processed.size() TSRMLS_CC);
+
+    for (size_t i = 0, j = 0; i < messages.size(); i++) {
+        if (!messages[i].valid) {
+            continue;
+        }
+
+        messages[i].valid = success && processed[j++].valid;
+
+        if (!messages[i].valid) {
+            efree(messages[i].output);
+        }
+    }
+
+    if (!success) {
+        return false;
+    }
+
+    array_init(return_value);
+    size_t i = 0;
+
+    for (
+        zend_hash_internal_pointer_reset_ex(itemList, &pos);
+        SUCCESS == zend_hash_get_current_data_ex(itemList, reinterpret_cast<void**>(&zItem), &pos);
+        zend_hash_move_forward_ex(itemList, &pos), i++
+    ) {
+        zval *result;
+        MAKE_STD_ZVAL(result);
+
+        if (messages[i].valid) {
+            ZVAL_STRINGL(result, reinterpret_cast<char*>(messages[i].output), encryption ? messages[i].length + digestSize : messages[i].length, 0);
+        } else {
+            ZVAL_FALSE(result);
+        }
+
+        char *key;
+        uint keyLength;
+        ulong index;
+
+        if (HASH_KEY_IS_STRING == zend_hash_get_current_key_ex(itemList, &key, &keyLength, &index, 0, &pos)) {
+            add_assoc_zval_ex(return_value, key, keyLength, result);
+        } else {
+            add_index_zval(return_value, index, result);
+        }
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ proto array AuthenticatedSymmetricCipherAbstract::sealBatch(array items)
+   Seals several messages with the current key. Each item is an array(nonce, plaintext [, aad]).
+   Keys are preserved, each value is the ciphertext followed by the MAC tag. The current iv is left unchanged */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, sealBatch) {
+    zval *items;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a", &items)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *encryptor;
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+
+    if (!processMessageBatch(getThis(), encryptor, true, items, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
+/* {{{ proto array AuthenticatedSymmetricCipherAbstract::openBatch(array items)
+   Verifies and decrypts several messages produced by seal() or sealBatch(). Each item is an array(nonce, ciphertext [, aad]).
+   Keys are preserved, each value is the plaintext or false if the message is not authentic. The current iv is left unchanged */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, openBatch) {
+    zval *items;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a", &items)) {
+        return;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *decryptor;
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    if (!processMessageBatch(getThis(), decryptor, false, items, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
 }
 /* }}} */
 
@@ -11,6 +11,8 @@
 #define PHP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_H
 
 #include "src/php_cryptopp.h"
+#include "src/symmetric/cipher/block/php_block_cipher_abstract.h"
+#include "authenticated_symmetric_cipher_message_batch.h"
 
 extern zend_class_entry *cryptopp_ce_AuthenticatedSymmetricCipherAbstract;
 void init_class_AuthenticatedSymmetricCipherAbstract(TSRMLS_D);
@@ -22,6 +24,16 @@ void setCryptoppAuthenticatedSymmetricCipherEncryptorPtr(zval *this_ptr, CryptoP
 void setCryptoppAuthenticatedSymmetricCipherDecryptorPtr(zval *this_ptr, CryptoPP::AuthenticatedSymmetricCipher *nativePtr TSRMLS_DC);
 bool isCryptoppAuthenticatedSymmetricCipherKeyValid(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC);
 bool isCryptoppAuthenticatedSymmetricCipherIvValid(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC);
+void ensureCryptoppAuthenticatedSymmetricCipherKeyed(zval *object, bool encryption TSRMLS_DC);
+bool isCryptoppAuthenticatedSymmetricCipherStreamable(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC);
+bool processCryptoppAuthenticatedSymmetricCipherMessages(
+    zval *object,
+    CryptoPP::AuthenticatedSymmetricCipher *cipher,
+    bool encryption,
+    AuthenticatedSymmetricCipherMessage *messages,
+    size_t count
+    TSRMLS_DC
+);
 
 /* {{{ CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR
    get the pointer to the native encryptor object of a php cipher class */
@@ -48,6 +60,16 @@ struct AuthenticatedSymmetricCipherAbstractContainer {
     zend_object std;
     CryptoPP::AuthenticatedSymmetricCipher *encryptor;
     CryptoPP::AuthenticatedSymmetricCipher *decryptor;
+    bool encryptorKeyed;
+    bool decryptorKeyed;
+    bool encryptorIvSynchronized;
+    bool decryptorIvSynchronized;
+    unsigned int encryptorKeyGeneration;
+    unsigned int decryptorKeyGeneration;
+    bool encryptionStarted;
+    bool decryptionStarted;
+    BlockCipherAbstractContainer *nativeCipher;
+    int ivLength;
 };
 
 extern zend_object_handlers AuthenticatedSymmetricCipherAbstract_object_handlers;
@@ -73,6 +95,10 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, addDecryptionAdditiona
 PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeEncryption);
 PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, finalizeDecryption);
 PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, restart);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, seal);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, open);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, sealBatch);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherAbstract, openBatch);
 /* }}} */
 
 /* {{{ php cipher classes methods arg info */
@@ -81,6 +107,26 @@ ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherAbstract___sleep, 0)
 ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_AuthenticatedSymmetricCipherAbstract_seal, 0, 0, 2)
+    ZEND_ARG_INFO(0, nonce)
+    ZEND_ARG_INFO(0, plaintext)
+    ZEND_ARG_INFO(0, aad)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_AuthenticatedSymmetricCipherAbstract_open, 0, 0, 2)
+    ZEND_ARG_INFO(0, nonce)
+    ZEND_ARG_INFO(0, ciphertext)
+    ZEND_ARG_INFO(0, aad)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherAbstract_sealBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, items, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherAbstract_openBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, items, 0)
+ZEND_END_ARG_INFO()
 /* }}} */
 
 /* {{{ Get needed cipher elements to build an authenticated cipher object */
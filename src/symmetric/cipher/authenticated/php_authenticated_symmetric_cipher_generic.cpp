@@ -14,6 +14,7 @@
 #include "src/mac/php_mac_abstract.h"
 #include "src/utils/zval_utils.h"
 #include "src/symmetric/mode/php_symmetric_mode_abstract.h"
+#include "src/symmetric/mode/php_ctr.h"
 #include "src/symmetric/cipher/stream/php_stream_cipher_abstract.h"
 #include "src/symmetric/cipher/php_symmetric_transformation_interface.h"
 #include "src/symmetric/cipher/symmetric_transformation_proxy.h"
@@ -21,8 +22,14 @@
 #include "php_authenticated_symmetric_cipher_interface.h"
 #include "php_authenticated_symmetric_cipher_abstract.h"
 #include "php_authenticated_symmetric_cipher_generic.h"
+#include <misc.h>
 #include <zend_exceptions.h>
 
+/* {{{ size of tiles processed by ProcessData()
+   a tile and its output stay in L1 cache between the cipher and the mac */
+#define GENERIC_TILE_SIZE   8192
+/* }}} */
+
 /* {{{ AuthenticatedSymmetricCipherGeneric::Base::Base */
 AuthenticatedSymmetricCipherGeneric::Base::Base(zval *zCipher, zval *zMac, CryptoPP::SymmetricCipher *cipher, CryptoPP::MessageAuthenticationCode *mac, bool cipherMustBeDestructed, bool macMustBeDestructed)
 {
@@ -33,6 +40,8 @@ AuthenticatedSymmetricCipherGeneric::Base::Base(zval *zCipher, zval *zMac, Crypt
     m_funcnameRestart           = makeZval("restart");
     m_cipherMustBeDestructed    = cipherMustBeDestructed;
     m_macMustBeDestructed       = macMustBeDestructed;
+    m_cipherIsUserClass         = 0 != dynamic_cast<SymmetricTransformationUserInterface*>(cipher);
+    m_macIsUserClass            = 0 != dynamic_cast<MacProxy*>(mac);
 }
 /* }}} */
 
@@ -67,17 +76,57 @@ AuthenticatedSymmetricCipherGeneric::Decryption::Decryption(zval *zCipher, zval
 }
 /* }}} */
 
-/* {{{ AuthenticatedSymmetricCipherGeneric::Base::ProcessData */
+/* {{{ AuthenticatedSymmetricCipherGeneric::Base::GetTileSize
+   returns the size of the tiles length bytes are processed by, or 0 if they must be processed at once */
+size_t AuthenticatedSymmetricCipherGeneric::Base::GetTileSize(size_t length) const
+{
+    unsigned int blockSize  = m_cipher->MandatoryBlockSize();
+    size_t tileSize         = GENERIC_TILE_SIZE - GENERIC_TILE_SIZE % blockSize;
+
+    if (length <= tileSize || 0 == tileSize || m_cipher->IsLastBlockSpecial()) {
+        return 0;
+    } else if (m_cipherIsUserClass || m_macIsUserClass) {
+        // php user classes are called once per call, as without tiles
+        return 0;
+    }
+
+    // large ctr inputs are already split between threads
+    Ctr::Parallel *ctr = dynamic_cast<Ctr::Parallel*>(m_cipher);
+
+    if (NULL != ctr && ctr->GetParallelThreshold() > 0 && length >= ctr->GetParallelThreshold()) {
+        return 0;
+    }
+
+    return tileSize;
+}
+/* }}} */
+
+/* {{{ AuthenticatedSymmetricCipherGeneric::Base::ProcessData
+   data is ciphered and authenticated one tile at a time, instead of being read twice from memory */
 void AuthenticatedSymmetricCipherGeneric::Base::ProcessData(byte *outString, const byte *inString, size_t length)
 {
-    m_cipher->ProcessData(outString, inString, length);
+    size_t tileSize = GetTileSize(length);
 
-    if (IsForwardTransformation()) {
-        // encryption
-        m_mac->Update(outString, length);
-    } else {
-        // decryption
-        m_mac->Update(inString, length);
+    if (0 == tileSize) {
+        tileSize = length;
+    }
+
+    while (length > 0) {
+        size_t size = CryptoPP::UnsignedMin(tileSize, length);
+
+        if (IsForwardTransformation()) {
+            // encryption
+            m_cipher->ProcessData(outString, inString, size);
+            m_mac->Update(outString, size);
+        } else {
+            // decryption. the ciphertext is authenticated first, as it is overwritten if data is processed in place
+            m_mac->Update(inString, size);
+            m_cipher->ProcessData(outString, inString, size);
+        }
+
+        outString  += size;
+        inString   += size;
+        length     -= size;
     }
 }
 /* }}} */
@@ -308,6 +357,11 @@ static bool isCryptoppAuthenticatedSymmetricCipherGenericMacKeyValid(zval *objec
 }
 
 bool isCryptoppAuthenticatedSymmetricCipherGenericMacKeyValid(zval *object, CryptoPP::AuthenticatedSymmetricCipher *cipher TSRMLS_DC) {
+    if (0 == dynamic_cast<AuthenticatedSymmetricCipherGeneric::Base*>(cipher)) {
+        // the cipher is not an instance of AuthenticatedSymmetricCipherGeneric, there is no mac object to ask
+        return true;
+    }
+
     zval *key   = getMacKey(object TSRMLS_CC);
     int keySize = IS_STRING == Z_TYPE_P(key) ? Z_STRLEN_P(key) : 0;
     zval_ptr_dtor(&key);
@@ -86,6 +86,7 @@ public:
 
     protected:
         Base(zval *zCipher, zval *zMac, CryptoPP::SymmetricCipher *cipher, CryptoPP::MessageAuthenticationCode *mac, bool cipherMustBeDestructed, bool macMustBeDestructed);
+        size_t GetTileSize(size_t length) const;
 
         // unused
         const Algorithm & GetAlgorithm() const {return *static_cast<const CryptoPP::MessageAuthenticationCode *>(this);}
@@ -94,6 +95,8 @@ public:
 
         bool m_cipherMustBeDestructed;
         bool m_macMustBeDestructed;
+        bool m_cipherIsUserClass;
+        bool m_macIsUserClass;
         zval *m_zCipher;
         zval *m_zMac;
         zval *m_funcnameRestart;
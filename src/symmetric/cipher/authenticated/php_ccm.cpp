@@ -20,6 +20,9 @@
 CCM::Base::Base(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed TSRMLS_DC)
     : m_cipher(cipher)
     , m_cipherMustBeDestructed(cipherMustBeDestructed)
+    , m_dataLengthsSet(false)
+    , m_specifiedAadLength(0)
+    , m_specifiedMessageLength(0)
 {
     SET_M_TSRMLS_C()
 }
@@ -45,6 +48,28 @@ void CCM::Base::SetDigestSize(int digestSize)
 }
 /* }}} */
 
+/* {{{ CCM::Base::SetDataLengths
+   stores the AAD and message lengths, they are specified each time the cipher is resynchronized */
+void CCM::Base::SetDataLengths(CryptoPP::lword aadLength, CryptoPP::lword messageLength)
+{
+    m_dataLengthsSet         = true;
+    m_specifiedAadLength     = aadLength;
+    m_specifiedMessageLength = messageLength;
+}
+/* }}} */
+
+/* {{{ CCM::Base::Resynchronize
+   also called by SetKeyWithIV, so lengths are applied whenever this direction is keyed */
+void CCM::Base::Resynchronize(const byte *iv, int length)
+{
+    CryptoPP::AuthenticatedSymmetricCipherBase::Resynchronize(iv, length);
+
+    if (m_dataLengthsSet) {
+        SpecifyDataLengths(m_specifiedAadLength, m_specifiedMessageLength);
+    }
+}
+/* }}} */
+
 /* {{{ CCM::Base::ProcessData */
 void CCM::Base::ProcessData(byte *outString, const byte *inString, size_t length)
 {
@@ -130,11 +155,12 @@ static void setDataSizeAndDigestSize(zval *object, CCM::Base *encryptor, CCM::Ba
     zval_ptr_dtor(&funcname);
     zval_ptr_dtor(&output);
 
-    // set digest size, data size and aad size
+    // set digest size, data size and aad size.
+    // lengths are part of the state set by the iv, each direction specifies them when it is keyed or resynchronized
     encryptor->SetDigestSize(Z_LVAL_P(zDigestSize));
     decryptor->SetDigestSize(Z_LVAL_P(zDigestSize));
-    encryptor->SpecifyDataLengths(Z_LVAL_P(zAadSize), Z_LVAL_P(zDataSize));
-    decryptor->SpecifyDataLengths(Z_LVAL_P(zAadSize), Z_LVAL_P(zDataSize));
+    encryptor->SetDataLengths(Z_LVAL_P(zAadSize), Z_LVAL_P(zDataSize));
+    decryptor->SetDataLengths(Z_LVAL_P(zAadSize), Z_LVAL_P(zDataSize));
 }
 /* }}} */
 
@@ -26,6 +26,8 @@ public:
     public:
         ~Base();
         void SetDigestSize(int digestSize);
+        void SetDataLengths(CryptoPP::lword aadLength, CryptoPP::lword messageLength);
+        void Resynchronize(const byte *iv, int length = -1);
         void ProcessData(byte *outString, const byte *inString, size_t length);
         void Update(const byte *input, size_t length);
         void Final(byte *digest);
@@ -40,6 +42,9 @@ public:
 
         bool m_cipherMustBeDestructed;
         CryptoPP::BlockCipher *m_cipher;
+        bool m_dataLengthsSet;
+        CryptoPP::lword m_specifiedAadLength;
+        CryptoPP::lword m_specifiedMessageLength;
         M_TSRMLS_D;
     };
     /* }}} */
@@ -0,0 +1,143 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/utils/zval_utils.h"
+#include "src/symmetric/cipher/stream/php_chacha20.h"
+#include "php_authenticated_symmetric_cipher_abstract.h"
+#include "php_chacha20_poly1305.h"
+#include <zend_exceptions.h>
+#include <misc.h>
+
+/* {{{ ChaCha20-Poly1305 AEAD construction of RFC 8439 */
+ChaCha20Poly1305::Base::Base(TSRMLS_D)
+{
+    SET_M_TSRMLS_C()
+}
+
+void ChaCha20Poly1305::Base::SetKeyWithoutResync(const byte *userKey, size_t keylength, const CryptoPP::NameValuePairs &params)
+{
+    // the nonce is set by Resync()
+    static const byte zeroNonce[12] = {0};
+    m_cipher.SetKeyWithIV(userKey, keylength, zeroNonce, sizeof(zeroNonce));
+    m_buffer.New(AuthenticationBlockSize());
+}
+
+void ChaCha20Poly1305::Base::Resync(const byte *iv, size_t len)
+{
+    // the one-time Poly1305 key is the first half of the keystream block 0. data is encrypted from block 1
+    CryptoPP::FixedSizeSecBlock<byte, 64> block;
+    memset(block, 0, block.size());
+    m_cipher.Resynchronize(iv, len);
+    m_cipher.ProcessString(block, block.size());
+    m_mac.SetKey(block);
+}
+
+void ChaCha20Poly1305::Base::ProcessData(byte *outString, const byte *inString, size_t length)
+{
+    // block 0 gives the Poly1305 key, so the 32 bits counter of ChaCha20 leaves 2^32 - 1 blocks for the message.
+    // checked before any data is processed. CryptoPP::AuthenticatedSymmetricCipherBase would throw a CryptoPP::InvalidArgument
+    if (m_state >= State_IVSet && m_totalMessageLength + length > MaxMessageLength()) {
+        zend_throw_exception_ex(getCryptoppException(), 0 M_TSRMLS_CC, (char*)"Cryptopp\\AuthenticatedSymmetricCipherChaCha20Poly1305 : message length exceeds maximum (%llu bytes)", MaxMessageLength());
+        throw false;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipherBase::ProcessData(outString, inString, length);
+}
+
+size_t ChaCha20Poly1305::Base::AuthenticateBlocks(const byte *data, size_t len)
+{
+    size_t blocksLength = len & ~(size_t)15;
+    m_mac.Update(data, blocksLength);
+    return len - blocksLength;
+}
+
+void ChaCha20Poly1305::Base::AuthenticatePaddedBlock()
+{
+    // aad and ciphertext are both padded with zeros to a multiple of 16 bytes
+    if (m_bufferedDataLength > 0) {
+        memset(m_buffer + m_bufferedDataLength, 0, AuthenticationBlockSize() - m_bufferedDataLength);
+        m_mac.Update(m_buffer, AuthenticationBlockSize());
+    }
+}
+
+void ChaCha20Poly1305::Base::AuthenticateLastHeaderBlock()
+{
+    AuthenticatePaddedBlock();
+}
+
+void ChaCha20Poly1305::Base::AuthenticateLastConfidentialBlock()
+{
+    AuthenticatePaddedBlock();
+}
+
+void ChaCha20Poly1305::Base::AuthenticateLastFooterBlock(byte *mac, size_t macSize)
+{
+    byte lengths[16];
+    CryptoPP::PutWord<CryptoPP::word64>(false, CryptoPP::LITTLE_ENDIAN_ORDER, lengths, m_totalHeaderLength);
+    CryptoPP::PutWord<CryptoPP::word64>(false, CryptoPP::LITTLE_ENDIAN_ORDER, lengths + 8, m_totalMessageLength);
+    m_mac.Update(lengths, sizeof(lengths));
+
+    byte digest[Poly1305::DIGESTSIZE];
+    m_mac.Final(digest);
+    memcpy(mac, digest, macSize);
+}
+/* }}} */
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherChaCha20Poly1305_construct, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_AuthenticatedSymmetricCipherChaCha20Poly1305;
+
+static zend_function_entry cryptopp_methods_AuthenticatedSymmetricCipherChaCha20Poly1305[] = {
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherChaCha20Poly1305, __construct, arginfo_AuthenticatedSymmetricCipherChaCha20Poly1305_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_FE_END
+};
+
+void init_class_AuthenticatedSymmetricCipherChaCha20Poly1305(TSRMLS_D) {
+    init_class_AuthenticatedSymmetricCipherAbstractChild("chacha20-poly1305", "AuthenticatedSymmetricCipherChaCha20Poly1305", &cryptopp_ce_AuthenticatedSymmetricCipherChaCha20Poly1305, cryptopp_methods_AuthenticatedSymmetricCipherChaCha20Poly1305 TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto AuthenticatedSymmetricCipherChaCha20Poly1305::__construct(void) */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherChaCha20Poly1305, __construct) {
+    // as with other authenticated ciphers, the key and the iv are held by an underlying cipher object
+    zval *cipherObject;
+    MAKE_STD_ZVAL(cipherObject);
+    object_init_ex(cipherObject, cryptopp_ce_StreamCipherChaCha20);
+
+    zval *funcname  = makeZval("__construct");
+    zval *output    = call_user_method(cipherObject, funcname TSRMLS_CC);
+    zval_ptr_dtor(&funcname);
+    zval_ptr_dtor(&output);
+
+    // instanciate authenticated cipher encryptor/decryptor
+    ChaCha20Poly1305::Encryption *encryptor = new ChaCha20Poly1305::Encryption(TSRMLS_C);
+    ChaCha20Poly1305::Decryption *decryptor = new ChaCha20Poly1305::Decryption(TSRMLS_C);
+    setCryptoppAuthenticatedSymmetricCipherEncryptorPtr(getThis(), encryptor TSRMLS_CC);
+    setCryptoppAuthenticatedSymmetricCipherDecryptorPtr(getThis(), decryptor TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "name", 4, "chacha20-poly1305", 17 TSRMLS_CC);
+    zend_update_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, cipherObject TSRMLS_CC);
+    zval_ptr_dtor(&cipherObject);
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,92 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_AUTHENTICATED_SYMMETRIC_CIPHER_CHACHA20_POLY1305_H
+#define PHP_AUTHENTICATED_SYMMETRIC_CIPHER_CHACHA20_POLY1305_H
+
+#include "src/php_cryptopp.h"
+#include "src/mac/poly1305.h"
+#include "src/symmetric/cipher/stream/chacha20_core.h"
+#include <authenc.h>
+
+void init_class_AuthenticatedSymmetricCipherChaCha20Poly1305(TSRMLS_D);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherChaCha20Poly1305, __construct);
+
+/* {{{ ChaCha20-Poly1305 AEAD construction of RFC 8439 */
+class ChaCha20Poly1305
+{
+public:
+    /* {{{ base class */
+    class Base : public CryptoPP::AuthenticatedSymmetricCipherBase
+    {
+    public:
+        static std::string StaticAlgorithmName() {return std::string("ChaCha20/Poly1305");}
+        std::string AlgorithmName() const {return StaticAlgorithmName();}
+        size_t MinKeyLength() const {return 32;}
+        size_t MaxKeyLength() const {return 32;}
+        size_t DefaultKeyLength() const {return 32;}
+        size_t GetValidKeyLength(size_t n) const {return 32;}
+        IV_Requirement IVRequirement() const {return UNIQUE_IV;}
+        unsigned int IVSize() const {return 12;}
+        unsigned int DigestSize() const {return Poly1305::DIGESTSIZE;}
+        CryptoPP::lword MaxHeaderLength() const {return CryptoPP::LWORD_MAX;}
+        CryptoPP::lword MaxMessageLength() const {return W64LIT(274877906880);} // (2^32 - 1) blocks of 64 bytes
+        void ProcessData(byte *outString, const byte *inString, size_t length);
+
+    protected:
+        Base(TSRMLS_D);
+        CryptoPP::SymmetricCipher & AccessSymmetricCipher() {return m_cipher;}
+        bool AuthenticationIsOnPlaintext() const {return false;}
+        unsigned int AuthenticationBlockSize() const {return 16;}
+        void SetKeyWithoutResync(const byte *userKey, size_t keylength, const CryptoPP::NameValuePairs &params);
+        void Resync(const byte *iv, size_t len);
+        size_t AuthenticateBlocks(const byte *data, size_t len);
+        void AuthenticateLastHeaderBlock();
+        void AuthenticateLastConfidentialBlock();
+        void AuthenticateLastFooterBlock(byte *mac, size_t macSize);
+
+    private:
+        void AuthenticatePaddedBlock();
+
+        ChaCha20::Encryption m_cipher;
+        Poly1305 m_mac;
+        M_TSRMLS_D;
+    };
+    /* }}} */
+
+    /* {{{ encryption class */
+    class Encryption : public Base
+    {
+    public:
+        Encryption(TSRMLS_D) : Base(TSRMLS_C){};
+        bool IsForwardTransformation() const {return true;}
+    };
+    /* }}} */
+
+    /* {{{ decryption class */
+    class Decryption : public Base
+    {
+    public:
+        Decryption(TSRMLS_D) : Base(TSRMLS_C){};
+        bool IsForwardTransformation() const {return false;}
+    };
+    /* }}} */
+};
+/* }}} */
+
+#endif /* PHP_AUTHENTICATED_SYMMETRIC_CIPHER_CHACHA20_POLY1305_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
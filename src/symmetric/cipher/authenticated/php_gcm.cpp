@@ -9,17 +9,28 @@
 
 #include "src/php_cryptopp.h"
 #include "src/exception/php_exception.h"
+#include "src/symmetric/cipher/key_schedule_cache.h"
+#include "src/symmetric/cipher/block/block_cipher_proxy.h"
 #include "src/symmetric/cipher/block/php_block_cipher_interface.h"
+#include "src/symmetric/mode/php_ctr.h"
 #include "php_authenticated_symmetric_cipher_abstract.h"
 #include "php_gcm.h"
 #include <zend_exceptions.h>
 #include <gcm.h>
+#include <misc.h>
+#include <pthread.h>
+#include <sstream>
 
 /* {{{ fork of CryptoPP::GCM that take a cipher as parameter instead of a template parameter */
-GCM::Base::Base(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed)
+GCM::Base::Base(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed, CryptoPP::GCM_TablesOption tablesOption TSRMLS_DC)
     : m_cipher(cipher)
+    , m_parallelThreshold(CTR_DEFAULT_PARALLEL_THRESHOLD)
     , m_cipherMustBeDestructed(cipherMustBeDestructed)
+    , m_keyScheduleCacheEnabled(false)
+    , m_tablesOption(tablesOption)
+    , m_sibling(NULL)
 {
+    SET_M_TSRMLS_C()
 }
 
 GCM::Base::~Base()
@@ -28,11 +39,314 @@ GCM::Base::~Base()
         delete m_cipher;
     }
 }
+
+void GCM::Base::SetKeyWithoutResync(const byte *userKey, size_t keylength, const CryptoPP::NameValuePairs &params)
+{
+    if (LoadSiblingTables(userKey, keylength, params)) {
+        return;
+    }
+
+    if (!m_keyScheduleCacheEnabled) {
+        CryptoPP::GCM_Base::SetKeyWithoutResync(userKey, keylength, params);
+        return;
+    }
+
+    // the hash key and its multiplication table only depend on the cipher, the key and the table size.
+    // they are all stored in m_buffer
+    std::stringstream tag;
+    tag << "gcm(" << m_cipher->AlgorithmName() << ")/" << GetTablesOption();
+
+    if (KeyScheduleCache::Load<KeyScheduleCache::BufferEntry>(tag.str(), userKey, keylength, m_buffer)) {
+        m_cipher->SetKey(userKey, keylength, params);
+        return;
+    }
+
+    CryptoPP::GCM_Base::SetKeyWithoutResync(userKey, keylength, params);
+    KeyScheduleCache::Store(tag.str(), userKey, keylength, new KeyScheduleCache::BufferEntry(m_buffer, m_buffer.size()));
+}
+
+bool GCM::Base::LoadSiblingTables(const byte *userKey, size_t keylength, const CryptoPP::NameValuePairs &params)
+{
+    if (NULL == m_sibling || 0 == m_sibling->m_buffer.size() || m_sibling->m_tablesOption != m_tablesOption) {
+        return false;
+    }
+
+    // the multiplication table only depends on the hash key E(K, 0^128) and on the table size.
+    // both directions share the block cipher, so it is keyed once whatever the result
+    CryptoPP::SecByteBlock hashKey(REQUIRED_BLOCKSIZE);
+    memset(hashKey, 0, REQUIRED_BLOCKSIZE);
+    m_cipher->SetKey(userKey, keylength, params);
+    m_cipher->ProcessBlock(hashKey);
+
+    if (!CryptoPP::VerifyBufsEqual(hashKey, m_sibling->HashKey(), REQUIRED_BLOCKSIZE)) {
+        return false;
+    }
+
+    m_buffer = m_sibling->m_buffer;
+    return true;
+}
+/* }}} */
+
+/* {{{ GCM::Base::Gctr */
+GCM::Base::Gctr::Gctr(const GCTR &ctr, CryptoPP::lword blocks)
+    : GCTR(ctr)
+{
+    // GCM only increments the rightmost 32 bits of the counter
+    byte *counter           = m_counterArray.BytePtr() + m_counterArray.size() - 4;
+    CryptoPP::word32 low    = CryptoPP::GetWord<CryptoPP::word32>(false, CryptoPP::BIG_ENDIAN_ORDER, counter);
+    CryptoPP::PutWord<CryptoPP::word32>(false, CryptoPP::BIG_ENDIAN_ORDER, counter, low + static_cast<CryptoPP::word32>(blocks));
+}
+/* }}} */
+
+/* {{{ GcmWorker
+   range of counter blocks processed by a thread */
+struct GcmWorker {
+    pthread_t thread;
+    bool started;
+    CryptoPP::BlockCipher *cipher;
+    GCM::Base::Gctr *ctr;
+    const byte *input;
+    byte *output;
+    size_t length;
+};
+
+static void *runGcmWorker(void *arg) {
+    GcmWorker *worker = static_cast<GcmWorker*>(arg);
+    worker->ctr->ProcessData(worker->output, worker->input, worker->length);
+    return NULL;
+}
+/* }}} */
+
+/* {{{ GCM::Base::ProcessData */
+void GCM::Base::ProcessData(byte *outString, const byte *inString, size_t length)
+{
+    // checked before any data is processed. CryptoPP::GCM_Base would throw a CryptoPP::InvalidArgument
+    if (m_state >= State_IVSet && m_totalMessageLength + length > MaxMessageLength()) {
+        zend_throw_exception_ex(getCryptoppException(), 0 M_TSRMLS_CC, (char*)"Cryptopp\\AuthenticatedSymmetricCipherGcm : message length exceeds maximum (%llu bytes)", MaxMessageLength());
+        throw false;
+    }
+
+    unsigned int threadCount = 0;
+
+    if (m_parallelThreshold > 0 && length >= m_parallelThreshold && NULL == dynamic_cast<BlockCipherProxy::Base*>(m_cipher)) {
+        // php user classes can only be called from the php thread
+        threadCount = getCtrThreadCount(length);
+    }
+
+    if (threadCount < 2) {
+        CryptoPP::GCM_Base::ProcessData(outString, inString, length);
+        return;
+    }
+
+    // consume the keystream left by a previous call. on the first call, this also authenticates the last additional data block
+    size_t leftOver = CryptoPP::UnsignedMin((REQUIRED_BLOCKSIZE - m_totalMessageLength % REQUIRED_BLOCKSIZE) % REQUIRED_BLOCKSIZE, length);
+    CryptoPP::GCM_Base::ProcessData(outString, inString, leftOver);
+    outString  += leftOver;
+    inString   += leftOver;
+    length     -= leftOver;
+
+    size_t blocks = length / REQUIRED_BLOCKSIZE;
+    m_totalMessageLength += blocks * REQUIRED_BLOCKSIZE;
+
+    // split full blocks between threads
+    size_t blocksPerThread  = blocks / threadCount;
+    GcmWorker *workers      = new GcmWorker[threadCount];
+    size_t firstBlock       = 0;
+
+    for (unsigned int i = 0; i < threadCount; i++) {
+        GcmWorker &worker   = workers[i];
+        size_t workerBlocks = i == threadCount - 1 ? blocks - firstBlock : blocksPerThread;
+        worker.started      = false;
+        worker.cipher       = NULL;
+        worker.ctr          = new Gctr(m_ctr, firstBlock);
+        worker.input        = inString + firstBlock * REQUIRED_BLOCKSIZE;
+        worker.output       = outString + firstBlock * REQUIRED_BLOCKSIZE;
+        worker.length       = workerBlocks * REQUIRED_BLOCKSIZE;
+        firstBlock         += workerBlocks;
+
+        // block ciphers are not safe to share between threads
+        try {
+            worker.cipher = dynamic_cast<CryptoPP::BlockCipher*>(m_cipher->Clone());
+        } catch (CryptoPP::NotImplemented &e) {
+            worker.cipher = NULL;
+        }
+
+        if (NULL != worker.cipher) {
+            worker.ctr->UseCipher(worker.cipher);
+            worker.started = 0 == pthread_create(&worker.thread, NULL, runGcmWorker, &worker);
+        }
+    }
+
+    // GHASH is computed by the calling thread: on the ciphertext while threads decrypt it,
+    // or on each range of ciphertext as soon as its thread has encrypted it
+    if (State_AuthUntransformed == m_state) {
+        AuthenticateData(inString, blocks * REQUIRED_BLOCKSIZE);
+    }
+
+    // a range whose thread could not be started is processed here
+    for (unsigned int i = 0; i < threadCount; i++) {
+        GcmWorker &worker = workers[i];
+
+        if (worker.started) {
+            pthread_join(worker.thread, NULL);
+        } else {
+            worker.ctr->ProcessData(worker.output, worker.input, worker.length);
+        }
+
+        if (State_AuthTransformed == m_state) {
+            AuthenticateData(worker.output, worker.length);
+        }
+
+        delete worker.ctr;
+        delete worker.cipher;
+    }
+
+    delete[] workers;
+
+    // move the counter after the processed blocks, and process the last partial block
+    m_ctr = Gctr(m_ctr, blocks);
+    outString  += blocks * REQUIRED_BLOCKSIZE;
+    inString   += blocks * REQUIRED_BLOCKSIZE;
+    length     -= blocks * REQUIRED_BLOCKSIZE;
+
+    if (length > 0) {
+        CryptoPP::GCM_Base::ProcessData(outString, inString, length);
+    }
+}
+/* }}} */
+
+/* {{{ GCM::Base::ProcessMessages */
+void GCM::Base::ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count)
+{
+    size_t first = 0;
+
+    while (first < count) {
+        // consecutive small messages are grouped until their keystream reaches the batch size
+        size_t last = first;
+        size_t size = 0;
+
+        while (last < count && messages[last].aadLength + messages[last].length <= AUTHENTICATED_SYMMETRIC_CIPHER_BATCH_MESSAGE_SIZE) {
+            size_t messageSize = REQUIRED_BLOCKSIZE * ((messages[last].length + REQUIRED_BLOCKSIZE - 1) / REQUIRED_BLOCKSIZE);
+
+            if (last > first && size + messageSize > AUTHENTICATED_SYMMETRIC_CIPHER_BATCH_SIZE) {
+                break;
+            }
+
+            size += messageSize;
+            last++;
+        }
+
+        if (last == first) {
+            processAuthenticatedSymmetricCipherMessage(*this, messages[first]);
+            first++;
+        } else {
+            ProcessMessageGroup(messages + first, last - first);
+            first = last;
+        }
+    }
+}
+
+void GCM::Base::ProcessMessageGroup(AuthenticatedSymmetricCipherMessage *messages, size_t count)
+{
+    size_t blocks = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        blocks += (messages[i].length + REQUIRED_BLOCKSIZE - 1) / REQUIRED_BLOCKSIZE;
+    }
+
+    // counter blocks of all messages are encrypted at once
+    CryptoPP::SecByteBlock keystream(REQUIRED_BLOCKSIZE * blocks);
+    byte *counter = keystream;
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message    = messages[i];
+        size_t messageBlocks                            = (message.length + REQUIRED_BLOCKSIZE - 1) / REQUIRED_BLOCKSIZE;
+
+        if (0 == messageBlocks) {
+            continue;
+        }
+
+        // the first block of a message uses inc32(J0). with a 96 bits nonce, J0 = nonce || 0^31 || 1
+        if (12 == message.nonceLength) {
+            memcpy(counter, message.nonce, 12);
+            CryptoPP::PutWord<CryptoPP::word32>(false, CryptoPP::BIG_ENDIAN_ORDER, counter + 12, 2);
+        } else {
+            Resynchronize(message.nonce, static_cast<int>(message.nonceLength));
+            memcpy(counter, Gctr(m_ctr, 0).CounterBlock(), REQUIRED_BLOCKSIZE);
+        }
+
+        // GCM only increments the rightmost 32 bits of the counter
+        CryptoPP::word32 low = CryptoPP::GetWord<CryptoPP::word32>(false, CryptoPP::BIG_ENDIAN_ORDER, counter + 12);
+
+        for (size_t j = 1; j < messageBlocks; j++) {
+            memcpy(counter + REQUIRED_BLOCKSIZE * j, counter, 12);
+            CryptoPP::PutWord<CryptoPP::word32>(false, CryptoPP::BIG_ENDIAN_ORDER, counter + REQUIRED_BLOCKSIZE * j + 12, low + static_cast<CryptoPP::word32>(j));
+        }
+
+        counter += REQUIRED_BLOCKSIZE * messageBlocks;
+    }
+
+    if (blocks > 0) {
+        m_cipher->AdvancedProcessBlocks(keystream, NULL, keystream, keystream.size(), CryptoPP::BlockTransformation::BT_AllowParallel);
+    }
+
+    // GHASH is computed message by message, on the ciphertext
+    const byte *messageKeystream = keystream;
+    byte digest[REQUIRED_BLOCKSIZE];
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message = messages[i];
+        Resynchronize(message.nonce, static_cast<int>(message.nonceLength));
+
+        if (message.aadLength > 0) {
+            Update(message.aad, message.aadLength);
+        }
+
+        // authenticates the last additional data block
+        CryptoPP::GCM_Base::ProcessData(message.output, message.input, 0);
+
+        if (State_AuthUntransformed == m_state) {
+            AuthenticateData(message.input, message.length);
+        }
+
+        CryptoPP::xorbuf(message.output, message.input, messageKeystream, message.length);
+
+        if (State_AuthTransformed == m_state) {
+            AuthenticateData(message.output, message.length);
+        }
+
+        m_totalMessageLength   += message.length;
+        messageKeystream       += REQUIRED_BLOCKSIZE * ((message.length + REQUIRED_BLOCKSIZE - 1) / REQUIRED_BLOCKSIZE);
+
+        if (IsForwardTransformation()) {
+            Final(message.digest);
+            message.valid = true;
+        } else {
+            Final(digest);
+            message.valid = CryptoPP::VerifyBufsEqual(digest, message.digest, DigestSize());
+
+            if (!message.valid) {
+                memset(message.output, 0, message.length);
+            }
+        }
+    }
+}
 /* }}} */
 
 /* {{{ arginfo */
-ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherGcm_construct, 0)
+ZEND_BEGIN_ARG_INFO_EX(arginfo_AuthenticatedSymmetricCipherGcm_construct, 0, 0, 1)
     ZEND_ARG_OBJ_INFO(0, cipher, Cryptopp\\BlockCipherInterface, 0)
+    ZEND_ARG_INFO(0, tableSize)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherGcm_getTableSize, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherGcm_setParallelThreshold, 0)
+    ZEND_ARG_INFO(0, threshold)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherGcm_getParallelThreshold, 0)
 ZEND_END_ARG_INFO()
 /* }}} */
 
@@ -41,22 +355,39 @@ zend_class_entry *cryptopp_ce_AuthenticatedSymmetricCipherGcm;
 
 static zend_function_entry cryptopp_methods_AuthenticatedSymmetricCipherGcm[] = {
     PHP_ME(Cryptopp_AuthenticatedSymmetricCipherGcm, __construct, arginfo_AuthenticatedSymmetricCipherGcm_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherGcm, getTableSize, arginfo_AuthenticatedSymmetricCipherGcm_getTableSize, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherGcm, setParallelThreshold, arginfo_AuthenticatedSymmetricCipherGcm_setParallelThreshold, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherGcm, getParallelThreshold, arginfo_AuthenticatedSymmetricCipherGcm_getParallelThreshold, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
 void init_class_AuthenticatedSymmetricCipherGcm(TSRMLS_D) {
     init_class_AuthenticatedSymmetricCipherAbstractChild("gcm", "AuthenticatedSymmetricCipherGcm", &cryptopp_ce_AuthenticatedSymmetricCipherGcm, cryptopp_methods_AuthenticatedSymmetricCipherGcm TSRMLS_CC);
+    zend_declare_property_long(cryptopp_ce_AuthenticatedSymmetricCipherGcm, "tableSize", 9, 2048, ZEND_ACC_PRIVATE TSRMLS_CC);
 }
 /* }}} */
 
-/* {{{ proto AuthenticatedSymmetricCipherGcm::__construct(Cryptopp\BlockCipherInterface cipher) */
+/* {{{ proto AuthenticatedSymmetricCipherGcm::__construct(Cryptopp\BlockCipherInterface cipher [, int tableSize = 2048]) */
 PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, __construct) {
     zval *cipherObject;
+    long tableSize = 2048;
 
-    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "O", &cipherObject, cryptopp_ce_BlockCipherInterface)) {
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "O|l", &cipherObject, cryptopp_ce_BlockCipherInterface, &tableSize)) {
         return;
     }
 
+    // GHASH multiplication table, computed once per key and copied to the other direction. 64K tables are faster without CLMUL
+    CryptoPP::GCM_TablesOption tablesOption;
+
+    if (2048 == tableSize) {
+        tablesOption = CryptoPP::GCM_2K_Tables;
+    } else if (65536 == tableSize) {
+        tablesOption = CryptoPP::GCM_64K_Tables;
+    } else {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\AuthenticatedSymmetricCipherGcm : table size must be 2048 or 65536, %ld given", tableSize);
+        RETURN_NULL()
+    }
+
     // get needed cipher elements
     CryptoPP::BlockCipher *cipherEncryptor;
     CryptoPP::BlockCipher *cipherDecryptor;
@@ -78,19 +409,71 @@ PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, __construct) {
     }
 
     // instanciate authenticated cipher encryptor/decryptor
-    GCM::Encryption *encryptor = new GCM::Encryption(cipherEncryptor, cipherMustBeDestructed);
-    GCM::Decryption *decryptor = new GCM::Decryption(cipherEncryptor, false);
+    GCM::Encryption *encryptor = new GCM::Encryption(cipherEncryptor, cipherMustBeDestructed, tablesOption TSRMLS_CC);
+    GCM::Decryption *decryptor = new GCM::Decryption(cipherEncryptor, false, tablesOption TSRMLS_CC);
+    encryptor->SetSibling(decryptor);
+    decryptor->SetSibling(encryptor);
+
+    if (!cipherMustBeDestructed) {
+        encryptor->EnableKeyScheduleCache();
+        decryptor->EnableKeyScheduleCache();
+    }
+
     setCryptoppAuthenticatedSymmetricCipherEncryptorPtr(getThis(), encryptor TSRMLS_CC);
     setCryptoppAuthenticatedSymmetricCipherDecryptorPtr(getThis(), decryptor TSRMLS_CC);
 
     zend_update_property_stringl(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "name", 4, authenticatedCipherName->c_str(), authenticatedCipherName->length() TSRMLS_CC);
     delete authenticatedCipherName;
 
+    zend_update_property_long(cryptopp_ce_AuthenticatedSymmetricCipherGcm, getThis(), "tableSize", 9, tableSize TSRMLS_CC);
+
     // hold the cipher object. if not, it can be deleted and associated encryptor/decryptor objects will be deleted too
     zend_update_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, cipherObject TSRMLS_CC);
 }
 /* }}} */
 
+/* {{{ proto int AuthenticatedSymmetricCipherGcm::getTableSize(void)
+   Returns the size of the GHASH multiplication table, in bytes */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, getTableSize) {
+    zval *tableSize = zend_read_property(cryptopp_ce_AuthenticatedSymmetricCipherGcm, getThis(), "tableSize", 9, 1 TSRMLS_CC);
+    RETURN_ZVAL(tableSize, 1, 0)
+}
+/* }}} */
+
+/* {{{ proto void AuthenticatedSymmetricCipherGcm::setParallelThreshold(int threshold)
+   Sets the data size from which encryption and decryption are split between several threads. 0 disables multi-threading */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, setParallelThreshold) {
+    long threshold;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &threshold)) {
+        return;
+    }
+
+    if (threshold < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: threshold cannot be negative", cryptopp_ce_AuthenticatedSymmetricCipherGcm->name);
+        RETURN_FALSE
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher *encryptor;
+    CryptoPP::AuthenticatedSymmetricCipher *decryptor;
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    dynamic_cast<GCM::Base*>(encryptor)->SetParallelThreshold(threshold);
+    dynamic_cast<GCM::Base*>(decryptor)->SetParallelThreshold(threshold);
+}
+/* }}} */
+
+/* {{{ proto int AuthenticatedSymmetricCipherGcm::getParallelThreshold(void)
+   Returns the data size from which encryption and decryption are split between several threads */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, getParallelThreshold) {
+    CryptoPP::AuthenticatedSymmetricCipher *encryptor;
+    CRYPTOPP_AUTHENTICATED_SYMMETRIC_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+
+    RETURN_LONG(dynamic_cast<GCM::Base*>(encryptor)->GetParallelThreshold())
+}
+/* }}} */
+
 /*
  * Local variables:
  * tab-width: 4
@@ -11,31 +11,71 @@
 #define PHP_AUTHENTICATED_SYMMETRIC_CIPHER_GCM_H
 
 #include "src/php_cryptopp.h"
+#include "authenticated_symmetric_cipher_message_batch.h"
 #include <gcm.h>
 
 void init_class_AuthenticatedSymmetricCipherGcm(TSRMLS_D);
 PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, __construct);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, getTableSize);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, setParallelThreshold);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherGcm, getParallelThreshold);
 
 /* {{{ fork of CryptoPP::GCM that take a cipher as parameter instead of a template parameter */
 class GCM
 {
 public:
     /* {{{ base class */
-    class Base : public CryptoPP::GCM_Base
+    class Base : public CryptoPP::GCM_Base, public AuthenticatedSymmetricCipherMessageBatch
     {
     public:
         ~Base();
         static std::string StaticAlgorithmName() {return std::string("GCM");}
 
+        // only for native ciphers. hash key and multiplication table are then taken from KeyScheduleCache
+        void EnableKeyScheduleCache() {m_keyScheduleCacheEnabled = true;}
+
+        // the other direction of the same php object. when it is already keyed with the same key,
+        // its hash key and multiplication table are copied instead of being computed again
+        void SetSibling(Base *sibling) {m_sibling = sibling;}
+
+        // inputs larger than the parallel threshold have their keystream split in ranges of counter blocks, each one processed
+        // by its own thread with a copy of the native block cipher, while the calling thread computes GHASH.
+        // user block ciphers are always processed by the calling thread
+        void ProcessData(byte *outString, const byte *inString, size_t length);
+        void SetParallelThreshold(size_t threshold) {m_parallelThreshold = threshold;}
+        size_t GetParallelThreshold() const {return m_parallelThreshold;}
+
+        // the keystream of small messages is generated by a single call to the block cipher, then each message is hashed
+        bool NeedsWholeMessages() const {return false;}
+        void ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count);
+
+        /* {{{ copy of the counter mode of a GCM object, moved forward by a number of blocks */
+        class Gctr : public GCTR
+        {
+        public:
+            Gctr(const GCTR &ctr, CryptoPP::lword blocks);
+            void UseCipher(CryptoPP::BlockCipher *cipher) {m_cipher = cipher;}
+            const byte *CounterBlock() const {return m_counterArray;}
+        };
+        /* }}} */
+
     protected:
-        Base(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed);
+        Base(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed, CryptoPP::GCM_TablesOption tablesOption TSRMLS_DC);
+        void SetKeyWithoutResync(const byte *userKey, size_t keylength, const CryptoPP::NameValuePairs &params);
 
     private:
-        CryptoPP::GCM_TablesOption GetTablesOption() const {return CryptoPP::GCM_2K_Tables;}
+        CryptoPP::GCM_TablesOption GetTablesOption() const {return m_tablesOption;}
+        bool LoadSiblingTables(const byte *userKey, size_t keylength, const CryptoPP::NameValuePairs &params);
         CryptoPP::BlockCipher & AccessBlockCipher() {return *m_cipher;}
+        void ProcessMessageGroup(AuthenticatedSymmetricCipherMessage *messages, size_t count);
 
+        size_t m_parallelThreshold;
         bool m_cipherMustBeDestructed;
+        bool m_keyScheduleCacheEnabled;
+        CryptoPP::GCM_TablesOption m_tablesOption;
+        Base *m_sibling;
         CryptoPP::BlockCipher *m_cipher;
+        M_TSRMLS_D;
     };
     /* }}} */
 
@@ -43,7 +83,7 @@ public:
     class Encryption : public Base
     {
     public:
-        Encryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed) : Base(cipher, cipherMustBeDestructed){};
+        Encryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed, CryptoPP::GCM_TablesOption tablesOption TSRMLS_DC) : Base(cipher, cipherMustBeDestructed, tablesOption TSRMLS_CC){};
         bool IsForwardTransformation() const {return true;}
     };
     /* }}} */
@@ -52,7 +92,7 @@ public:
     class Decryption : public Base
     {
     public:
-        Decryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed) : Base(cipher, cipherMustBeDestructed){};
+        Decryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed, CryptoPP::GCM_TablesOption tablesOption TSRMLS_DC) : Base(cipher, cipherMustBeDestructed, tablesOption TSRMLS_CC){};
         bool IsForwardTransformation() const {return false;}
     };
     /* }}} */
@@ -0,0 +1,544 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/symmetric/cipher/block/php_block_cipher_interface.h"
+#include "php_authenticated_symmetric_cipher_abstract.h"
+#include "php_ocb.h"
+#include <zend_exceptions.h>
+#include <misc.h>
+
+/* {{{ ocbDouble
+   multiplication by x in GF(2^128) */
+static inline void ocbDouble(byte *output, const byte *input)
+{
+    byte carry = input[0] >> 7;
+
+    for (int i = 0; i < 15; i++) {
+        output[i] = (input[i] << 1) | (input[i + 1] >> 7);
+    }
+
+    output[15] = (input[15] << 1) ^ (carry * 0x87);
+}
+/* }}} */
+
+/* {{{ ocbNtz
+   number of trailing zeros of a block index */
+static inline unsigned int ocbNtz(CryptoPP::word64 i)
+{
+    unsigned int n = 0;
+
+    while (0 == (i & 1)) {
+        i >>= 1;
+        n++;
+    }
+
+    return n;
+}
+/* }}} */
+
+/* {{{ OCB3 authenticated encryption mode of RFC 7253 */
+OCB::Base::Base(CryptoPP::BlockCipher *cipher, CryptoPP::BlockCipher *inverseCipher, bool cipherMustBeDestructed, bool inverseCipherMustBeDestructed TSRMLS_DC)
+    : m_state(State_Start)
+    , m_cipherMustBeDestructed(cipherMustBeDestructed)
+    , m_inverseCipherMustBeDestructed(inverseCipherMustBeDestructed)
+    , m_cipher(cipher)
+    , m_inverseCipher(inverseCipher)
+    , m_ktopValid(false)
+    , m_aadBufferedLength(0)
+    , m_blockIndex(0)
+    , m_aadBlockIndex(0)
+{
+    SET_M_TSRMLS_C()
+}
+
+OCB::Base::~Base()
+{
+    if (m_cipherMustBeDestructed) {
+        delete m_cipher;
+    }
+
+    if (m_inverseCipherMustBeDestructed) {
+        delete m_inverseCipher;
+    }
+}
+
+void OCB::Base::UncheckedSetKey(const byte *userKey, unsigned int keylength, const CryptoPP::NameValuePairs &params)
+{
+    m_state = State_Start;
+    m_cipher->SetKey(userKey, keylength, params);
+
+    if (NULL != m_inverseCipher) {
+        m_inverseCipher->SetKey(userKey, keylength, params);
+    }
+
+    // L_* = E(0^128), L_$ = double(L_*), L_0 = double(L_$), L_i = double(L_i-1)
+    memset(m_l, 0, 16);
+    m_cipher->ProcessBlock(m_l);
+
+    for (unsigned int i = 1; i < 66; i++) {
+        ocbDouble(m_l + 16 * i, m_l + 16 * (i - 1));
+    }
+
+    m_ktopValid = false;
+    m_state     = State_KeySet;
+
+    size_t ivLength;
+    const byte *iv = GetIVAndThrowIfInvalid(params, ivLength);
+
+    if (NULL != iv) {
+        Resynchronize(iv, static_cast<int>(ivLength));
+    }
+}
+
+void OCB::Base::Resynchronize(const byte *iv, int ivLength)
+{
+    if (m_state < State_KeySet) {
+        throw CryptoPP::BadState(AlgorithmName(), "Resynchronize", "key is set");
+    }
+
+    size_t length = ThrowIfInvalidIVLength(ivLength);
+
+    // nonce = 0^7 (taglen mod 128) || 0* || 1 || iv
+    byte nonce[16];
+    memset(nonce, 0, sizeof(nonce));
+    nonce[15 - length] = 1;
+    memcpy(nonce + 16 - length, iv, length);
+
+    unsigned int bottom = nonce[15] & 0x3f;
+    nonce[15]          &= 0xc0;
+
+    // Ktop only depends on the upper bits of the nonce, so it is shared by 64 consecutive counter based nonces
+    if (!m_ktopValid || 0 != memcmp(nonce, m_ktopNonce, 16)) {
+        memcpy(m_ktopNonce, nonce, 16);
+        m_cipher->ProcessBlock(m_ktopNonce, m_ktop);
+        m_ktopValid = true;
+    }
+
+    // stretch = Ktop || (Ktop[1..64] xor Ktop[9..72]), and Offset_0 = stretch[1+bottom..128+bottom]
+    byte stretch[24];
+    memcpy(stretch, m_ktop, 16);
+
+    for (int i = 0; i < 8; i++) {
+        stretch[16 + i] = m_ktop[i] ^ m_ktop[i + 1];
+    }
+
+    unsigned int byteShift  = bottom / 8;
+    unsigned int bitShift   = bottom % 8;
+
+    for (int i = 0; i < 16; i++) {
+        m_offset[i] = stretch[i + byteShift] << bitShift;
+
+        if (bitShift > 0) {
+            m_offset[i] |= stretch[i + byteShift + 1] >> (8 - bitShift);
+        }
+    }
+
+    memset(m_checksum, 0, 16);
+    memset(m_aadOffset, 0, 16);
+    memset(m_aadSum, 0, 16);
+    m_aadBufferedLength = 0;
+    m_blockIndex        = 0;
+    m_aadBlockIndex     = 0;
+    m_state             = State_IVSet;
+}
+
+void OCB::Base::AuthenticateBlocks(const byte *data, size_t length)
+{
+    // Sum = Sum xor E(A_i xor Offset_i), with up to PARALLEL_BLOCKS blocks encrypted by a single call
+    while (length > 0) {
+        size_t chunkLength  = CryptoPP::STDMIN(length, m_offsets.size());
+        size_t blockCount   = chunkLength / 16;
+
+        for (size_t i = 0; i < blockCount; i++) {
+            CryptoPP::xorbuf(m_aadOffset, L(ocbNtz(++m_aadBlockIndex)), 16);
+            CryptoPP::xorbuf(m_offsets + 16 * i, data + 16 * i, m_aadOffset, 16);
+        }
+
+        m_cipher->AdvancedProcessBlocks(m_offsets, NULL, m_offsets, chunkLength, CryptoPP::BlockTransformation::BT_AllowParallel);
+
+        for (size_t i = 0; i < blockCount; i++) {
+            CryptoPP::xorbuf(m_aadSum, m_offsets + 16 * i, 16);
+        }
+
+        data   += chunkLength;
+        length -= chunkLength;
+    }
+}
+
+void OCB::Base::Update(const byte *input, size_t length)
+{
+    if (m_state < State_IVSet) {
+        throw CryptoPP::BadState(AlgorithmName(), "Update", "setting key and IV");
+    } else if (m_state > State_IVSet) {
+        throw CryptoPP::BadState(AlgorithmName(), "Update was called after message input has started");
+    }
+
+    if (m_aadBufferedLength > 0) {
+        size_t count = CryptoPP::STDMIN(length, static_cast<size_t>(16 - m_aadBufferedLength));
+        memcpy(m_aadBuffer + m_aadBufferedLength, input, count);
+        m_aadBufferedLength += count;
+        input               += count;
+        length              -= count;
+
+        if (m_aadBufferedLength < 16) {
+            return;
+        }
+
+        AuthenticateBlocks(m_aadBuffer, 16);
+        m_aadBufferedLength = 0;
+    }
+
+    size_t blocksLength = length & ~static_cast<size_t>(15);
+    AuthenticateBlocks(input, blocksLength);
+
+    memcpy(m_aadBuffer, input + blocksLength, length - blocksLength);
+    m_aadBufferedLength = length - blocksLength;
+}
+
+void OCB::Base::ProcessBlocks(byte *outString, const byte *inString, size_t length)
+{
+    // C_i = Offset_i xor E(P_i xor Offset_i). offsets are computed first, so that the block cipher can process
+    // up to PARALLEL_BLOCKS independent blocks at once
+    while (length > 0) {
+        size_t chunkLength  = CryptoPP::STDMIN(length, m_offsets.size());
+        size_t blockCount   = chunkLength / 16;
+
+        for (size_t i = 0; i < blockCount; i++) {
+            CryptoPP::xorbuf(m_offset, L(ocbNtz(++m_blockIndex)), 16);
+            memcpy(m_offsets + 16 * i, m_offset, 16);
+        }
+
+        if (IsForwardTransformation()) {
+            for (size_t i = 0; i < blockCount; i++) {
+                CryptoPP::xorbuf(m_checksum, inString + 16 * i, 16);
+            }
+
+            CryptoPP::xorbuf(outString, inString, m_offsets, chunkLength);
+            m_cipher->AdvancedProcessBlocks(outString, m_offsets, outString, chunkLength, CryptoPP::BlockTransformation::BT_AllowParallel);
+        } else {
+            CryptoPP::xorbuf(outString, inString, m_offsets, chunkLength);
+            m_inverseCipher->AdvancedProcessBlocks(outString, m_offsets, outString, chunkLength, CryptoPP::BlockTransformation::BT_AllowParallel);
+
+            for (size_t i = 0; i < blockCount; i++) {
+                CryptoPP::xorbuf(m_checksum, outString + 16 * i, 16);
+            }
+        }
+
+        inString  += chunkLength;
+        outString += chunkLength;
+        length    -= chunkLength;
+    }
+}
+
+void OCB::Base::ProcessData(byte *outString, const byte *inString, size_t length)
+{
+    if (m_state < State_IVSet) {
+        throw CryptoPP::BadState(AlgorithmName(), "ProcessData", "setting key and IV");
+    } else if (0 == length) {
+        return;
+    } else if (State_LastBlock == m_state) {
+        // a partial block is the last block of the message: it is encrypted differently than a full block
+        zend_throw_exception_ex(getCryptoppException(), 0 M_TSRMLS_CC, (char*)"Cryptopp\\AuthenticatedSymmetricCipherOcb : data must be processed by multiples of 16 bytes, only the last part of a message can be shorter");
+        throw false;
+    }
+
+    m_state = State_Message;
+
+    size_t blocksLength = length & ~static_cast<size_t>(15);
+    ProcessBlocks(outString, inString, blocksLength);
+
+    if (blocksLength == length) {
+        return;
+    }
+
+    // Offset_* = Offset_m xor L_*, C_* = P_* xor E(Offset_*), and Checksum_* = Checksum_m xor (P_* || 1 || 0*)
+    size_t lastLength = length - blocksLength;
+    inString         += blocksLength;
+    outString        += blocksLength;
+
+    byte pad[16];
+    CryptoPP::xorbuf(m_offset, LStar(), 16);
+    m_cipher->ProcessBlock(m_offset, pad);
+
+    if (IsForwardTransformation()) {
+        CryptoPP::xorbuf(m_checksum, inString, lastLength);
+        CryptoPP::xorbuf(outString, inString, pad, lastLength);
+    } else {
+        CryptoPP::xorbuf(outString, inString, pad, lastLength);
+        CryptoPP::xorbuf(m_checksum, outString, lastLength);
+    }
+
+    m_checksum[lastLength] ^= 0x80;
+    m_state                 = State_LastBlock;
+}
+
+void OCB::Base::TruncatedFinal(byte *mac, size_t macSize)
+{
+    ThrowIfInvalidTruncatedSize(macSize);
+
+    if (m_state < State_IVSet) {
+        throw CryptoPP::BadState(AlgorithmName(), "TruncatedFinal", "setting key and IV");
+    }
+
+    // the last partial block of aad is padded with 1 || 0*
+    if (m_aadBufferedLength > 0) {
+        m_aadBuffer[m_aadBufferedLength] = 0x80;
+        memset(m_aadBuffer + m_aadBufferedLength + 1, 0, 16 - m_aadBufferedLength - 1);
+        CryptoPP::xorbuf(m_aadOffset, LStar(), 16);
+        CryptoPP::xorbuf(m_aadBuffer, m_aadOffset, 16);
+        m_cipher->ProcessBlock(m_aadBuffer);
+        CryptoPP::xorbuf(m_aadSum, m_aadBuffer, 16);
+        m_aadBufferedLength = 0;
+    }
+
+    // Tag = E(Checksum xor Offset xor L_$) xor HASH(K, A)
+    CryptoPP::xorbuf(m_checksum, m_offset, 16);
+    CryptoPP::xorbuf(m_checksum, LDollar(), 16);
+    m_cipher->ProcessBlock(m_checksum);
+    CryptoPP::xorbuf(m_checksum, m_aadSum, 16);
+    memcpy(mac, m_checksum, macSize);
+
+    m_state = State_KeySet;
+}
+
+void OCB::Base::ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count)
+{
+    size_t first = 0;
+
+    while (first < count) {
+        // consecutive small messages are grouped until their blocks reach the batch size
+        size_t last = first;
+        size_t size = 0;
+
+        while (last < count && messages[last].aadLength + messages[last].length <= AUTHENTICATED_SYMMETRIC_CIPHER_BATCH_MESSAGE_SIZE) {
+            size_t messageSize = 16 * ((messages[last].aadLength + 15) / 16 + messages[last].length / 16 + 1);
+
+            if (last > first && size + messageSize > AUTHENTICATED_SYMMETRIC_CIPHER_BATCH_SIZE) {
+                break;
+            }
+
+            size += messageSize;
+            last++;
+        }
+
+        if (last == first) {
+            processAuthenticatedSymmetricCipherMessage(*this, messages[first]);
+            first++;
+        } else {
+            ProcessMessageGroup(messages + first, last - first);
+            first = last;
+        }
+    }
+}
+
+void OCB::Base::ProcessMessageGroup(AuthenticatedSymmetricCipherMessage *messages, size_t count)
+{
+    bool encryption     = IsForwardTransformation();
+    size_t hashBlocks   = 0;
+    size_t dataBlocks   = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        hashBlocks += (messages[i].aadLength + 15) / 16 + (0 == messages[i].length % 16 ? 0 : 1);
+        dataBlocks += messages[i].length / 16;
+    }
+
+    // aad blocks and pads of last partial blocks are encrypted by the cipher, full message blocks by the cipher or the
+    // inverse cipher. each kind of block of all messages is passed to the block cipher at once
+    CryptoPP::SecByteBlock hash(16 * hashBlocks);
+    CryptoPP::SecByteBlock data(16 * dataBlocks);
+    CryptoPP::SecByteBlock dataOffsets(16 * dataBlocks);
+    CryptoPP::SecByteBlock offsets(16 * count);
+    CryptoPP::SecByteBlock tags(16 * count);
+    CryptoPP::SecByteBlock aadSums(16 * count);
+    byte *hashBlock = hash;
+    byte *dataBlock = data;
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message = messages[i];
+        Resynchronize(message.nonce, static_cast<int>(message.nonceLength));
+
+        // A_i xor Offset_i, and (A_* || 1 || 0*) xor Offset_*
+        size_t aadBlocksLength = message.aadLength & ~static_cast<size_t>(15);
+
+        for (size_t j = 0; j < aadBlocksLength; j += 16, hashBlock += 16) {
+            CryptoPP::xorbuf(m_aadOffset, L(ocbNtz(++m_aadBlockIndex)), 16);
+            CryptoPP::xorbuf(hashBlock, message.aad + j, m_aadOffset, 16);
+        }
+
+        if (aadBlocksLength < message.aadLength) {
+            size_t lastLength = message.aadLength - aadBlocksLength;
+            CryptoPP::xorbuf(m_aadOffset, LStar(), 16);
+            memcpy(hashBlock, m_aadOffset, 16);
+            CryptoPP::xorbuf(hashBlock, message.aad + aadBlocksLength, lastLength);
+            hashBlock[lastLength] ^= 0x80;
+            hashBlock += 16;
+        }
+
+        // P_i xor Offset_i, or C_i xor Offset_i
+        size_t blocksLength = message.length & ~static_cast<size_t>(15);
+
+        for (size_t j = 0; j < blocksLength; j += 16, dataBlock += 16) {
+            CryptoPP::xorbuf(m_offset, L(ocbNtz(++m_blockIndex)), 16);
+            memcpy(dataOffsets + (dataBlock - data), m_offset, 16);
+            CryptoPP::xorbuf(dataBlock, message.input + j, m_offset, 16);
+
+            if (encryption) {
+                CryptoPP::xorbuf(m_checksum, message.input + j, 16);
+            }
+        }
+
+        // the pad of the last partial block is E(Offset_*)
+        if (blocksLength < message.length) {
+            CryptoPP::xorbuf(m_offset, LStar(), 16);
+            memcpy(hashBlock, m_offset, 16);
+            hashBlock += 16;
+        }
+
+        memcpy(offsets + 16 * i, m_offset, 16);
+        memcpy(tags + 16 * i, m_checksum, 16);
+    }
+
+    if (hashBlocks > 0) {
+        m_cipher->AdvancedProcessBlocks(hash, NULL, hash, hash.size(), CryptoPP::BlockTransformation::BT_AllowParallel);
+    }
+
+    if (dataBlocks > 0) {
+        CryptoPP::BlockCipher *cipher = encryption ? m_cipher : m_inverseCipher;
+        cipher->AdvancedProcessBlocks(data, dataOffsets, data, data.size(), CryptoPP::BlockTransformation::BT_AllowParallel);
+    }
+
+    hashBlock = hash;
+    dataBlock = data;
+    memset(aadSums, 0, aadSums.size());
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message    = messages[i];
+        byte *checksum                                  = tags + 16 * i;
+        size_t aadBlocks                                = (message.aadLength + 15) / 16;
+        size_t blocksLength                             = message.length & ~static_cast<size_t>(15);
+
+        for (size_t j = 0; j < aadBlocks; j++, hashBlock += 16) {
+            CryptoPP::xorbuf(aadSums + 16 * i, hashBlock, 16);
+        }
+
+        memcpy(message.output, dataBlock, blocksLength);
+        dataBlock += blocksLength;
+
+        if (!encryption) {
+            for (size_t j = 0; j < blocksLength; j += 16) {
+                CryptoPP::xorbuf(checksum, message.output + j, 16);
+            }
+        }
+
+        if (blocksLength < message.length) {
+            size_t lastLength = message.length - blocksLength;
+            CryptoPP::xorbuf(message.output + blocksLength, message.input + blocksLength, hashBlock, lastLength);
+            CryptoPP::xorbuf(checksum, encryption ? message.input + blocksLength : message.output + blocksLength, lastLength);
+            checksum[lastLength] ^= 0x80;
+            hashBlock += 16;
+        }
+
+        // Checksum xor Offset xor L_$
+        CryptoPP::xorbuf(checksum, offsets + 16 * i, 16);
+        CryptoPP::xorbuf(checksum, LDollar(), 16);
+    }
+
+    // Tag = E(Checksum xor Offset xor L_$) xor HASH(K, A)
+    m_cipher->AdvancedProcessBlocks(tags, aadSums, tags, tags.size(), CryptoPP::BlockTransformation::BT_AllowParallel);
+
+    for (size_t i = 0; i < count; i++) {
+        AuthenticatedSymmetricCipherMessage &message = messages[i];
+
+        if (encryption) {
+            memcpy(message.digest, tags + 16 * i, 16);
+            message.valid = true;
+        } else {
+            message.valid = CryptoPP::VerifyBufsEqual(tags + 16 * i, message.digest, 16);
+
+            if (!message.valid) {
+                memset(message.output, 0, message.length);
+            }
+        }
+    }
+
+    m_state = State_KeySet;
+}
+/* }}} */
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_AuthenticatedSymmetricCipherOcb_construct, 0)
+    ZEND_ARG_OBJ_INFO(0, cipher, Cryptopp\\BlockCipherInterface, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_AuthenticatedSymmetricCipherOcb;
+
+static zend_function_entry cryptopp_methods_AuthenticatedSymmetricCipherOcb[] = {
+    PHP_ME(Cryptopp_AuthenticatedSymmetricCipherOcb, __construct, arginfo_AuthenticatedSymmetricCipherOcb_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_FE_END
+};
+
+void init_class_AuthenticatedSymmetricCipherOcb(TSRMLS_D) {
+    init_class_AuthenticatedSymmetricCipherAbstractChild("ocb", "AuthenticatedSymmetricCipherOcb", &cryptopp_ce_AuthenticatedSymmetricCipherOcb, cryptopp_methods_AuthenticatedSymmetricCipherOcb TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto AuthenticatedSymmetricCipherOcb::__construct(Cryptopp\BlockCipherInterface cipher) */
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherOcb, __construct) {
+    zval *cipherObject;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "O", &cipherObject, cryptopp_ce_BlockCipherInterface)) {
+        return;
+    }
+
+    // get needed cipher elements
+    CryptoPP::BlockCipher *cipherEncryptor;
+    CryptoPP::BlockCipher *cipherDecryptor;
+    std::string *authenticatedCipherName;
+    bool cipherMustBeDestructed;
+
+    if (!cryptoppAuthenticatedSymmetricCipherGetCipherElements("ocb", cipherObject, getThis(), &cipherEncryptor, &cipherDecryptor, &authenticatedCipherName, cipherMustBeDestructed TSRMLS_CC)) {
+        RETURN_NULL()
+    } else if (16 != cipherEncryptor->BlockSize()) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\AuthenticatedSymmetricCipherOcb require a block cipher with a block size of 128 bits (16 bytes)");
+
+        if (cipherMustBeDestructed) {
+            delete cipherEncryptor;
+            delete cipherDecryptor;
+        }
+
+        delete authenticatedCipherName;
+        RETURN_NULL()
+    }
+
+    // instanciate authenticated cipher encryptor/decryptor. unlike other modes, decryption needs the inverse cipher
+    OCB::Encryption *encryptor = new OCB::Encryption(cipherEncryptor, cipherMustBeDestructed TSRMLS_CC);
+    OCB::Decryption *decryptor = new OCB::Decryption(cipherEncryptor, cipherDecryptor, cipherMustBeDestructed TSRMLS_CC);
+    setCryptoppAuthenticatedSymmetricCipherEncryptorPtr(getThis(), encryptor TSRMLS_CC);
+    setCryptoppAuthenticatedSymmetricCipherDecryptorPtr(getThis(), decryptor TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "name", 4, authenticatedCipherName->c_str(), authenticatedCipherName->length() TSRMLS_CC);
+    delete authenticatedCipherName;
+
+    // hold the cipher object. if not, it can be deleted and associated encryptor/decryptor objects will be deleted too
+    zend_update_property(cryptopp_ce_AuthenticatedSymmetricCipherAbstract, getThis(), "cipher", 6, cipherObject TSRMLS_CC);
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,129 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_AUTHENTICATED_SYMMETRIC_CIPHER_OCB_H
+#define PHP_AUTHENTICATED_SYMMETRIC_CIPHER_OCB_H
+
+#include "src/php_cryptopp.h"
+#include "authenticated_symmetric_cipher_message_batch.h"
+#include <cryptlib.h>
+#include <secblock.h>
+
+void init_class_AuthenticatedSymmetricCipherOcb(TSRMLS_D);
+PHP_METHOD(Cryptopp_AuthenticatedSymmetricCipherOcb, __construct);
+
+/* {{{ OCB3 authenticated encryption mode of RFC 7253, with 128 bits tags.
+   Crypto++ does not provide OCB, so it is not a fork: it is built directly on the block cipher */
+class OCB
+{
+public:
+    /* {{{ base class */
+    class Base : public CryptoPP::AuthenticatedSymmetricCipher, public AuthenticatedSymmetricCipherMessageBatch
+    {
+    public:
+        ~Base();
+        static std::string StaticAlgorithmName() {return std::string("OCB");}
+        std::string AlgorithmName() const {return m_cipher->AlgorithmName() + std::string("/OCB");}
+        size_t MinKeyLength() const {return m_cipher->MinKeyLength();}
+        size_t MaxKeyLength() const {return m_cipher->MaxKeyLength();}
+        size_t DefaultKeyLength() const {return m_cipher->DefaultKeyLength();}
+        size_t GetValidKeyLength(size_t n) const {return m_cipher->GetValidKeyLength(n);}
+        bool IsValidKeyLength(size_t n) const {return m_cipher->IsValidKeyLength(n);}
+        IV_Requirement IVRequirement() const {return UNIQUE_IV;}
+        unsigned int IVSize() const {return 12;}
+        unsigned int MinIVLength() const {return 1;}
+        unsigned int MaxIVLength() const {return 15;}
+        unsigned int DigestSize() const {return 16;}
+        CryptoPP::lword MaxHeaderLength() const {return CryptoPP::LWORD_MAX;}
+        CryptoPP::lword MaxMessageLength() const {return CryptoPP::LWORD_MAX;}
+        bool IsRandomAccess() const {return false;}
+        bool IsSelfInverting() const {return false;}
+
+        void Resynchronize(const byte *iv, int ivLength = -1);
+        void Restart() {if (m_state > State_KeySet) m_state = State_KeySet;}
+        void Update(const byte *input, size_t length);
+        void ProcessData(byte *outString, const byte *inString, size_t length);
+        void TruncatedFinal(byte *mac, size_t macSize);
+
+        // blocks of small messages are interleaved, so that the block cipher processes blocks of several messages at once
+        bool NeedsWholeMessages() const {return false;}
+        void ProcessMessages(AuthenticatedSymmetricCipherMessage *messages, size_t count);
+
+    protected:
+        Base(CryptoPP::BlockCipher *cipher, CryptoPP::BlockCipher *inverseCipher, bool cipherMustBeDestructed, bool inverseCipherMustBeDestructed TSRMLS_DC);
+        void UncheckedSetKey(const byte *userKey, unsigned int keylength, const CryptoPP::NameValuePairs &params);
+
+    private:
+        enum State {State_Start, State_KeySet, State_IVSet, State_Message, State_LastBlock};
+
+        // number of blocks whose offsets are computed before they are passed to the block cipher at once
+        static const unsigned int PARALLEL_BLOCKS = 32;
+
+        // L_*, L_$ and L_0 to L_63
+        const byte *L(unsigned int i) const {return m_l + 16 * (i + 2);}
+        const byte *LStar() const {return m_l;}
+        const byte *LDollar() const {return m_l + 16;}
+
+        void ProcessBlocks(byte *outString, const byte *inString, size_t length);
+        void AuthenticateBlocks(const byte *data, size_t length);
+        void ProcessMessageGroup(AuthenticatedSymmetricCipherMessage *messages, size_t count);
+
+        State m_state;
+        bool m_cipherMustBeDestructed;
+        bool m_inverseCipherMustBeDestructed;
+        CryptoPP::BlockCipher *m_cipher;
+        CryptoPP::BlockCipher *m_inverseCipher;
+        CryptoPP::FixedSizeSecBlock<byte, 16 * 66> m_l;
+        CryptoPP::FixedSizeSecBlock<byte, 16 * PARALLEL_BLOCKS> m_offsets;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_ktopNonce;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_ktop;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_offset;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_checksum;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_aadOffset;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_aadSum;
+        CryptoPP::FixedSizeSecBlock<byte, 16> m_aadBuffer;
+        bool m_ktopValid;
+        unsigned int m_aadBufferedLength;
+        CryptoPP::word64 m_blockIndex;
+        CryptoPP::word64 m_aadBlockIndex;
+        M_TSRMLS_D;
+    };
+    /* }}} */
+
+    /* {{{ encryption class */
+    class Encryption : public Base
+    {
+    public:
+        Encryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed TSRMLS_DC) : Base(cipher, NULL, cipherMustBeDestructed, false TSRMLS_CC){};
+        bool IsForwardTransformation() const {return true;}
+    };
+    /* }}} */
+
+    /* {{{ decryption class
+       the inverse cipher is needed to decrypt message blocks. the cipher is still used for offsets, the last block and the tag */
+    class Decryption : public Base
+    {
+    public:
+        Decryption(CryptoPP::BlockCipher *cipher, CryptoPP::BlockCipher *inverseCipher, bool inverseCipherMustBeDestructed TSRMLS_DC) : Base(cipher, inverseCipher, false, inverseCipherMustBeDestructed TSRMLS_CC){};
+        bool IsForwardTransformation() const {return false;}
+    };
+    /* }}} */
+};
+/* }}} */
+
+#endif /* PHP_AUTHENTICATED_SYMMETRIC_CIPHER_OCB_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,168 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/exception/php_mac_verification_failed_exception.h"
+#include "src/mac/poly1305.h"
+#include "php_secret_box.h"
+#include <misc.h>
+#include <salsa.h>
+#include <secblock.h>
+#include <zend_exceptions.h>
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_SecretBox_seal, 0)
+    ZEND_ARG_INFO(0, key)
+    ZEND_ARG_INFO(0, nonce)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SecretBox_open, 0)
+    ZEND_ARG_INFO(0, key)
+    ZEND_ARG_INFO(0, nonce)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_SecretBox;
+
+static zend_function_entry cryptopp_methods_SecretBox[] = {
+    PHP_ME(Cryptopp_SecretBox, seal, arginfo_SecretBox_seal, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Cryptopp_SecretBox, open, arginfo_SecretBox_open, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_FE_END
+};
+
+void init_class_SecretBox(TSRMLS_D) {
+    zend_class_entry ce;
+    INIT_NS_CLASS_ENTRY(ce, "Cryptopp", "SecretBox", cryptopp_methods_SecretBox);
+    cryptopp_ce_SecretBox               = zend_register_internal_class(&ce TSRMLS_CC);
+    cryptopp_ce_SecretBox->ce_flags    |= ZEND_ACC_EXPLICIT_ABSTRACT_CLASS;
+}
+/* }}} */
+
+/* {{{ initSecretBoxCipher
+   keys the cipher and derives the one-time Poly1305 key from the first 32 bytes of the keystream.
+   the message is encrypted with the rest of the keystream, from the same position, as NaCl does */
+static void initSecretBoxCipher(CryptoPP::XSalsa20::Encryption &cipher, Poly1305 &mac, const byte *key, const byte *nonce) {
+    CryptoPP::FixedSizeSecBlock<byte, Poly1305::KEYLENGTH> macKey;
+    memset(macKey, 0, macKey.size());
+
+    cipher.SetKeyWithIV(key, 32, nonce, 24);
+    cipher.ProcessString(macKey, macKey.size());
+    mac.SetKey(macKey);
+}
+/* }}} */
+
+/* {{{ checkSecretBoxParameters
+   checks key and nonce lengths. returns false on failure */
+static bool checkSecretBoxParameters(int keySize, int nonceSize TSRMLS_DC) {
+    if (32 != keySize) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\SecretBox : %d is not a valid key length", keySize);
+        return false;
+    } else if (24 != nonceSize) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\SecretBox : %d is not a valid nonce length", nonceSize);
+        return false;
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ proto string SecretBox::seal(string key, string nonce, string data)
+   Encrypts and authenticates data with XSalsa20-Poly1305. The result is the 16 bytes tag followed by the ciphertext,
+   as produced by NaCl's crypto_secretbox_easy() */
+PHP_METHOD(Cryptopp_SecretBox, seal) {
+    char *key       = NULL;
+    int keySize     = 0;
+    char *nonce     = NULL;
+    int nonceSize   = 0;
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "sss", &key, &keySize, &nonce, &nonceSize, &data, &dataSize)) {
+        return;
+    }
+
+    if (!checkSecretBoxParameters(keySize, nonceSize TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    CryptoPP::XSalsa20::Encryption cipher;
+    Poly1305 mac;
+    initSecretBoxCipher(cipher, mac, reinterpret_cast<byte*>(key), reinterpret_cast<byte*>(nonce));
+
+    // the ciphertext is written after the tag, in the returned string
+    int outputSize  = Poly1305::DIGESTSIZE + dataSize;
+    byte *output    = reinterpret_cast<byte*>(emalloc(outputSize + 1));
+    output[outputSize] = '\0';
+
+    cipher.ProcessData(output + Poly1305::DIGESTSIZE, reinterpret_cast<byte*>(data), dataSize);
+    mac.Update(output + Poly1305::DIGESTSIZE, dataSize);
+    mac.Final(output);
+
+    RETURN_STRINGL(reinterpret_cast<char*>(output), outputSize, 0)
+}
+/* }}} */
+
+/* {{{ proto string SecretBox::open(string key, string nonce, string data)
+   Verifies and decrypts data produced by seal() or by NaCl's crypto_secretbox_easy().
+   Throws a CryptoppMacVerificationFailedException if the tag is not valid */
+PHP_METHOD(Cryptopp_SecretBox, open) {
+    char *key       = NULL;
+    int keySize     = 0;
+    char *nonce     = NULL;
+    int nonceSize   = 0;
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "sss", &key, &keySize, &nonce, &nonceSize, &data, &dataSize)) {
+        return;
+    }
+
+    if (!checkSecretBoxParameters(keySize, nonceSize TSRMLS_CC)) {
+        RETURN_FALSE
+    } else if (dataSize < static_cast<int>(Poly1305::DIGESTSIZE)) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\SecretBox : data must be at least %d bytes long", Poly1305::DIGESTSIZE);
+        RETURN_FALSE
+    }
+
+    CryptoPP::XSalsa20::Encryption cipher;
+    Poly1305 mac;
+    initSecretBoxCipher(cipher, mac, reinterpret_cast<byte*>(key), reinterpret_cast<byte*>(nonce));
+
+    // the ciphertext is authenticated before being decrypted
+    const byte *ciphertext  = reinterpret_cast<byte*>(data) + Poly1305::DIGESTSIZE;
+    int outputSize          = dataSize - Poly1305::DIGESTSIZE;
+    byte tag[Poly1305::DIGESTSIZE];
+    mac.Update(ciphertext, outputSize);
+    mac.Final(tag);
+
+    if (!CryptoPP::VerifyBufsEqual(tag, reinterpret_cast<byte*>(data), Poly1305::DIGESTSIZE)) {
+        zend_throw_exception_ex(getCryptoppMacVerificationFailedException(), 0 TSRMLS_CC, (char*)"Cryptopp\\SecretBox : MAC verification failed");
+        RETURN_FALSE
+    }
+
+    byte *output        = reinterpret_cast<byte*>(emalloc(outputSize + 1));
+    output[outputSize]  = '\0';
+    cipher.ProcessData(output, ciphertext, outputSize);
+
+    RETURN_STRINGL(reinterpret_cast<char*>(output), outputSize, 0)
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,214 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "aes_multi_key.h"
+#include <aes.h>
+#include <misc.h>
+#include <modes.h>
+#include <secblock.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#   define PHP_CRYPTOPP_AES_MULTI_KEY_AESNI 1
+#   include <cpuid.h>
+#   include <wmmintrin.h>
+#endif
+
+#ifdef PHP_CRYPTOPP_AES_MULTI_KEY_AESNI
+
+/* {{{ number of blocks processed together. AES-NI has a latency of several cycles per round,
+   8 independent blocks are enough to issue one round per cycle */
+#define AES_MULTI_KEY_LANES 8
+/* }}} */
+
+/* {{{ size of an expanded key schedule, in bytes */
+#define AES_MULTI_KEY_SCHEDULE_SIZE 240
+/* }}} */
+
+/* {{{ aesniIsAvailable
+   checks once if the CPU supports AES-NI */
+static bool aesniIsAvailable() {
+    static int available = -1;
+
+    if (-1 == available) {
+        unsigned int eax, ebx, ecx, edx;
+        available = (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES)) ? 1 : 0;
+    }
+
+    return 1 == available;
+}
+/* }}} */
+
+/* {{{ aesniExpandKey
+   FIPS 197 key expansion. round keys are stored in byte order, as expected by AES-NI. returns the number of rounds.
+   SubWord() is computed by AESKEYGENASSIST rather than with a table lookup indexed by key bytes, which would leak them
+   through cache timings */
+__attribute__((target("aes,sse2")))
+static unsigned int aesniExpandKey(const byte *key, size_t keyLength, byte *schedule) {
+    unsigned int nk         = keyLength / 4;
+    unsigned int rounds     = nk + 6;
+    unsigned int words      = 4 * (rounds + 1);
+    CryptoPP::word32 rcon   = 0x01;
+
+    memcpy(schedule, key, keyLength);
+
+    for (unsigned int i = nk; i < words; i++) {
+        CryptoPP::word32 temp;
+        memcpy(&temp, schedule + 4 * (i - 1), 4);
+
+        if (0 == i % nk || (nk > 6 && 4 == i % nk)) {
+            // with the same word in all lanes, lane 0 is SubWord(temp) and lane 1 is RotWord(SubWord(temp))
+            __m128i assist = _mm_aeskeygenassist_si128(_mm_set1_epi32(static_cast<int>(temp)), 0x00);
+
+            if (0 == i % nk) {
+                temp    = static_cast<CryptoPP::word32>(_mm_cvtsi128_si32(_mm_shuffle_epi32(assist, 0x55))) ^ rcon;
+                rcon    = (rcon << 1) ^ ((rcon & 0x80) ? 0x11b : 0x00);
+            } else {
+                temp    = static_cast<CryptoPP::word32>(_mm_cvtsi128_si32(assist));
+            }
+        }
+
+        CryptoPP::word32 previous;
+        memcpy(&previous, schedule + 4 * (i - nk), 4);
+        temp ^= previous;
+        memcpy(schedule + 4 * i, &temp, 4);
+    }
+
+    return rounds;
+}
+/* }}} */
+
+/* {{{ aesniEncryptBlocks
+   encrypts up to AES_MULTI_KEY_LANES blocks, each one with its own key schedule. all schedules must have the same
+   number of rounds. rounds of all blocks are interleaved */
+__attribute__((target("aes,sse2")))
+static void aesniEncryptBlocks(const byte *const *schedules, unsigned int rounds, const byte *inBlocks, byte *outBlocks, size_t blockCount) {
+    __m128i blocks[AES_MULTI_KEY_LANES];
+
+    for (size_t i = 0; i < blockCount; i++) {
+        blocks[i] = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(inBlocks + i * 16)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(schedules[i]))
+        );
+    }
+
+    for (unsigned int r = 1; r < rounds; r++) {
+        for (size_t i = 0; i < blockCount; i++) {
+            blocks[i] = _mm_aesenc_si128(blocks[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(schedules[i] + r * 16)));
+        }
+    }
+
+    for (size_t i = 0; i < blockCount; i++) {
+        blocks[i] = _mm_aesenclast_si128(blocks[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(schedules[i] + rounds * 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outBlocks + i * 16), blocks[i]);
+    }
+}
+/* }}} */
+
+/* {{{ AesniLanes
+   counter blocks waiting to be encrypted, with the key schedule and the message position of each one */
+struct AesniLanes {
+    const byte *schedules[AES_MULTI_KEY_LANES];
+    const AesMultiKeyCtrItem *items[AES_MULTI_KEY_LANES];
+    size_t offsets[AES_MULTI_KEY_LANES];
+    CryptoPP::FixedSizeSecBlock<byte, AES_MULTI_KEY_LANES * 16> counters;
+    CryptoPP::FixedSizeSecBlock<byte, AES_MULTI_KEY_LANES * 16> keystream;
+    size_t count;
+};
+/* }}} */
+
+/* {{{ aesniFlushLanes
+   encrypts pending counters and xors the keystream with the corresponding message blocks */
+static void aesniFlushLanes(AesniLanes &lanes, unsigned int rounds) {
+    if (0 == lanes.count) {
+        return;
+    }
+
+    aesniEncryptBlocks(lanes.schedules, rounds, lanes.counters, lanes.keystream, lanes.count);
+
+    for (size_t i = 0; i < lanes.count; i++) {
+        const AesMultiKeyCtrItem *item  = lanes.items[i];
+        size_t blockSize                = CryptoPP::STDMIN<size_t>(16, item->length - lanes.offsets[i]);
+        CryptoPP::xorbuf(item->output + lanes.offsets[i], item->input + lanes.offsets[i], lanes.keystream + i * 16, blockSize);
+    }
+
+    lanes.count = 0;
+}
+/* }}} */
+
+/* {{{ aesniProcessItems
+   expands all key schedules, then walks the blocks of all messages that share the same number of rounds,
+   AES_MULTI_KEY_LANES counters at a time, whatever the message they belong to */
+static void aesniProcessItems(const AesMultiKeyCtrItem *items, size_t count) {
+    CryptoPP::SecByteBlock schedules(count * AES_MULTI_KEY_SCHEDULE_SIZE);
+    CryptoPP::SecBlock<unsigned int> rounds(count);
+
+    for (size_t i = 0; i < count; i++) {
+        rounds[i] = aesniExpandKey(items[i].key, items[i].keyLength, schedules + i * AES_MULTI_KEY_SCHEDULE_SIZE);
+    }
+
+    AesniLanes lanes;
+    lanes.count = 0;
+    CryptoPP::FixedSizeSecBlock<byte, 16> counter;
+
+    for (unsigned int roundCount = 10; roundCount <= 14; roundCount += 2) {
+        for (size_t i = 0; i < count; i++) {
+            if (roundCount != rounds[i]) {
+                continue;
+            }
+
+            memcpy(counter, items[i].iv, 16);
+
+            for (size_t offset = 0; offset < items[i].length; offset += 16) {
+                lanes.schedules[lanes.count]    = schedules + i * AES_MULTI_KEY_SCHEDULE_SIZE;
+                lanes.items[lanes.count]        = &items[i];
+                lanes.offsets[lanes.count]      = offset;
+                memcpy(lanes.counters + lanes.count * 16, counter, 16);
+                CryptoPP::IncrementCounterByOne(counter, 16);
+
+                if (AES_MULTI_KEY_LANES == ++lanes.count) {
+                    aesniFlushLanes(lanes, roundCount);
+                }
+            }
+        }
+
+        aesniFlushLanes(lanes, roundCount);
+    }
+}
+/* }}} */
+
+#endif /* PHP_CRYPTOPP_AES_MULTI_KEY_AESNI */
+
+/* {{{ AesMultiKeyCtr::ProcessItems */
+void AesMultiKeyCtr::ProcessItems(const AesMultiKeyCtrItem *items, size_t count) {
+#ifdef PHP_CRYPTOPP_AES_MULTI_KEY_AESNI
+    if (aesniIsAvailable()) {
+        aesniProcessItems(items, count);
+        return;
+    }
+#endif
+
+    // without AES-NI, table based AES gains nothing from interleaving
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption ctr;
+
+    for (size_t i = 0; i < count; i++) {
+        ctr.SetKeyWithIV(items[i].key, items[i].keyLength, items[i].iv, 16);
+        ctr.ProcessData(items[i].output, items[i].input, items[i].length);
+    }
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
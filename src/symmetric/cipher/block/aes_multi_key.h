@@ -0,0 +1,48 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_BLOCK_CIPHER_AES_MULTI_KEY_H
+#define PHP_BLOCK_CIPHER_AES_MULTI_KEY_H
+
+#include "src/php_cryptopp.h"
+
+/* {{{ AesMultiKeyCtrItem
+   one message of a multi-key batch. iv is the 16 bytes initial counter, as with CTR_Mode<AES> */
+struct AesMultiKeyCtrItem {
+    const byte *key;
+    size_t keyLength;
+    const byte *iv;
+    const byte *input;
+    byte *output;
+    size_t length;
+};
+/* }}} */
+
+/* {{{ AesMultiKeyCtr
+   encrypts/decrypts many messages, each one under its own key, with AES in CTR mode.
+   when AES-NI is available, all key schedules are expanded first and blocks of different messages
+   are processed together so that the AES pipeline stays full even with short messages */
+class AesMultiKeyCtr
+{
+public:
+    static bool IsValidKeyLength(size_t n) {return 16 == n || 24 == n || 32 == n;}
+    static void ProcessItems(const AesMultiKeyCtrItem *items, size_t count);
+};
+/* }}} */
+
+#endif /* PHP_BLOCK_CIPHER_AES_MULTI_KEY_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
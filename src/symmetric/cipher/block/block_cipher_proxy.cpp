@@ -14,6 +14,8 @@
 #include "block_cipher_proxy.h"
 #include <zend_exceptions.h>
 #include <exception>
+#include <misc.h>
+#include <secblock.h>
 
 /* {{{ BlockCipherProxy::Base::Base */
 BlockCipherProxy::Base::Base(zval *blockCipherObject, const char* processDataFuncname, const char *processBlockFuncname TSRMLS_DC)
@@ -128,8 +130,6 @@ void BlockCipherProxy::Base::ProcessAndXorBlock(const byte *inBlock, const byte
 /* {{{ BlockCipherProxy::Base::ProcessAndXorBlock */
 void BlockCipherProxy::Base::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock)
 {
-    // TODO optimize? (use of AdvancedProcessBlocks)
-
     unsigned int blockSize = BlockSize();
 
     if (!m_dataProcessEnabled) {
@@ -162,6 +162,82 @@ void BlockCipherProxy::Base::ProcessAndXorBlock(const byte *inBlock, const byte
 }
 /* }}} */
 
+/* {{{ BlockCipherProxy::Base::AdvancedProcessBlocks
+   process a run of independent blocks with a single call to the bulk php method (encrypt() or decrypt())
+   instead of calling encryptBlock()/decryptBlock() for each block */
+size_t BlockCipherProxy::Base::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, CryptoPP::word32 flags) const
+{
+    size_t blockSize    = m_blockSize;
+    size_t blocks       = length / blockSize;
+
+    if (!m_dataProcessEnabled || blocks < 2 || !(flags & BT_AllowParallel) || (flags & BT_DontIncrementInOutPointers)) {
+        // nothing to batch, or blocks depend on each other (ex: cbc encryption xors each input with the previous output)
+        return CryptoPP::BlockCipher::AdvancedProcessBlocks(inBlocks, xorBlocks, outBlocks, length, flags);
+    }
+
+    size_t runSize = blocks * blockSize;
+
+    byte *counter       = const_cast<byte*>(inBlocks);
+    byte counterLsb     = counter[blockSize - 1];
+
+    // build input blocks
+    CryptoPP::SecByteBlock input(runSize);
+
+    if (flags & BT_InBlockIsCounter) {
+        // inBlocks is a counter whose last byte is incremented after each block
+        for (size_t i = 0; i < blocks; i++) {
+            memcpy(input + i * blockSize, counter, blockSize);
+            counter[blockSize - 1]++;
+        }
+    } else {
+        memcpy(input, inBlocks, runSize);
+    }
+
+    if (NULL != xorBlocks && (flags & BT_XorInput)) {
+        CryptoPP::xorbuf(input, xorBlocks, runSize);
+    }
+
+    // xorBlocks may overlap outBlocks (CBC decryption in place), so keep a copy before writing output
+    CryptoPP::SecByteBlock outputXor;
+
+    if (NULL != xorBlocks && !(flags & BT_XorInput)) {
+        outputXor.Assign(xorBlocks, runSize);
+    }
+
+    // process blocks
+    zval *zInput    = makeZval(reinterpret_cast<const char*>(input.BytePtr()), runSize);
+    zval *zOutput   = call_user_method(m_blockCipherObject, m_funcnameProcessData, zInput M_TSRMLS_CC);
+
+    if (IS_STRING != Z_TYPE_P(zOutput)) {
+        zval_ptr_dtor(&zInput);
+        zval_ptr_dtor(&zOutput);
+        throw false;
+    } else if (static_cast<size_t>(Z_STRLEN_P(zOutput)) != runSize) {
+        // the bulk method does not process blocks independently, fallback to one call per block
+        zval_ptr_dtor(&zInput);
+        zval_ptr_dtor(&zOutput);
+
+        if (flags & BT_InBlockIsCounter) {
+            counter[blockSize - 1] = counterLsb;
+        }
+
+        return CryptoPP::BlockCipher::AdvancedProcessBlocks(inBlocks, xorBlocks, outBlocks, length, flags);
+    }
+
+    memcpy(outBlocks, reinterpret_cast<byte*>(Z_STRVAL_P(zOutput)), runSize);
+
+    // xor output blocks
+    if (outputXor.size() > 0) {
+        CryptoPP::xorbuf(outBlocks, outputXor, runSize);
+    }
+
+    zval_ptr_dtor(&zInput);
+    zval_ptr_dtor(&zOutput);
+
+    return length - runSize;
+}
+/* }}} */
+
 /*
  * Local variables:
  * tab-width: 4
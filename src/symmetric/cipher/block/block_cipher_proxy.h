@@ -33,6 +33,9 @@ public:
         void SetKey(const byte *key, size_t length, const CryptoPP::NameValuePairs &params = CryptoPP::g_nullNameValuePairs);
         void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
         void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock);
+        // CBC and CFB decryption pass whole runs of independent blocks here (BT_AllowParallel) and apply the chained xor afterwards.
+        // a run is forwarded to a single call of the bulk php method
+        size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, CryptoPP::word32 flags) const;
         std::string AlgorithmName() const {return m_name;}
 
         // unused
@@ -9,8 +9,8 @@ def getConfig(cryptoppDir):
         return config
 
     config["enabled"]                   = True
-    config["srcFileList"]               = ["symmetric/cipher/block/php_aes.cpp"]
-    config["headerFileList"]            = ["symmetric/cipher/block/php_aes.h"]
+    config["srcFileList"]               = ["symmetric/cipher/block/php_aes.cpp", "symmetric/cipher/block/aes_multi_key.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/block/php_aes.h", "symmetric/cipher/block/aes_multi_key.h"]
     config["phpMinitStatements"]        = ["init_class_BlockCipherAes(TSRMLS_C);"]
 
     return config
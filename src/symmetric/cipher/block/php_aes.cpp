@@ -8,13 +8,26 @@
  */
 
 #include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/symmetric/cipher/key_schedule_cache.h"
 #include "php_block_cipher_abstract.h"
 #include "php_aes.h"
+#include "aes_multi_key.h"
 #include <aes.h>
+#include <vector>
+#include <zend_exceptions.h>
 
 /* {{{ arginfo */
 ZEND_BEGIN_ARG_INFO(arginfo_BlockCipherAes_construct, 0)
 ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_BlockCipherAes_encryptCtrBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, items, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_BlockCipherAes_decryptCtrBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, items, 0)
+ZEND_END_ARG_INFO()
 /* }}} */
 
 /* {{{ PHP class declaration */
@@ -22,6 +35,8 @@ zend_class_entry *cryptopp_ce_BlockCipherAes;
 
 static zend_function_entry cryptopp_methods_BlockCipherAes[] = {
     PHP_ME(Cryptopp_BlockCipherAes, __construct, arginfo_BlockCipherAes_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_BlockCipherAes, encryptCtrBatch, arginfo_BlockCipherAes_encryptCtrBatch, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Cryptopp_BlockCipherAes, decryptCtrBatch, arginfo_BlockCipherAes_decryptCtrBatch, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -32,8 +47,8 @@ void init_class_BlockCipherAes(TSRMLS_D) {
 
 /* {{{ proto BlockCipherAes::__construct(void) */
 PHP_METHOD(Cryptopp_BlockCipherAes, __construct) {
-    CryptoPP::AES::Encryption *encryptor = new CryptoPP::AES::Encryption();
-    CryptoPP::AES::Decryption *decryptor = new CryptoPP::AES::Decryption();
+    CryptoPP::AES::Encryption *encryptor = new KeyScheduleLazy<KeyScheduleCached<CryptoPP::AES::Encryption> >();
+    CryptoPP::AES::Decryption *decryptor = new KeyScheduleLazy<KeyScheduleCached<CryptoPP::AES::Decryption> >();
     setCryptoppBlockCipherEncryptorPtr(getThis(), encryptor TSRMLS_CC);
     setCryptoppBlockCipherDecryptorPtr(getThis(), decryptor TSRMLS_CC);
 
@@ -41,6 +56,119 @@ PHP_METHOD(Cryptopp_BlockCipherAes, __construct) {
 }
 /* }}} */
 
+/* {{{ processAesCtrBatch
+   encrypts/decrypts a list of array(key, iv, data) items with AES in CTR mode, each item under its own key.
+   keys of the list are preserved. returns false on failure */
+static bool processAesCtrBatch(zval *items, zval *return_value TSRMLS_DC) {
+    HashTable *itemList = Z_ARRVAL_P(items);
+    HashPosition pos;
+    zval **zItem;
+    std::vector<AesMultiKeyCtrItem> nativeItems;
+    nativeItems.reserve(zend_hash_num_elements(itemList));
+
+    // check items
+    for (
+        zend_hash_internal_pointer_reset_ex(itemList, &pos);
+        SUCCESS == zend_hash_get_current_data_ex(itemList, reinterpret_cast<void**>(&zItem), &pos);
+        zend_hash_move_forward_ex(itemList, &pos)
+    ) {
+        zval **zKey     = NULL;
+        zval **zIv      = NULL;
+        zval **zData    = NULL;
+
+        if (
+            IS_ARRAY != Z_TYPE_PP(zItem) ||
+            SUCCESS != zend_hash_index_find(Z_ARRVAL_PP(zItem), 0, reinterpret_cast<void**>(&zKey)) ||
+            SUCCESS != zend_hash_index_find(Z_ARRVAL_PP(zItem), 1, reinterpret_cast<void**>(&zIv)) ||
+            SUCCESS != zend_hash_index_find(Z_ARRVAL_PP(zItem), 2, reinterpret_cast<void**>(&zData)) ||
+            IS_STRING != Z_TYPE_PP(zKey) ||
+            IS_STRING != Z_TYPE_PP(zIv) ||
+            IS_STRING != Z_TYPE_PP(zData)
+        ) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: each item must be an array of 3 strings: key, initialization vector and data", cryptopp_ce_BlockCipherAes->name);
+            return false;
+        } else if (!AesMultiKeyCtr::IsValidKeyLength(Z_STRLEN_PP(zKey))) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : %d is not a valid key length", cryptopp_ce_BlockCipherAes->name, Z_STRLEN_PP(zKey));
+            return false;
+        } else if (CryptoPP::AES::BLOCKSIZE != Z_STRLEN_PP(zIv)) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : %d is not a valid initialization vector length", cryptopp_ce_BlockCipherAes->name, Z_STRLEN_PP(zIv));
+            return false;
+        }
+
+        AesMultiKeyCtrItem item;
+        item.key        = reinterpret_cast<const byte*>(Z_STRVAL_PP(zKey));
+        item.keyLength  = Z_STRLEN_PP(zKey);
+        item.iv         = reinterpret_cast<const byte*>(Z_STRVAL_PP(zIv));
+        item.input      = reinterpret_cast<const byte*>(Z_STRVAL_PP(zData));
+        item.output     = NULL;
+        item.length     = Z_STRLEN_PP(zData);
+        nativeItems.push_back(item);
+    }
+
+    // output strings are handed over to php as is, without copy
+    for (std::vector<AesMultiKeyCtrItem>::iterator it = nativeItems.begin(); it != nativeItems.end(); ++it) {
+        it->output              = reinterpret_cast<byte*>(emalloc(it->length + 1));
+        it->output[it->length]  = '\0';
+    }
+
+    if (!nativeItems.empty()) {
+        AesMultiKeyCtr::ProcessItems(&nativeItems[0], nativeItems.size());
+    }
+
+    array_init(return_value);
+    size_t i = 0;
+
+    for (
+        zend_hash_internal_pointer_reset_ex(itemList, &pos);
+        SUCCESS == zend_hash_get_current_data_ex(itemList, reinterpret_cast<void**>(&zItem), &pos);
+        zend_hash_move_forward_ex(itemList, &pos), i++
+    ) {
+        char *key;
+        uint keyLength;
+        ulong index;
+        char *output = reinterpret_cast<char*>(nativeItems[i].output);
+
+        if (HASH_KEY_IS_STRING == zend_hash_get_current_key_ex(itemList, &key, &keyLength, &index, 0, &pos)) {
+            add_assoc_stringl_ex(return_value, key, keyLength, output, nativeItems[i].length, 0);
+        } else {
+            add_index_stringl(return_value, index, output, nativeItems[i].length, 0);
+        }
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ proto array BlockCipherAes::encryptCtrBatch(array items)
+   Encrypts several messages in CTR mode, each one with its own key. Each item is an array(key, iv, plaintext) */
+PHP_METHOD(Cryptopp_BlockCipherAes, encryptCtrBatch) {
+    zval *items;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a", &items)) {
+        return;
+    }
+
+    if (!processAesCtrBatch(items, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
+/* {{{ proto array BlockCipherAes::decryptCtrBatch(array items)
+   Decrypts several messages in CTR mode, each one with its own key. Each item is an array(key, iv, ciphertext) */
+PHP_METHOD(Cryptopp_BlockCipherAes, decryptCtrBatch) {
+    zval *items;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a", &items)) {
+        return;
+    }
+
+    if (!processAesCtrBatch(items, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
 /*
  * Local variables:
  * tab-width: 4
@@ -14,6 +14,8 @@
 
 void init_class_BlockCipherAes(TSRMLS_D);
 PHP_METHOD(Cryptopp_BlockCipherAes, __construct);
+PHP_METHOD(Cryptopp_BlockCipherAes, encryptCtrBatch);
+PHP_METHOD(Cryptopp_BlockCipherAes, decryptCtrBatch);
 
 #endif /* PHP_BLOCK_CIPHER_AES_H */
 
@@ -121,9 +121,7 @@ void setCryptoppBlockCipherDecryptorPtr(zval *this_ptr, CryptoPP::BlockCipher *d
 /* {{{ isCryptoppBlockCipherKeyValid
    verify that a key size is valid for a BlockCipherAbstract instance */
 bool isCryptoppBlockCipherKeyValid(zval *object, CryptoPP::BlockCipher *cipher TSRMLS_DC, bool throwIfFalse) {
-    zval *key   = zend_read_property(cryptopp_ce_BlockCipherAbstract, object, "key", 3, 1 TSRMLS_CC);
-    int keySize = Z_STRLEN_P(key);
-
+    int keySize = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC))->keyLength;
     return isCryptoppSymmetricKeyValid(object, cipher, keySize TSRMLS_CC, throwIfFalse);
 }
 /* }}} */
@@ -204,6 +202,11 @@ PHP_METHOD(Cryptopp_BlockCipherAbstract, setKey) {
     encryptor->SetKey(bKey, keySize);
     decryptor->SetKey(bKey, keySize);
     zend_update_property_stringl(cryptopp_ce_BlockCipherAbstract, getThis(), "key", 3, key, keySize TSRMLS_CC);
+
+    // objects built on top of this cipher compare the key generation to know if their own key dependent state is stale
+    BlockCipherAbstractContainer *container = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC));
+    container->keyLength                    = keySize;
+    container->keyGeneration++;
 }
 /* }}} */
 
@@ -309,14 +312,10 @@ PHP_METHOD(Cryptopp_BlockCipherAbstract, encrypt) {
     }
 
     // encrypt
+    // all blocks are independent, so they are handed at once to the cipher to let it process several blocks in parallel
     byte *input     = reinterpret_cast<byte*>(data);
     byte *output    = new byte[dataSize];
-    byte block[blockSize];
-    int blocks = dataSize / blockSize;
-
-    for (int i = 0; i < blocks; i++) {
-        encryptor->ProcessAndXorBlock(&input[i * blockSize], NULL, &output[i * blockSize]);
-    }
+    encryptor->AdvancedProcessBlocks(input, NULL, output, dataSize, CryptoPP::BlockTransformation::BT_AllowParallel);
 
     RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
     delete[] output;
@@ -350,15 +349,11 @@ PHP_METHOD(Cryptopp_BlockCipherAbstract, decrypt) {
         RETURN_FALSE
     }
 
-    // encrypt
+    // decrypt
+    // all blocks are independent, so they are handed at once to the cipher to let it process several blocks in parallel
     byte *input     = reinterpret_cast<byte*>(data);
     byte *output    = new byte[dataSize];
-    byte block[blockSize];
-    int blocks = dataSize / blockSize;
-
-    for (int i = 0; i < blocks; i++) {
-        decryptor->ProcessAndXorBlock(&input[i * blockSize], NULL, &output[i * blockSize]);
-    }
+    decryptor->AdvancedProcessBlocks(input, NULL, output, dataSize, CryptoPP::BlockTransformation::BT_AllowParallel);
 
     RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
     delete[] output;
@@ -45,6 +45,8 @@ struct BlockCipherAbstractContainer {
     zend_object std;
     CryptoPP::BlockCipher *encryptor;
     CryptoPP::BlockCipher *decryptor;
+    int keyLength;
+    unsigned int keyGeneration;
 };
 
 extern zend_object_handlers BlockCipherAbstract_object_handlers;
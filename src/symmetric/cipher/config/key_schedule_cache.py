@@ -0,0 +1,10 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    config["enabled"]               = True
+    config["srcFileList"]           = ["symmetric/cipher/key_schedule_cache.cpp"]
+    config["headerFileList"]        = ["symmetric/cipher/key_schedule_cache.h"]
+
+    return config
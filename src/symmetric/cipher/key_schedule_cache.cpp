@@ -0,0 +1,170 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "key_schedule_cache.h"
+#include <aes.h>
+#include <cbcmac.h>
+#include <osrng.h>
+#include <list>
+#include <map>
+#include <pthread.h>
+
+/* {{{ cache storage of a worker. the fingerprint of an entry is the tag followed by the CBC-MAC of the key */
+typedef std::list<std::string> KeyScheduleCacheLruList;
+
+struct KeyScheduleCacheNode {
+    KeyScheduleCache::Entry *entry;
+    KeyScheduleCacheLruList::iterator lruPosition;
+};
+
+typedef std::map<std::string, KeyScheduleCacheNode> KeyScheduleCacheMap;
+
+struct KeyScheduleCacheStorage {
+    CryptoPP::CBC_MAC<CryptoPP::AES> fingerprintMac;
+    KeyScheduleCacheMap map;
+    KeyScheduleCacheLruList lru;
+    size_t size;
+};
+
+static pthread_once_t keyScheduleCacheOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t keyScheduleCacheKey;
+/* }}} */
+
+/* {{{ eraseNode
+   removes an entry from the cache of a worker */
+static void eraseNode(KeyScheduleCacheStorage *storage, KeyScheduleCacheMap::iterator it) {
+    storage->size -= it->second.entry->Size();
+    storage->lru.erase(it->second.lruPosition);
+    delete it->second.entry;
+    storage->map.erase(it);
+}
+/* }}} */
+
+/* {{{ deleteStorage
+   deletes the cache of a worker. also called when a thread exits */
+static void deleteStorage(void *arg) {
+    KeyScheduleCacheStorage *storage = static_cast<KeyScheduleCacheStorage*>(arg);
+
+    while (!storage->map.empty()) {
+        eraseNode(storage, storage->map.begin());
+    }
+
+    delete storage;
+}
+/* }}} */
+
+/* {{{ createStorageKey */
+static void createStorageKey() {
+    pthread_key_create(&keyScheduleCacheKey, deleteStorage);
+}
+/* }}} */
+
+/* {{{ getStorage
+   returns the cache of the calling worker, created on first use */
+static KeyScheduleCacheStorage *getStorage() {
+    pthread_once(&keyScheduleCacheOnce, createStorageKey);
+    KeyScheduleCacheStorage *storage = static_cast<KeyScheduleCacheStorage*>(pthread_getspecific(keyScheduleCacheKey));
+
+    if (NULL == storage) {
+        CryptoPP::SecByteBlock secret(CryptoPP::AES::DEFAULT_KEYLENGTH);
+        CryptoPP::OS_GenerateRandomBlock(false, secret, secret.size());
+
+        storage         = new KeyScheduleCacheStorage();
+        storage->size   = 0;
+        storage->fingerprintMac.SetKey(secret, secret.size());
+        pthread_setspecific(keyScheduleCacheKey, storage);
+    }
+
+    return storage;
+}
+/* }}} */
+
+/* {{{ getFingerprint
+   returns the fingerprint of a key. the key is prefixed by its length so that CBC-MAC inputs are prefix-free */
+static std::string getFingerprint(KeyScheduleCacheStorage *storage, const std::string &tag, const byte *key, size_t length) {
+    byte prefix = static_cast<byte>(length);
+    byte digest[CryptoPP::AES::BLOCKSIZE];
+    storage->fingerprintMac.Update(&prefix, 1);
+    storage->fingerprintMac.Update(key, length);
+    storage->fingerprintMac.Final(digest);
+
+    std::string fingerprint(tag);
+    fingerprint.push_back('\0');
+    fingerprint.append(reinterpret_cast<const char*>(digest), sizeof(digest));
+
+    return fingerprint;
+}
+/* }}} */
+
+/* {{{ KeyScheduleCache::Find
+   returns the entry of a key and marks it as the most recently used one, or NULL */
+const KeyScheduleCache::Entry *KeyScheduleCache::Find(const std::string &tag, const byte *key, size_t length) {
+    KeyScheduleCacheStorage *storage    = getStorage();
+    KeyScheduleCacheMap::iterator it    = storage->map.find(getFingerprint(storage, tag, key, length));
+
+    if (storage->map.end() == it) {
+        return NULL;
+    }
+
+    storage->lru.splice(storage->lru.begin(), storage->lru, it->second.lruPosition);
+
+    return it->second.entry;
+}
+/* }}} */
+
+/* {{{ KeyScheduleCache::Store
+   adds an entry, then evicts least recently used entries until the cache fits in KEY_SCHEDULE_CACHE_MAX_SIZE */
+void KeyScheduleCache::Store(const std::string &tag, const byte *key, size_t length, Entry *entry) {
+    if (entry->Size() > KEY_SCHEDULE_CACHE_MAX_SIZE) {
+        delete entry;
+        return;
+    }
+
+    KeyScheduleCacheStorage *storage    = getStorage();
+    std::string fingerprint(getFingerprint(storage, tag, key, length));
+    KeyScheduleCacheMap::iterator it    = storage->map.find(fingerprint);
+
+    if (storage->map.end() != it) {
+        eraseNode(storage, it);
+    }
+
+    storage->lru.push_front(fingerprint);
+    KeyScheduleCacheNode &node  = storage->map[fingerprint];
+    node.entry                  = entry;
+    node.lruPosition            = storage->lru.begin();
+    storage->size              += entry->Size();
+
+    while (storage->size > KEY_SCHEDULE_CACHE_MAX_SIZE) {
+        eraseNode(storage, storage->map.find(storage->lru.back()));
+    }
+}
+/* }}} */
+
+/* {{{ KeyScheduleCache::Clear
+   removes all entries of the calling worker and forgets its fingerprint key */
+void KeyScheduleCache::Clear() {
+    pthread_once(&keyScheduleCacheOnce, createStorageKey);
+    KeyScheduleCacheStorage *storage = static_cast<KeyScheduleCacheStorage*>(pthread_getspecific(keyScheduleCacheKey));
+
+    if (NULL != storage) {
+        deleteStorage(storage);
+        pthread_setspecific(keyScheduleCacheKey, NULL);
+    }
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,163 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_SYMMETRIC_KEY_SCHEDULE_CACHE_H
+#define PHP_SYMMETRIC_KEY_SCHEDULE_CACHE_H
+
+#include "src/php_cryptopp.h"
+#include <secblock.h>
+#include <string>
+#include <typeinfo>
+
+/* {{{ KEY_SCHEDULE_CACHE_MAX_SIZE
+   maximum size of cached key schedules of a worker, in bytes. least recently used entries are evicted first */
+#define KEY_SCHEDULE_CACHE_MAX_SIZE 262144
+/* }}} */
+
+/* {{{ KeyScheduleCache
+   per worker cache of expanded key schedules: each thread (so each process without ZTS) has its own, and no lock is taken.
+   entries are looked up by a tag identifying the algorithm and a CBC-MAC of the raw key under a random per worker AES key.
+   cached schedules hold key material: the first round keys of an AES schedule are the key itself */
+class KeyScheduleCache
+{
+public:
+    /* {{{ cache entry */
+    class Entry
+    {
+    public:
+        virtual ~Entry() {}
+        virtual size_t Size() const =0;
+    };
+    /* }}} */
+
+    /* {{{ entry holding a copy of a keyed object */
+    template <class T>
+    class ObjectEntry : public Entry
+    {
+    public:
+        ObjectEntry(const T &object) : m_object(object) {}
+        size_t Size() const {return sizeof(T);}
+        void CopyTo(T &object) const {object = m_object;}
+
+    private:
+        T m_object;
+    };
+    /* }}} */
+
+    /* {{{ entry holding a copy of a buffer */
+    class BufferEntry : public Entry
+    {
+    public:
+        BufferEntry(const byte *buffer, size_t length) : m_buffer(buffer, length) {}
+        size_t Size() const {return sizeof(BufferEntry) + m_buffer.size();}
+        template <class B> void CopyTo(B &buffer) const {buffer.Assign(m_buffer.begin(), m_buffer.size());}
+
+    private:
+        CryptoPP::SecByteBlock m_buffer;
+    };
+    /* }}} */
+
+    // copies the cached entry into destination. returns false if there is no entry for this key
+    template <class E, class D>
+    static bool Load(const std::string &tag, const byte *key, size_t length, D &destination) {
+        const Entry *entry = Find(tag, key, length);
+
+        if (NULL != entry) {
+            static_cast<const E*>(entry)->CopyTo(destination);
+        }
+
+        return NULL != entry;
+    }
+
+    // takes ownership of entry
+    static void Store(const std::string &tag, const byte *key, size_t length, Entry *entry);
+
+    // clears the cache of the calling worker
+    static void Clear();
+
+private:
+    static const Entry *Find(const std::string &tag, const byte *key, size_t length);
+};
+/* }}} */
+
+/* {{{ KeyScheduleCached
+   native cipher whose key schedule goes through KeyScheduleCache.
+   T must be copy assignable, and its key schedule must only depend on the key */
+template <class T>
+class KeyScheduleCached : public T
+{
+protected:
+    void UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs &params) {
+        std::string tag(typeid(T).name());
+
+        if (KeyScheduleCache::Load<KeyScheduleCache::ObjectEntry<T> >(tag, key, length, static_cast<T&>(*this))) {
+            return;
+        }
+
+        T::UncheckedSetKey(key, length, params);
+        KeyScheduleCache::Store(tag, key, length, new KeyScheduleCache::ObjectEntry<T>(*this));
+    }
+};
+/* }}} */
+
+/* {{{ KeyScheduleLazy
+   native cipher whose key schedule is expanded on first use rather than when the key is set, so that a direction
+   which is never used never pays for its key schedule. T must be a block cipher whose key schedule only depends on the key */
+template <class T>
+class KeyScheduleLazy : public T
+{
+public:
+    KeyScheduleLazy() : m_keyPending(false) {}
+
+    void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const {
+        ExpandPendingKey();
+        T::ProcessAndXorBlock(inBlock, xorBlock, outBlock);
+    }
+
+    size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, CryptoPP::word32 flags) const {
+        ExpandPendingKey();
+        return T::AdvancedProcessBlocks(inBlocks, xorBlocks, outBlocks, length, flags);
+    }
+
+    CryptoPP::Clonable *Clone() const {
+        ExpandPendingKey();
+        return T::Clone();
+    }
+
+protected:
+    void UncheckedSetKey(const byte *key, unsigned int length, const CryptoPP::NameValuePairs &params) {
+        m_pendingKey.Assign(key, length);
+        m_keyPending = true;
+    }
+
+private:
+    void ExpandPendingKey() const {
+        if (m_keyPending) {
+            KeyScheduleLazy *self = const_cast<KeyScheduleLazy*>(this);
+            self->T::UncheckedSetKey(m_pendingKey.begin(), m_pendingKey.size(), CryptoPP::g_nullNameValuePairs);
+            self->m_pendingKey.resize(0);
+            m_keyPending = false;
+        }
+    }
+
+    CryptoPP::SecByteBlock m_pendingKey;
+    mutable bool m_keyPending;
+};
+/* }}} */
+
+#endif /* PHP_SYMMETRIC_KEY_SCHEDULE_CACHE_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,446 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "chacha20_core.h"
+#include <zend_exceptions.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#   define PHP_CRYPTOPP_CHACHA20_SIMD 1
+#   include <cpuid.h>
+#   include <immintrin.h>
+#endif
+
+using CryptoPP::word32;
+
+/* {{{ CHACHA20_MAX_BLOCKS
+   number of keystream blocks of a nonce, the block counter being 32 bits wide (RFC 8439) */
+#define CHACHA20_MAX_BLOCKS W64LIT(4294967296)
+/* }}} */
+
+/* {{{ little endian helpers */
+static inline word32 chacha20Load32(const byte *p) {
+    return (word32)p[0] | ((word32)p[1] << 8) | ((word32)p[2] << 16) | ((word32)p[3] << 24);
+}
+
+static inline void chacha20Store32(byte *p, word32 v) {
+    p[0] = (byte)v;
+    p[1] = (byte)(v >> 8);
+    p[2] = (byte)(v >> 16);
+    p[3] = (byte)(v >> 24);
+}
+/* }}} */
+
+/* {{{ portable block function */
+#define CHACHA20_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CHACHA20_QUARTER_ROUND(a, b, c, d)                   \
+    a += b; d ^= a; d = CHACHA20_ROTL(d, 16);               \
+    c += d; b ^= c; b = CHACHA20_ROTL(b, 12);               \
+    a += b; d ^= a; d = CHACHA20_ROTL(d, 8);                \
+    c += d; b ^= c; b = CHACHA20_ROTL(b, 7);
+
+static void chacha20DoubleRounds(word32 *x) {
+    for (int i = 0; i < 10; i++) {
+        CHACHA20_QUARTER_ROUND(x[0], x[4], x[8],  x[12])
+        CHACHA20_QUARTER_ROUND(x[1], x[5], x[9],  x[13])
+        CHACHA20_QUARTER_ROUND(x[2], x[6], x[10], x[14])
+        CHACHA20_QUARTER_ROUND(x[3], x[7], x[11], x[15])
+        CHACHA20_QUARTER_ROUND(x[0], x[5], x[10], x[15])
+        CHACHA20_QUARTER_ROUND(x[1], x[6], x[11], x[12])
+        CHACHA20_QUARTER_ROUND(x[2], x[7], x[8],  x[13])
+        CHACHA20_QUARTER_ROUND(x[3], x[4], x[9],  x[14])
+    }
+}
+
+static void chacha20ProcessBlocksPortable(word32 *state, const byte *input, byte *output, size_t blockCount) {
+    word32 x[16];
+
+    for (size_t b = 0; b < blockCount; b++) {
+        memcpy(x, state, sizeof(x));
+        chacha20DoubleRounds(x);
+
+        for (int i = 0; i < 16; i++) {
+            word32 word = x[i] + state[i];
+
+            if (NULL != input) {
+                word ^= chacha20Load32(input + 4 * i);
+            }
+
+            chacha20Store32(output + 4 * i, word);
+        }
+
+        state[12]++;
+        output += 64;
+
+        if (NULL != input) {
+            input += 64;
+        }
+    }
+
+    memset(x, 0, sizeof(x));
+}
+/* }}} */
+
+#ifdef PHP_CRYPTOPP_CHACHA20_SIMD
+
+/* {{{ sse2IsAvailable
+   checks once if the CPU supports SSE2. always true on x86-64 */
+static bool sse2IsAvailable() {
+#ifdef __x86_64__
+    return true;
+#else
+    static int available = -1;
+
+    if (-1 == available) {
+        unsigned int eax, ebx, ecx, edx;
+        available = (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (edx & bit_SSE2)) ? 1 : 0;
+    }
+
+    return 1 == available;
+#endif
+}
+/* }}} */
+
+/* {{{ avx2IsAvailable
+   checks once if the CPU supports AVX2 and if the OS saves the YMM registers */
+static bool avx2IsAvailable() {
+    static int available = -1;
+
+    if (-1 == available) {
+        unsigned int eax, ebx, ecx, edx;
+        available = 0;
+
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_OSXSAVE) && (ecx & bit_AVX) && __get_cpuid_max(0, NULL) >= 7) {
+            unsigned int xcr0, xcr0High;
+            __asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+
+            if (6 == (xcr0 & 6)) {
+                __cpuid_count(7, 0, eax, ebx, ecx, edx);
+                available = (ebx & bit_AVX2) ? 1 : 0;
+            }
+        }
+    }
+
+    return 1 == available;
+}
+/* }}} */
+
+/* {{{ chacha20ProcessBlocksSse2
+   processes blockCount blocks, blockCount being a multiple of 4. each register holds the same word of 4 consecutive
+   blocks, so the 4 blocks go through the rounds together and are transposed back before being stored */
+#define CHACHA20_SSE2_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define CHACHA20_SSE2_QUARTER_ROUND(a, b, c, d)                                                 \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA20_SSE2_ROTL(d, 16);           \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA20_SSE2_ROTL(b, 12);           \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA20_SSE2_ROTL(d, 8);            \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA20_SSE2_ROTL(b, 7);
+
+__attribute__((target("sse2")))
+static void chacha20ProcessBlocksSse2(word32 *state, const byte *input, byte *output, size_t blockCount) {
+    __m128i x[16];
+    __m128i s[16];
+
+    for (size_t b = 0; b < blockCount; b += 4) {
+        for (int i = 0; i < 16; i++) {
+            s[i] = _mm_set1_epi32(state[i]);
+        }
+
+        s[12] = _mm_add_epi32(s[12], _mm_set_epi32(3, 2, 1, 0));
+
+        for (int i = 0; i < 16; i++) {
+            x[i] = s[i];
+        }
+
+        for (int i = 0; i < 10; i++) {
+            CHACHA20_SSE2_QUARTER_ROUND(x[0], x[4], x[8],  x[12])
+            CHACHA20_SSE2_QUARTER_ROUND(x[1], x[5], x[9],  x[13])
+            CHACHA20_SSE2_QUARTER_ROUND(x[2], x[6], x[10], x[14])
+            CHACHA20_SSE2_QUARTER_ROUND(x[3], x[7], x[11], x[15])
+            CHACHA20_SSE2_QUARTER_ROUND(x[0], x[5], x[10], x[15])
+            CHACHA20_SSE2_QUARTER_ROUND(x[1], x[6], x[11], x[12])
+            CHACHA20_SSE2_QUARTER_ROUND(x[2], x[7], x[8],  x[13])
+            CHACHA20_SSE2_QUARTER_ROUND(x[3], x[4], x[9],  x[14])
+        }
+
+        for (int i = 0; i < 16; i++) {
+            x[i] = _mm_add_epi32(x[i], s[i]);
+        }
+
+        // transpose each group of 4 words: out[j] holds the words of block j
+        for (int group = 0; group < 4; group++) {
+            __m128i t0 = _mm_unpacklo_epi32(x[4 * group],     x[4 * group + 1]);
+            __m128i t1 = _mm_unpacklo_epi32(x[4 * group + 2], x[4 * group + 3]);
+            __m128i t2 = _mm_unpackhi_epi32(x[4 * group],     x[4 * group + 1]);
+            __m128i t3 = _mm_unpackhi_epi32(x[4 * group + 2], x[4 * group + 3]);
+            __m128i out[4];
+            out[0] = _mm_unpacklo_epi64(t0, t1);
+            out[1] = _mm_unpackhi_epi64(t0, t1);
+            out[2] = _mm_unpacklo_epi64(t2, t3);
+            out[3] = _mm_unpackhi_epi64(t2, t3);
+
+            for (int j = 0; j < 4; j++) {
+                size_t offset = j * 64 + group * 16;
+
+                if (NULL != input) {
+                    out[j] = _mm_xor_si128(out[j], _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + offset)));
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + offset), out[j]);
+            }
+        }
+
+        state[12] += 4;
+        output    += 256;
+
+        if (NULL != input) {
+            input += 256;
+        }
+    }
+}
+/* }}} */
+
+/* {{{ chacha20ProcessBlocksAvx2
+   processes blockCount blocks, blockCount being a multiple of 8. same layout as the SSE2 version with 8 blocks per
+   register. rotations by 16 and 8 bits are byte shuffles */
+#define CHACHA20_AVX2_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define CHACHA20_AVX2_QUARTER_ROUND(a, b, c, d)                                                         \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = _mm256_shuffle_epi8(d, rot16);         \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = CHACHA20_AVX2_ROTL(b, 12);             \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = _mm256_shuffle_epi8(d, rot8);          \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = CHACHA20_AVX2_ROTL(b, 7);
+
+__attribute__((target("avx2")))
+static void chacha20ProcessBlocksAvx2(word32 *state, const byte *input, byte *output, size_t blockCount) {
+    const __m256i rot16 = _mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2
+    );
+    const __m256i rot8 = _mm256_set_epi8(
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3
+    );
+    __m256i x[16];
+    __m256i s[16];
+
+    for (size_t b = 0; b < blockCount; b += 8) {
+        for (int i = 0; i < 16; i++) {
+            s[i] = _mm256_set1_epi32(state[i]);
+        }
+
+        s[12] = _mm256_add_epi32(s[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+
+        for (int i = 0; i < 16; i++) {
+            x[i] = s[i];
+        }
+
+        for (int i = 0; i < 10; i++) {
+            CHACHA20_AVX2_QUARTER_ROUND(x[0], x[4], x[8],  x[12])
+            CHACHA20_AVX2_QUARTER_ROUND(x[1], x[5], x[9],  x[13])
+            CHACHA20_AVX2_QUARTER_ROUND(x[2], x[6], x[10], x[14])
+            CHACHA20_AVX2_QUARTER_ROUND(x[3], x[7], x[11], x[15])
+            CHACHA20_AVX2_QUARTER_ROUND(x[0], x[5], x[10], x[15])
+            CHACHA20_AVX2_QUARTER_ROUND(x[1], x[6], x[11], x[12])
+            CHACHA20_AVX2_QUARTER_ROUND(x[2], x[7], x[8],  x[13])
+            CHACHA20_AVX2_QUARTER_ROUND(x[3], x[4], x[9],  x[14])
+        }
+
+        for (int i = 0; i < 16; i++) {
+            x[i] = _mm256_add_epi32(x[i], s[i]);
+        }
+
+        // transpose each group of 4 words within 128 bits lanes: t[group][j] holds the words of block j in its low
+        // lane and the words of block j + 4 in its high lane
+        __m256i t[4][4];
+
+        for (int group = 0; group < 4; group++) {
+            __m256i t0 = _mm256_unpacklo_epi32(x[4 * group],     x[4 * group + 1]);
+            __m256i t1 = _mm256_unpacklo_epi32(x[4 * group + 2], x[4 * group + 3]);
+            __m256i t2 = _mm256_unpackhi_epi32(x[4 * group],     x[4 * group + 1]);
+            __m256i t3 = _mm256_unpackhi_epi32(x[4 * group + 2], x[4 * group + 3]);
+            t[group][0] = _mm256_unpacklo_epi64(t0, t1);
+            t[group][1] = _mm256_unpackhi_epi64(t0, t1);
+            t[group][2] = _mm256_unpacklo_epi64(t2, t3);
+            t[group][3] = _mm256_unpackhi_epi64(t2, t3);
+        }
+
+        // then pair the lanes of two groups to get 32 contiguous bytes of a block
+        for (int j = 0; j < 4; j++) {
+            __m256i out[4];
+            out[0] = _mm256_permute2x128_si256(t[0][j], t[1][j], 0x20);
+            out[1] = _mm256_permute2x128_si256(t[2][j], t[3][j], 0x20);
+            out[2] = _mm256_permute2x128_si256(t[0][j], t[1][j], 0x31);
+            out[3] = _mm256_permute2x128_si256(t[2][j], t[3][j], 0x31);
+
+            for (int k = 0; k < 4; k++) {
+                size_t offset = (j + 4 * (k >> 1)) * 64 + (k & 1) * 32;
+
+                if (NULL != input) {
+                    out[k] = _mm256_xor_si256(out[k], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + offset)));
+                }
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + offset), out[k]);
+            }
+        }
+
+        state[12] += 8;
+        output    += 512;
+
+        if (NULL != input) {
+            input += 512;
+        }
+    }
+}
+/* }}} */
+
+#endif /* PHP_CRYPTOPP_CHACHA20_SIMD */
+
+/* {{{ ChaCha20Core */
+void ChaCha20Core::SetKey(word32 *state, const byte *key) {
+    // "expand 32-byte k"
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+
+    for (int i = 0; i < 8; i++) {
+        state[4 + i] = chacha20Load32(key + 4 * i);
+    }
+}
+
+void ChaCha20Core::SetNonce(word32 *state, const byte *nonce) {
+    state[12] = 0;
+    state[13] = chacha20Load32(nonce);
+    state[14] = chacha20Load32(nonce + 4);
+    state[15] = chacha20Load32(nonce + 8);
+}
+
+void ChaCha20Core::ProcessBlocks(word32 *state, const byte *input, byte *output, size_t blockCount) {
+#ifdef PHP_CRYPTOPP_CHACHA20_SIMD
+    if (blockCount >= 8 && avx2IsAvailable()) {
+        size_t count = blockCount & ~(size_t)7;
+        chacha20ProcessBlocksAvx2(state, input, output, count);
+        blockCount  -= count;
+        output      += count * 64;
+        input        = NULL != input ? input + count * 64 : NULL;
+    }
+
+    if (blockCount >= 4 && sse2IsAvailable()) {
+        size_t count = blockCount & ~(size_t)3;
+        chacha20ProcessBlocksSse2(state, input, output, count);
+        blockCount  -= count;
+        output      += count * 64;
+        input        = NULL != input ? input + count * 64 : NULL;
+    }
+#endif
+
+    chacha20ProcessBlocksPortable(state, input, output, blockCount);
+}
+
+void ChaCha20Core::HChaCha20(const byte *key, const byte *nonce, byte *subkey) {
+    word32 x[16];
+    SetKey(x, key);
+
+    for (int i = 0; i < 4; i++) {
+        x[12 + i] = chacha20Load32(nonce + 4 * i);
+    }
+
+    chacha20DoubleRounds(x);
+
+    for (int i = 0; i < 4; i++) {
+        chacha20Store32(subkey + 4 * i, x[i]);
+        chacha20Store32(subkey + 16 + 4 * i, x[12 + i]);
+    }
+
+    memset(x, 0, sizeof(x));
+}
+/* }}} */
+
+/* {{{ throwChaCha20Exception
+   policies are instanciated by crypto++ templates without the php thread context, it is only fetched on this error path */
+static void throwChaCha20Exception(const char *message) {
+    TSRMLS_FETCH();
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"ChaCha20 : %s", message);
+    throw false;
+}
+/* }}} */
+
+/* {{{ ChaCha20_Policy */
+void ChaCha20_Policy::CipherSetKey(const CryptoPP::NameValuePairs &params, const byte *key, size_t length) {
+    ChaCha20Core::SetKey(m_state, key);
+}
+
+void ChaCha20_Policy::CipherResynchronize(byte *keystreamBuffer, const byte *iv, size_t length) {
+    ChaCha20Core::SetNonce(m_state, iv);
+    m_blockCount = 0;
+}
+
+void ChaCha20_Policy::OperateKeystream(CryptoPP::KeystreamOperation operation, byte *output, const byte *input, size_t iterationCount) {
+    if (m_blockCount + iterationCount > CHACHA20_MAX_BLOCKS) {
+        throwChaCha20Exception("block counter exhausted, a nonce cannot be used for more than 256 GB");
+    }
+
+    ChaCha20Core::ProcessBlocks(m_state, (operation & CryptoPP::INPUT_NULL) ? NULL : input, output, iterationCount);
+    m_blockCount += iterationCount;
+}
+
+void ChaCha20_Policy::SeekToIteration(CryptoPP::lword iterationCount) {
+    // seeking to the very end of the keystream is allowed, processing data from there is not
+    if (iterationCount > CHACHA20_MAX_BLOCKS) {
+        throwChaCha20Exception("offset exceeds the keystream of a nonce (256 GB)");
+    }
+
+    m_state[12]     = (word32)iterationCount;
+    m_blockCount    = iterationCount;
+}
+
+unsigned int ChaCha20_Policy::GetOptimalBlockSize() const {
+#ifdef PHP_CRYPTOPP_CHACHA20_SIMD
+    if (avx2IsAvailable()) {
+        return 8 * BYTES_PER_ITERATION;
+    } else if (sse2IsAvailable()) {
+        return 4 * BYTES_PER_ITERATION;
+    }
+#endif
+
+    return BYTES_PER_ITERATION;
+}
+/* }}} */
+
+/* {{{ XChaCha20_Policy */
+void XChaCha20_Policy::CipherSetKey(const CryptoPP::NameValuePairs &params, const byte *key, size_t length) {
+    // the actual key depends on the nonce
+    memcpy(m_key, key, 32);
+}
+
+void XChaCha20_Policy::CipherResynchronize(byte *keystreamBuffer, const byte *iv, size_t length) {
+    CryptoPP::FixedSizeSecBlock<byte, 32> subkey;
+    ChaCha20Core::HChaCha20(m_key, iv, subkey);
+    ChaCha20Core::SetKey(m_state, subkey);
+
+    // the nonce of the underlying ChaCha20 is 4 zero bytes followed by the last 8 bytes of the XChaCha20 nonce
+    byte nonce[12] = {0};
+    memcpy(nonce + 4, iv + 16, 8);
+    ChaCha20Core::SetNonce(m_state, nonce);
+    m_blockCount = 0;
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
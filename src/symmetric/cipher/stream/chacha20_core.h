@@ -0,0 +1,111 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_STREAM_CIPHER_CHACHA20_CORE_H
+#define PHP_STREAM_CIPHER_CHACHA20_CORE_H
+
+#include "src/php_cryptopp.h"
+#include <seckey.h>
+#include <strciphr.h>
+
+/* {{{ ChaCha20Core
+   ChaCha20 as specified by RFC 8439: 256 bits key, 96 bits nonce and 32 bits block counter.
+   keystream blocks are generated 8 at a time with AVX2, or 4 at a time with SSE2, when the CPU supports it */
+class ChaCha20Core
+{
+public:
+    // state is the 16 words input block of the block function
+    static void SetKey(CryptoPP::word32 *state, const byte *key);
+    static void SetNonce(CryptoPP::word32 *state, const byte *nonce);
+
+    // xors blockCount blocks of keystream with input, or writes them to output if input is NULL.
+    // the block counter (word 12 of the state) is incremented accordingly
+    static void ProcessBlocks(CryptoPP::word32 *state, const byte *input, byte *output, size_t blockCount);
+
+    // derives the 32 bytes XChaCha20 subkey from a key and the first 16 bytes of a nonce
+    static void HChaCha20(const byte *key, const byte *nonce, byte *subkey);
+};
+/* }}} */
+
+/* {{{ ChaCha20_Info */
+struct ChaCha20_Info : public CryptoPP::FixedKeyLength<32, CryptoPP::SimpleKeyingInterface::UNIQUE_IV, 12>
+{
+    static const char *StaticAlgorithmName() {return "ChaCha20";}
+};
+/* }}} */
+
+/* {{{ XChaCha20_Info */
+struct XChaCha20_Info : public CryptoPP::FixedKeyLength<32, CryptoPP::SimpleKeyingInterface::UNIQUE_IV, 24>
+{
+    static const char *StaticAlgorithmName() {return "XChaCha20";}
+};
+/* }}} */
+
+/* {{{ ChaCha20_Policy
+   the 32 bits block counter cannot wrap: once 2^32 blocks have been generated with a nonce, and when seeking past them,
+   a php exception is thrown */
+class ChaCha20_Policy : public CryptoPP::AdditiveCipherConcretePolicy<CryptoPP::word32, 16>
+{
+public:
+    ChaCha20_Policy() : m_blockCount(0) {}
+
+protected:
+    void CipherSetKey(const CryptoPP::NameValuePairs &params, const byte *key, size_t length);
+    void CipherResynchronize(byte *keystreamBuffer, const byte *iv, size_t length);
+    void OperateKeystream(CryptoPP::KeystreamOperation operation, byte *output, const byte *input, size_t iterationCount);
+    bool CipherIsRandomAccess() const {return true;}
+    void SeekToIteration(CryptoPP::lword iterationCount);
+    unsigned int GetAlignment() const {return 1;}
+    unsigned int GetOptimalBlockSize() const;
+
+    CryptoPP::FixedSizeSecBlock<CryptoPP::word32, 16> m_state;
+
+    // blocks generated since the nonce was set, including the skipped ones. can reach 2^32, unlike m_state[12]
+    CryptoPP::lword m_blockCount;
+};
+/* }}} */
+
+/* {{{ XChaCha20_Policy
+   ChaCha20 keyed with a subkey derived from the key and the first 16 bytes of a 24 bytes nonce */
+class XChaCha20_Policy : public ChaCha20_Policy
+{
+protected:
+    void CipherSetKey(const CryptoPP::NameValuePairs &params, const byte *key, size_t length);
+    void CipherResynchronize(byte *keystreamBuffer, const byte *iv, size_t length);
+
+    CryptoPP::FixedSizeSecBlock<byte, 32> m_key;
+};
+/* }}} */
+
+/* {{{ ChaCha20 */
+struct ChaCha20 : public ChaCha20_Info
+{
+    typedef CryptoPP::SymmetricCipherFinal<CryptoPP::ConcretePolicyHolder<ChaCha20_Policy, CryptoPP::AdditiveCipherTemplate<> >, ChaCha20_Info> Encryption;
+    typedef Encryption Decryption;
+};
+/* }}} */
+
+/* {{{ XChaCha20 */
+struct XChaCha20 : public XChaCha20_Info
+{
+    typedef CryptoPP::SymmetricCipherFinal<CryptoPP::ConcretePolicyHolder<XChaCha20_Policy, CryptoPP::AdditiveCipherTemplate<> >, XChaCha20_Info> Encryption;
+    typedef Encryption Decryption;
+};
+/* }}} */
+
+#endif /* PHP_STREAM_CIPHER_CHACHA20_CORE_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
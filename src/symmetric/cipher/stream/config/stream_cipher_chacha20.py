@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # chacha20 is implemented by the extension, only the stream cipher templates of crypto++ are needed
+    if not os.path.isfile(cryptoppDir + "/strciphr.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/cipher/stream/chacha20_core.cpp", "symmetric/cipher/stream/php_chacha20.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/stream/chacha20_core.h", "symmetric/cipher/stream/php_chacha20.h"]
+    config["phpMinitStatements"]        = ["init_class_StreamCipherChaCha20(TSRMLS_C);"]
+
+    return config
@@ -0,0 +1,16 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    # xchacha20 is implemented by the extension, only the stream cipher templates of crypto++ are needed
+    if not os.path.isfile(cryptoppDir + "/strciphr.h"):
+        config["enabled"] = False
+        return config
+
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/cipher/stream/php_xchacha20.cpp"]
+    config["headerFileList"]            = ["symmetric/cipher/stream/php_xchacha20.h"]
+    config["phpMinitStatements"]        = ["init_class_StreamCipherXChaCha20(TSRMLS_C);"]
+
+    return config
@@ -93,6 +93,7 @@ zend_class_entry *cryptopp_ce_StreamCipherSalsa20;
 static zend_function_entry cryptopp_methods_StreamCipherSalsa20[] = {
     PHP_ME(Cryptopp_StreamCipherSalsa20, __construct, arginfo_StreamCipherSalsa20_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
     PHP_ME(Cryptopp_StreamCipherSalsa20, setRounds, arginfo_StreamCipherSalsa20_setRounds, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_StreamCipherAbstract, seek, arginfo_StreamCipherAbstract_seek, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
@@ -17,6 +17,7 @@
 #include "php_stream_cipher_abstract.h"
 #include <zend_exceptions.h>
 #include <string>
+#include <vector>
 
 /* {{{ StreamCipherAbstract_free_storage
    custom object free handler */
@@ -47,6 +48,8 @@ static zend_function_entry cryptopp_methods_StreamCipherAbstract[] = {
     PHP_ME(Cryptopp_StreamCipherAbstract, encrypt, arginfo_SymmetricTransformationInterface_encrypt, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_ME(Cryptopp_StreamCipherAbstract, decrypt, arginfo_SymmetricTransformationInterface_decrypt, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_ME(Cryptopp_StreamCipherAbstract, restart, arginfo_SymmetricTransformationInterface_restart, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_StreamCipherAbstract, encryptBatch, arginfo_StreamCipherAbstract_encryptBatch, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_StreamCipherAbstract, decryptBatch, arginfo_StreamCipherAbstract_decryptBatch, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
@@ -147,7 +150,66 @@ bool isCryptoppStreamCipherIvValid(zval *object, CryptoPP::SymmetricCipher *ciph
 static void setKeyWithIv(zval *object, CryptoPP::SymmetricCipher *encryptor, CryptoPP::SymmetricCipher *decryptor TSRMLS_DC) {
     zval *zKey      = zend_read_property(cryptopp_ce_StreamCipherAbstract, object, "key", 3, 1 TSRMLS_CC);
     zval *zIv       = zend_read_property(cryptopp_ce_StreamCipherAbstract, object, "iv", 2, 1 TSRMLS_CC);
-    setSymmetricCipherKeyIv(object, encryptor, decryptor, zKey, zIv TSRMLS_CC);
+    bool ivSetted   = setSymmetricCipherKeyIv(object, encryptor, decryptor, zKey, zIv TSRMLS_CC);
+
+    static_cast<StreamCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC))->keyed = ivSetted;
+}
+/* }}} */
+
+/* {{{ resynchronize
+   loads the iv into the native cipher objects of a cipher php object. the key setup is only run again if
+   native objects were not keyed yet */
+static void resynchronize(zval *object, CryptoPP::SymmetricCipher *encryptor, CryptoPP::SymmetricCipher *decryptor TSRMLS_DC) {
+    if (!static_cast<StreamCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC))->keyed) {
+        setKeyWithIv(object, encryptor, decryptor TSRMLS_CC);
+    } else if (encryptor->IsResynchronizable()) {
+        zval *zIv   = zend_read_property(cryptopp_ce_StreamCipherAbstract, object, "iv", 2, 1 TSRMLS_CC);
+        byte *iv    = reinterpret_cast<byte*>(Z_STRVAL_P(zIv));
+        encryptor->Resynchronize(iv, Z_STRLEN_P(zIv));
+        decryptor->Resynchronize(iv, Z_STRLEN_P(zIv));
+    }
+}
+/* }}} */
+
+/* {{{ processBatch
+   encrypts or decrypts a list of data, each one with its own iv. native objects are keyed if they were not yet, and are then
+   only resynchronized between items. the used one is then resynchronized with the current iv. returns false on failure */
+static bool processBatch(
+    zval *object,
+    CryptoPP::SymmetricCipher *encryptor,
+    CryptoPP::SymmetricCipher *decryptor,
+    bool encryption,
+    zval *ivs,
+    zval *data,
+    zval *return_value
+    TSRMLS_DC
+) {
+    CryptoPP::SymmetricCipher *cipher = encryption ? encryptor : decryptor;
+    std::vector<SymmetricCipherBatchItem> items;
+
+    if (!isCryptoppStreamCipherKeyValid(object, cipher TSRMLS_CC) || !getSymmetricCipherBatchItems(object, cipher, ivs, data, items TSRMLS_CC)) {
+        return false;
+    } else if (items.empty()) {
+        array_init(return_value);
+        return true;
+    }
+
+    StreamCipherAbstractContainer *container = static_cast<StreamCipherAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+
+    if (!container->keyed) {
+        // the key schedule is run once, with the iv of the first item
+        zval *zKey          = zend_read_property(cryptopp_ce_StreamCipherAbstract, object, "key", 3, 1 TSRMLS_CC);
+        container->keyed    = setSymmetricCipherKeyIv(object, encryptor, decryptor, zKey, items[0].iv TSRMLS_CC);
+    }
+
+    bool result = processSymmetricCipherBatch(cipher, items, return_value TSRMLS_CC);
+    zval *zIv   = zend_read_property(cryptopp_ce_StreamCipherAbstract, object, "iv", 2, 1 TSRMLS_CC);
+
+    if (cipher->IsResynchronizable() && isCryptoppSymmetricIvValid(object, cipher, Z_STRLEN_P(zIv) TSRMLS_CC, false)) {
+        cipher->Resynchronize(reinterpret_cast<byte*>(Z_STRVAL_P(zIv)), Z_STRLEN_P(zIv));
+    }
+
+    return result;
 }
 /* }}} */
 
@@ -270,7 +332,7 @@ PHP_METHOD(Cryptopp_StreamCipherAbstract, setIv) {
 
     // set the iv on both the php object and the native cryptopp object
     zend_update_property_stringl(cryptopp_ce_StreamCipherAbstract, getThis(), "iv", 2, iv, ivSize TSRMLS_CC);
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    resynchronize(getThis(), encryptor, decryptor TSRMLS_CC);
 }
 /* }}} */
 
@@ -319,7 +381,13 @@ PHP_METHOD(Cryptopp_StreamCipherAbstract, encrypt) {
 
     // encrypt
     byte *output = new byte[dataSize];
-    encryptor->ProcessData(output, reinterpret_cast<byte*>(data), dataSize);
+
+    try {
+        encryptor->ProcessData(output, reinterpret_cast<byte*>(data), dataSize);
+    } catch (bool e) {
+        delete[] output;
+        RETURN_FALSE
+    }
 
     RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
     delete[] output;
@@ -355,7 +423,13 @@ PHP_METHOD(Cryptopp_StreamCipherAbstract, decrypt) {
 
     // encrypt
     byte *output = new byte[dataSize];
-    decryptor->ProcessData(output, reinterpret_cast<byte*>(data), dataSize);
+
+    try {
+        decryptor->ProcessData(output, reinterpret_cast<byte*>(data), dataSize);
+    } catch (bool e) {
+        delete[] output;
+        RETURN_FALSE
+    }
 
     RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
     delete[] output;
@@ -369,7 +443,93 @@ PHP_METHOD(Cryptopp_StreamCipherAbstract, restart) {
     CryptoPP::SymmetricCipher *decryptor;
     CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
     CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    resynchronize(getThis(), encryptor, decryptor TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto void StreamCipherAbstract::seek(int offset)
+   Moves to the given byte offset of the keystream, relative to the initialization vector.
+   Only exposed by child classes whose native objects support random access */
+PHP_METHOD(Cryptopp_StreamCipherAbstract, seek) {
+    long offset;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &offset)) {
+        return;
+    }
+
+    CryptoPP::SymmetricCipher *encryptor;
+    CryptoPP::SymmetricCipher *decryptor;
+    CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+    CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    if (offset < 0) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: offset cannot be negative", ce->name);
+        RETURN_FALSE
+    }
+
+    if (!encryptor->IsRandomAccess() || !decryptor->IsRandomAccess()) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: random access is not supported", ce->name);
+        RETURN_FALSE
+    }
+
+    // check key and iv
+    if (!isCryptoppStreamCipherKeyValid(getThis(), encryptor TSRMLS_CC) || !isCryptoppStreamCipherIvValid(getThis(), encryptor TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    // set the keystream position of both directions, without processing the skipped data
+    try {
+        encryptor->Seek(static_cast<CryptoPP::lword>(offset));
+        decryptor->Seek(static_cast<CryptoPP::lword>(offset));
+    } catch (bool e) {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
+/* {{{ proto array StreamCipherAbstract::encryptBatch(array ivs, array data)
+   Encrypts several strings, each one with the iv having the same key in ivs. Keys of data are preserved.
+   The next call to encrypt() starts again from the current iv, as after restart() */
+PHP_METHOD(Cryptopp_StreamCipherAbstract, encryptBatch) {
+    zval *ivs;
+    zval *data;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "aa", &ivs, &data)) {
+        return;
+    }
+
+    CryptoPP::SymmetricCipher *encryptor;
+    CryptoPP::SymmetricCipher *decryptor;
+    CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+    CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    if (!processBatch(getThis(), encryptor, decryptor, true, ivs, data, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
+/* {{{ proto array StreamCipherAbstract::decryptBatch(array ivs, array data)
+   Decrypts several strings, each one with the iv having the same key in ivs. Keys of data are preserved.
+   The next call to decrypt() starts again from the current iv, as after restart() */
+PHP_METHOD(Cryptopp_StreamCipherAbstract, decryptBatch) {
+    zval *ivs;
+    zval *data;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "aa", &ivs, &data)) {
+        return;
+    }
+
+    CryptoPP::SymmetricCipher *encryptor;
+    CryptoPP::SymmetricCipher *decryptor;
+    CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+    CRYPTOPP_STREAM_CIPHER_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    if (!processBatch(getThis(), encryptor, decryptor, false, ivs, data, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
 }
 /* }}} */
 
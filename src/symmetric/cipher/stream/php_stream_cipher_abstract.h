@@ -46,6 +46,7 @@ struct StreamCipherAbstractContainer {
     zend_object std;
     CryptoPP::SymmetricCipher *encryptor;
     CryptoPP::SymmetricCipher *decryptor;
+    bool keyed;
 };
 
 extern zend_object_handlers StreamCipherAbstract_object_handlers;
@@ -66,6 +67,9 @@ PHP_METHOD(Cryptopp_StreamCipherAbstract, getIv);
 PHP_METHOD(Cryptopp_StreamCipherAbstract, encrypt);
 PHP_METHOD(Cryptopp_StreamCipherAbstract, decrypt);
 PHP_METHOD(Cryptopp_StreamCipherAbstract, restart);
+PHP_METHOD(Cryptopp_StreamCipherAbstract, seek);
+PHP_METHOD(Cryptopp_StreamCipherAbstract, encryptBatch);
+PHP_METHOD(Cryptopp_StreamCipherAbstract, decryptBatch);
 /* }}} */
 
 /* {{{ php cipher classes methods arg info */
@@ -74,6 +78,20 @@ ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO(arginfo_StreamCipherAbstract___sleep, 0)
 ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_StreamCipherAbstract_seek, 0)
+    ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_StreamCipherAbstract_encryptBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, ivs, 0)
+    ZEND_ARG_ARRAY_INFO(0, data, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_StreamCipherAbstract_decryptBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, ivs, 0)
+    ZEND_ARG_ARRAY_INFO(0, data, 0)
+ZEND_END_ARG_INFO()
 /* }}} */
 
 #endif /* PHP_STREAM_CIPHER_ABSTRACT_H */
@@ -0,0 +1,52 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "php_stream_cipher_abstract.h"
+#include "php_xchacha20.h"
+#include "chacha20_core.h"
+
+/* {{{ arginfo */
+ZEND_BEGIN_ARG_INFO(arginfo_StreamCipherXChaCha20_construct, 0)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_class_entry *cryptopp_ce_StreamCipherXChaCha20;
+
+static zend_function_entry cryptopp_methods_StreamCipherXChaCha20[] = {
+    PHP_ME(Cryptopp_StreamCipherXChaCha20, __construct, arginfo_StreamCipherXChaCha20_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_StreamCipherAbstract, seek, arginfo_StreamCipherAbstract_seek, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_FE_END
+};
+
+void init_class_StreamCipherXChaCha20(TSRMLS_D) {
+    init_class_StreamCipherAbstractChild("xchacha20", "StreamCipherXChaCha20", &cryptopp_ce_StreamCipherXChaCha20, cryptopp_methods_StreamCipherXChaCha20 TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto StreamCipherXChaCha20::__construct(void) */
+PHP_METHOD(Cryptopp_StreamCipherXChaCha20, __construct) {
+    XChaCha20::Encryption *encryptor = new XChaCha20::Encryption();
+    XChaCha20::Decryption *decryptor = new XChaCha20::Decryption();
+    setCryptoppStreamCipherEncryptorPtr(getThis(), encryptor TSRMLS_CC);
+    setCryptoppStreamCipherDecryptorPtr(getThis(), decryptor TSRMLS_CC);
+
+    zend_update_property_stringl(cryptopp_ce_StreamCipherAbstract, getThis(), "name", 4, "xchacha20", 9 TSRMLS_CC);
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
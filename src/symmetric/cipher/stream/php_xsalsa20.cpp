@@ -93,6 +93,7 @@ zend_class_entry *cryptopp_ce_StreamCipherXSalsa20;
 static zend_function_entry cryptopp_methods_StreamCipherXSalsa20[] = {
     PHP_ME(Cryptopp_StreamCipherXSalsa20, __construct, arginfo_StreamCipherXSalsa20_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
     PHP_ME(Cryptopp_StreamCipherXSalsa20, setRounds, arginfo_StreamCipherXSalsa20_setRounds, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_StreamCipherAbstract, seek, arginfo_StreamCipherAbstract_seek, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
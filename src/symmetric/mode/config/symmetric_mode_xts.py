@@ -0,0 +1,11 @@
+import os
+
+def getConfig(cryptoppDir):
+    config = {}
+
+    config["enabled"]                   = True
+    config["srcFileList"]               = ["symmetric/mode/php_xts.cpp"]
+    config["headerFileList"]            = ["symmetric/mode/php_xts.h"]
+    config["phpMinitStatements"]        = ["init_class_SymmetricModeXts(TSRMLS_C);"]
+
+    return config
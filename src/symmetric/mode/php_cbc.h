@@ -46,7 +46,8 @@ public:
     };
     /* }}} */
 
-    /* {{{ decryption class */
+    /* {{{ decryption class
+       ciphertext blocks are decrypted in parallel runs, see BlockCipherProxy::Base::AdvancedProcessBlocks() */
     class Decryption : public Base, public CryptoPP::CBC_Mode_ExternalCipher::Decryption
     {
     public:
@@ -46,7 +46,8 @@ public:
     };
     /* }}} */
 
-    /* {{{ decryption class */
+    /* {{{ decryption class
+       as with Cbc::Decryption, previous ciphertext blocks are encrypted in parallel runs */
     class Decryption : public Base, public CryptoPP::CFB_Mode_ExternalCipher::Decryption
     {
     public:
@@ -8,10 +8,21 @@
  */
 
 #include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/symmetric/cipher/block/block_cipher_proxy.h"
 #include "src/symmetric/cipher/block/php_block_cipher_interface.h"
 #include "php_symmetric_mode_abstract.h"
 #include "php_ctr.h"
 #include <modes.h>
+#include <misc.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <zend_exceptions.h>
+
+/* {{{ multi-threading limits */
+#define CTR_MAX_THREADS                 16
+#define CTR_MIN_BYTES_PER_THREAD        1048576
+/* }}} */
 
 /* {{{ fork of CryptoPP::CTR_Mode_ExternalCipher to support block cipher destruction */
 Ctr::Base::~Base()
@@ -22,10 +33,176 @@ Ctr::Base::~Base()
 }
 /* }}} */
 
+/* {{{ addToCtrCounter
+   adds n to a big-endian counter */
+static void addToCtrCounter(byte *counter, unsigned int size, CryptoPP::lword n) {
+    for (int i = size - 1; i >= 0 && n > 0; i--) {
+        n          += counter[i];
+        counter[i]  = static_cast<byte>(n);
+        n         >>= 8;
+    }
+}
+/* }}} */
+
+/* {{{ processCtrBlocks
+   xors blocks with the keystream generated from counter.
+   AdvancedProcessBlocks() only increments the last byte of the counter, so blocks are processed in runs that do not overflow it */
+static void processCtrBlocks(const CryptoPP::BlockCipher &cipher, byte *counter, const byte *input, byte *output, size_t blocks) {
+    unsigned int blockSize = cipher.BlockSize();
+
+    while (blocks > 0) {
+        unsigned int lsb    = counter[blockSize - 1];
+        size_t runBlocks    = CryptoPP::UnsignedMin(blocks, 256U - lsb);
+
+        cipher.AdvancedProcessBlocks(counter, input, output, runBlocks * blockSize, CryptoPP::BlockTransformation::BT_InBlockIsCounter | CryptoPP::BlockTransformation::BT_AllowParallel);
+
+        if (lsb + runBlocks == 256) {
+            // last byte has wrapped
+            CryptoPP::IncrementCounterByOne(counter, blockSize - 1);
+        }
+
+        input  += runBlocks * blockSize;
+        output += runBlocks * blockSize;
+        blocks -= runBlocks;
+    }
+}
+/* }}} */
+
+/* {{{ CtrWorker
+   range of counter blocks processed by a thread */
+struct CtrWorker {
+    pthread_t thread;
+    bool started;
+    CryptoPP::BlockCipher *cipher;
+    CryptoPP::SecByteBlock counter;
+    const byte *input;
+    byte *output;
+    size_t blocks;
+};
+
+static void *runCtrWorker(void *arg) {
+    CtrWorker *worker = static_cast<CtrWorker*>(arg);
+    processCtrBlocks(*worker->cipher, worker->counter, worker->input, worker->output, worker->blocks);
+    return NULL;
+}
+/* }}} */
+
+/* {{{ getCtrThreadCount
+   number of threads used to process length bytes. also used by GCM */
+unsigned int getCtrThreadCount(size_t length) {
+    long cpuCount           = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threadCount      = length / CTR_MIN_BYTES_PER_THREAD;
+
+    if (cpuCount > 0 && threadCount > static_cast<size_t>(cpuCount)) {
+        threadCount = cpuCount;
+    }
+
+    if (threadCount > CTR_MAX_THREADS) {
+        threadCount = CTR_MAX_THREADS;
+    }
+
+    return threadCount;
+}
+/* }}} */
+
+/* {{{ Ctr::Parallel::ProcessData */
+void Ctr::Parallel::ProcessData(byte *outString, const byte *inString, size_t length)
+{
+    unsigned int threadCount = 0;
+
+    if (m_parallelThreshold > 0 && length >= m_parallelThreshold && NULL == dynamic_cast<BlockCipherProxy::Base*>(m_cipher)) {
+        // php user classes can only be called from the php thread
+        threadCount = getCtrThreadCount(length);
+    }
+
+    if (threadCount < 2) {
+        CryptoPP::CTR_Mode_ExternalCipher::Encryption::ProcessData(outString, inString, length);
+        return;
+    }
+
+    // consume the keystream left by a previous call
+    size_t leftOver = CryptoPP::UnsignedMin(m_leftOver, length);
+
+    if (leftOver > 0) {
+        CryptoPP::CTR_Mode_ExternalCipher::Encryption::ProcessData(outString, inString, leftOver);
+        outString  += leftOver;
+        inString   += leftOver;
+        length     -= leftOver;
+    }
+
+    // split full blocks between threads. the calling thread processes the last range
+    unsigned int blockSize  = BlockSize();
+    size_t blocks           = length / blockSize;
+    size_t blocksPerThread  = blocks / threadCount;
+    CtrWorker *workers      = new CtrWorker[threadCount - 1];
+    size_t firstBlock       = 0;
+
+    for (unsigned int i = 0; i < threadCount - 1; i++) {
+        CtrWorker &worker   = workers[i];
+        worker.started      = false;
+        worker.cipher       = NULL;
+        worker.input        = inString + firstBlock * blockSize;
+        worker.output       = outString + firstBlock * blockSize;
+        worker.blocks       = blocksPerThread;
+        worker.counter.Assign(m_counterArray, blockSize);
+        addToCtrCounter(worker.counter, blockSize, firstBlock);
+        firstBlock         += blocksPerThread;
+
+        // block ciphers are not safe to share between threads
+        try {
+            worker.cipher = dynamic_cast<CryptoPP::BlockCipher*>(m_cipher->Clone());
+        } catch (CryptoPP::NotImplemented &e) {
+            worker.cipher = NULL;
+        }
+
+        if (NULL != worker.cipher) {
+            worker.started = 0 == pthread_create(&worker.thread, NULL, runCtrWorker, &worker);
+        }
+    }
+
+    // last range
+    CryptoPP::SecByteBlock counter(m_counterArray, blockSize);
+    addToCtrCounter(counter, blockSize, firstBlock);
+    processCtrBlocks(*m_cipher, counter, inString + firstBlock * blockSize, outString + firstBlock * blockSize, blocks - firstBlock);
+
+    // wait for threads. a range whose thread could not be started is processed here
+    for (unsigned int i = 0; i < threadCount - 1; i++) {
+        CtrWorker &worker = workers[i];
+
+        if (worker.started) {
+            pthread_join(worker.thread, NULL);
+        } else {
+            processCtrBlocks(*m_cipher, worker.counter, worker.input, worker.output, worker.blocks);
+        }
+
+        delete worker.cipher;
+    }
+
+    delete[] workers;
+
+    // move the counter after the processed blocks, and process the last partial block
+    addToCtrCounter(m_counterArray, blockSize, blocks);
+    outString  += blocks * blockSize;
+    inString   += blocks * blockSize;
+    length     -= blocks * blockSize;
+
+    if (length > 0) {
+        CryptoPP::CTR_Mode_ExternalCipher::Encryption::ProcessData(outString, inString, length);
+    }
+}
+/* }}} */
+
 /* {{{ arginfo */
 ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeCtr_construct, 0)
     ZEND_ARG_OBJ_INFO(0, cipher, Cryptopp\\BlockCipherInterface, 0)
 ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeCtr_setParallelThreshold, 0)
+    ZEND_ARG_INFO(0, threshold)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeCtr_getParallelThreshold, 0)
+ZEND_END_ARG_INFO()
 /* }}} */
 
 /* {{{ PHP class declaration */
@@ -33,6 +210,9 @@ zend_class_entry *cryptopp_ce_SymmetricModeCtr;
 
 static zend_function_entry cryptopp_methods_SymmetricModeCtr[] = {
     PHP_ME(Cryptopp_SymmetricModeCtr, __construct, arginfo_SymmetricModeCtr_construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_SymmetricModeAbstract, seek, arginfo_SymmetricModeAbstract_seek, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeCtr, setParallelThreshold, arginfo_SymmetricModeCtr_setParallelThreshold, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeCtr, getParallelThreshold, arginfo_SymmetricModeCtr_getParallelThreshold, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
@@ -78,6 +258,40 @@ PHP_METHOD(Cryptopp_SymmetricModeCtr, __construct) {
 }
 /* }}} */
 
+/* {{{ proto void SymmetricModeCtr::setParallelThreshold(int threshold)
+   Sets the data size from which encryption and decryption are split between several threads. 0 disables multi-threading */
+PHP_METHOD(Cryptopp_SymmetricModeCtr, setParallelThreshold) {
+    long threshold;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &threshold)) {
+        return;
+    }
+
+    if (threshold < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: threshold cannot be negative", cryptopp_ce_SymmetricModeCtr->name);
+        RETURN_FALSE
+    }
+
+    CryptoPP::SymmetricCipher *encryptor;
+    CryptoPP::SymmetricCipher *decryptor;
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    dynamic_cast<Ctr::Parallel*>(encryptor)->SetParallelThreshold(threshold);
+    dynamic_cast<Ctr::Parallel*>(decryptor)->SetParallelThreshold(threshold);
+}
+/* }}} */
+
+/* {{{ proto int SymmetricModeCtr::getParallelThreshold(void)
+   Returns the data size from which encryption and decryption are split between several threads */
+PHP_METHOD(Cryptopp_SymmetricModeCtr, getParallelThreshold) {
+    CryptoPP::SymmetricCipher *encryptor;
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+
+    RETURN_LONG(dynamic_cast<Ctr::Parallel*>(encryptor)->GetParallelThreshold())
+}
+/* }}} */
+
 /*
  * Local variables:
  * tab-width: 4
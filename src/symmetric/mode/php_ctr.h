@@ -15,6 +15,14 @@
 
 void init_class_SymmetricModeCtr(TSRMLS_D);
 PHP_METHOD(Cryptopp_SymmetricModeCtr, __construct);
+PHP_METHOD(Cryptopp_SymmetricModeCtr, setParallelThreshold);
+PHP_METHOD(Cryptopp_SymmetricModeCtr, getParallelThreshold);
+
+/* {{{ inputs from this size are split between several threads by default */
+#define CTR_DEFAULT_PARALLEL_THRESHOLD 4194304
+/* }}} */
+
+unsigned int getCtrThreadCount(size_t length);
 
 /* {{{ fork of CryptoPP::CTR_Mode_ExternalCipher to support block cipher destruction */
 class Ctr
@@ -36,23 +44,42 @@ public:
     };
     /* }}} */
 
+    /* {{{ ctr transformation (same for both directions)
+       inputs larger than the parallel threshold are split in ranges of counter blocks, each one processed by its own thread
+       with a copy of the native block cipher. user block ciphers are always processed by the calling thread */
+    class Parallel : public CryptoPP::CTR_Mode_ExternalCipher::Encryption
+    {
+    public:
+        Parallel(CryptoPP::BlockCipher *cipher, byte *iv, int ivSize)
+            : CryptoPP::CTR_Mode_ExternalCipher::Encryption(*cipher, iv, ivSize)
+            , m_parallelThreshold(CTR_DEFAULT_PARALLEL_THRESHOLD) {};
+
+        void ProcessData(byte *outString, const byte *inString, size_t length);
+        void SetParallelThreshold(size_t threshold) {m_parallelThreshold = threshold;}
+        size_t GetParallelThreshold() const {return m_parallelThreshold;}
+
+    protected:
+        size_t m_parallelThreshold;
+    };
+    /* }}} */
+
     /* {{{ encryption class */
-    class Encryption : public Base, public CryptoPP::CTR_Mode_ExternalCipher::Encryption
+    class Encryption : public Base, public Parallel
     {
     public:
         Encryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed, byte *iv, int ivSize)
             : Base(cipher, cipherMustBeDestructed)
-            , CryptoPP::CTR_Mode_ExternalCipher::Encryption(*cipher, iv, ivSize) {};
+            , Parallel(cipher, iv, ivSize) {};
     };
     /* }}} */
 
     /* {{{ decryption class */
-    class Decryption : public Base, public CryptoPP::CTR_Mode_ExternalCipher::Decryption
+    class Decryption : public Base, public Parallel
     {
     public:
         Decryption(CryptoPP::BlockCipher *cipher, bool cipherMustBeDestructed, byte *iv, int ivSize)
             : Base(cipher, cipherMustBeDestructed)
-            , CryptoPP::CTR_Mode_ExternalCipher::Decryption(*cipher, iv, ivSize) {};
+            , Parallel(cipher, iv, ivSize) {};
     };
     /* }}} */
 };
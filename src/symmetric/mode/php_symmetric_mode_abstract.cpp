@@ -21,6 +21,7 @@
 #include "php_symmetric_mode_abstract.h"
 #include <zend_exceptions.h>
 #include <string>
+#include <vector>
 
 /* {{{ SymmetricModeAbstract_free_storage
    custom object free handler */
@@ -51,6 +52,8 @@ static zend_function_entry cryptopp_methods_SymmetricModeAbstract[] = {
     PHP_ME(Cryptopp_SymmetricModeAbstract, encrypt, arginfo_SymmetricTransformationInterface_encrypt, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_ME(Cryptopp_SymmetricModeAbstract, decrypt, arginfo_SymmetricTransformationInterface_decrypt, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_ME(Cryptopp_SymmetricModeAbstract, restart, arginfo_SymmetricTransformationInterface_restart, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeAbstract, encryptBatch, arginfo_SymmetricModeAbstract_encryptBatch, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeAbstract, decryptBatch, arginfo_SymmetricModeAbstract_decryptBatch, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
     PHP_FE_END
 };
 
@@ -69,7 +72,6 @@ void init_class_SymmetricModeAbstract(TSRMLS_D) {
     zend_declare_property_null(cryptopp_ce_SymmetricModeAbstract, "cipher", 6, ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_string(cryptopp_ce_SymmetricModeAbstract, "name", 4, "",  ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_string(cryptopp_ce_SymmetricModeAbstract, "iv", 2, "",  ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_bool(cryptopp_ce_SymmetricModeAbstract, "ivSetted", 8, 0, ZEND_ACC_PRIVATE TSRMLS_CC);
 }
 /* }}} */
 
@@ -154,9 +156,11 @@ bool cryptoppSymmetricModeGetCipherElements(
     cipherMustBeDestructed = false;
 
     if (instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_BlockCipherAbstract TSRMLS_CC)) {
-        // retrieve native objects
-        *cipherEncryptor = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(cipherObject TSRMLS_CC))->encryptor;
-        *cipherDecryptor = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(cipherObject TSRMLS_CC))->decryptor;
+        // retrieve native objects. the key length of a native cipher is then read without calling php code
+        BlockCipherAbstractContainer *cipherContainer = static_cast<BlockCipherAbstractContainer *>(zend_object_store_get_object(cipherObject TSRMLS_CC));
+        *cipherEncryptor = cipherContainer->encryptor;
+        *cipherDecryptor = cipherContainer->decryptor;
+        static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(modeObject TSRMLS_CC))->nativeCipher = cipherContainer;
     } else if (instanceof_function(Z_OBJCE_P(cipherObject), cryptopp_ce_BlockCipherInterface TSRMLS_CC)) {
         // create a proxy to the user php object
         try {
@@ -224,10 +228,16 @@ static inline zval *getCipherKey(zval *object TSRMLS_DC) {
 /* {{{ isCryptoppSymmetricModeKeyValid
    verify that a key size is valid for a SymmetricModeAbstract instance */
 bool isCryptoppSymmetricModeKeyValid(zval *object, CryptoPP::SymmetricCipher *mode TSRMLS_DC) {
-    zval *key;
-    key         = getCipherKey(object TSRMLS_CC);
-    int keySize = IS_STRING == Z_TYPE_P(key) ? Z_STRLEN_P(key) : 0;
-    zval_ptr_dtor(&key);
+    SymmetricModeAbstractContainer *container   = static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    int keySize                                 = 0;
+
+    if (NULL != container->nativeCipher) {
+        keySize = container->nativeCipher->keyLength;
+    } else {
+        zval *key   = getCipherKey(object TSRMLS_CC);
+        keySize     = IS_STRING == Z_TYPE_P(key) ? Z_STRLEN_P(key) : 0;
+        zval_ptr_dtor(&key);
+    }
 
     return isCryptoppSymmetricKeyValid(object, mode, keySize TSRMLS_CC);
 }
@@ -236,37 +246,110 @@ bool isCryptoppSymmetricModeKeyValid(zval *object, CryptoPP::SymmetricCipher *mo
 /* {{{ isCryptoppSymmetricModeIvValid
    verify that an iv size is valid for a SymmetricModeAbstract instance */
 bool isCryptoppSymmetricModeIvValid(zval *object, CryptoPP::SymmetricCipher *mode TSRMLS_DC) {
-    zval *iv;
-    iv          = zend_read_property(cryptopp_ce_SymmetricModeAbstract, object, "iv", 2, 1 TSRMLS_CC);
-    int ivSize  = Z_STRLEN_P(iv);
-
+    int ivSize = static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC))->ivLength;
     return isCryptoppSymmetricIvValid(object, mode, ivSize TSRMLS_CC);
 }
 /* }}} */
 
 /* {{{ setKeyWithIv
-   sets the key and the iv (if applicable) of the native mode objects of a mode php object */
-static void setKeyWithIv(zval *object, CryptoPP::SymmetricCipher *encryptor, CryptoPP::SymmetricCipher *decryptor TSRMLS_DC) {
+   sets the key and the iv (if applicable) of the native mode objects of a mode php object.
+   returns false if the key or the iv is not set yet */
+static bool setKeyWithIv(zval *object, CryptoPP::SymmetricCipher *encryptor, CryptoPP::SymmetricCipher *decryptor TSRMLS_DC) {
     zval *zKey      = getCipherKey(object TSRMLS_CC);
     zval *zIv       = zend_read_property(cryptopp_ce_SymmetricModeAbstract, object, "iv", 2, 1 TSRMLS_CC);
     bool ivSetted   = setSymmetricCipherKeyIv(object, encryptor, decryptor, zKey, zIv TSRMLS_CC);
     zval_ptr_dtor(&zKey);
 
-    if (ivSetted) {
-        zend_update_property_bool(cryptopp_ce_SymmetricModeAbstract, object, "ivSetted", 8, 1 TSRMLS_CC);
+    return ivSetted;
+}
+/* }}} */
+
+/* {{{ invalidateNativeKeys
+   indicates that the native mode objects must be keyed again with the current key and iv before their next use */
+static inline void invalidateNativeKeys(zval *object TSRMLS_DC) {
+    SymmetricModeAbstractContainer *container   = static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    container->encryptorKeyed                   = false;
+    container->decryptorKeyed                   = false;
+}
+/* }}} */
+
+/* {{{ invalidateNativeIvs
+   indicates that the native mode objects must be resynchronized with the current iv before their next use.
+   their key schedule is kept */
+static inline void invalidateNativeIvs(zval *object TSRMLS_DC) {
+    SymmetricModeAbstractContainer *container   = static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    container->encryptorIvSynchronized          = false;
+    container->decryptorIvSynchronized          = false;
+}
+/* }}} */
+
+/* {{{ resynchronize
+   loads the current iv into a native mode object without running its key schedule again */
+static void resynchronize(zval *object, CryptoPP::SymmetricCipher *mode TSRMLS_DC) {
+    if (!mode->IsResynchronizable()) {
+        // there is no iv to load
+        return;
+    }
+
+    zval *zIv = zend_read_property(cryptopp_ce_SymmetricModeAbstract, object, "iv", 2, 1 TSRMLS_CC);
+    mode->Resynchronize(reinterpret_cast<byte*>(Z_STRVAL_P(zIv)), Z_STRLEN_P(zIv));
+}
+/* }}} */
+
+/* {{{ ensureCryptoppSymmetricModeKeyed
+   keys the native encryptor or decryptor of a SymmetricModeAbstract instance if the key or the iv changed since its last use.
+   each direction is keyed on its first use, so that an object only used to encrypt never schedules the decryption key.
+   when only the iv changed, the direction is resynchronized instead. a key set directly on the cipher object needs nothing
+   more: modes have no state depending on the key besides the cipher itself, which is keyed by its own setKey() */
+void ensureCryptoppSymmetricModeKeyed(zval *object, bool encryption TSRMLS_DC) {
+    SymmetricModeAbstractContainer *container = static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+
+    if (encryption && !container->encryptorKeyed) {
+        container->encryptorKeyed           = setKeyWithIv(object, container->encryptor, NULL TSRMLS_CC);
+        container->encryptorIvSynchronized  = container->encryptorKeyed;
+    } else if (encryption && !container->encryptorIvSynchronized) {
+        resynchronize(object, container->encryptor TSRMLS_CC);
+        container->encryptorIvSynchronized  = true;
+    } else if (!encryption && !container->decryptorKeyed) {
+        container->decryptorKeyed           = setKeyWithIv(object, NULL, container->decryptor TSRMLS_CC);
+        container->decryptorIvSynchronized  = container->decryptorKeyed;
+    } else if (!encryption && !container->decryptorIvSynchronized) {
+        resynchronize(object, container->decryptor TSRMLS_CC);
+        container->decryptorIvSynchronized  = true;
     }
 }
 /* }}} */
 
-/* {{{ ensureIvIsSet
-   ensure the iv is set.
-   If cipher's setKey() is called after setIv(), the internal iv of the native cryptopp object may not be set. */
-static inline void ensureIvIsSet(zval *object, CryptoPP::SymmetricCipher *encryptor, CryptoPP::SymmetricCipher *decryptor TSRMLS_DC) {
-    zval *ivSetted = zend_read_property(cryptopp_ce_SymmetricModeAbstract, object, "ivSetted", 8, 1 TSRMLS_CC);
+/* {{{ processBatch
+   encrypts or decrypts a list of data, each one with its own iv. the native object is keyed if it was not yet, and is then
+   only resynchronized between items. it goes back to the current iv on its next use. returns false on failure */
+static bool processBatch(zval *object, CryptoPP::SymmetricCipher *mode, bool encryption, zval *ivs, zval *data, zval *return_value TSRMLS_DC) {
+    std::vector<SymmetricCipherBatchItem> items;
+
+    if (!isCryptoppSymmetricModeKeyValid(object, mode TSRMLS_CC) || !getSymmetricCipherBatchItems(object, mode, ivs, data, items TSRMLS_CC)) {
+        return false;
+    } else if (items.empty()) {
+        array_init(return_value);
+        return true;
+    }
+
+    SymmetricModeAbstractContainer *container   = static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(object TSRMLS_CC));
+    bool &keyed                                 = encryption ? container->encryptorKeyed : container->decryptorKeyed;
 
-    if (!Z_BVAL_P(ivSetted)) {
-        setKeyWithIv(object, encryptor, decryptor TSRMLS_CC);
+    if (!keyed) {
+        // the key schedule is run once, with the iv of the first item
+        zval *zKey  = getCipherKey(object TSRMLS_CC);
+        keyed       = setSymmetricCipherKeyIv(object, encryption ? mode : NULL, encryption ? NULL : mode, zKey, items[0].iv TSRMLS_CC);
+        zval_ptr_dtor(&zKey);
     }
+
+    if (encryption) {
+        container->encryptorIvSynchronized = false;
+    } else {
+        container->decryptorIvSynchronized = false;
+    }
+
+    return processSymmetricCipherBatch(mode, items, return_value TSRMLS_CC);
 }
 /* }}} */
 
@@ -372,8 +455,8 @@ PHP_METHOD(Cryptopp_SymmetricModeAbstract, setKey) {
     zval_ptr_dtor(&zKey);
     zval_ptr_dtor(&output);
 
-    // set the key on both the php object and the native cryptopp object
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    // native objects will be keyed on their next use
+    invalidateNativeKeys(getThis() TSRMLS_CC);
 }
 /* }}} */
 
@@ -397,9 +480,10 @@ PHP_METHOD(Cryptopp_SymmetricModeAbstract, setIv) {
         RETURN_FALSE;
     }
 
-    // set the iv on both the php object and the native cryptopp object
+    // set the iv on the php object. native objects will be resynchronized on their next use
     zend_update_property_stringl(cryptopp_ce_SymmetricModeAbstract, getThis(), "iv", 2, iv, ivSize TSRMLS_CC);
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    static_cast<SymmetricModeAbstractContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC))->ivLength = ivSize;
+    invalidateNativeIvs(getThis() TSRMLS_CC);
 }
 /* }}} */
 
@@ -438,7 +522,7 @@ PHP_METHOD(Cryptopp_SymmetricModeAbstract, encrypt) {
         RETURN_FALSE
     }
 
-    ensureIvIsSet(getThis(), encryptor, NULL TSRMLS_CC);
+    ensureCryptoppSymmetricModeKeyed(getThis(), true TSRMLS_CC);
 
     // check dataSize against block size
     int blockSize = static_cast<int>(encryptor->MandatoryBlockSize());
@@ -481,7 +565,7 @@ PHP_METHOD(Cryptopp_SymmetricModeAbstract, decrypt) {
         RETURN_FALSE
     }
 
-    ensureIvIsSet(getThis(), NULL, decryptor TSRMLS_CC);
+    ensureCryptoppSymmetricModeKeyed(getThis(), false TSRMLS_CC);
 
     // check dataSize against block size
     int blockSize = static_cast<int>(decryptor->MandatoryBlockSize());
@@ -513,7 +597,88 @@ PHP_METHOD(Cryptopp_SymmetricModeAbstract, restart) {
     CryptoPP::SymmetricCipher *decryptor;
     CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor);
     CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_DECRYPTOR_PTR(decryptor);
-    setKeyWithIv(getThis(), encryptor, decryptor TSRMLS_CC);
+    invalidateNativeIvs(getThis() TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto void SymmetricModeAbstract::seek(int offset)
+   Moves to the given byte offset of the keystream, relative to the initialization vector.
+   Only exposed by child classes whose native objects support random access */
+PHP_METHOD(Cryptopp_SymmetricModeAbstract, seek) {
+    long offset;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &offset)) {
+        return;
+    }
+
+    CryptoPP::SymmetricCipher *encryptor;
+    CryptoPP::SymmetricCipher *decryptor;
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    if (offset < 0) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: offset cannot be negative", ce->name);
+        RETURN_FALSE
+    }
+
+    if (!encryptor->IsRandomAccess() || !decryptor->IsRandomAccess()) {
+        zend_class_entry *ce = zend_get_class_entry(getThis() TSRMLS_CC);
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: random access is not supported", ce->name);
+        RETURN_FALSE
+    }
+
+    // check key and iv
+    if (!isCryptoppSymmetricModeKeyValid(getThis(), encryptor TSRMLS_CC) || !isCryptoppSymmetricModeIvValid(getThis(), encryptor TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    ensureCryptoppSymmetricModeKeyed(getThis(), true TSRMLS_CC);
+    ensureCryptoppSymmetricModeKeyed(getThis(), false TSRMLS_CC);
+
+    // set the keystream position of both directions, without processing the skipped data
+    encryptor->Seek(static_cast<CryptoPP::lword>(offset));
+    decryptor->Seek(static_cast<CryptoPP::lword>(offset));
+}
+/* }}} */
+
+/* {{{ proto array SymmetricModeAbstract::encryptBatch(array ivs, array data)
+   Encrypts several strings, each one with the iv having the same key in ivs. Keys of data are preserved.
+   The next call to encrypt() starts again from the current iv, as after restart() */
+PHP_METHOD(Cryptopp_SymmetricModeAbstract, encryptBatch) {
+    zval *ivs;
+    zval *data;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "aa", &ivs, &data)) {
+        return;
+    }
+
+    CryptoPP::SymmetricCipher *encryptor;
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_ENCRYPTOR_PTR(encryptor)
+
+    if (!processBatch(getThis(), encryptor, true, ivs, data, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+}
+/* }}} */
+
+/* {{{ proto array SymmetricModeAbstract::decryptBatch(array ivs, array data)
+   Decrypts several strings, each one with the iv having the same key in ivs. Keys of data are preserved.
+   The next call to decrypt() starts again from the current iv, as after restart() */
+PHP_METHOD(Cryptopp_SymmetricModeAbstract, decryptBatch) {
+    zval *ivs;
+    zval *data;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "aa", &ivs, &data)) {
+        return;
+    }
+
+    CryptoPP::SymmetricCipher *decryptor;
+    CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_DECRYPTOR_PTR(decryptor)
+
+    if (!processBatch(getThis(), decryptor, false, ivs, data, return_value TSRMLS_CC)) {
+        RETURN_FALSE
+    }
 }
 /* }}} */
 
@@ -11,6 +11,7 @@
 #define PHP_SYMMETRIC_MODE_ABSTRACT_H
 
 #include "src/php_cryptopp.h"
+#include "src/symmetric/cipher/block/php_block_cipher_abstract.h"
 
 extern zend_class_entry *cryptopp_ce_SymmetricModeAbstract;
 void init_class_SymmetricModeAbstract(TSRMLS_D);
@@ -22,6 +23,7 @@ void setCryptoppSymmetricModeEncryptorPtr(zval *this_ptr, CryptoPP::SymmetricCip
 void setCryptoppSymmetricModeDecryptorPtr(zval *this_ptr, CryptoPP::SymmetricCipher *nativePtr TSRMLS_DC);
 bool isCryptoppSymmetricModeKeyValid(zval *object, CryptoPP::SymmetricCipher *mode TSRMLS_DC);
 bool isCryptoppSymmetricModeIvValid(zval *object, CryptoPP::SymmetricCipher *mode TSRMLS_DC);
+void ensureCryptoppSymmetricModeKeyed(zval *object, bool encryption TSRMLS_DC);
 
 /* {{{ get the pointer to the native encryptor object of a php mode class */
 #define CRYPTOPP_SYMMETRIC_MODE_ABSTRACT_GET_ENCRYPTOR_PTR(ptrName)         \
@@ -46,6 +48,12 @@ struct SymmetricModeAbstractContainer {
     zend_object std;
     CryptoPP::SymmetricCipher *encryptor;
     CryptoPP::SymmetricCipher *decryptor;
+    bool encryptorKeyed;
+    bool decryptorKeyed;
+    bool encryptorIvSynchronized;
+    bool decryptorIvSynchronized;
+    BlockCipherAbstractContainer *nativeCipher;
+    int ivLength;
 };
 
 extern zend_object_handlers SymmetricModeAbstract_object_handlers;
@@ -66,6 +74,9 @@ PHP_METHOD(Cryptopp_SymmetricModeAbstract, getIv);
 PHP_METHOD(Cryptopp_SymmetricModeAbstract, encrypt);
 PHP_METHOD(Cryptopp_SymmetricModeAbstract, decrypt);
 PHP_METHOD(Cryptopp_SymmetricModeAbstract, restart);
+PHP_METHOD(Cryptopp_SymmetricModeAbstract, seek);
+PHP_METHOD(Cryptopp_SymmetricModeAbstract, encryptBatch);
+PHP_METHOD(Cryptopp_SymmetricModeAbstract, decryptBatch);
 /* }}} */
 
 /* {{{ php mode classes methods arg info */
@@ -74,6 +85,20 @@ ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeAbstract___sleep, 0)
 ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeAbstract_seek, 0)
+    ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeAbstract_encryptBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, ivs, 0)
+    ZEND_ARG_ARRAY_INFO(0, data, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeAbstract_decryptBatch, 0)
+    ZEND_ARG_ARRAY_INFO(0, ivs, 0)
+    ZEND_ARG_ARRAY_INFO(0, data, 0)
+ZEND_END_ARG_INFO()
 /* }}} */
 
 /* {{{ Get needed cipher elements to build a mode object */
@@ -0,0 +1,427 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "src/php_cryptopp.h"
+#include "src/exception/php_exception.h"
+#include "src/symmetric/cipher/block/php_block_cipher_abstract.h"
+#include "src/utils/zval_utils.h"
+#include "php_xts.h"
+#include <misc.h>
+#include <secblock.h>
+#include <string>
+#include <zend_exceptions.h>
+
+/* {{{ arg info */
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts___construct, 0)
+    ZEND_ARG_OBJ_INFO(0, dataCipher, Cryptopp\\BlockCipherAbstract, 0)
+    ZEND_ARG_OBJ_INFO(0, tweakCipher, Cryptopp\\BlockCipherAbstract, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts___wakeup, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts___sleep, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts_getName, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts_encryptSector, 0)
+    ZEND_ARG_INFO(0, sector)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts_decryptSector, 0)
+    ZEND_ARG_INFO(0, sector)
+    ZEND_ARG_INFO(0, data)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts_encryptSectors, 0)
+    ZEND_ARG_INFO(0, firstSector)
+    ZEND_ARG_INFO(0, data)
+    ZEND_ARG_INFO(0, sectorSize)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_SymmetricModeXts_decryptSectors, 0)
+    ZEND_ARG_INFO(0, firstSector)
+    ZEND_ARG_INFO(0, data)
+    ZEND_ARG_INFO(0, sectorSize)
+ZEND_END_ARG_INFO()
+/* }}} */
+
+/* {{{ SymmetricModeXts_free_storage
+   custom object free handler */
+void SymmetricModeXts_free_storage(void *object TSRMLS_DC) {
+    // native ciphers are owned by the BlockCipherAbstract objects
+    SymmetricModeXtsContainer *obj = static_cast<SymmetricModeXtsContainer *>(object);
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+    efree(obj);
+}
+/* }}} */
+
+/* {{{ PHP class declaration */
+zend_object_handlers SymmetricModeXts_object_handlers;
+zend_class_entry *cryptopp_ce_SymmetricModeXts;
+
+static zend_function_entry cryptopp_methods_SymmetricModeXts[] = {
+    PHP_ME(Cryptopp_SymmetricModeXts, __construct, arginfo_SymmetricModeXts___construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
+    PHP_ME(Cryptopp_SymmetricModeXts, __sleep, arginfo_SymmetricModeXts___sleep, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeXts, __wakeup, arginfo_SymmetricModeXts___wakeup, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeXts, getName, arginfo_SymmetricModeXts_getName, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeXts, encryptSector, arginfo_SymmetricModeXts_encryptSector, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeXts, decryptSector, arginfo_SymmetricModeXts_decryptSector, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeXts, encryptSectors, arginfo_SymmetricModeXts_encryptSectors, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_ME(Cryptopp_SymmetricModeXts, decryptSectors, arginfo_SymmetricModeXts_decryptSectors, ZEND_ACC_PUBLIC | ZEND_ACC_FINAL)
+    PHP_FE_END
+};
+
+void init_class_SymmetricModeXts(TSRMLS_D) {
+    zend_class_entry ce;
+    INIT_NS_CLASS_ENTRY(ce, "Cryptopp", "SymmetricModeXts", cryptopp_methods_SymmetricModeXts);
+    cryptopp_ce_SymmetricModeXts                    = zend_register_internal_class(&ce TSRMLS_CC);
+
+    cryptopp_ce_SymmetricModeXts->create_object     = zend_custom_create_handler<SymmetricModeXtsContainer, SymmetricModeXts_free_storage, &SymmetricModeXts_object_handlers>;
+    memcpy(&SymmetricModeXts_object_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    SymmetricModeXts_object_handlers.clone_obj      = NULL;
+
+    zend_declare_property_null(cryptopp_ce_SymmetricModeXts, "dataCipher", 10, ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(cryptopp_ce_SymmetricModeXts, "tweakCipher", 11, ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_string(cryptopp_ce_SymmetricModeXts, "name", 4, "",  ZEND_ACC_PRIVATE TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ getCryptoppSymmetricModeXtsContainer
+   get the native objects of the php class */
+static SymmetricModeXtsContainer *getCryptoppSymmetricModeXtsContainer(zval *this_ptr TSRMLS_DC) {
+    SymmetricModeXtsContainer *container = static_cast<SymmetricModeXtsContainer *>(zend_object_store_get_object(this_ptr TSRMLS_CC));
+
+    if (NULL == container->dataEncryptor || NULL == container->dataDecryptor || NULL == container->tweakEncryptor) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"Cryptopp\\SymmetricModeXts : constructor was not called");
+        return NULL;
+    }
+
+    return container;
+}
+/* }}} */
+
+/* {{{ xtsMultiplyByAlpha
+   multiplies a tweak by the primitive element of GF(2^128) (IEEE 1619, little-endian) */
+static inline void xtsMultiplyByAlpha(byte *tweak) {
+    byte carry = 0;
+
+    for (int i = 0; i < XTS_BLOCK_SIZE; i++) {
+        byte nextCarry  = tweak[i] >> 7;
+        tweak[i]        = static_cast<byte>(tweak[i] << 1) | carry;
+        carry           = nextCarry;
+    }
+
+    if (carry) {
+        tweak[0] ^= 0x87;
+    }
+}
+/* }}} */
+
+/* {{{ xtsProcessBlocks
+   processes consecutive blocks whose tweaks are at the same offset in tweaks. all blocks are handed to the cipher at once */
+static inline void xtsProcessBlocks(const CryptoPP::BlockCipher &cipher, const byte *tweaks, const byte *input, byte *output, size_t length) {
+    if (0 == length) {
+        return;
+    }
+
+    cipher.AdvancedProcessBlocks(input, tweaks, output, length, CryptoPP::BlockTransformation::BT_XorInput | CryptoPP::BlockTransformation::BT_AllowParallel);
+    CryptoPP::xorbuf(output, tweaks, length);
+}
+/* }}} */
+
+/* {{{ xtsProcessSectors
+   encrypts or decrypts consecutive sectors. the last sector can be shorter than sectorSize.
+   blocks of all sectors are processed with a single call, except the last two blocks of sectors that need ciphertext stealing */
+static void xtsProcessSectors(
+    const CryptoPP::BlockCipher &cipher,
+    const CryptoPP::BlockCipher &tweakEncryptor,
+    bool encryption,
+    CryptoPP::word64 firstSector,
+    const byte *input,
+    byte *output,
+    size_t length,
+    size_t sectorSize
+) {
+    size_t sectorCount = (length + sectorSize - 1) / sectorSize;
+
+    // encrypt the initial tweak of all sectors
+    CryptoPP::SecByteBlock sectorTweaks(sectorCount * XTS_BLOCK_SIZE);
+    memset(sectorTweaks, 0, sectorTweaks.size());
+
+    for (size_t i = 0; i < sectorCount; i++) {
+        CryptoPP::PutWord(false, CryptoPP::LITTLE_ENDIAN_ORDER, sectorTweaks + i * XTS_BLOCK_SIZE, static_cast<CryptoPP::word64>(firstSector + i));
+    }
+
+    tweakEncryptor.AdvancedProcessBlocks(sectorTweaks, NULL, sectorTweaks, sectorTweaks.size(), CryptoPP::BlockTransformation::BT_AllowParallel);
+
+    // tweak of each block, at the same offset than the block
+    CryptoPP::SecByteBlock tweaks(length + XTS_BLOCK_SIZE);
+    size_t pendingOffset = 0;
+
+    for (size_t i = 0; i < sectorCount; i++) {
+        size_t offset       = i * sectorSize;
+        size_t sectorLength = CryptoPP::UnsignedMin(sectorSize, length - offset);
+        size_t remainder    = sectorLength % XTS_BLOCK_SIZE;
+        size_t blocks       = sectorLength / XTS_BLOCK_SIZE - (remainder > 0 ? 1 : 0);
+        byte tweak[XTS_BLOCK_SIZE];
+        memcpy(tweak, sectorTweaks + i * XTS_BLOCK_SIZE, XTS_BLOCK_SIZE);
+
+        for (size_t j = 0; j < blocks; j++) {
+            memcpy(tweaks + offset + j * XTS_BLOCK_SIZE, tweak, XTS_BLOCK_SIZE);
+            xtsMultiplyByAlpha(tweak);
+        }
+
+        if (0 == remainder) {
+            continue;
+        }
+
+        // ciphertext stealing. process pending blocks first
+        size_t stealOffset = offset + blocks * XTS_BLOCK_SIZE;
+        xtsProcessBlocks(cipher, tweaks + pendingOffset, input + pendingOffset, output + pendingOffset, stealOffset - pendingOffset);
+        pendingOffset = offset + sectorLength;
+
+        // the last full block uses the tweak of the partial block when decrypting
+        byte nextTweak[XTS_BLOCK_SIZE];
+        memcpy(nextTweak, tweak, XTS_BLOCK_SIZE);
+        xtsMultiplyByAlpha(nextTweak);
+
+        byte block[XTS_BLOCK_SIZE];
+        xtsProcessBlocks(cipher, encryption ? tweak : nextTweak, input + stealOffset, block, XTS_BLOCK_SIZE);
+        memcpy(output + stealOffset + XTS_BLOCK_SIZE, block, remainder);
+        memcpy(block, input + stealOffset + XTS_BLOCK_SIZE, remainder);
+        xtsProcessBlocks(cipher, encryption ? nextTweak : tweak, block, output + stealOffset, XTS_BLOCK_SIZE);
+    }
+
+    xtsProcessBlocks(cipher, tweaks + pendingOffset, input + pendingOffset, output + pendingOffset, length - pendingOffset);
+}
+/* }}} */
+
+/* {{{ processSectors
+   checks parameters and keys, then encrypts or decrypts sectors. returns NULL on failure */
+static byte *processSectors(zval *object, bool encryption, long firstSector, const char *data, int dataSize, long sectorSize TSRMLS_DC) {
+    SymmetricModeXtsContainer *container = getCryptoppSymmetricModeXtsContainer(object TSRMLS_CC);
+
+    if (NULL == container) {
+        return NULL;
+    }
+
+    // check keys
+    zval *dataCipher    = zend_read_property(cryptopp_ce_SymmetricModeXts, object, "dataCipher", 10, 0 TSRMLS_CC);
+    zval *tweakCipher   = zend_read_property(cryptopp_ce_SymmetricModeXts, object, "tweakCipher", 11, 0 TSRMLS_CC);
+
+    if (!isCryptoppBlockCipherKeyValid(dataCipher, container->dataEncryptor TSRMLS_CC) || !isCryptoppBlockCipherKeyValid(tweakCipher, container->tweakEncryptor TSRMLS_CC)) {
+        return NULL;
+    }
+
+    // check parameters
+    if (firstSector < 0) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: sector cannot be negative", cryptopp_ce_SymmetricModeXts->name);
+        return NULL;
+    } else if (sectorSize < XTS_BLOCK_SIZE) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: sector size must be at least %d bytes, %ld given", cryptopp_ce_SymmetricModeXts->name, XTS_BLOCK_SIZE, sectorSize);
+        return NULL;
+    }
+
+    size_t lastSectorSize = static_cast<size_t>(dataSize) % static_cast<size_t>(sectorSize);
+
+    if (dataSize < XTS_BLOCK_SIZE || (lastSectorSize > 0 && lastSectorSize < XTS_BLOCK_SIZE)) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: each sector must be at least %d bytes long", cryptopp_ce_SymmetricModeXts->name, XTS_BLOCK_SIZE);
+        return NULL;
+    }
+
+    // process
+    byte *output = new byte[dataSize];
+    xtsProcessSectors(
+        encryption ? *container->dataEncryptor : *container->dataDecryptor,
+        *container->tweakEncryptor,
+        encryption,
+        static_cast<CryptoPP::word64>(firstSector),
+        reinterpret_cast<const byte*>(data),
+        output,
+        dataSize,
+        sectorSize
+    );
+
+    return output;
+}
+/* }}} */
+
+/* {{{ proto SymmetricModeXts::__construct(Cryptopp\BlockCipherAbstract dataCipher, Cryptopp\BlockCipherAbstract tweakCipher)
+   The key of dataCipher encrypts data, the key of tweakCipher encrypts sector numbers. keys should be different */
+PHP_METHOD(Cryptopp_SymmetricModeXts, __construct) {
+    zval *dataCipher;
+    zval *tweakCipher;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "OO", &dataCipher, cryptopp_ce_BlockCipherAbstract, &tweakCipher, cryptopp_ce_BlockCipherAbstract)) {
+        return;
+    }
+
+    CryptoPP::BlockCipher *dataEncryptor    = getCryptoppBlockCipherEncryptorPtr(dataCipher TSRMLS_CC);
+    CryptoPP::BlockCipher *dataDecryptor    = getCryptoppBlockCipherDecryptorPtr(dataCipher TSRMLS_CC);
+    CryptoPP::BlockCipher *tweakEncryptor   = getCryptoppBlockCipherEncryptorPtr(tweakCipher TSRMLS_CC);
+
+    if (NULL == dataEncryptor || NULL == dataDecryptor || NULL == tweakEncryptor) {
+        return;
+    }
+
+    // check block sizes
+    if (XTS_BLOCK_SIZE != dataEncryptor->BlockSize() || XTS_BLOCK_SIZE != tweakEncryptor->BlockSize()) {
+        zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: block size of ciphers must be %d bytes", cryptopp_ce_SymmetricModeXts->name, XTS_BLOCK_SIZE);
+        return;
+    }
+
+    SymmetricModeXtsContainer *container    = static_cast<SymmetricModeXtsContainer *>(zend_object_store_get_object(getThis() TSRMLS_CC));
+    container->dataEncryptor                = dataEncryptor;
+    container->dataDecryptor                = dataDecryptor;
+    container->tweakEncryptor               = tweakEncryptor;
+
+    // build mode name with cipher name
+    zval *funcname      = makeZval("getName");
+    zval *zCipherName   = call_user_method(dataCipher, funcname TSRMLS_CC);
+    std::string name("xts(");
+    name.append(Z_STRVAL_P(zCipherName), Z_STRLEN_P(zCipherName));
+    name.append(")");
+    zend_update_property_stringl(cryptopp_ce_SymmetricModeXts, getThis(), "name", 4, name.c_str(), name.size() TSRMLS_CC);
+    zval_ptr_dtor(&zCipherName);
+    zval_ptr_dtor(&funcname);
+
+    // hold the cipher objects. if not, they can be deleted and associated native objects will be deleted too
+    zend_update_property(cryptopp_ce_SymmetricModeXts, getThis(), "dataCipher", 10, dataCipher TSRMLS_CC);
+    zend_update_property(cryptopp_ce_SymmetricModeXts, getThis(), "tweakCipher", 11, tweakCipher TSRMLS_CC);
+}
+/* }}} */
+
+/* {{{ proto void SymmetricModeXts::__sleep(void)
+   Prevents serialization of a SymmetricModeXts instance */
+PHP_METHOD(Cryptopp_SymmetricModeXts, __sleep) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\SymmetricModeXts instances");
+}
+/* }}} */
+
+/* {{{ proto void SymmetricModeXts::__wakeup(void)
+   Prevents use of a SymmetricModeXts instance that has been unserialized */
+PHP_METHOD(Cryptopp_SymmetricModeXts, __wakeup) {
+    zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"You cannot serialize or unserialize Cryptopp\\SymmetricModeXts instances");
+}
+/* }}} */
+
+/* {{{ proto string SymmetricModeXts::getName(void)
+   Return algorithm name */
+PHP_METHOD(Cryptopp_SymmetricModeXts, getName) {
+    if (NULL == getCryptoppSymmetricModeXtsContainer(getThis() TSRMLS_CC)) {
+        RETURN_FALSE
+    }
+
+    zval *name = zend_read_property(cryptopp_ce_SymmetricModeXts, getThis(), "name", 4, 0 TSRMLS_CC);
+    RETURN_ZVAL(name, 1, 0);
+}
+/* }}} */
+
+/* {{{ proto string SymmetricModeXts::encryptSector(int sector, string data)
+   Encrypts a sector */
+PHP_METHOD(Cryptopp_SymmetricModeXts, encryptSector) {
+    long sector;
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ls", &sector, &data, &dataSize)) {
+        return;
+    }
+
+    byte *output = processSectors(getThis(), true, sector, data, dataSize, dataSize > XTS_BLOCK_SIZE ? dataSize : XTS_BLOCK_SIZE TSRMLS_CC);
+
+    if (NULL == output) {
+        RETURN_FALSE
+    }
+
+    RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
+    delete[] output;
+}
+/* }}} */
+
+/* {{{ proto string SymmetricModeXts::decryptSector(int sector, string data)
+   Decrypts a sector */
+PHP_METHOD(Cryptopp_SymmetricModeXts, decryptSector) {
+    long sector;
+    char *data      = NULL;
+    int dataSize    = 0;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "ls", &sector, &data, &dataSize)) {
+        return;
+    }
+
+    byte *output = processSectors(getThis(), false, sector, data, dataSize, dataSize > XTS_BLOCK_SIZE ? dataSize : XTS_BLOCK_SIZE TSRMLS_CC);
+
+    if (NULL == output) {
+        RETURN_FALSE
+    }
+
+    RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
+    delete[] output;
+}
+/* }}} */
+
+/* {{{ proto string SymmetricModeXts::encryptSectors(int firstSector, string data, int sectorSize)
+   Encrypts consecutive sectors. The last sector can be shorter than sectorSize */
+PHP_METHOD(Cryptopp_SymmetricModeXts, encryptSectors) {
+    long firstSector;
+    char *data      = NULL;
+    int dataSize    = 0;
+    long sectorSize;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "lsl", &firstSector, &data, &dataSize, &sectorSize)) {
+        return;
+    }
+
+    byte *output = processSectors(getThis(), true, firstSector, data, dataSize, sectorSize TSRMLS_CC);
+
+    if (NULL == output) {
+        RETURN_FALSE
+    }
+
+    RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
+    delete[] output;
+}
+/* }}} */
+
+/* {{{ proto string SymmetricModeXts::decryptSectors(int firstSector, string data, int sectorSize)
+   Decrypts consecutive sectors. The last sector can be shorter than sectorSize */
+PHP_METHOD(Cryptopp_SymmetricModeXts, decryptSectors) {
+    long firstSector;
+    char *data      = NULL;
+    int dataSize    = 0;
+    long sectorSize;
+
+    if (FAILURE == zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "lsl", &firstSector, &data, &dataSize, &sectorSize)) {
+        return;
+    }
+
+    byte *output = processSectors(getThis(), false, firstSector, data, dataSize, sectorSize TSRMLS_CC);
+
+    if (NULL == output) {
+        RETURN_FALSE
+    }
+
+    RETVAL_STRINGL(reinterpret_cast<char*>(output), dataSize, 1);
+    delete[] output;
+}
+/* }}} */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -0,0 +1,55 @@
+/*
+ * This file is part of php-cryptopp.
+ *
+ * (c) Stephen Berquet <stephen.berquet@gmail.com>
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#ifndef PHP_SYMMETRIC_MODE_XTS_H
+#define PHP_SYMMETRIC_MODE_XTS_H
+
+#include "src/php_cryptopp.h"
+
+extern zend_class_entry *cryptopp_ce_SymmetricModeXts;
+void init_class_SymmetricModeXts(TSRMLS_D);
+
+/* {{{ XTS_BLOCK_SIZE
+   XTS tweaks are elements of GF(2^128), so the block cipher must have a block size of 128 bits */
+#define XTS_BLOCK_SIZE 16
+/* }}} */
+
+/* {{{ object creation related stuff */
+struct SymmetricModeXtsContainer {
+    zend_object std;
+    CryptoPP::BlockCipher *dataEncryptor;
+    CryptoPP::BlockCipher *dataDecryptor;
+    CryptoPP::BlockCipher *tweakEncryptor;
+};
+
+extern zend_object_handlers SymmetricModeXts_object_handlers;
+void SymmetricModeXts_free_storage(void *object TSRMLS_DC);
+/* }}} */
+
+/* {{{ methods declarations */
+PHP_METHOD(Cryptopp_SymmetricModeXts, __construct);
+PHP_METHOD(Cryptopp_SymmetricModeXts, __sleep);
+PHP_METHOD(Cryptopp_SymmetricModeXts, __wakeup);
+PHP_METHOD(Cryptopp_SymmetricModeXts, getName);
+PHP_METHOD(Cryptopp_SymmetricModeXts, encryptSector);
+PHP_METHOD(Cryptopp_SymmetricModeXts, decryptSector);
+PHP_METHOD(Cryptopp_SymmetricModeXts, encryptSectors);
+PHP_METHOD(Cryptopp_SymmetricModeXts, decryptSectors);
+/* }}} */
+
+#endif /* PHP_SYMMETRIC_MODE_XTS_H */
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: sw=4 ts=4 expandtab fdm=marker
+ * vim<600: sw=4 ts=4 expandtab
+ */
@@ -109,6 +109,98 @@ bool setSymmetricCipherKeyIv(
 }
 /* }}} */
 
+/* {{{ getSymmetricCipherBatchItems
+   checks a list of data given to encryptBatch() or decryptBatch(), and the list of ivs going with it.
+   each data is paired with the iv having the same key. returns false on failure */
+bool getSymmetricCipherBatchItems(
+    zval *object,
+    CryptoPP::SymmetricCipher *cipher,
+    zval *ivs,
+    zval *data,
+    std::vector<SymmetricCipherBatchItem> &items
+    TSRMLS_DC
+) {
+    zend_class_entry *ce    = zend_get_class_entry(object TSRMLS_CC);
+    int blockSize           = static_cast<int>(cipher->MandatoryBlockSize());
+    HashTable *dataList     = Z_ARRVAL_P(data);
+    HashPosition pos;
+    zval **zData;
+    items.reserve(zend_hash_num_elements(dataList));
+
+    for (
+        zend_hash_internal_pointer_reset_ex(dataList, &pos);
+        SUCCESS == zend_hash_get_current_data_ex(dataList, reinterpret_cast<void**>(&zData), &pos);
+        zend_hash_move_forward_ex(dataList, &pos)
+    ) {
+        SymmetricCipherBatchItem item;
+        zval **zIv  = NULL;
+        int found   = FAILURE;
+
+        if (HASH_KEY_IS_STRING == zend_hash_get_current_key_ex(dataList, &item.key, &item.keyLength, &item.index, 0, &pos)) {
+            found = zend_hash_find(Z_ARRVAL_P(ivs), item.key, item.keyLength, reinterpret_cast<void**>(&zIv));
+        } else {
+            item.key    = NULL;
+            found       = zend_hash_index_find(Z_ARRVAL_P(ivs), item.index, reinterpret_cast<void**>(&zIv));
+        }
+
+        if (SUCCESS != found) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : each data must have an initialization vector with the same key", ce->name);
+            return false;
+        } else if (IS_STRING != Z_TYPE_PP(zData) || IS_STRING != Z_TYPE_PP(zIv)) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s : each data and each initialization vector must be a string", ce->name);
+            return false;
+        } else if (!isCryptoppSymmetricIvValid(object, cipher, Z_STRLEN_PP(zIv) TSRMLS_CC)) {
+            return false;
+        } else if (0 != Z_STRLEN_PP(zData) % blockSize) {
+            zend_throw_exception_ex(getCryptoppException(), 0 TSRMLS_CC, (char*)"%s: data size (%d) is not a multiple of block size (%d)", ce->name, Z_STRLEN_PP(zData), blockSize);
+            return false;
+        }
+
+        item.iv         = *zIv;
+        item.input      = reinterpret_cast<byte*>(Z_STRVAL_PP(zData));
+        item.inputSize  = Z_STRLEN_PP(zData);
+        items.push_back(item);
+    }
+
+    return true;
+}
+/* }}} */
+
+/* {{{ processSymmetricCipherBatch
+   encrypts or decrypts items checked by getSymmetricCipherBatchItems() with a keyed native object, which is only
+   resynchronized with the iv of each item. results are added to a pre-sized array, with the keys of the data list.
+   returns false on failure */
+bool processSymmetricCipherBatch(CryptoPP::SymmetricCipher *cipher, std::vector<SymmetricCipherBatchItem> &items, zval *return_value TSRMLS_DC) {
+    array_init_size(return_value, items.size());
+
+    for (std::vector<SymmetricCipherBatchItem>::iterator it = items.begin(); it != items.end(); ++it) {
+        // output strings are handed over to php as is, without copy
+        byte *output            = reinterpret_cast<byte*>(emalloc(it->inputSize + 1));
+        output[it->inputSize]   = '\0';
+
+        try {
+            if (cipher->IsResynchronizable()) {
+                cipher->Resynchronize(reinterpret_cast<byte*>(Z_STRVAL_P(it->iv)), Z_STRLEN_P(it->iv));
+            }
+
+            cipher->ProcessData(output, it->input, it->inputSize);
+        } catch (bool e) {
+            efree(output);
+            zval_dtor(return_value);
+            return false;
+        }
+
+        if (NULL != it->key) {
+            add_assoc_stringl_ex(return_value, it->key, it->keyLength, reinterpret_cast<char*>(output), it->inputSize, 0);
+        } else {
+            add_index_stringl(return_value, it->index, reinterpret_cast<char*>(output), it->inputSize, 0);
+        }
+    }
+
+    return true;
+}
+/* }}} */
+
 /*
  * Local variables:
  * tab-width: 4
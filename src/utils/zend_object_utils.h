@@ -11,6 +11,7 @@
 #define PHP_ZEND_OBJECT_UTILS_H
 
 #include "src/php_cryptopp.h"
+#include <vector>
 
 bool isCryptoppSymmetricKeyValid(zval *object, CryptoPP::SimpleKeyingInterface *keying, int keySize TSRMLS_DC, bool throwIfFalse = true);
 bool isCryptoppSymmetricIvValid(zval *object, CryptoPP::SimpleKeyingInterface *keying, int ivSize TSRMLS_DC, bool throwIfFalse = true);
@@ -24,6 +25,27 @@ bool setSymmetricCipherKeyIv(
     TSRMLS_DC
 );
 
+/* {{{ one item of a list given to encryptBatch() or decryptBatch() */
+struct SymmetricCipherBatchItem {
+    zval *iv;
+    const byte *input;
+    int inputSize;
+    char *key;
+    uint keyLength;
+    ulong index;
+};
+/* }}} */
+
+bool getSymmetricCipherBatchItems(
+    zval *object,
+    CryptoPP::SymmetricCipher *cipher,
+    zval *ivs,
+    zval *data,
+    std::vector<SymmetricCipherBatchItem> &items
+    TSRMLS_DC
+);
+bool processSymmetricCipherBatch(CryptoPP::SymmetricCipher *cipher, std::vector<SymmetricCipherBatchItem> &items, zval *return_value TSRMLS_DC);
+
 typedef void(*zend_object_free_storage)(void* TSRMLS_DC);
 
 /* {{{ backport of object_properties_init() for PHP < 5.4 */
@@ -0,0 +1,350 @@
+--TEST--
+Chunked authenticated transformation filter (errors)
+--FILE--
+<?php
+
+$c = new Cryptopp\BlockCipherAes();
+$a = new Cryptopp\AuthenticatedSymmetricCipherGcm($c);
+$o = new Cryptopp\ChunkedAuthenticatedTransformationFilter($a, "key-1", 16);
+
+// encrypt without key
+echo "- no key:\n";
+try {
+    $o->encryptString("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$a->setKey(Cryptopp\HexUtils::hex2bin("77be63708971c4e240d1cb79e8d77feb"));
+
+// invalid constructor arguments
+echo "- constructor:\n";
+try {
+    new Cryptopp\ChunkedAuthenticatedTransformationFilter($a, str_repeat("a", 256));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    new Cryptopp\ChunkedAuthenticatedTransformationFilter($a, "", 0);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    new Cryptopp\ChunkedAuthenticatedTransformationFilter($a, "", 8388609);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    new Cryptopp\ChunkedAuthenticatedTransformationFilter(new Cryptopp\AuthenticatedSymmetricCipherGeneric(new Cryptopp\SymmetricModeCbc($c), new Cryptopp\MacHmac(new Cryptopp\HashSha1())));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    new Cryptopp\ChunkedAuthenticatedTransformationFilter(new Cryptopp\AuthenticatedSymmetricCipherCcm($c));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// invalid header
+echo "- header:\n";
+$data   = str_repeat("0123456789abcdef", 2);
+$e      = $o->encryptString($data);
+
+try {
+    $o->decryptString("abc");
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\ChunkedAuthenticatedTransformationFilter::readKeyId(substr($e, 0, 10));
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+try {
+    $e2 = $e;
+    $e2[0] = chr(2);
+    $o->decryptString($e2);
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+try {
+    $o2 = new Cryptopp\ChunkedAuthenticatedTransformationFilter($a, "key-2", 16);
+    $o2->decryptString($e);
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+// tampered data
+echo "- tampered data:\n";
+$positions = array(
+    1,              // key id length
+    3,              // key id
+    10,             // chunk size
+    15,             // nonce prefix
+    30,             // first chunk
+    80,             // tag of the second chunk
+);
+
+foreach ($positions as $position) {
+    try {
+        $e2 = $e;
+        $e2[$position] = chr(ord($e2[$position]) ^ 1);
+        $o->decryptString($e2);
+        echo "not detected\n";
+    } catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+        echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+    } catch (Cryptopp\CryptoppException $ex) {
+        echo $ex->getMessage() . "\n";
+    }
+}
+
+// swapped chunks
+try {
+    $o->decryptString(substr($e, 0, 23) . substr($e, 55, 32) . substr($e, 23, 32));
+} catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+    echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+}
+
+// truncated data
+echo "- truncated data:\n";
+foreach (array(55, 86, 60, 23) as $length) {
+    try {
+        $o->decryptString(substr($e, 0, $length));
+    } catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+        echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+    } catch (Cryptopp\CryptoppException $ex) {
+        echo $ex->getMessage() . "\n";
+    }
+}
+
+// stream: chunks before the faulty one are written
+echo "- stream:\n";
+$e2 = $e;
+$e2[80] = chr(ord($e2[80]) ^ 1);
+$input = fopen("php://memory", "w+");
+fwrite($input, $e2);
+rewind($input);
+$output = fopen("php://memory", "w+");
+
+try {
+    $o->decryptStream($input, $output);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+    echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+}
+
+rewind($output);
+var_dump(stream_get_contents($output));
+
+// range
+echo "- range:\n";
+try {
+    $o->decryptRange($e2, 20, 5);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+    echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+}
+
+// the last chunk is verified even if the range does not reach it
+try {
+    $o->decryptRange($e2, 2, 5);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+    echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+}
+
+// data truncated at a chunk boundary: its last chunk does not have the last chunk flag
+$truncated = substr($e, 0, 55);
+
+foreach (array(array(2, 5), array(20, 5), array(16, 0)) as $range) {
+    try {
+        $o->decryptRange($truncated, $range[0], $range[1]);
+        echo "not detected\n";
+    } catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+        echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+    }
+}
+
+$input = fopen("php://memory", "w+");
+fwrite($input, $truncated);
+
+try {
+    $o->decryptRange($input, 20, 5);
+    echo "not detected\n";
+} catch (Cryptopp\CryptoppMacVerificationFailedException $ex) {
+    echo get_class($ex) . " : " . $ex->getMessage() . "\n";
+}
+
+var_dump($o->decryptRange($e, 2, 5));
+
+try {
+    $o->decryptRange($e, -1, 5);
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+try {
+    $o->decryptRange(array(), 0, 5);
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+// read errors are not taken as the end of the stream
+echo "- read error:\n";
+class FailingStream
+{
+    public $context;
+
+    public function stream_open($path, $mode, $options, &$openedPath)
+    {
+        return true;
+    }
+
+    public function stream_read($count)
+    {
+        return "";
+    }
+
+    public function stream_eof()
+    {
+        return false;
+    }
+}
+
+stream_wrapper_register("cryptopp-failing", "FailingStream");
+
+try {
+    $o->encryptStream(fopen("cryptopp-failing://input", "rb"), fopen("php://memory", "w+"));
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+try {
+    $o->decryptStream(fopen("cryptopp-failing://input", "rb"), fopen("php://memory", "w+"));
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+// files
+echo "- file:\n";
+try {
+    $o->encryptFile(__DIR__ . "/does-not-exist", __DIR__ . "/does-not-exist-either");
+} catch (Cryptopp\CryptoppException $ex) {
+    echo str_replace(__DIR__, "", $ex->getMessage()) . "\n";
+}
+
+// sleep
+echo "- sleep:\n";
+try {
+    serialize($o);
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+// bad arguments
+echo "- bad arguments:\n";
+var_dump(@$o->encryptString(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->decryptString(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->encryptStream("a", "b"));
+echo "$php_errormsg\n";
+
+// cipher object: constructor not called
+echo "- cipher object (parent constructor not called):\n";
+class AuthenticatedChild extends Cryptopp\AuthenticatedSymmetricCipherGcm
+{
+    public function __construct(){}
+}
+
+try {
+    $o = new Cryptopp\ChunkedAuthenticatedTransformationFilter(new AuthenticatedChild());
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+// test inheritance - parent constructor not called
+echo "- inheritance (parent constructor not called):\n";
+class ChildParentConstructorNotCalled extends Cryptopp\ChunkedAuthenticatedTransformationFilter
+{
+    public function __construct(){}
+}
+
+$o = new ChildParentConstructorNotCalled();
+
+try {
+    $o->encryptString("");
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+try {
+    $o->decryptString("");
+} catch (Cryptopp\CryptoppException $ex) {
+    echo $ex->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- no key:
+Cryptopp\AuthenticatedSymmetricCipherGcm : a key is required
+- constructor:
+Cryptopp\ChunkedAuthenticatedTransformationFilter : the key id cannot be longer than 255 bytes
+Cryptopp\ChunkedAuthenticatedTransformationFilter : the chunk size must be between 1 and 8388608
+Cryptopp\ChunkedAuthenticatedTransformationFilter : the chunk size must be between 1 and 8388608
+Cryptopp\ChunkedAuthenticatedTransformationFilter : Cryptopp\AuthenticatedSymmetricCipherGeneric cannot be used, it must accept data of any size and 16 bytes nonces
+Cryptopp\ChunkedAuthenticatedTransformationFilter : Cryptopp\AuthenticatedSymmetricCipherCcm cannot be used, it must accept data of any size and 16 bytes nonces
+- header:
+Cryptopp\ChunkedAuthenticatedTransformationFilter : invalid header
+Cryptopp\ChunkedAuthenticatedTransformationFilter : invalid header
+Cryptopp\ChunkedAuthenticatedTransformationFilter : invalid header
+Cryptopp\ChunkedAuthenticatedTransformationFilter : data was encrypted with another key id
+- tampered data:
+Cryptopp\ChunkedAuthenticatedTransformationFilter : invalid header
+Cryptopp\ChunkedAuthenticatedTransformationFilter : data was encrypted with another key id
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+- truncated data:
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\ChunkedAuthenticatedTransformationFilter : data is truncated or its size is not valid
+Cryptopp\ChunkedAuthenticatedTransformationFilter : data is truncated or its size is not valid
+- stream:
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+string(16) "0123456789abcdef"
+- range:
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\ChunkedAuthenticatedTransformationFilter : MAC verification failed
+string(5) "23456"
+Cryptopp\ChunkedAuthenticatedTransformationFilter : offset and length cannot be negative
+Cryptopp\ChunkedAuthenticatedTransformationFilter : input must be a string or a stream
+- read error:
+Cryptopp\ChunkedAuthenticatedTransformationFilter : cannot read the input stream
+Cryptopp\ChunkedAuthenticatedTransformationFilter : cannot read the input stream
+- file:
+Cryptopp\ChunkedAuthenticatedTransformationFilter : cannot open file /does-not-exist
+- sleep:
+You cannot serialize or unserialize Cryptopp\ChunkedAuthenticatedTransformationFilter instances
+- bad arguments:
+NULL
+Cryptopp\ChunkedAuthenticatedTransformationFilter::encryptString() expects parameter 1 to be string, array given
+NULL
+Cryptopp\ChunkedAuthenticatedTransformationFilter::decryptString() expects parameter 1 to be string, array given
+NULL
+Cryptopp\ChunkedAuthenticatedTransformationFilter::encryptStream() expects parameter 1 to be resource, string given
+- cipher object (parent constructor not called):
+Cryptopp\AuthenticatedSymmetricCipherAbstract cannot be extended by user classes
+- inheritance (parent constructor not called):
+Cryptopp\ChunkedAuthenticatedTransformationFilter : constructor was not called
+Cryptopp\ChunkedAuthenticatedTransformationFilter : constructor was not called
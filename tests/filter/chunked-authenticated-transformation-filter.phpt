@@ -0,0 +1,161 @@
+--TEST--
+Chunked authenticated transformation filter
+--FILE--
+<?php
+
+$c = new Cryptopp\BlockCipherAes();
+$a = new Cryptopp\AuthenticatedSymmetricCipherGcm($c);
+$a->setKey(Cryptopp\HexUtils::hex2bin("77be63708971c4e240d1cb79e8d77feb"));
+$o = new Cryptopp\ChunkedAuthenticatedTransformationFilter($a, "key-1", 16);
+
+// check getters
+var_dump($o->getCipher() === $a);
+var_dump($o->getKeyId());
+var_dump($o->getChunkSize());
+
+$o2 = new Cryptopp\ChunkedAuthenticatedTransformationFilter($a);
+var_dump($o2->getKeyId());
+var_dump($o2->getChunkSize());
+
+// encrypt/decrypt strings
+echo "- string:\n";
+$data = "";
+
+for ($i = 0; $i < 100; $i++) {
+    $data .= chr($i);
+}
+
+$e = $o->encryptString($data);
+var_dump(strlen($e));
+var_dump(Cryptopp\ChunkedAuthenticatedTransformationFilter::readKeyId($e));
+var_dump($o->decryptString($e) === $data);
+var_dump($e === $o->encryptString($data));
+
+$e = $o->encryptString(substr($data, 0, 32));
+var_dump(strlen($e));
+var_dump($o->decryptString($e) === substr($data, 0, 32));
+
+$e = $o->encryptString("");
+var_dump(strlen($e));
+var_dump($o->decryptString($e));
+
+$e = $o2->encryptString($data);
+var_dump(strlen($e));
+var_dump(Cryptopp\ChunkedAuthenticatedTransformationFilter::readKeyId($e));
+var_dump($o2->decryptString($e) === $data);
+
+// encrypt/decrypt streams
+echo "- stream:\n";
+$input = fopen("php://memory", "w+");
+fwrite($input, $data);
+rewind($input);
+$encrypted = fopen("php://memory", "w+");
+var_dump($o->encryptStream($input, $encrypted));
+rewind($encrypted);
+$e = stream_get_contents($encrypted);
+var_dump(strlen($e));
+var_dump($o->decryptString($e) === $data);
+
+rewind($encrypted);
+$decrypted = fopen("php://memory", "w+");
+var_dump($o->decryptStream($encrypted, $decrypted));
+rewind($decrypted);
+var_dump(stream_get_contents($decrypted) === $data);
+
+// encrypt/decrypt files
+echo "- file:\n";
+$plainFile      = tempnam(sys_get_temp_dir(), "cryptopp");
+$encryptedFile  = tempnam(sys_get_temp_dir(), "cryptopp");
+$decryptedFile  = tempnam(sys_get_temp_dir(), "cryptopp");
+file_put_contents($plainFile, str_repeat($data, 10));
+var_dump($o->encryptFile($plainFile, $encryptedFile));
+var_dump(filesize($encryptedFile));
+var_dump($o->decryptFile($encryptedFile, $decryptedFile));
+var_dump(file_get_contents($decryptedFile) === str_repeat($data, 10));
+var_dump($o->decryptString(file_get_contents($encryptedFile)) === str_repeat($data, 10));
+
+// decrypt ranges
+echo "- range:\n";
+$e      = $o->encryptString($data);
+$stream = fopen($encryptedFile, "rb");
+$ranges = array(array(0, 0), array(0, 1), array(0, 16), array(15, 2), array(16, 16), array(20, 50), array(90, 10), array(95, 20), array(99, 1), array(100, 1), array(150, 3), array(0, 1000));
+$valid  = true;
+
+foreach ($ranges as $range) {
+    $valid = $valid && (string) substr($data, $range[0], $range[1]) === $o->decryptRange($e, $range[0], $range[1]);
+    $valid = $valid && (string) substr(str_repeat($data, 10), $range[0] + 500, $range[1]) === $o->decryptRange($stream, $range[0] + 500, $range[1]);
+}
+
+var_dump($valid);
+var_dump($o->decryptRange($e, 20, 5) === substr($data, 20, 5));
+var_dump($o->decryptRange($e, 100, 5));
+fclose($stream);
+
+// a faulty chunk does not prevent other ranges from being decrypted
+$e[30] = chr(ord($e[30]) ^ 1);
+var_dump($o->decryptRange($e, 20, 5) === substr($data, 20, 5));
+
+unlink($plainFile);
+unlink($encryptedFile);
+unlink($decryptedFile);
+
+// other ciphers
+echo "- other ciphers:\n";
+$ciphers = array(
+    array(new Cryptopp\AuthenticatedSymmetricCipherEax(new Cryptopp\BlockCipherAes()), "77be63708971c4e240d1cb79e8d77feb"),
+    array(new Cryptopp\AuthenticatedSymmetricCipherAesSiv(), "77be63708971c4e240d1cb79e8d77feb77be63708971c4e240d1cb79e8d77feb"),
+);
+
+foreach ($ciphers as $item) {
+    list($cipher, $key) = $item;
+    $cipher->setKey(Cryptopp\HexUtils::hex2bin($key));
+    $f = new Cryptopp\ChunkedAuthenticatedTransformationFilter($cipher, "", 10);
+    $e = $f->encryptString($data);
+    var_dump(strlen($e));
+    var_dump($f->decryptString($e) === $data);
+    var_dump($f->decryptRange($e, 33, 33) === substr($data, 33, 33));
+}
+
+?>
+--EXPECT--
+bool(true)
+string(5) "key-1"
+int(16)
+string(0) ""
+int(65536)
+- string:
+int(235)
+string(5) "key-1"
+bool(true)
+bool(false)
+int(87)
+bool(true)
+int(39)
+string(0) ""
+int(134)
+string(0) ""
+bool(true)
+- stream:
+bool(true)
+int(235)
+bool(true)
+bool(true)
+bool(true)
+- file:
+bool(true)
+int(2031)
+bool(true)
+bool(true)
+bool(true)
+- range:
+bool(true)
+bool(true)
+string(0) ""
+bool(true)
+- other ciphers:
+int(278)
+bool(true)
+bool(true)
+int(278)
+bool(true)
+bool(true)
@@ -0,0 +1,38 @@
+--TEST--
+Hash algorithm: HMAC-SHA-256
+--FILE--
+<?php
+
+$hash = new Cryptopp\HashSha256();
+$hmac = new Cryptopp\MacHmac($hash);
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("Hi There")));
+
+$hmac->setKey("Jefe");
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("what do ya want for nothing?")));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest(Cryptopp\HexUtils::hex2bin(str_repeat("dd", 50)))));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("0102030405060708090a0b0c0d0e0f10111213141516171819"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest(Cryptopp\HexUtils::hex2bin(str_repeat("cd", 50)))));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("Test With Truncation")));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin(str_repeat("aa", 131)));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("Test Using Larger Than Block-Size Key - Hash Key First")));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin(str_repeat("aa", 131)));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("This is a test using a larger than block-size key and a larger than block-size data. The key needs to be hashed before being used by the HMAC algorithm.")));
+
+?>
+--EXPECT--
+string(64) "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"
+string(64) "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"
+string(64) "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe"
+string(64) "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b"
+string(64) "a3b6167473100ee06e0c796c2955552bfa6f7c0a6a8aef8b93f860aab0cd20c5"
+string(64) "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"
+string(64) "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2"
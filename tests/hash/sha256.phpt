@@ -0,0 +1,73 @@
+--TEST--
+Hash algorithm: SHA-256
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\HashSha256", "Cryptopp\HashAbstract", true));
+
+// check algorithm infos
+$o = new Cryptopp\HashSha256();
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+var_dump($o->getDigestSize());
+
+// check digest calculation
+echo "- digest calculation:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->calculateDigest("qwertyuiop")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->calculateDigest("azerty")));
+
+// check incremental hash
+echo "- incremental hash:\n";
+$o->update("qwerty");
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check that a restart() is not necessary after a call to finalize()
+echo "- restart not necessary:\n";
+$o->update("qwerty");
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check restart()
+echo "- restart:\n";
+$o->update("qwerty");
+$o->restart();
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check values returned by Cryptopp\Hash for this algorithm
+echo "- Cryptopp\Hash:\n";
+var_dump(in_array("sha256", Cryptopp\Hash::getAlgos()));
+var_dump(Cryptopp\Hash::getClassname("sha256"));
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+var_dump(strlen($o->calculateDigest($data)));
+$o->update($data);
+var_dump(strlen($o->finalize()));
+
+?>
+--EXPECT--
+bool(true)
+string(6) "sha256"
+int(64)
+int(32)
+- digest calculation:
+string(64) "9a900403ac313ba27a1bc81f0932652b8020dac92c234d98fa0b06bf0040ecfd"
+string(64) "f2d81a260dea8a100dd517984e53c56a7523d96942a834b9cdc249bd4e8c7aa9"
+- incremental hash:
+string(64) "9a900403ac313ba27a1bc81f0932652b8020dac92c234d98fa0b06bf0040ecfd"
+- restart not necessary:
+string(64) "9a900403ac313ba27a1bc81f0932652b8020dac92c234d98fa0b06bf0040ecfd"
+- restart:
+string(64) "bd33a355148056c92431fd29fab91d61cc97e522f022d730998d87138343f3a9"
+- Cryptopp\Hash:
+bool(true)
+string(19) "Cryptopp\HashSha256"
+- large data:
+int(32)
+int(32)
@@ -0,0 +1,38 @@
+--TEST--
+Hash algorithm: HMAC-SHA-384
+--FILE--
+<?php
+
+$hash = new Cryptopp\HashSha384();
+$hmac = new Cryptopp\MacHmac($hash);
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("Hi There")));
+
+$hmac->setKey("Jefe");
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("what do ya want for nothing?")));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest(Cryptopp\HexUtils::hex2bin(str_repeat("dd", 50)))));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("0102030405060708090a0b0c0d0e0f10111213141516171819"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest(Cryptopp\HexUtils::hex2bin(str_repeat("cd", 50)))));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin("0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c"));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("Test With Truncation")));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin(str_repeat("aa", 131)));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("Test Using Larger Than Block-Size Key - Hash Key First")));
+
+$hmac->setKey(Cryptopp\HexUtils::hex2bin(str_repeat("aa", 131)));
+var_dump(Cryptopp\HexUtils::bin2hex($hmac->calculateDigest("This is a test using a larger than block-size key and a larger than block-size data. The key needs to be hashed before being used by the HMAC algorithm.")));
+
+?>
+--EXPECT--
+string(96) "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59cfaea9ea9076ede7f4af152e8b2fa9cb6"
+string(96) "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e8e2240ca5e69e2c78b3239ecfab21649"
+string(96) "88062608d3e6ad8a0aa2ace014c8a86f0aa635d947ac9febe83ef4e55966144b2a5ab39dc13814b94e3ab6e101a34f27"
+string(96) "3e8a69b7783c25851933ab6290af6ca77a9981480850009cc5577c6e1f573b4e6801dd23c4a7d679ccf8a386c674cffb"
+string(96) "3abf34c3503b2a23a46efc619baef897f4c8e42c934ce55ccbae9740fcbc1af4ca62269e2a37cd88ba926341efe4aeea"
+string(96) "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c60c2ef6ab4030fe8296248df163f44952"
+string(96) "6617178e941f020d351e2f254e8fd32c602420feb0b8fb9adccebb82461e99c5a678cc31e799176d3860e6110c46523e"
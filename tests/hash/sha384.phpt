@@ -0,0 +1,73 @@
+--TEST--
+Hash algorithm: SHA-384
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\HashSha384", "Cryptopp\HashAbstract", true));
+
+// check algorithm infos
+$o = new Cryptopp\HashSha384();
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+var_dump($o->getDigestSize());
+
+// check digest calculation
+echo "- digest calculation:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->calculateDigest("qwertyuiop")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->calculateDigest("azerty")));
+
+// check incremental hash
+echo "- incremental hash:\n";
+$o->update("qwerty");
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check that a restart() is not necessary after a call to finalize()
+echo "- restart not necessary:\n";
+$o->update("qwerty");
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check restart()
+echo "- restart:\n";
+$o->update("qwerty");
+$o->restart();
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check values returned by Cryptopp\Hash for this algorithm
+echo "- Cryptopp\Hash:\n";
+var_dump(in_array("sha384", Cryptopp\Hash::getAlgos()));
+var_dump(Cryptopp\Hash::getClassname("sha384"));
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+var_dump(strlen($o->calculateDigest($data)));
+$o->update($data);
+var_dump(strlen($o->finalize()));
+
+?>
+--EXPECT--
+bool(true)
+string(6) "sha384"
+int(128)
+int(48)
+- digest calculation:
+string(96) "48472c8aa75845d3f1fcef05a66077e97c9fae8ce08dce7f4b7d77d29de53bdab21face39518e6a0bccd84adbaf1c4d7"
+string(96) "b730a44242d878af9f384a1105081f2c4f67797683beb5943236851f53705f03fe10fd621bca9965f6222959262f0eaa"
+- incremental hash:
+string(96) "48472c8aa75845d3f1fcef05a66077e97c9fae8ce08dce7f4b7d77d29de53bdab21face39518e6a0bccd84adbaf1c4d7"
+- restart not necessary:
+string(96) "48472c8aa75845d3f1fcef05a66077e97c9fae8ce08dce7f4b7d77d29de53bdab21face39518e6a0bccd84adbaf1c4d7"
+- restart:
+string(96) "3ac18dce375b78c0f62c2008976ba7fce3f8e8e4a60d6712d250b670dc55d0a2e65f330682eb9c6074dcbb8b55176e1a"
+- Cryptopp\Hash:
+bool(true)
+string(19) "Cryptopp\HashSha384"
+- large data:
+int(48)
+int(48)
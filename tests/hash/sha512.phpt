@@ -0,0 +1,73 @@
+--TEST--
+Hash algorithm: SHA-512
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\HashSha512", "Cryptopp\HashAbstract", true));
+
+// check algorithm infos
+$o = new Cryptopp\HashSha512();
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+var_dump($o->getDigestSize());
+
+// check digest calculation
+echo "- digest calculation:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->calculateDigest("qwertyuiop")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->calculateDigest("azerty")));
+
+// check incremental hash
+echo "- incremental hash:\n";
+$o->update("qwerty");
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check that a restart() is not necessary after a call to finalize()
+echo "- restart not necessary:\n";
+$o->update("qwerty");
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check restart()
+echo "- restart:\n";
+$o->update("qwerty");
+$o->restart();
+$o->update("uio");
+$o->update("p");
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalize()));
+
+// check values returned by Cryptopp\Hash for this algorithm
+echo "- Cryptopp\Hash:\n";
+var_dump(in_array("sha512", Cryptopp\Hash::getAlgos()));
+var_dump(Cryptopp\Hash::getClassname("sha512"));
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+var_dump(strlen($o->calculateDigest($data)));
+$o->update($data);
+var_dump(strlen($o->finalize()));
+
+?>
+--EXPECT--
+bool(true)
+string(6) "sha512"
+int(128)
+int(64)
+- digest calculation:
+string(128) "6308d8f6a7ccc9f77e41be5331a52c71c0bb28ecbd4669b960d60dd505dfde9ddd7a30cd26bb308010b3819699daba7caeb791bf6a4153605fe56d1fd3d5df41"
+string(128) "df6b9fb15cfdbb7527be5a8a6e39f39e572c8ddb943fbc79a943438e9d3d85ebfc2ccf9e0eccd9346026c0b6876e0e01556fe56f135582c05fbdbb505d46755a"
+- incremental hash:
+string(128) "6308d8f6a7ccc9f77e41be5331a52c71c0bb28ecbd4669b960d60dd505dfde9ddd7a30cd26bb308010b3819699daba7caeb791bf6a4153605fe56d1fd3d5df41"
+- restart not necessary:
+string(128) "6308d8f6a7ccc9f77e41be5331a52c71c0bb28ecbd4669b960d60dd505dfde9ddd7a30cd26bb308010b3819699daba7caeb791bf6a4153605fe56d1fd3d5df41"
+- restart:
+string(128) "e3d4549e4a3f35c5dfe5f0d237cd64d89e74cd19424da1e155e21cab3648441045505b696f1012dc4467d008c42b5738b4effbcf2fb2854fa684be8cb2f45ea0"
+- Cryptopp\Hash:
+bool(true)
+string(19) "Cryptopp\HashSha512"
+- large data:
+int(64)
+int(64)
@@ -0,0 +1,212 @@
+--TEST--
+OTP
+--FILE--
+<?php
+
+$mac = new Cryptopp\MacHmac(new Cryptopp\HashSha1());
+$mac->setKey("12345678901234567890");
+
+// hotp (RFC 4226 test vectors)
+echo "- hotp:\n";
+$o = new Cryptopp\Otp($mac);
+var_dump($o->getDigits());
+var_dump($o->getPeriod());
+
+for ($i = 0; $i < 10; $i++) {
+    var_dump($o->generateHotp($i));
+}
+
+// totp (RFC 6238 test vectors)
+echo "- totp:\n";
+$o = new Cryptopp\Otp($mac, 8, 30);
+var_dump($o->generateTotp(59));
+var_dump($o->generateTotp(1111111109));
+var_dump($o->generateTotp(1111111111));
+var_dump($o->generateTotp(1234567890));
+var_dump($o->generateTotp(2000000000));
+var_dump(8 == strlen($o->generateTotp()));
+
+// hotp verification
+echo "- hotp verification:\n";
+$o = new Cryptopp\Otp($mac);
+var_dump($o->verifyHotp("359152", 2));
+var_dump($o->verifyHotp("359152", 0));
+var_dump($o->verifyHotp("359152", 0, 2));
+var_dump($o->verifyHotp("359152", 3, 2));
+var_dump($o->verifyHotp("35915", 2));
+
+// pending data of the mac object is kept
+echo "- pending data:\n";
+$mac->update("pending");
+var_dump($o->generateHotp(2));
+var_dump(bin2hex($mac->finalize()) === bin2hex($mac->calculateDigest("pending")));
+
+// totp verification
+echo "- totp verification:\n";
+$o = new Cryptopp\Otp($mac, 8);
+var_dump($o->verify("07081804", 0, 1111111109));
+var_dump($o->verify("07081804", 0, 1111111109 + 30));
+var_dump($o->verify("07081804", 1, 1111111109 + 30));
+var_dump($o->verify("07081804", 2, 1111111109 - 60));
+var_dump($o->verify("07081804", 2, 1111111109 + 90));
+var_dump($o->verify("94287082", 2, 0));
+var_dump($o->verify($o->generateTotp(), 0));
+
+// user mac
+echo "- user mac:\n";
+class UserHmac implements Cryptopp\MacInterface
+{
+    private $mac;
+
+    public function __construct() {
+        $this->mac = new Cryptopp\MacHmac(new Cryptopp\HashSha1());
+    }
+
+    public function getName() {return "user";}
+    public function getDigestSize() {return $this->mac->getDigestSize();}
+    public function getBlockSize() {return $this->mac->getBlockSize();}
+    public function isValidKeyLength($l) {return $this->mac->isValidKeyLength($l);}
+    public function setKey($key) {$this->mac->setKey($key);}
+    public function getKey() {return $this->mac->getKey();}
+    public function calculateDigest($data) {return $this->mac->calculateDigest($data);}
+    public function update($data) {$this->mac->update($data);}
+    public function finalize() {return $this->mac->finalize();}
+    public function restart() {$this->mac->restart();}
+}
+
+$userMac = new UserHmac();
+$userMac->setKey("12345678901234567890");
+$o = new Cryptopp\Otp($userMac);
+var_dump($o->generateHotp(9));
+var_dump($o->verifyHotp("520489", 7, 2));
+
+// errors
+echo "- errors:\n";
+try {
+    new Cryptopp\Otp($mac, 5);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    new Cryptopp\Otp($mac, 6, 0);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $md5 = new Cryptopp\MacHmac(new Cryptopp\HashMd5());
+    new Cryptopp\Otp($md5);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// a hmac of a user hash cannot be copied, its state lives in the php hash object
+class UserSha1 implements Cryptopp\HashInterface
+{
+    private $hash;
+
+    public function __construct() {
+        $this->hash = new Cryptopp\HashSha1();
+    }
+
+    public function getName() {return "user";}
+    public function getDigestSize() {return $this->hash->getDigestSize();}
+    public function getBlockSize() {return $this->hash->getBlockSize();}
+    public function calculateDigest($data) {return $this->hash->calculateDigest($data);}
+    public function update($data) {$this->hash->update($data);}
+    public function finalize() {return $this->hash->finalize();}
+    public function restart() {$this->hash->restart();}
+}
+
+try {
+    new Cryptopp\Otp(new Cryptopp\MacHmac(new UserSha1()));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->generateHotp(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->verify("123456", -1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->verifyHotp("123456", 0, 101);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->verifyHotp("123456", PHP_INT_MAX, 1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// sleep
+echo "- sleep:\n";
+try {
+    serialize($o);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- hotp:
+int(6)
+int(30)
+string(6) "755224"
+string(6) "287082"
+string(6) "359152"
+string(6) "969429"
+string(6) "338314"
+string(6) "254676"
+string(6) "287922"
+string(6) "162583"
+string(6) "399871"
+string(6) "520489"
+- totp:
+string(8) "94287082"
+string(8) "07081804"
+string(8) "14050471"
+string(8) "89005924"
+string(8) "69279037"
+bool(true)
+- hotp verification:
+int(2)
+bool(false)
+int(2)
+bool(false)
+bool(false)
+- pending data:
+string(6) "359152"
+bool(true)
+- totp verification:
+bool(true)
+bool(false)
+bool(true)
+bool(true)
+bool(false)
+bool(true)
+bool(true)
+- user mac:
+string(6) "520489"
+int(9)
+- errors:
+Cryptopp\Otp: digits must be between 6 and 8, 5 given
+Cryptopp\Otp: period must be greater than 0
+Cryptopp\Otp: MAC digest size must be at least 20 bytes, 16 given
+Cryptopp\Otp: Cryptopp\MacHmac cannot be used, its state cannot be copied
+Cryptopp\Otp: counter cannot be negative
+Cryptopp\Otp: window cannot be negative
+Cryptopp\Otp: window cannot be greater than 100
+Cryptopp\Otp: counter + window is too large
+- sleep:
+You cannot serialize or unserialize Cryptopp\Otp instances
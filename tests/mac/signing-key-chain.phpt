@@ -0,0 +1,131 @@
+--TEST--
+Signing key chain
+--FILE--
+<?php
+
+$mac = new Cryptopp\MacHmac(new Cryptopp\HashSha1());
+$mac->setKey("mac key");
+$o = new Cryptopp\SigningKeyChain($mac, "AWS4wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY");
+
+// signing key
+echo "- signing key:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20150830", "us-east-1", "iam")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20150830", "us-east-1", "iam")));
+
+// compare with the chain computed step by step
+$m = new Cryptopp\MacHmac(new Cryptopp\HashSha1());
+$key = "AWS4wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY";
+
+foreach (array("20150830", "us-east-1", "iam", "aws4_request") as $data) {
+    $m->setKey($key);
+    $key = $m->calculateDigest($data);
+}
+
+var_dump($key === $o->getSigningKey("20150830", "us-east-1", "iam"));
+
+// sign
+echo "- sign:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->sign("20150830", "us-east-1", "iam", "string to sign")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->sign("20150830", "us-east-1", "iam", "string to sign")));
+
+// mac key is not modified
+echo "- mac key:\n";
+var_dump($mac->getKey());
+$m->setKey("mac key");
+var_dump($m->calculateDigest("data") === $mac->calculateDigest("data"));
+
+// other dates and terminator
+echo "- custom terminator:\n";
+$o = new Cryptopp\SigningKeyChain($mac, "AWS4wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY", "custom_request");
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20150831", "eu-west-1", "s3")));
+$o->getSigningKey("20150901", "eu-west-1", "s3");
+$o->getSigningKey("20150902", "eu-west-1", "s3");
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20150831", "eu-west-1", "s3")));
+$o->clearCache();
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20150831", "eu-west-1", "s3")));
+var_dump($o->getMac() === $mac);
+
+// aws signature version 4 known answers
+echo "- sigv4:\n";
+$sha256 = new Cryptopp\MacHmac(new Cryptopp\HashSha256());
+$o = new Cryptopp\SigningKeyChain($sha256, "AWS4wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY");
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20120215", "us-east-1", "iam")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->getSigningKey("20150830", "us-east-1", "iam")));
+$stringToSign = "AWS4-HMAC-SHA256\n20150830T123600Z\n20150830/us-east-1/iam/aws4_request\nf536975d06c0309214f805bb90ccff089219ecd68b2577efef23edd43b7e1a59";
+var_dump(Cryptopp\HexUtils::bin2hex($o->sign("20150830", "us-east-1", "iam", $stringToSign)));
+
+// many scopes
+echo "- many scopes:\n";
+$k = $o->getSigningKey("20150830", "us-east-1", "iam");
+
+for ($i = 0; $i < 100; $i++) {
+    $o->getSigningKey("20150830", "region-$i", "iam");
+}
+
+var_dump($k === $o->getSigningKey("20150830", "us-east-1", "iam"));
+var_dump($o->getSigningKey("20150830", "region-99", "iam") === $o->getSigningKey("20150830", "region-99", "iam"));
+
+// user hash throwing an exception
+echo "- user hash exception:\n";
+class ThrowingHash implements Cryptopp\HashInterface
+{
+    public function getName() {return "throwing";}
+    public function getDigestSize() {return 20;}
+    public function getBlockSize() {return 64;}
+    public function calculateDigest($data) {throw new Exception("hash failure");}
+    public function update($data) {throw new Exception("hash failure");}
+    public function finalize() {throw new Exception("hash failure");}
+    public function restart() {}
+}
+
+$o = new Cryptopp\SigningKeyChain(new Cryptopp\MacHmac(new ThrowingHash()), "secret");
+
+try {
+    $o->getSigningKey("20150830", "us-east-1", "iam");
+} catch (Exception $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->sign("20150830", "us-east-1", "iam", "data");
+} catch (Exception $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// sleep
+echo "- sleep:\n";
+try {
+    serialize($o);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- signing key:
+string(40) "be57b32e1ee3d59b9d74782f7a70b0ec1c6633a4"
+string(40) "be57b32e1ee3d59b9d74782f7a70b0ec1c6633a4"
+bool(true)
+- sign:
+string(40) "0ac6a4ce56ca8459ed2e740cc32cc45e9349bd91"
+string(40) "0ac6a4ce56ca8459ed2e740cc32cc45e9349bd91"
+- mac key:
+string(7) "mac key"
+bool(true)
+- custom terminator:
+string(40) "3d54a3ff84023fe8280022f6b0ebecfae2939e04"
+string(40) "3d54a3ff84023fe8280022f6b0ebecfae2939e04"
+string(40) "3d54a3ff84023fe8280022f6b0ebecfae2939e04"
+bool(true)
+- sigv4:
+string(64) "f4780e2d9f65fa895f9c67b32ce1baf0b0d8a43505a000a1a9e090d414db404d"
+string(64) "c4afb1cc5771d871763a393e44b703571b55cc28424d1a5e86da6ed3c154a4b9"
+string(64) "5d672d79c15b13162d9279b0855cfba6789a8edb4c82c400e06b5924a6f2b5d7"
+- many scopes:
+bool(true)
+bool(true)
+- user hash exception:
+hash failure
+hash failure
+- sleep:
+You cannot serialize or unserialize Cryptopp\SigningKeyChain instances
@@ -88,6 +88,7 @@ $fileList = array(
     "Filter/SymmetricTransformationFilter.php",
     "Filter/AuthenticatedSymmetricTransformationFilter.php",
     "Filter/HashTransformationFilter.php",
+    "Filter/ChunkedAuthenticatedTransformationFilter.php",
     "RandomByteGenerator/RandomByteGeneratorInterface.php",
     "RandomByteGenerator/RandomByteGenerator.php",
     "Hash/HashTransformationInterface.php",
@@ -98,6 +99,9 @@ $fileList = array(
     "Hash/HashMd5.php",
     "Hash/HashSha3_512.php",
     "Hash/HashSha1.php",
+    "Hash/HashSha256.php",
+    "Hash/HashSha384.php",
+    "Hash/HashSha512.php",
     "Hash/HashSha3_224.php",
     "Hash/HashSha3_256.php",
     "Symmetric/Cipher/SymmetricCipherInterface.php",
@@ -108,6 +112,8 @@ $fileList = array(
     "Symmetric/Cipher/Stream/StreamCipherSalsa20.php",
     "Symmetric/Cipher/Stream/StreamCipherSosemanuk.php",
     "Symmetric/Cipher/Stream/StreamCipherXSalsa20.php",
+    "Symmetric/Cipher/Stream/StreamCipherChaCha20.php",
+    "Symmetric/Cipher/Stream/StreamCipherXChaCha20.php",
     "Symmetric/Cipher/Stream/StreamCipher.php",
     "Symmetric/Cipher/Block/BlockCipherInterface.php",
     "Symmetric/Cipher/Block/BlockCipherAbstract.php",
@@ -119,7 +125,11 @@ $fileList = array(
     "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipherGcm.php",
     "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipherCcm.php",
     "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipherEax.php",
+    "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipherOcb.php",
+    "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipherChaCha20Poly1305.php",
     "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipher.php",
+    "Symmetric/Cipher/Authenticated/AuthenticatedSymmetricCipherAesSiv.php",
+    "Symmetric/Cipher/Authenticated/SecretBox.php",
     "Symmetric/Mode/SymmetricModeInterface.php",
     "Symmetric/Mode/SymmetricModeAbstract.php",
     "Symmetric/Mode/SymmetricModeCbc.php",
@@ -127,6 +137,7 @@ $fileList = array(
     "Symmetric/Mode/SymmetricModeCtr.php",
     "Symmetric/Mode/SymmetricModeEcb.php",
     "Symmetric/Mode/SymmetricModeOfb.php",
+    "Symmetric/Mode/SymmetricModeXts.php",
     "Symmetric/Mode/SymmetricMode.php",
     "Padding/PaddingInterface.php",
     "Padding/PaddingNoPadding.php",
@@ -137,6 +148,9 @@ $fileList = array(
     "Mac/MacHmac.php",
     "Mac/MacTwoTrackMac.php",
     "Mac/Mac.php",
+    "Mac/Otp.php",
+    "Mac/SigningKeyChain.php",
+    "Mac/Jws.php",
     "Utils/DigestUtils.php",
     "Utils/HexUtils.php",
     "constants.php",
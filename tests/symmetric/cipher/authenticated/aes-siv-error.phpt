@@ -0,0 +1,136 @@
+--TEST--
+Authenticated symmetric cipher: AES-SIV (errors)
+--FILE--
+<?php
+
+$o = new Cryptopp\AuthenticatedSymmetricCipherAesSiv();
+
+// seal without key
+echo "- no key:\n";
+try {
+    $o->seal("", "123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->openBatch(array(array("", "12345678901234567890")));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// invalid key
+echo "- invalid key:\n";
+try {
+    $o->setKey("1234567890123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->setKey("");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// incremental processing
+echo "- incremental processing:\n";
+$o->setKey("12345678901234567890123456789012");
+
+try {
+    $o->encrypt("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->decrypt("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->addEncryptionAdditionalData("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->finalizeDecryption();
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    new Cryptopp\AuthenticatedSymmetricTransformationFilter($o);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// open
+echo "- open:\n";
+$c = $o->seal("", "data", "aad");
+
+try {
+    $o->open("", $c, "other aad");
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . " : " . $e->getMessage() . "\n";
+}
+
+try {
+    $o->open("nonce", $c, "aad");
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . " : " . $e->getMessage() . "\n";
+}
+
+try {
+    $o->open("", "123456789012345");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// batch with invalid items
+echo "- batch:\n";
+try {
+    $o->sealBatch(array(array("", "data"), "data"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->openBatch(array(array("", $c, "aad"), array("")));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// sleep
+echo "- sleep:\n";
+try {
+    serialize($o);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- no key:
+Cryptopp\AuthenticatedSymmetricCipherAesSiv : a key is required
+Cryptopp\AuthenticatedSymmetricCipherAesSiv : a key is required
+- invalid key:
+Cryptopp\AuthenticatedSymmetricCipherAesSiv : 16 is not a valid key length
+Cryptopp\AuthenticatedSymmetricCipherAesSiv : a key is required
+- incremental processing:
+Cryptopp\AuthenticatedSymmetricCipherAesSiv: messages can only be processed whole, use seal() and open()
+Cryptopp\AuthenticatedSymmetricCipherAesSiv: messages can only be processed whole, use seal() and open()
+Cryptopp\AuthenticatedSymmetricCipherAesSiv: messages can only be processed whole, use seal() and open()
+Cryptopp\AuthenticatedSymmetricCipherAesSiv: messages can only be processed whole, use seal() and open()
+Cryptopp\AuthenticatedSymmetricCipherAesSiv: messages can only be processed whole, use seal() and open()
+- open:
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\AuthenticatedSymmetricCipherAesSiv : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\AuthenticatedSymmetricCipherAesSiv : MAC verification failed
+Cryptopp\AuthenticatedSymmetricCipherAesSiv: data size (15) is lower than the MAC tag size (16)
+- batch:
+Cryptopp\AuthenticatedSymmetricCipherAesSiv : each item must be an array of 2 or 3 strings: nonce, data and additional authenticated data
+Cryptopp\AuthenticatedSymmetricCipherAesSiv : each item must be an array of 2 or 3 strings: nonce, data and additional authenticated data
+- sleep:
+You cannot serialize or unserialize Cryptopp\AuthenticatedSymmetricCipherAbstract instances
@@ -0,0 +1,173 @@
+--TEST--
+Authenticated symmetric cipher: AES-SIV
+--FILE--
+<?php
+
+$o = new Cryptopp\AuthenticatedSymmetricCipherAesSiv();
+
+// check algorithm infos
+var_dump(is_a($o, "Cryptopp\AuthenticatedSymmetricCipherAbstract"));
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+var_dump($o->getDigestSize());
+
+// key length check
+echo "- key length check:\n";
+var_dump($o->isValidKeyLength(32));
+var_dump($o->isValidKeyLength(48));
+var_dump($o->isValidKeyLength(64));
+var_dump($o->isValidKeyLength(16));
+var_dump($o->isValidKeyLength(33));
+
+// iv length check
+echo "- iv length check:\n";
+var_dump($o->isValidIvLength(0));
+var_dump($o->isValidIvLength(12));
+var_dump($o->isValidIvLength(16));
+
+// set key
+echo "- set key:\n";
+$o->setKey(Cryptopp\HexUtils::hex2bin("fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->getKey()));
+
+// RFC 5297 A.1, the tag follows the ciphertext
+echo "- rfc 5297:\n";
+$aad = Cryptopp\HexUtils::hex2bin("101112131415161718191a1b1c1d1e1f2021222324252627");
+$c = $o->seal("", Cryptopp\HexUtils::hex2bin("112233445566778899aabbccddee"), $aad);
+var_dump(Cryptopp\HexUtils::bin2hex($c));
+var_dump(Cryptopp\HexUtils::bin2hex($o->open("", $c, $aad)));
+
+// nonce
+echo "- nonce:\n";
+$c = $o->seal("0123456789abcdef", "Lorem ipsum dolor sit amet", "header");
+var_dump(Cryptopp\HexUtils::bin2hex($c));
+var_dump($o->open("0123456789abcdef", $c, "header"));
+
+// determinism
+echo "- determinism:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->seal("", "alice@example.com", "users.email")));
+var_dump($o->seal("", "alice@example.com", "users.email") === $o->seal("", "alice@example.com", "users.email"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->seal("", "alice@example.com")));
+var_dump($o->seal("", "alice@example.com") === $o->seal("", "alice@example.com", ""));
+var_dump(Cryptopp\HexUtils::bin2hex($o->seal("", "")));
+var_dump($o->open("", $o->seal("", "")));
+
+// other key lengths
+echo "- key lengths:\n";
+$key = "";
+
+for ($i = 0; $i < 64; $i++) {
+    $key .= chr($i);
+}
+
+$o2 = new Cryptopp\AuthenticatedSymmetricCipherAesSiv();
+$o2->setKey($key);
+$c = $o2->seal("", "Lorem ipsum dolor sit amet, consectetur adipiscing");
+var_dump(Cryptopp\HexUtils::bin2hex($c));
+var_dump($o2->open("", $c));
+$o2->setKey(substr($key, 0, 48));
+$c = $o2->seal("nonce", "Lorem ipsum dolor sit amet, consectetur adipiscing", "aad");
+var_dump(Cryptopp\HexUtils::bin2hex($c));
+var_dump($o2->open("nonce", $c, "aad"));
+
+// batch
+echo "- batch:\n";
+$batch = $o->sealBatch(array(
+    "a" => array("", "alice@example.com", "users.email"),
+    5   => array("", "bob@example.com", "users.email"),
+    "x" => array("", "alice@example.com", "users.email"),
+));
+var_dump(array_keys($batch));
+var_dump(Cryptopp\HexUtils::bin2hex($batch["a"]));
+var_dump(Cryptopp\HexUtils::bin2hex($batch[5]));
+var_dump($batch["a"] === $batch["x"]);
+var_dump($batch["a"] === $o->seal("", "alice@example.com", "users.email"));
+
+$items = array();
+
+foreach ($batch as $k => $c) {
+    $items[$k] = array("", $c, "users.email");
+}
+
+var_dump($o->openBatch($items));
+var_dump($o->sealBatch(array()));
+
+// batch with invalid items
+echo "- batch invalid items:\n";
+$items[5][1][20] = chr(ord($items[5][1][20]) ^ 1);
+$items["short"] = array("", "123456789012345", "users.email");
+$items["aad"] = array("", $batch["a"], "other");
+var_dump($o->openBatch($items));
+
+?>
+--EXPECT--
+bool(true)
+string(7) "aes-siv"
+int(1)
+int(16)
+- key length check:
+bool(true)
+bool(true)
+bool(true)
+bool(false)
+bool(false)
+- iv length check:
+bool(true)
+bool(true)
+bool(true)
+- set key:
+string(64) "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"
+- rfc 5297:
+string(60) "40c02b9690c4dc04daef7f6afe5c85632d07c6e8f37f950acd320a2ecc93"
+string(28) "112233445566778899aabbccddee"
+- nonce:
+string(84) "fa254f77bf3be9b5b8e99f4ccd9a8f986b9935db9133f4923e5dcd2a1e69f02a89ce9e0c5624c67cd687"
+string(26) "Lorem ipsum dolor sit amet"
+- determinism:
+string(66) "12d2bb1d0f16a119f6ea76c65b4b82feca46c7bdb80c8bdd2ff3f86f5daab37d61"
+bool(true)
+string(66) "608361f46eb4ac65e90616f540428f363e7a43c443d1229bb59eb1b91ed8f9360f"
+bool(true)
+string(32) "f2007a5beb2b8900c588a7adf599f172"
+string(0) ""
+- key lengths:
+string(132) "ea8edb55806f0ac0f9bdc08e1524dbb508f2364eb17ff35704c63eab61c3305288d4e708974b82864d3eb4e8b89d7bb3ccff3ec77360d606c24b642f113b3cc996d4"
+string(50) "Lorem ipsum dolor sit amet, consectetur adipiscing"
+string(132) "36d3e5686f39e397eec560cc1b355fe6de3f6cf85eee08100d26c76df4c5567ccf8dbcb28860f8a7c5620018919662057a6eda5f8792a39c07db935a522ee0aa0b0c"
+string(50) "Lorem ipsum dolor sit amet, consectetur adipiscing"
+- batch:
+array(3) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  int(5)
+  [2]=>
+  string(1) "x"
+}
+string(66) "12d2bb1d0f16a119f6ea76c65b4b82feca46c7bdb80c8bdd2ff3f86f5daab37d61"
+string(62) "c96e820c6ff1a4485a84833f453de804f6fab4e166a9aaeb0a52091e00e9da"
+bool(true)
+bool(true)
+array(3) {
+  ["a"]=>
+  string(17) "alice@example.com"
+  [5]=>
+  string(15) "bob@example.com"
+  ["x"]=>
+  string(17) "alice@example.com"
+}
+array(0) {
+}
+- batch invalid items:
+array(5) {
+  ["a"]=>
+  string(17) "alice@example.com"
+  [5]=>
+  bool(false)
+  ["x"]=>
+  string(17) "alice@example.com"
+  ["short"]=>
+  bool(false)
+  ["aad"]=>
+  bool(false)
+}
@@ -51,3 +51,5 @@ string(27) "addDecryptionAdditionalData"
 string(18) "finalizeEncryption"
 string(18) "finalizeDecryption"
 string(7) "restart"
+string(4) "seal"
+string(4) "open"
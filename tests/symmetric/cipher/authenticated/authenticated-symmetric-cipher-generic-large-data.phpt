@@ -0,0 +1,161 @@
+--TEST--
+Authenticated symmetric cipher generic: large data
+--FILE--
+<?php
+
+// data larger than the tiles processed by the native cipher
+$key    = Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c");
+$iv     = Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f");
+$macKey = Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308");
+$data   = str_repeat("0123456789abcdef", 6250);
+
+// reference: cipher, then mac over the whole ciphertext
+$c = new Cryptopp\SymmetricModeCbc(new Cryptopp\BlockCipherAes());
+$c->setKey($key);
+$c->setIv($iv);
+$expectedCiphertext = $c->encrypt($data);
+
+$m = new Cryptopp\MacHmac(new Cryptopp\HashSha256());
+$m->setKey($macKey);
+$expectedMac = $m->calculateDigest($expectedCiphertext);
+
+// generic
+$o = new Cryptopp\AuthenticatedSymmetricCipherGeneric(new Cryptopp\SymmetricModeCbc(new Cryptopp\BlockCipherAes()), new Cryptopp\MacHmac(new Cryptopp\HashSha256()));
+$o->setMacKey($macKey);
+$o->setKey($key);
+$o->setIv($iv);
+
+echo "- encrypt:\n";
+$ciphertext = $o->encrypt($data);
+var_dump(strlen($ciphertext));
+var_dump($ciphertext === $expectedCiphertext);
+var_dump($o->finalizeEncryption() === $expectedMac);
+
+echo "- decrypt:\n";
+$o->restart();
+var_dump($o->decrypt($ciphertext) === $data);
+var_dump($o->finalizeDecryption() === $expectedMac);
+
+// several calls, some of them not aligned on tiles
+echo "- several calls:\n";
+$o->restart();
+$ciphertext = $o->encrypt(substr($data, 0, 16)) . $o->encrypt(substr($data, 16, 50000)) . $o->encrypt(substr($data, 50016));
+var_dump($ciphertext === $expectedCiphertext);
+var_dump($o->finalizeEncryption() === $expectedMac);
+
+// stream cipher
+echo "- stream cipher:\n";
+$c = new Cryptopp\StreamCipherSosemanuk();
+$c->setKey($key);
+$c->setIv($iv);
+$expectedCiphertext = $c->encrypt($data . "123");
+$expectedMac        = $m->calculateDigest($expectedCiphertext);
+
+$o = new Cryptopp\AuthenticatedSymmetricCipherGeneric(new Cryptopp\StreamCipherSosemanuk(), new Cryptopp\MacHmac(new Cryptopp\HashSha256()));
+$o->setMacKey($macKey);
+$o->setKey($key);
+$o->setIv($iv);
+var_dump($o->encrypt($data . "123") === $expectedCiphertext);
+var_dump($o->finalizeEncryption() === $expectedMac);
+
+// user mac: called once per call on both encryption and decryption, as without tiles
+echo "- user mac:\n";
+class MacUser implements Cryptopp\MacInterface
+{
+    public $updates = 0;
+    private $mac;
+
+    public function __construct()
+    {
+        $this->mac = new Cryptopp\MacHmac(new Cryptopp\HashSha256());
+    }
+
+    public function getName()
+    {
+        return "userm";
+    }
+
+    public function getDigestSize()
+    {
+        return $this->mac->getDigestSize();
+    }
+
+    public function getBlockSize()
+    {
+        return $this->mac->getBlockSize();
+    }
+
+    public function isValidKeyLength($l)
+    {
+        return $this->mac->isValidKeyLength($l);
+    }
+
+    public function setKey($key)
+    {
+        $this->mac->setKey($key);
+    }
+
+    public function getKey()
+    {
+        return $this->mac->getKey();
+    }
+
+    public function calculateDigest($data)
+    {
+        return $this->mac->calculateDigest($data);
+    }
+
+    public function update($data)
+    {
+        $this->updates++;
+        $this->mac->update($data);
+    }
+
+    public function finalize()
+    {
+        return $this->mac->finalize();
+    }
+
+    public function restart()
+    {
+        $this->mac->restart();
+    }
+}
+
+$mac = new MacUser();
+$o = new Cryptopp\AuthenticatedSymmetricCipherGeneric(new Cryptopp\SymmetricModeCbc(new Cryptopp\BlockCipherAes()), $mac);
+$o->setMacKey($macKey);
+$o->setKey($key);
+$o->setIv($iv);
+$ciphertext = $o->encrypt($data);
+var_dump($mac->updates);
+$expectedMac = $o->finalizeEncryption();
+var_dump($expectedMac === $m->calculateDigest($ciphertext));
+
+$o->restart();
+$mac->updates = 0;
+var_dump($o->decrypt($ciphertext) === $data);
+var_dump($mac->updates);
+var_dump($o->finalizeDecryption() === $expectedMac);
+
+?>
+--EXPECT--
+- encrypt:
+int(100000)
+bool(true)
+bool(true)
+- decrypt:
+bool(true)
+bool(true)
+- several calls:
+bool(true)
+bool(true)
+- stream cipher:
+bool(true)
+bool(true)
+- user mac:
+int(1)
+bool(true)
+bool(true)
+int(1)
+bool(true)
@@ -153,6 +153,8 @@ string(27) "addDecryptionAdditionalData"
 string(18) "finalizeEncryption"
 string(18) "finalizeDecryption"
 string(7) "restart"
+string(4) "seal"
+string(4) "open"
 - key length check:
 bool(true)
 bool(false)
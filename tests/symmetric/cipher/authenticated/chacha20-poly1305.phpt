@@ -0,0 +1,162 @@
+--TEST--
+Authenticated symmetric cipher: ChaCha20-Poly1305
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\AuthenticatedSymmetricCipherChaCha20Poly1305", "Cryptopp\AuthenticatedSymmetricCipherAbstract", true));
+
+// check algorithm infos
+$o = new Cryptopp\AuthenticatedSymmetricCipherChaCha20Poly1305();
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+var_dump($o->getDigestSize());
+
+// key length check
+echo "- key length check:\n";
+var_dump($o->isValidKeyLength(32));
+var_dump($o->isValidKeyLength(16));
+var_dump($o->isValidKeyLength(33));
+
+// iv length check
+echo "- iv length check:\n";
+var_dump($o->isValidIvLength(12));
+var_dump($o->isValidIvLength(8));
+var_dump($o->isValidIvLength(24));
+
+// set key
+echo "- set key:\n";
+$o->setKey("azertyuiopqsdfghjklmwxcvbnwqaxsz");
+var_dump($o->getKey());
+
+// set iv
+echo "- set iv:\n";
+$o->setIv("qsdfghjklmaz");
+var_dump($o->getIv());
+
+// rfc 8439 section 2.8.2
+echo "- encrypt + aad:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherChaCha20Poly1305();
+$o->setKey(Cryptopp\HexUtils::hex2bin("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("070000004041424344454647"));
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("50515253c0c1c2c3c4c5c6c7"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("Ladies and Gentlemen of the class of '99: If I could offer you o")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("nly one tip for the future, sunscreen would be it.")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+echo "- decrypt + aad:\n";
+$o->restart();
+$o->addDecryptionAdditionalData(Cryptopp\HexUtils::hex2bin("50515253c0c1c2c3c4c5c6c7"));
+var_dump($o->decrypt(Cryptopp\HexUtils::hex2bin("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36")));
+var_dump($o->decrypt(Cryptopp\HexUtils::hex2bin("92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// restart encryption
+echo "- restart encryption:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("Ladies and Gentlemen of the class of '99: If I could offer you o")));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("Ladies and Gentlemen of the class of '99: If I could offer you o")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("nly one tip for the future, sunscreen would be it.")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// restart decryption
+echo "- restart decryption:\n";
+$o->restart();
+var_dump($o->decrypt(Cryptopp\HexUtils::hex2bin("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36")));
+$o->restart();
+var_dump($o->decrypt(Cryptopp\HexUtils::hex2bin("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36")));
+var_dump($o->decrypt(Cryptopp\HexUtils::hex2bin("92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116")));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// encrypt aad only
+echo "- encrypt aad only:\n";
+$o->restart();
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("50515253c0c1c2c3c4c5c6c7"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// decrypt aad only
+echo "- decrypt aad only:\n";
+$o->restart();
+$o->addDecryptionAdditionalData(Cryptopp\HexUtils::hex2bin("50515253c0c1c2c3c4c5c6c7"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// empty message
+echo "- empty:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// seal and open
+echo "- seal and open:\n";
+$nonce  = Cryptopp\HexUtils::hex2bin("070000004041424344454647");
+$aad    = Cryptopp\HexUtils::hex2bin("50515253c0c1c2c3c4c5c6c7");
+$sealed = $o->seal($nonce, "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.", $aad);
+var_dump(Cryptopp\HexUtils::bin2hex($sealed));
+var_dump($o->open($nonce, $sealed, $aad));
+
+$tampered      = $sealed;
+$tampered[0]   = chr(ord($tampered[0]) ^ 1);
+
+try {
+    $o->open($nonce, $tampered, $aad);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . ": " . $e->getMessage() . "\n";
+}
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+$o->restart();
+$o->addEncryptionAdditionalData($data);
+$o->addDecryptionAdditionalData($data);
+var_dump(strlen($o->encrypt($data)));
+var_dump(strlen($o->decrypt($data)));
+
+?>
+--EXPECT--
+bool(true)
+string(17) "chacha20-poly1305"
+int(1)
+int(16)
+- key length check:
+bool(true)
+bool(false)
+bool(false)
+- iv length check:
+bool(true)
+bool(false)
+bool(false)
+- set key:
+string(32) "azertyuiopqsdfghjklmwxcvbnwqaxsz"
+- set iv:
+string(12) "qsdfghjklmaz"
+- encrypt + aad:
+string(128) "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+string(100) "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116"
+string(32) "1ae10b594f09e26a7e902ecbd0600691"
+- decrypt + aad:
+string(64) "Ladies and Gentlemen of the class of '99: If I could offer you o"
+string(50) "nly one tip for the future, sunscreen would be it."
+string(32) "1ae10b594f09e26a7e902ecbd0600691"
+- restart encryption:
+string(128) "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+string(128) "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+string(100) "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116"
+string(32) "6a23a4681fd59456aea1d29f82477216"
+- restart decryption:
+string(64) "Ladies and Gentlemen of the class of '99: If I could offer you o"
+string(64) "Ladies and Gentlemen of the class of '99: If I could offer you o"
+string(50) "nly one tip for the future, sunscreen would be it."
+string(32) "6a23a4681fd59456aea1d29f82477216"
+- encrypt aad only:
+string(32) "e622e5647a38d967a7ecbcb46c7f675c"
+- decrypt aad only:
+string(32) "e622e5647a38d967a7ecbcb46c7f675c"
+- empty:
+string(32) "a0784d7a4716f3feb4f64e7f4b39bf04"
+- seal and open:
+string(260) "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b61161ae10b594f09e26a7e902ecbd0600691"
+string(114) "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it."
+Cryptopp\CryptoppMacVerificationFailedException: Cryptopp\AuthenticatedSymmetricCipherChaCha20Poly1305 : MAC verification failed
+- large data:
+int(10485760)
+int(10485760)
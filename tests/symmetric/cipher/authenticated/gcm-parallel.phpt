@@ -0,0 +1,87 @@
+--TEST--
+Authenticated symmetric cipher: GCM multi-threaded processing
+--FILE--
+<?php
+
+$key = Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308");
+$iv  = Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888");
+$aad = Cryptopp\HexUtils::hex2bin("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+
+$serial = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+$serial->setKey($key);
+$serial->setIv($iv);
+$serial->setParallelThreshold(0);
+
+$parallel = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+$parallel->setKey($key);
+$parallel->setIv($iv);
+$parallel->setParallelThreshold(1024);
+
+// threshold
+echo "- threshold:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+var_dump($o->getParallelThreshold());
+var_dump($serial->getParallelThreshold());
+var_dump($parallel->getParallelThreshold());
+
+// same output and tag as the single threaded path, with unaligned and chained calls
+echo "- encrypt:\n";
+$data = str_repeat("0123456789abcdefghijklmnopqrstu", 270601);
+$serial->addEncryptionAdditionalData($aad);
+$parallel->addEncryptionAdditionalData($aad);
+var_dump($serial->encrypt("abc") === $parallel->encrypt("abc"));
+var_dump($serial->encrypt($data) === $parallel->encrypt($data));
+var_dump($serial->encrypt("defghijklmnopqrstuvwxyz") === $parallel->encrypt("defghijklmnopqrstuvwxyz"));
+var_dump($serial->encrypt($data) === $parallel->encrypt($data));
+var_dump($serial->finalizeEncryption() === $parallel->finalizeEncryption());
+
+echo "- decrypt:\n";
+$serial->restart();
+$parallel->restart();
+$serial->addEncryptionAdditionalData($aad);
+$parallel->addDecryptionAdditionalData($aad);
+$encrypted = $serial->encrypt($data);
+var_dump($data === $parallel->decrypt($encrypted));
+var_dump($serial->finalizeEncryption() === $parallel->finalizeDecryption());
+
+echo "- seal:\n";
+$sealed = $parallel->seal($iv, $data, $aad);
+var_dump($sealed === $serial->seal($iv, $data, $aad));
+var_dump($data === $parallel->open($iv, $sealed, $aad));
+
+try {
+    $sealed[1000000] = chr(ord($sealed[1000000]) ^ 1);
+    $parallel->open($iv, $sealed, $aad);
+} catch (Cryptopp\CryptoppException $e) {
+    echo get_class($e) . "\n";
+}
+
+// errors
+echo "- errors:\n";
+try {
+    $o->setParallelThreshold(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- threshold:
+int(4194304)
+int(0)
+int(1024)
+- encrypt:
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+- decrypt:
+bool(true)
+bool(true)
+- seal:
+bool(true)
+bool(true)
+Cryptopp\CryptoppMacVerificationFailedException
+- errors:
+Cryptopp\AuthenticatedSymmetricCipherGcm: threshold cannot be negative
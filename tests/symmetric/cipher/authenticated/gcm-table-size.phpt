@@ -0,0 +1,47 @@
+--TEST--
+Authenticated symmetric cipher: GCM table size
+--FILE--
+<?php
+
+$key        = Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308");
+$iv         = Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888");
+$plaintext  = Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+$aad        = Cryptopp\HexUtils::hex2bin("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+var_dump($o->getTableSize());
+
+foreach (array(2048, 65536) as $tableSize) {
+    echo "- $tableSize:\n";
+    $o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes(), $tableSize);
+    var_dump($o->getTableSize());
+    $o->setKey($key);
+    $o->setIv($iv);
+    $o->addEncryptionAdditionalData($aad);
+    var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($plaintext)));
+    var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+    var_dump($plaintext === $o->open($iv, $o->seal($iv, $plaintext, $aad), $aad));
+}
+
+echo "- invalid table size:\n";
+try {
+    $o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes(), 4096);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+int(2048)
+- 2048:
+int(2048)
+string(120) "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091"
+string(32) "5bc94fbc3221a5db94fae95ae7121a47"
+bool(true)
+- 65536:
+int(65536)
+string(120) "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091"
+string(32) "5bc94fbc3221a5db94fae95ae7121a47"
+bool(true)
+- invalid table size:
+Cryptopp\AuthenticatedSymmetricCipherGcm : table size must be 2048 or 65536, 4096 given
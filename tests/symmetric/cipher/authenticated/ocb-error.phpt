@@ -0,0 +1,192 @@
+--TEST--
+Authenticated symmetric cipher: OCB (errors)
+--FILE--
+<?php
+
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb($c);
+$o->setKey(Cryptopp\HexUtils::hex2bin("77be63708971c4e240d1cb79e8d77feb"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("e0e00f19fed7ba0136a797f3"));
+
+// invalid key
+echo "- invalid key:\n";
+try {
+    $o->setKey("123456789012345678901234567890123");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->setKey("");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// encrypt without key
+echo "- encrypt no key:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb(new Cryptopp\BlockCipherAes());
+
+try {
+    $o->encrypt("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// aad without key
+echo "- aad no key:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb(new Cryptopp\BlockCipherAes());
+
+try {
+    $o->addEncryptionAdditionalData("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// invalid iv
+echo "- invalid iv:\n";
+try {
+    $o->setIv("1234567890123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// empty iv
+echo "- empty iv:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb(new Cryptopp\BlockCipherAes());
+$o->setKey("1234567890123456");
+
+try {
+    $o->encrypt("123456");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// encrypt before aad
+echo "- encrypt before aad:\n";
+$o->restart();
+$o->setKey("1234567890123456");
+$o->setIv("123456789012");
+
+$o->encrypt("azerty");
+
+try {
+    $o->addEncryptionAdditionalData("qwerty");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// decrypt before aad
+echo "- decrypt before aad:\n";
+$o->decrypt("azerty");
+
+try {
+    $o->addDecryptionAdditionalData("qwerty");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// partial block followed by more data
+echo "- partial block:\n";
+$o->restart();
+$o->encrypt("1234567890123456");
+$o->encrypt("azerty");
+
+try {
+    $o->encrypt("qwerty");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o->restart();
+$o->decrypt("azerty");
+
+try {
+    $o->decrypt("qwerty");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// sleep
+echo "- sleep:\n";
+try {
+    serialize($o);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// bad arguments
+echo "- bad arguments:\n";
+var_dump(@$o->encrypt(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->decrypt(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->addEncryptionAdditionalData(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->addDecryptionAdditionalData(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->setKey(array()));
+echo "$php_errormsg\n";
+var_dump(@$o->setIv(array()));
+echo "$php_errormsg\n";
+
+// test inheritance
+echo "- inheritance:\n";
+class Child extends Cryptopp\AuthenticatedSymmetricCipherOcb{}
+
+$o = new Child(new Cryptopp\BlockCipherAes());
+var_dump($o->getBlockSize());
+
+// test inheritance - parent constructor not called
+echo "- inheritance (parent constructor not called):\n";
+class ChildParentConstructorNotCalled extends Cryptopp\AuthenticatedSymmetricCipherOcb
+{
+    public function __construct(){}
+}
+
+$o = new ChildParentConstructorNotCalled();
+
+try {
+    $o->getBlockSize();
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- invalid key:
+Cryptopp\AuthenticatedSymmetricCipherOcb : 33 is not a valid key length
+Cryptopp\AuthenticatedSymmetricCipherOcb : a key is required
+- encrypt no key:
+Cryptopp\AuthenticatedSymmetricCipherOcb : a key is required
+- aad no key:
+Cryptopp\AuthenticatedSymmetricCipherOcb : a key is required
+- invalid iv:
+Cryptopp\AuthenticatedSymmetricCipherOcb : 16 is not a valid initialization vector length
+- empty iv:
+Cryptopp\AuthenticatedSymmetricCipherOcb : an initialization vector is required
+- encrypt before aad:
+Cryptopp\AuthenticatedSymmetricCipherOcb: additional authenticated data must be added before any encryption
+- decrypt before aad:
+Cryptopp\AuthenticatedSymmetricCipherOcb: additional authenticated data must be added before any decryption
+- partial block:
+Cryptopp\AuthenticatedSymmetricCipherOcb : data must be processed by multiples of 16 bytes, only the last part of a message can be shorter
+Cryptopp\AuthenticatedSymmetricCipherOcb : data must be processed by multiples of 16 bytes, only the last part of a message can be shorter
+- sleep:
+You cannot serialize or unserialize Cryptopp\AuthenticatedSymmetricCipherAbstract instances
+- bad arguments:
+NULL
+Cryptopp\AuthenticatedSymmetricCipherAbstract::encrypt() expects parameter 1 to be string, array given
+NULL
+Cryptopp\AuthenticatedSymmetricCipherAbstract::decrypt() expects parameter 1 to be string, array given
+NULL
+Cryptopp\AuthenticatedSymmetricCipherAbstract::addEncryptionAdditionalData() expects parameter 1 to be string, array given
+NULL
+Cryptopp\AuthenticatedSymmetricCipherAbstract::addDecryptionAdditionalData() expects parameter 1 to be string, array given
+NULL
+Cryptopp\AuthenticatedSymmetricCipherAbstract::setKey() expects parameter 1 to be string, array given
+NULL
+Cryptopp\AuthenticatedSymmetricCipherAbstract::setIv() expects parameter 1 to be string, array given
+- inheritance:
+int(1)
+- inheritance (parent constructor not called):
+Cryptopp\AuthenticatedSymmetricCipherAbstract cannot be extended by user classes
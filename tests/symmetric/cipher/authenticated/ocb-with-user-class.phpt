@@ -0,0 +1,120 @@
+--TEST--
+Authenticated symmetric cipher: OCB with user class
+--FILE--
+<?php
+
+// decryption uses the inverse cipher, so the user class wraps a real block cipher
+class BlockCipherUser implements Cryptopp\BlockCipherInterface
+{
+    private $aes;
+
+    public function __construct()
+    {
+        $this->aes = new Cryptopp\BlockCipherAes();
+    }
+
+    public function getName()
+    {
+        return "user";
+    }
+
+    public function getBlockSize()
+    {
+        return 16;
+    }
+
+    public function isValidKeyLength($keyLength)
+    {
+        return 16 == $keyLength;
+    }
+
+    public function setKey($key)
+    {
+        $this->aes->setKey($key);
+    }
+
+    public function getKey()
+    {
+        return $this->aes->getKey();
+    }
+
+    public function encryptBlock($data)
+    {
+        return $this->aes->encryptBlock($data);
+    }
+
+    public function decryptBlock($data)
+    {
+        return $this->aes->decryptBlock($data);
+    }
+
+    public function encrypt($data)
+    {
+        return $this->aes->encrypt($data);
+    }
+
+    public function decrypt($data)
+    {
+        return $this->aes->decrypt($data);
+    }
+}
+
+// check algorithm infos
+$c = new BlockCipherUser();
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb($c);
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+
+// key length check
+echo "- key length check:\n";
+var_dump($o->isValidKeyLength(16));
+var_dump($o->isValidKeyLength(24));
+
+// encrypt
+echo "- encrypt:\n";
+$o->setKey(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa9988776655443322110d"));
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("2021222324252627"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// decrypt
+echo "- decrypt:\n";
+$o->restart();
+$o->addDecryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b65e8628e568bad7a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// block size
+echo "- invalid block size:\n";
+class BlockCipherUser2 extends BlockCipherUser
+{
+    public function getBlockSize()
+    {
+        return 8;
+    }
+}
+
+try {
+    $o = new Cryptopp\AuthenticatedSymmetricCipherOcb(new BlockCipherUser2());
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+string(9) "ocb(user)"
+int(1)
+- key length check:
+bool(true)
+bool(false)
+- encrypt:
+string(64) "d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"
+string(16) "65e8628e568bad7a"
+string(32) "ed07ba06a4a69483a7035490c5769e60"
+- decrypt:
+string(80) "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"
+string(32) "ed07ba06a4a69483a7035490c5769e60"
+- invalid block size:
+Cryptopp\AuthenticatedSymmetricCipherOcb require a block cipher with a block size of 128 bits (16 bytes)
@@ -0,0 +1,177 @@
+--TEST--
+Authenticated symmetric cipher: OCB
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\AuthenticatedSymmetricCipherOcb", "Cryptopp\AuthenticatedSymmetricCipherAbstract", true));
+
+// check algorithm infos
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb($c);
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+var_dump($o->getDigestSize());
+
+// key length check
+echo "- key length check:\n";
+var_dump($o->isValidKeyLength(16));
+var_dump($o->isValidKeyLength(15));
+var_dump($o->isValidKeyLength(17));
+
+// iv length check
+echo "- iv length check:\n";
+var_dump($o->isValidIvLength(0));
+var_dump($o->isValidIvLength(1));
+var_dump($o->isValidIvLength(12));
+var_dump($o->isValidIvLength(15));
+var_dump($o->isValidIvLength(16));
+
+// set key
+echo "- set key:\n";
+$o->setKey("azertyuiopqsdfgh");
+var_dump($o->getKey());
+var_dump($c->getKey());
+
+// set iv
+echo "- set iv:\n";
+$o->setIv("qsdfghjklmaz");
+var_dump($o->getIv());
+
+// rfc 7253 appendix A
+echo "- encrypt:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb($c);
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa9988776655443322110d"));
+$c->setKey(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("2021222324252627"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// decrypt
+echo "- decrypt:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\AuthenticatedSymmetricCipherOcb($c);
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa9988776655443322110d"));
+$c->setKey(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+$o->addDecryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("65e8628e568bad7a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// restart encryption
+echo "- restart encryption:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"))));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("2021222324252627"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// restart decryption
+echo "- restart decryption:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"))));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("65e8628e568bad7a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// short messages
+echo "- short messages:\n";
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa99887766554433221100"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa99887766554433221101"));
+$o->restart();
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("0001020304050607"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("0001020304050607"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa99887766554433221103"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("45dd69f8f5aae724"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// encrypt aad only
+echo "- encrypt aad only:\n";
+$o->setIv(Cryptopp\HexUtils::hex2bin("bbaa99887766554433221104"));
+$o->restart();
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+$o->addEncryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// decrypt aad only
+echo "- decrypt aad only:\n";
+$o->restart();
+$o->addDecryptionAdditionalData(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f000102030405060708090a0b0c0d0e0f"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// seal and open
+echo "- seal and open:\n";
+$nonce  = Cryptopp\HexUtils::hex2bin("bbaa9988776655443322110d");
+$sealed = $o->seal($nonce, Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"));
+var_dump(Cryptopp\HexUtils::bin2hex($sealed));
+var_dump(Cryptopp\HexUtils::bin2hex($o->open($nonce, $sealed)));
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+$o->restart();
+$o->addEncryptionAdditionalData($data);
+$o->addDecryptionAdditionalData($data);
+var_dump(strlen($o->encrypt($data)));
+var_dump(strlen($o->decrypt($data)));
+
+?>
+--EXPECT--
+bool(true)
+string(8) "ocb(aes)"
+int(1)
+int(16)
+- key length check:
+bool(true)
+bool(false)
+bool(false)
+- iv length check:
+bool(false)
+bool(true)
+bool(true)
+bool(true)
+bool(false)
+- set key:
+string(16) "azertyuiopqsdfgh"
+string(16) "azertyuiopqsdfgh"
+- set iv:
+string(12) "qsdfghjklmaz"
+- encrypt:
+string(64) "d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"
+string(16) "65e8628e568bad7a"
+string(32) "ed07ba06a4a69483a7035490c5769e60"
+- decrypt:
+string(64) "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+string(16) "2021222324252627"
+string(32) "ed07ba06a4a69483a7035490c5769e60"
+- restart encryption:
+string(64) "d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"
+string(64) "d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b"
+string(16) "65e8628e568bad7a"
+string(32) "8e975c5341d3d5d0cf3258cf7fee7f74"
+- restart decryption:
+string(64) "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+string(64) "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+string(16) "2021222324252627"
+string(32) "8e975c5341d3d5d0cf3258cf7fee7f74"
+- short messages:
+string(32) "785407bfffc8ad9edcc5520ac9111ee6"
+string(16) "6820b3657b6f615a"
+string(32) "5725bda0d3b4eb3a257c9af1f8f03009"
+string(16) "0001020304050607"
+string(32) "14054cd1f35d82760b2cd00d2f99bfa9"
+- encrypt aad only:
+string(32) "86928dca2327a7b74bd7298666637724"
+- decrypt aad only:
+string(32) "86928dca2327a7b74bd7298666637724"
+- seal and open:
+string(112) "d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b65e8628e568bad7a8e975c5341d3d5d0cf3258cf7fee7f74"
+string(80) "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324252627"
+- large data:
+int(10485760)
+int(10485760)
@@ -0,0 +1,242 @@
+--TEST--
+Authenticated symmetric cipher: sealBatch and openBatch
+--FILE--
+<?php
+
+$key        = Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308");
+$nonce1     = Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888");
+$nonce2     = Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf889");
+$plaintext  = Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+$aad        = Cryptopp\HexUtils::hex2bin("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+
+echo "- gcm:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+$o->setKey($key);
+$o->setIv($nonce1);
+$sealed = $o->sealBatch(array(
+    "a" => array($nonce1, $plaintext, $aad),
+    3   => array($nonce2, Cryptopp\HexUtils::hex2bin("000102030405")),
+    "c" => array($nonce1, "", ""),
+));
+var_dump(array_keys($sealed));
+var_dump(Cryptopp\HexUtils::bin2hex($sealed["a"]));
+var_dump(Cryptopp\HexUtils::bin2hex($sealed[3]));
+var_dump($sealed["c"] === $o->seal($nonce1, ""));
+var_dump($o->sealBatch(array()));
+
+// open
+echo "- open:\n";
+$opened = $o->openBatch(array(
+    "a" => array($nonce1, $sealed["a"], $aad),
+    3   => array($nonce2, $sealed[3]),
+    "c" => array($nonce1, $sealed["c"]),
+));
+var_dump(Cryptopp\HexUtils::bin2hex($opened["a"]));
+var_dump(Cryptopp\HexUtils::bin2hex($opened[3]));
+var_dump($opened["c"]);
+
+// the current iv is not changed
+echo "- current iv:\n";
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->getIv()));
+
+// messages that are not authentic
+echo "- verification:\n";
+$tampered       = $sealed["a"];
+$tampered[0]    = chr(ord($tampered[0]) ^ 1);
+var_dump($o->openBatch(array(
+    array($nonce1, $tampered, $aad),
+    array($nonce1, $sealed["a"]),
+    array($nonce2, $sealed["a"], $aad),
+    array($nonce1, "abc"),
+    array($nonce1, $sealed["a"], $aad),
+)));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->sealBatch(array(array($nonce1)));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->openBatch(array(array($nonce1, $sealed["a"], 123)));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->sealBatch(array(array($nonce1, $plaintext), array("", $plaintext)));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+    $o->sealBatch(array(array($nonce1, $plaintext)));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// ccm needs lengths before processing data
+echo "- ccm:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherCcm(new Cryptopp\BlockCipherAes());
+$o->setKey($key);
+$sealed = $o->sealBatch(array(array($nonce1, $plaintext, $aad), array($nonce2, $plaintext)));
+var_dump($sealed[0] === $o->seal($nonce1, $plaintext, $aad));
+var_dump($sealed[1] === $o->seal($nonce2, $plaintext));
+var_dump($o->openBatch(array(array($nonce1, $sealed[0], $aad), array($nonce2, $sealed[1]))) === array($plaintext, $plaintext));
+
+// blocks of small messages are interleaved, larger messages are processed one by one
+echo "- interleaving:\n";
+foreach (array("Cryptopp\AuthenticatedSymmetricCipherGcm", "Cryptopp\AuthenticatedSymmetricCipherOcb") as $className) {
+    $o = new $className(new Cryptopp\BlockCipherAes());
+    $o->setKey($key);
+    $items      = array();
+    $expected   = array();
+    $plaintexts = array();
+
+    for ($i = 1; $i <= 40; $i++) {
+        $n = substr($nonce1 . $nonce2, $i % 7, 8 + $i % 5);
+        $p = str_repeat(chr($i), 40 == $i ? 5000 : $i * 37);
+        $a = str_repeat("a", $i % 20);
+
+        // streaming encryption
+        $o->setIv($n);
+
+        if ("" !== $a) {
+            $o->addEncryptionAdditionalData($a);
+        }
+
+        $items[$i]      = array($n, $p, $a);
+        $expected[$i]   = $o->encrypt($p) . $o->finalizeEncryption();
+        $plaintexts[$i] = $p;
+    }
+
+    $sealed = $o->sealBatch($items);
+    var_dump($sealed === $expected);
+
+    foreach ($sealed as $i => $c) {
+        $items[$i][1] = $c;
+    }
+
+    var_dump($o->openBatch($items) === $plaintexts);
+}
+
+// user block ciphers get the blocks of several messages at once too
+echo "- user class:\n";
+class BlockCipherUser implements Cryptopp\BlockCipherInterface
+{
+    private $aes;
+
+    public function __construct()
+    {
+        $this->aes = new Cryptopp\BlockCipherAes();
+    }
+
+    public function getName()
+    {
+        return "user";
+    }
+
+    public function getBlockSize()
+    {
+        return 16;
+    }
+
+    public function isValidKeyLength($keyLength)
+    {
+        return 16 == $keyLength;
+    }
+
+    public function setKey($key)
+    {
+        $this->aes->setKey($key);
+    }
+
+    public function getKey()
+    {
+        return $this->aes->getKey();
+    }
+
+    public function encryptBlock($data)
+    {
+        return $this->aes->encryptBlock($data);
+    }
+
+    public function decryptBlock($data)
+    {
+        return $this->aes->decryptBlock($data);
+    }
+
+    public function encrypt($data)
+    {
+        return $this->aes->encrypt($data);
+    }
+
+    public function decrypt($data)
+    {
+        return $this->aes->decrypt($data);
+    }
+}
+
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new BlockCipherUser());
+$o->setKey($key);
+$sealed = $o->sealBatch(array(array($nonce1, $plaintext, $aad), array($nonce2, Cryptopp\HexUtils::hex2bin("000102030405"))));
+var_dump(Cryptopp\HexUtils::bin2hex($sealed[1]));
+var_dump($o->openBatch(array(array($nonce1, $sealed[0], $aad))) === array($plaintext));
+
+?>
+--EXPECT--
+- gcm:
+array(3) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  int(3)
+  [2]=>
+  string(1) "c"
+}
+string(152) "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e0915bc94fbc3221a5db94fae95ae7121a47"
+string(44) "8511f6ac55f9a678da70accdb1e8131f20f8457636fb"
+bool(true)
+array(0) {
+}
+- open:
+string(120) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+string(12) "000102030405"
+string(0) ""
+- current iv:
+string(32) "42831ec2217774244b7221b784d0d49c"
+string(24) "cafebabefacedbaddecaf888"
+- verification:
+array(5) {
+  [0]=>
+  bool(false)
+  [1]=>
+  bool(false)
+  [2]=>
+  bool(false)
+  [3]=>
+  bool(false)
+  [4]=>
+  string(60) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+}
+- errors:
+Cryptopp\AuthenticatedSymmetricCipherGcm : each item must be an array of 2 or 3 strings: nonce, data and additional authenticated data
+Cryptopp\AuthenticatedSymmetricCipherGcm : each item must be an array of 2 or 3 strings: nonce, data and additional authenticated data
+Cryptopp\AuthenticatedSymmetricCipherGcm : an initialization vector is required
+Cryptopp\AuthenticatedSymmetricCipherGcm : a key is required
+- ccm:
+bool(true)
+bool(true)
+bool(true)
+- interleaving:
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+- user class:
+string(44) "8511f6ac55f9a678da70accdb1e8131f20f8457636fb"
+bool(true)
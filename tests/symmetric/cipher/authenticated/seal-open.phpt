@@ -0,0 +1,119 @@
+--TEST--
+Authenticated symmetric cipher: seal and open
+--FILE--
+<?php
+
+$key        = Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308");
+$nonce1     = Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888");
+$nonce2     = Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf889");
+$plaintext  = Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+$aad        = Cryptopp\HexUtils::hex2bin("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+
+echo "- gcm:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+$o->setKey($key);
+$sealed = $o->seal($nonce1, $plaintext, $aad);
+var_dump(Cryptopp\HexUtils::bin2hex($sealed));
+var_dump(Cryptopp\HexUtils::bin2hex($o->open($nonce1, $sealed, $aad)));
+var_dump(Cryptopp\HexUtils::bin2hex($o->seal($nonce2, Cryptopp\HexUtils::hex2bin("000102030405"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->open($nonce2, Cryptopp\HexUtils::hex2bin("8511f6ac55f9a678da70accdb1e8131f20f8457636fb"))));
+var_dump($o->open($nonce1, $o->seal($nonce1, "")));
+
+// the current iv is not changed
+echo "- current iv:\n";
+$o->setIv($nonce1);
+$o->seal($nonce2, $plaintext);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a"))));
+$o->open($nonce2, $o->seal($nonce2, $plaintext));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("42831ec2217774244b7221b784d0d49c"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->getIv()));
+
+echo "- verification:\n";
+$tampered       = $sealed;
+$tampered[0]    = chr(ord($tampered[0]) ^ 1);
+
+try {
+    $o->open($nonce1, $tampered, $aad);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . ": " . $e->getMessage() . "\n";
+}
+
+try {
+    $o->open($nonce1, $sealed);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . ": " . $e->getMessage() . "\n";
+}
+
+try {
+    $o->open($nonce2, $sealed, $aad);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . ": " . $e->getMessage() . "\n";
+}
+
+try {
+    $o->open($nonce1, "abc");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->seal("", $plaintext);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+    $o->seal($nonce1, $plaintext);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+echo "- ccm:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherCcm(new Cryptopp\BlockCipherAes());
+$o->setKey($key);
+$sealed = $o->seal($nonce1, $plaintext, $aad);
+var_dump(strlen($sealed));
+var_dump($plaintext === $o->open($nonce1, $sealed, $aad));
+var_dump($plaintext === $o->open($nonce2, $o->seal($nonce2, $plaintext)));
+
+echo "- eax:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherEax(new Cryptopp\BlockCipherAes());
+$o->setKey($key);
+$sealed = $o->seal($nonce1, $plaintext, $aad);
+var_dump(strlen($sealed));
+var_dump($plaintext === $o->open($nonce1, $sealed, $aad));
+
+$o->setIv($nonce1);
+$o->addEncryptionAdditionalData($aad);
+var_dump($sealed === $o->encrypt($plaintext) . $o->finalizeEncryption());
+
+?>
+--EXPECT--
+- gcm:
+string(152) "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e0915bc94fbc3221a5db94fae95ae7121a47"
+string(120) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+string(44) "8511f6ac55f9a678da70accdb1e8131f20f8457636fb"
+string(12) "000102030405"
+string(0) ""
+- current iv:
+string(32) "42831ec2217774244b7221b784d0d49c"
+string(32) "42831ec2217774244b7221b784d0d49c"
+string(32) "d9313225f88406e5a55909c5aff5269a"
+string(24) "cafebabefacedbaddecaf888"
+- verification:
+Cryptopp\CryptoppMacVerificationFailedException: Cryptopp\AuthenticatedSymmetricCipherGcm : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException: Cryptopp\AuthenticatedSymmetricCipherGcm : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException: Cryptopp\AuthenticatedSymmetricCipherGcm : MAC verification failed
+Cryptopp\AuthenticatedSymmetricCipherGcm: data size (3) is lower than the MAC tag size (16)
+Cryptopp\AuthenticatedSymmetricCipherGcm : an initialization vector is required
+Cryptopp\AuthenticatedSymmetricCipherGcm : a key is required
+- ccm:
+int(76)
+bool(true)
+bool(true)
+- eax:
+int(76)
+bool(true)
+bool(true)
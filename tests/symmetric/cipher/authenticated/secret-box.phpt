@@ -0,0 +1,92 @@
+--TEST--
+Authenticated symmetric cipher: SecretBox
+--FILE--
+<?php
+
+$key    = Cryptopp\HexUtils::hex2bin("1b27556473e985d462cd51197a9a46c76009549eac6474f206c4ee0844f68389");
+$nonce  = Cryptopp\HexUtils::hex2bin("69696ee955b62b73cd62bda875fc73d68219e0036b7a0b37");
+
+// NaCl test vector
+echo "- seal:\n";
+$data = Cryptopp\HexUtils::hex2bin(
+    "be075fc53c81f2d5cf141316ebeb0c7b5228c52a4c62cbd44b66849b64244ffc" .
+    "e5ecbaaf33bd751a1ac728d45e6c61296cdc3c01233561f41db66cce314adb31" .
+    "0e3be8250c46f06dceea3a7fa1348057e2f6556ad6b1318a024a838f21af1fde" .
+    "048977eb48f59ffd4924ca1c60902e52f0a089bc76897040e082f93776384864" .
+    "5e0705"
+);
+$box = Cryptopp\SecretBox::seal($key, $nonce, $data);
+var_dump(Cryptopp\HexUtils::bin2hex($box));
+var_dump(Cryptopp\HexUtils::bin2hex(Cryptopp\SecretBox::seal($key, $nonce, "hello world")));
+var_dump(Cryptopp\HexUtils::bin2hex(Cryptopp\SecretBox::seal($key, $nonce, "")));
+
+// open
+echo "- open:\n";
+var_dump(Cryptopp\SecretBox::open($key, $nonce, $box) === $data);
+var_dump(Cryptopp\SecretBox::open($key, $nonce, Cryptopp\SecretBox::seal($key, $nonce, "hello world")));
+var_dump(Cryptopp\SecretBox::open($key, $nonce, Cryptopp\SecretBox::seal($key, $nonce, "")));
+
+// tampered
+echo "- tampered:\n";
+$tampered       = $box;
+$tampered[20]   = chr(ord($tampered[20]) ^ 1);
+
+try {
+    Cryptopp\SecretBox::open($key, $nonce, $tampered);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . " : " . $e->getMessage() . "\n";
+}
+
+$tampered       = $box;
+$tampered[0]    = chr(ord($tampered[0]) ^ 1);
+
+try {
+    Cryptopp\SecretBox::open($key, $nonce, $tampered);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . " : " . $e->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\SecretBox::open($key, strrev($nonce), $box);
+} catch (Cryptopp\CryptoppMacVerificationFailedException $e) {
+    echo get_class($e) . " : " . $e->getMessage() . "\n";
+}
+
+// errors
+echo "- errors:\n";
+try {
+    Cryptopp\SecretBox::seal("1234567890123456", $nonce, "data");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\SecretBox::seal($key, "123456789012", "data");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\SecretBox::open($key, $nonce, "123456789012345");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- seal:
+string(294) "f3ffc7703f9400e52a7dfb4b3d3305d98e993b9f48681273c29650ba32fc76ce48332ea7164d96a4476fb8c531a1186ac0dfc17c98dce87b4da7f011ec48c97271d2c20f9b928fe2270d6fb863d51738b48eeee314a7cc8ab932164548e526ae90224368517acfeabd6bb3732bc0e9da99832b61ca01b6de56244a9e88d5f9b37973f622a43d14a6599b1f654cb45a74e355a5"
+string(54) "0bbeaa7668cb1621c42fe4d4e5a4afcb58fb08361bc997c97fee27"
+string(32) "2539121d8e234e652d651fa4c8cff880"
+- open:
+bool(true)
+string(11) "hello world"
+string(0) ""
+- tampered:
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\SecretBox : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\SecretBox : MAC verification failed
+Cryptopp\CryptoppMacVerificationFailedException : Cryptopp\SecretBox : MAC verification failed
+- errors:
+Cryptopp\SecretBox : 16 is not a valid key length
+Cryptopp\SecretBox : 12 is not a valid nonce length
+Cryptopp\SecretBox : data must be at least 16 bytes long
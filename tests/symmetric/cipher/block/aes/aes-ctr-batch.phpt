@@ -0,0 +1,100 @@
+--TEST--
+Block cipher: AES multi-key CTR batch
+--FILE--
+<?php
+
+// NIST SP 800-38A F.5.1
+echo "- known vector:\n";
+$result = Cryptopp\BlockCipherAes::encryptCtrBatch(array(
+    "a" => array(
+        Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"),
+        Cryptopp\HexUtils::hex2bin("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"),
+        Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"),
+    ),
+));
+var_dump(array_keys($result));
+var_dump(Cryptopp\HexUtils::bin2hex($result["a"]));
+
+// same result as one SymmetricModeCtr per message
+echo "- compare with SymmetricModeCtr:\n";
+$items = array();
+
+for ($i = 0; $i < 40; $i++) {
+    $key    = substr(str_repeat(chr(65 + $i), 32), 0, 16 + 8 * ($i % 3));
+    $iv     = str_repeat(chr(255 - $i), 16);
+    $data   = substr(str_repeat("0123456789abcdefghijklmnopqrstuvwxyz", 10), $i, ($i * 37) % 257);
+    $items[10 * $i] = array($key, $iv, $data);
+}
+
+$encrypted  = Cryptopp\BlockCipherAes::encryptCtrBatch($items);
+$ok         = count($encrypted) == count($items);
+$decryptList = array();
+
+foreach ($items as $index => $item) {
+    $o = new Cryptopp\SymmetricModeCtr(new Cryptopp\BlockCipherAes());
+    $o->setKey($item[0]);
+    $o->setIv($item[1]);
+    $ok = $ok && $encrypted[$index] === $o->encrypt($item[2]);
+
+    $decryptList[$index] = array($item[0], $item[1], $encrypted[$index]);
+}
+
+var_dump($ok);
+
+$decrypted  = Cryptopp\BlockCipherAes::decryptCtrBatch($decryptList);
+$ok         = true;
+
+foreach ($items as $index => $item) {
+    $ok = $ok && $decrypted[$index] === $item[2];
+}
+
+var_dump($ok);
+var_dump(Cryptopp\BlockCipherAes::encryptCtrBatch(array()));
+
+// errors
+echo "- errors:\n";
+$key    = "1234567890123456";
+$iv     = "abcdefghijklmnop";
+
+try {
+    Cryptopp\BlockCipherAes::encryptCtrBatch(array(array($key, $iv)));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\BlockCipherAes::encryptCtrBatch(array("data"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\BlockCipherAes::encryptCtrBatch(array(array($key, $iv, "data"), array("123", $iv, "data")));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    Cryptopp\BlockCipherAes::decryptCtrBatch(array(array($key, "123", "data")));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- known vector:
+array(1) {
+  [0]=>
+  string(1) "a"
+}
+string(64) "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+- compare with SymmetricModeCtr:
+bool(true)
+bool(true)
+array(0) {
+}
+- errors:
+Cryptopp\BlockCipherAes: each item must be an array of 3 strings: key, initialization vector and data
+Cryptopp\BlockCipherAes: each item must be an array of 3 strings: key, initialization vector and data
+Cryptopp\BlockCipherAes : 3 is not a valid key length
+Cryptopp\BlockCipherAes : 3 is not a valid initialization vector length
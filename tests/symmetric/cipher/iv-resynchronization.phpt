@@ -0,0 +1,102 @@
+--TEST--
+Symmetric cipher: iv resynchronization
+--FILE--
+<?php
+
+// restart() and setIv() only load the iv when the key did not change. a key changed in the meantime,
+// including directly on the underlying cipher, must always be taken into account
+$key    = Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c");
+$iv1    = Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f");
+$iv2    = Cryptopp\HexUtils::hex2bin("0f0e0d0c0b0a09080706050403020100");
+$block  = Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a");
+
+echo "- mode:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\SymmetricModeCbc($c);
+$o->setKey($key);
+$o->setIv($iv1);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($block)));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($block)));
+$o->setIv($iv2);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($block)));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("39d96651b10ea680aff0acc620b0d5aa"))));
+$o->setIv($iv1);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("7649abac8119b246cee98e9b12e9197d"))));
+
+// key set on the cipher object
+$c->setKey($iv1);
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($block)));
+
+echo "- stream cipher:\n";
+$key    = Cryptopp\HexUtils::hex2bin("0053a6f94c9ff24598eb3e91e4378add3083d6297ccf2275c81b6ec11467ba0d");
+$iv1    = Cryptopp\HexUtils::hex2bin("0d74db42a91077de");
+$iv2    = Cryptopp\HexUtils::hex2bin("de7710a942db740d");
+$data   = str_repeat("a", 100);
+
+$reference1 = new Cryptopp\StreamCipherSalsa20();
+$reference1->setKey($key);
+$reference1->setIv($iv1);
+$reference1 = $reference1->encrypt($data);
+
+$reference2 = new Cryptopp\StreamCipherSalsa20();
+$reference2->setKey($key);
+$reference2->setIv($iv2);
+$reference2 = $reference2->encrypt($data);
+
+$o = new Cryptopp\StreamCipherSalsa20();
+$o->setIv($iv1);
+$o->setKey($key);
+var_dump($reference1 === $o->encrypt($data));
+$o->restart();
+var_dump($reference1 === $o->encrypt($data));
+$o->setIv($iv2);
+var_dump($reference2 === $o->encrypt($data));
+var_dump($data === $o->decrypt($reference2));
+$o->setIv($iv1);
+var_dump($data === $o->decrypt($reference1));
+
+echo "- authenticated cipher:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm($c);
+$o->setKey(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("000000000000000000000000"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("0388dace60b6a392f328c2b971b2fe78"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeDecryption()));
+
+// key set on the cipher object: the hash key must be computed again
+$c->setKey(Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"))));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"))));
+
+?>
+--EXPECT--
+- mode:
+string(32) "7649abac8119b246cee98e9b12e9197d"
+string(32) "7649abac8119b246cee98e9b12e9197d"
+string(32) "39d96651b10ea680aff0acc620b0d5aa"
+string(32) "6bc1bee22e409f96e93d7e117393172a"
+string(32) "6bc1bee22e409f96e93d7e117393172a"
+string(32) "e4ef93eb8ef9a7424709f8eaa953450e"
+- stream cipher:
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+- authenticated cipher:
+string(32) "0388dace60b6a392f328c2b971b2fe78"
+string(32) "ab6e47d42cec13bdf53a67b21257bddf"
+string(32) "0388dace60b6a392f328c2b971b2fe78"
+string(32) "ab6e47d42cec13bdf53a67b21257bddf"
+string(32) "00000000000000000000000000000000"
+string(32) "ab6e47d42cec13bdf53a67b21257bddf"
+string(64) "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+string(64) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
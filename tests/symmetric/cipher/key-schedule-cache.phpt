@@ -0,0 +1,100 @@
+--TEST--
+Symmetric cipher: key schedules cache
+--FILE--
+<?php
+
+// key schedules of native ciphers are cached. switching keys must always give the right results
+$keys = array(
+    Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"),
+    Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f1011121314151617"),
+    Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"),
+);
+$block = Cryptopp\HexUtils::hex2bin("00112233445566778899aabbccddeeff");
+
+echo "- block cipher:\n";
+$c1 = new Cryptopp\BlockCipherAes();
+$c2 = new Cryptopp\BlockCipherAes();
+
+for ($i = 0; $i < 2; $i++) {
+    foreach ($keys as $key) {
+        $c1->setKey($key);
+        $c2->setKey($key);
+        $encrypted = $c1->encryptBlock($block);
+        var_dump(Cryptopp\HexUtils::bin2hex($encrypted));
+        var_dump($block === $c2->decryptBlock($encrypted));
+    }
+}
+
+echo "- mode:\n";
+$o = new Cryptopp\SymmetricModeCtr(new Cryptopp\BlockCipherAes());
+$o->setIv(Cryptopp\HexUtils::hex2bin("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+
+for ($i = 0; $i < 2; $i++) {
+    $o->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+    var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+    $o->setKey($keys[0]);
+    $o->restart();
+    var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($block)));
+}
+
+echo "- authenticated cipher:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+
+for ($i = 0; $i < 2; $i++) {
+    $o->setKey(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"));
+    $o->setIv(Cryptopp\HexUtils::hex2bin("000000000000000000000000"));
+    var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+    var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+    $o->setKey(Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308"));
+    $o->setIv(Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888"));
+    var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"))));
+    $o->finalizeDecryption();
+}
+
+echo "- eviction:\n";
+$c1 = new Cryptopp\BlockCipherAes();
+$c2 = new Cryptopp\BlockCipherAes();
+$ok = true;
+
+for ($i = 0; $i < 2000; $i++) {
+    $key = str_pad($i, 16, "k");
+    $c1->setKey($key);
+    $c2->setKey($key);
+    $ok = $ok && $block === $c2->decryptBlock($c1->encryptBlock($block));
+}
+
+$c1->setKey($keys[0]);
+var_dump($ok);
+var_dump(Cryptopp\HexUtils::bin2hex($c1->encryptBlock($block)));
+
+?>
+--EXPECT--
+- block cipher:
+string(32) "69c4e0d86a7b0430d8cdb78070b4c55a"
+bool(true)
+string(32) "dda97ca4864cdfe06eaf70a0ec0d7191"
+bool(true)
+string(32) "8ea2b7ca516745bfeafc49904b496089"
+bool(true)
+string(32) "69c4e0d86a7b0430d8cdb78070b4c55a"
+bool(true)
+string(32) "dda97ca4864cdfe06eaf70a0ec0d7191"
+bool(true)
+string(32) "8ea2b7ca516745bfeafc49904b496089"
+bool(true)
+- mode:
+string(32) "874d6191b620e3261bef6864990db6ce"
+string(32) "66b6e5db7007573f1fc874bcffcb4352"
+string(32) "874d6191b620e3261bef6864990db6ce"
+string(32) "66b6e5db7007573f1fc874bcffcb4352"
+- authenticated cipher:
+string(32) "0388dace60b6a392f328c2b971b2fe78"
+string(32) "ab6e47d42cec13bdf53a67b21257bddf"
+string(64) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+string(32) "0388dace60b6a392f328c2b971b2fe78"
+string(32) "ab6e47d42cec13bdf53a67b21257bddf"
+string(64) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+- eviction:
+bool(true)
+string(32) "69c4e0d86a7b0430d8cdb78070b4c55a"
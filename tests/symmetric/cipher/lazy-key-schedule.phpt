@@ -0,0 +1,82 @@
+--TEST--
+Symmetric cipher: lazy key scheduling
+--FILE--
+<?php
+
+// each direction is keyed on its first use. using only one direction, or switching keys between directions,
+// must always give the right results
+$key128 = Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f");
+$key192 = Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f1011121314151617");
+$block  = Cryptopp\HexUtils::hex2bin("00112233445566778899aabbccddeeff");
+
+echo "- block cipher:\n";
+$c = new Cryptopp\BlockCipherAes();
+$c->setKey($key128);
+var_dump(Cryptopp\HexUtils::bin2hex($c->decryptBlock(Cryptopp\HexUtils::hex2bin("69c4e0d86a7b0430d8cdb78070b4c55a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($c->encryptBlock($block)));
+$c->setKey($key192);
+var_dump(Cryptopp\HexUtils::bin2hex($c->decryptBlock(Cryptopp\HexUtils::hex2bin("dda97ca4864cdfe06eaf70a0ec0d7191"))));
+$c->setKey($key128);
+var_dump(Cryptopp\HexUtils::bin2hex($c->decryptBlock(Cryptopp\HexUtils::hex2bin("69c4e0d86a7b0430d8cdb78070b4c55a"))));
+
+echo "- mode:\n";
+$o = new Cryptopp\SymmetricModeCbc(new Cryptopp\BlockCipherAes());
+$o->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("7649abac8119b246cee98e9b12e9197d"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("7649abac8119b246cee98e9b12e9197d"))));
+
+// the iv is set before the key
+$o = new Cryptopp\SymmetricModeCbc(new Cryptopp\BlockCipherAes());
+$o->setIv(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+$o->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("7649abac8119b246cee98e9b12e9197d"))));
+
+echo "- authenticated cipher:\n";
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm(new Cryptopp\BlockCipherAes());
+$o->setKey(Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"))));
+
+$o->setKey(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("000000000000000000000000"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->finalizeEncryption()));
+
+// CCM lengths are specified on each direction when it is keyed
+$o = new Cryptopp\AuthenticatedSymmetricCipherCcm(new Cryptopp\BlockCipherAes());
+$o->setKey(Cryptopp\HexUtils::hex2bin("c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("00000003020100a0a1a2a3a4a5"));
+$o->setDigestSize(8);
+$o->specifyDataSize(11, 0);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("588c979a61c663d2f066d0"))));
+$o->restart();
+$o->specifyDataSize(11, 0);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("08090a0b0c0d0e0f101112"))));
+
+?>
+--EXPECT--
+- block cipher:
+string(32) "00112233445566778899aabbccddeeff"
+string(32) "69c4e0d86a7b0430d8cdb78070b4c55a"
+string(32) "00112233445566778899aabbccddeeff"
+string(32) "00112233445566778899aabbccddeeff"
+- mode:
+string(32) "6bc1bee22e409f96e93d7e117393172a"
+string(32) "7649abac8119b246cee98e9b12e9197d"
+string(32) "7649abac8119b246cee98e9b12e9197d"
+string(32) "6bc1bee22e409f96e93d7e117393172a"
+string(32) "6bc1bee22e409f96e93d7e117393172a"
+- authenticated cipher:
+string(64) "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+string(64) "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+string(32) "58e2fccefa7e3061367f1d57a4e7455a"
+string(32) "0388dace60b6a392f328c2b971b2fe78"
+string(32) "ab6e47d42cec13bdf53a67b21257bddf"
+string(22) "08090a0b0c0d0e0f101112"
+string(22) "588c979a61c663d2f066d0"
@@ -0,0 +1,62 @@
+--TEST--
+Symmetric cipher: key and iv state of native objects
+--FILE--
+<?php
+
+echo "- mode:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\SymmetricModeCbc($c);
+
+try {
+    $o->encrypt(str_repeat("a", 16));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+// key set on the cipher object is seen by the mode
+$c->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+
+try {
+    $o->encrypt(str_repeat("a", 16));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o->setIv(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+
+echo "- authenticated cipher:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\AuthenticatedSymmetricCipherGcm($c);
+$c->setKey(Cryptopp\HexUtils::hex2bin("feffe9928665731c6d6a8f9467308308"));
+
+try {
+    $o->encrypt(str_repeat("a", 16));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o->setIv(Cryptopp\HexUtils::hex2bin("cafebabefacedbaddecaf888"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("d9313225f88406e5a55909c5aff5269a"))));
+
+try {
+    $o->addEncryptionAdditionalData("aad");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o->restart();
+$o->addEncryptionAdditionalData("aad");
+var_dump(strlen($o->finalizeEncryption()));
+
+?>
+--EXPECT--
+- mode:
+Cryptopp\SymmetricModeCbc : a key is required
+Cryptopp\SymmetricModeCbc : an initialization vector is required
+string(32) "7649abac8119b246cee98e9b12e9197d"
+- authenticated cipher:
+Cryptopp\AuthenticatedSymmetricCipherGcm : an initialization vector is required
+string(32) "42831ec2217774244b7221b784d0d49c"
+Cryptopp\AuthenticatedSymmetricCipherGcm: additional authenticated data must be added before any encryption
+int(16)
@@ -0,0 +1,82 @@
+--TEST--
+Stream cipher: ChaCha20 seek
+--FILE--
+<?php
+
+$o = new Cryptopp\StreamCipherChaCha20();
+$o->setKey(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("000000000000004a00000000"));
+
+// encrypt
+echo "- encrypt:\n";
+$o->seek(16);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+$o->seek(5);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("0000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// rfc 8439 section 2.4.2 starts with the block counter set to 1
+echo "- rfc 8439:\n";
+$o->seek(64);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.")));
+
+// decrypt
+echo "- decrypt:\n";
+$o->seek(16);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("d258a22a6dcb4bb9f6569cb3efe2deaf"))));
+
+// seek is consistent with sequential encryption across keystream blocks
+echo "- large offset:\n";
+$o->restart();
+$data = str_repeat("a", 1000);
+$encrypted = $o->encrypt($data);
+$o->seek(131);
+var_dump(substr($encrypted, 131) === $o->encrypt(substr($data, 131)));
+
+// the 32 bits block counter gives 2^32 blocks of 64 bytes per nonce
+echo "- end of keystream:\n";
+$o->seek(274877906880);
+var_dump(strlen($o->encrypt(str_repeat("a", 64))));
+
+try {
+    $o->encrypt("a");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->seek(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->seek(274877907008);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- encrypt:
+string(32) "d258a22a6dcb4bb9f6569cb3efe2deaf"
+string(22) "a0354981329a806a140eaf"
+string(32) "d258a22a6dcb4bb9f6569cb3efe2deaf"
+- rfc 8439:
+string(228) "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab77937365af90bbf74a35be6b40b8eedf2785e42874d"
+- decrypt:
+string(32) "00000000000000000000000000000000"
+- large offset:
+bool(true)
+- end of keystream:
+int(64)
+ChaCha20 : block counter exhausted, a nonce cannot be used for more than 256 GB
+string(32) "af051e40bba0354981329a806a140eaf"
+- errors:
+Cryptopp\StreamCipherChaCha20: offset cannot be negative
+ChaCha20 : offset exceeds the keystream of a nonce (256 GB)
@@ -0,0 +1,126 @@
+--TEST--
+Stream cipher: ChaCha20
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\StreamCipherChaCha20", "Cryptopp\StreamCipherAbstract", true));
+
+// check algorithm infos
+$o = new Cryptopp\StreamCipherChaCha20();
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+
+// key length check
+echo "- key length check:\n";
+var_dump($o->isValidKeyLength(32));
+var_dump($o->isValidKeyLength(16));
+var_dump($o->isValidKeyLength(0));
+var_dump($o->isValidKeyLength(33));
+
+// iv length check
+echo "- iv length check:\n";
+var_dump($o->isValidIvLength(12));
+var_dump($o->isValidIvLength(8));
+var_dump($o->isValidIvLength(24));
+
+// set key
+echo "- set key:\n";
+$o->setKey("azertyuiopqsdfghjklmwxcvbnwqaxsz");
+var_dump($o->getKey());
+
+// set iv
+echo "- set iv:\n";
+$o->setIv("qsdfghjklmwx");
+var_dump($o->getIv());
+
+// encrypt
+echo "- encrypt:\n";
+$o->setKey(Cryptopp\HexUtils::hex2bin("0000000000000000000000000000000000000000000000000000000000000000"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("000000000000000000000000"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// decrypt
+echo "- decrypt:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("76b8e0ada0f13d90405d6ae55386bd28"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("bdd219b8a08ded1aa836efcc8b770dc7"))));
+
+// restart encryption
+echo "- restart encryption:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// rfc 8439 section 2.4.2
+echo "- rfc 8439:\n";
+$o->setKey(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("000000000000004a00000000"));
+$o->encrypt(str_repeat("\0", 64));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt("Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.")));
+
+// data processed in one call, many keystream blocks at once, or in pieces of any size gives the same result
+echo "- split data:\n";
+$data = "";
+
+for ($i = 0; $i < 2000; $i++) {
+    $data .= chr(($i * 7 + 3) % 256);
+}
+
+$o->restart();
+$encrypted  = $o->encrypt($data);
+$pieces     = "";
+$offset     = 0;
+$o->restart();
+
+foreach (array(1, 63, 64, 65, 127, 256, 3, 512, 909) as $length) {
+    $pieces .= $o->encrypt(substr($data, $offset, $length));
+    $offset += $length;
+}
+
+var_dump($encrypted === $pieces);
+$o->restart();
+var_dump($data === $o->decrypt($encrypted));
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+var_dump(strlen($o->encrypt($data)));
+var_dump(strlen($o->decrypt($data)));
+
+?>
+--EXPECT--
+bool(true)
+string(8) "chacha20"
+int(1)
+- key length check:
+bool(true)
+bool(false)
+bool(false)
+bool(false)
+- iv length check:
+bool(true)
+bool(false)
+bool(false)
+- set key:
+string(32) "azertyuiopqsdfghjklmwxcvbnwqaxsz"
+- set iv:
+string(12) "qsdfghjklmwx"
+- encrypt:
+string(32) "76b8e0ada0f13d90405d6ae55386bd28"
+string(32) "bdd219b8a08ded1aa836efcc8b770dc7"
+- decrypt:
+string(32) "00000000000000000000000000000000"
+string(32) "00000000000000000000000000000000"
+- restart encryption:
+string(32) "76b8e0ada0f13d90405d6ae55386bd28"
+string(32) "76b8e0ada0f13d90405d6ae55386bd28"
+- rfc 8439:
+string(228) "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab77937365af90bbf74a35be6b40b8eedf2785e42874d"
+- split data:
+bool(true)
+bool(true)
+- large data:
+int(10485760)
+int(10485760)
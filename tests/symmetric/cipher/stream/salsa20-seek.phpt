@@ -0,0 +1,50 @@
+--TEST--
+Stream cipher: Salsa20 seek
+--FILE--
+<?php
+
+$o = new Cryptopp\StreamCipherSalsa20();
+$o->setKey(Cryptopp\HexUtils::hex2bin("a7c083feb7aabbff1122334455667788"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("0011223344556677"));
+
+// encrypt
+echo "- encrypt:\n";
+$o->seek(16);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+$o->seek(5);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("0000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// decrypt
+echo "- decrypt:\n";
+$o->seek(16);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("a566b2365dfb197b61a549b299e2149a"))));
+
+// seek is consistent with sequential encryption across keystream blocks
+echo "- large offset:\n";
+$o->restart();
+$data = str_repeat("a", 1000);
+$encrypted = $o->encrypt($data);
+$o->seek(131);
+var_dump(substr($encrypted, 131) === $o->encrypt(substr($data, 131)));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->seek(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- encrypt:
+string(32) "a566b2365dfb197b61a549b299e2149a"
+string(22) "99f686d0039c12603242bf"
+string(32) "a566b2365dfb197b61a549b299e2149a"
+- decrypt:
+string(32) "00000000000000000000000000000000"
+- large offset:
+bool(true)
+- errors:
+Cryptopp\StreamCipherSalsa20: offset cannot be negative
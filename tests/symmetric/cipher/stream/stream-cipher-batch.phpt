@@ -0,0 +1,104 @@
+--TEST--
+Stream cipher: batch encryption
+--FILE--
+<?php
+
+$o = new Cryptopp\StreamCipherSalsa20();
+$o->setKey(Cryptopp\HexUtils::hex2bin("a7c083feb7aabbff1122334455667788"));
+
+$ivs = array(
+    "a" => Cryptopp\HexUtils::hex2bin("0011223344556677"),
+    5   => Cryptopp\HexUtils::hex2bin("8899aabbccddeeff"),
+    "b" => Cryptopp\HexUtils::hex2bin("0011223344556677"),
+);
+
+$data = array(
+    "a" => str_repeat("\0", 32),
+    5   => "Lorem ipsum dolor sit amet",
+    "b" => "",
+);
+
+// encrypt
+echo "- encrypt:\n";
+$encrypted = $o->encryptBatch($ivs, $data);
+var_dump(array_keys($encrypted));
+var_dump(Cryptopp\HexUtils::bin2hex($encrypted["a"]));
+var_dump($encrypted["b"]);
+var_dump($o->decryptBatch($ivs, $encrypted) === $data);
+var_dump($o->encryptBatch(array(), array()));
+
+// same results as setIv() then encrypt()
+echo "- same as encrypt():\n";
+
+foreach ($data as $key => $value) {
+    $o->setIv($ivs[$key]);
+    var_dump($o->encrypt($value) === $encrypted[$key]);
+}
+
+// the keystream of the current iv starts again after a batch, the other direction is not affected
+echo "- current iv:\n";
+$o->setIv(Cryptopp\HexUtils::hex2bin("0011223344556677"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("03ad21c7d699f686d0039c12603242bf"))));
+$o->encryptBatch($ivs, $data);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("a566b2365dfb197b61a549b299e2149a"))));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->encryptBatch(array("a" => "12345678"), array("b" => "data"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->encryptBatch(array(array()), array("data"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->decryptBatch(array("1234"), array("data"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o = new Cryptopp\StreamCipherSalsa20();
+
+try {
+    $o->encryptBatch(array("12345678"), array("data"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- encrypt:
+array(3) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  int(5)
+  [2]=>
+  string(1) "b"
+}
+string(64) "03ad21c7d699f686d0039c12603242bfa566b2365dfb197b61a549b299e2149a"
+string(0) ""
+bool(true)
+array(0) {
+}
+- same as encrypt():
+bool(true)
+bool(true)
+bool(true)
+- current iv:
+string(32) "03ad21c7d699f686d0039c12603242bf"
+string(32) "00000000000000000000000000000000"
+string(32) "03ad21c7d699f686d0039c12603242bf"
+string(32) "00000000000000000000000000000000"
+- errors:
+Cryptopp\StreamCipherSalsa20 : each data must have an initialization vector with the same key
+Cryptopp\StreamCipherSalsa20 : each data and each initialization vector must be a string
+Cryptopp\StreamCipherSalsa20 : 4 is not a valid initialization vector length
+Cryptopp\StreamCipherSalsa20 : a key is required
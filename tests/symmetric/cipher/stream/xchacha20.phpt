@@ -0,0 +1,102 @@
+--TEST--
+Stream cipher: XChaCha20
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\StreamCipherXChaCha20", "Cryptopp\StreamCipherAbstract", true));
+
+// check algorithm infos
+$o = new Cryptopp\StreamCipherXChaCha20();
+var_dump($o->getName());
+var_dump($o->getBlockSize());
+
+// key length check
+echo "- key length check:\n";
+var_dump($o->isValidKeyLength(32));
+var_dump($o->isValidKeyLength(16));
+var_dump($o->isValidKeyLength(0));
+var_dump($o->isValidKeyLength(33));
+
+// iv length check
+echo "- iv length check:\n";
+var_dump($o->isValidIvLength(24));
+var_dump($o->isValidIvLength(12));
+var_dump($o->isValidIvLength(26));
+
+// set key
+echo "- set key:\n";
+$o->setKey("azertyuiopqsdfghjklmwxcvbnwqaxsz");
+var_dump($o->getKey());
+
+// set iv
+echo "- set iv:\n";
+$o->setIv("qsdfghjklmwxcvbnazertyui");
+var_dump($o->getIv());
+
+// encrypt
+echo "- encrypt:\n";
+$o->setKey(Cryptopp\HexUtils::hex2bin("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("404142434445464748494a4b4c4d4e4f5051525354555658"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("0000000000000000000000000000000000000000000000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("0000000000000000000000000000000000000000000000000000000000000000"))));
+
+// decrypt
+echo "- decrypt:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("1131ce9a2a20ae0d67c8935c7789fa1025c9e5bb720fb96f11354fb97af0bd9a"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("adec0863ba60cac8582c48f86cdfc48edd46a48642c5de62ccf11c7b21bf337d"))));
+
+// draft-irtf-cfrg-xchacha test vector, with the block counter starting at 1
+echo "- xchacha draft:\n";
+$o->seek(64);
+$plaintext = "The dhole (pronounced \"dole\") is also known as the Asiatic wild dog, red dog, and whistling dog. It is about the size of a German shepherd but looks more like a long-legged fox. This highly elusive and skilled jumper is classified with wolves, coyotes, jackals, and foxes in the taxonomic family Canidae.";
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt($plaintext)));
+$o->seek(64);
+var_dump($plaintext === $o->decrypt(Cryptopp\HexUtils::hex2bin("4559abba4e48c16102e8bb2c05e6947f50a786de162f9b0b7e592a9b53d0d4e98d8d6410d540a1a6375b26d80dace4fab52384c731acbf16a5923c0c48d3575d4d0d2c673b666faa731061277701093a6bf7a158a8864292a41c48e3a9b4c0daece0f8d98d0d7e05b37a307bbb66333164ec9e1b24ea0d6c3ffddcec4f68e7443056193a03c810e11344ca06d8ed8a2bfb1e8d48cfa6bc0eb4e2464b748142407c9f431aee769960e15ba8b96890466ef2457599852385c661f752ce20f9da0c09ab6b19df74e76a95967446f8d0fd415e7bee2a12a114c20eb5292ae7a349ae577820d5520a1f3fb62a17ce6a7e68fa7c79111d8860920bc048ef43fe84486ccb87c25f0ae045f0cce1e7989a9aa220a28bdd4827e751a24a6d5c62d790a66393b93111c1a55dd7421a10184974c7c5")));
+
+// restart encryption
+echo "- restart encryption:\n";
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// large data
+echo "- large data:\n";
+$data = str_repeat("a", 10485760);
+var_dump(strlen($o->encrypt($data)));
+var_dump(strlen($o->decrypt($data)));
+
+?>
+--EXPECT--
+bool(true)
+string(9) "xchacha20"
+int(1)
+- key length check:
+bool(true)
+bool(false)
+bool(false)
+bool(false)
+- iv length check:
+bool(true)
+bool(false)
+bool(false)
+- set key:
+string(32) "azertyuiopqsdfghjklmwxcvbnwqaxsz"
+- set iv:
+string(24) "qsdfghjklmwxcvbnazertyui"
+- encrypt:
+string(64) "1131ce9a2a20ae0d67c8935c7789fa1025c9e5bb720fb96f11354fb97af0bd9a"
+string(64) "adec0863ba60cac8582c48f86cdfc48edd46a48642c5de62ccf11c7b21bf337d"
+- decrypt:
+string(64) "0000000000000000000000000000000000000000000000000000000000000000"
+string(64) "0000000000000000000000000000000000000000000000000000000000000000"
+- xchacha draft:
+string(608) "4559abba4e48c16102e8bb2c05e6947f50a786de162f9b0b7e592a9b53d0d4e98d8d6410d540a1a6375b26d80dace4fab52384c731acbf16a5923c0c48d3575d4d0d2c673b666faa731061277701093a6bf7a158a8864292a41c48e3a9b4c0daece0f8d98d0d7e05b37a307bbb66333164ec9e1b24ea0d6c3ffddcec4f68e7443056193a03c810e11344ca06d8ed8a2bfb1e8d48cfa6bc0eb4e2464b748142407c9f431aee769960e15ba8b96890466ef2457599852385c661f752ce20f9da0c09ab6b19df74e76a95967446f8d0fd415e7bee2a12a114c20eb5292ae7a349ae577820d5520a1f3fb62a17ce6a7e68fa7c79111d8860920bc048ef43fe84486ccb87c25f0ae045f0cce1e7989a9aa220a28bdd4827e751a24a6d5c62d790a66393b93111c1a55dd7421a10184974c7c5"
+bool(true)
+- restart encryption:
+string(32) "1131ce9a2a20ae0d67c8935c7789fa10"
+string(32) "1131ce9a2a20ae0d67c8935c7789fa10"
+- large data:
+int(10485760)
+int(10485760)
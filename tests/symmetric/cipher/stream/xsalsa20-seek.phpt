@@ -0,0 +1,50 @@
+--TEST--
+Stream cipher: XSalsa20 seek
+--FILE--
+<?php
+
+$o = new Cryptopp\StreamCipherXSalsa20();
+$o->setKey(Cryptopp\HexUtils::hex2bin("2ecbb5a282ee515b3226952d11d0579607f653a708d18920d18dc5106f76074f"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("53f67a3bada58382426b7d2142c327c7a9fa75a8634463c7"));
+
+// encrypt
+echo "- encrypt:\n";
+$o->seek(16);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+$o->seek(5);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("0000000000000000000000"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"))));
+
+// decrypt
+echo "- decrypt:\n";
+$o->seek(16);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("39b420e15e86515fa935e6b32cf727c4"))));
+
+// seek is consistent with sequential encryption across keystream blocks
+echo "- large offset:\n";
+$o->restart();
+$data = str_repeat("a", 1000);
+$encrypted = $o->encrypt($data);
+$o->seek(131);
+var_dump(substr($encrypted, 131) === $o->encrypt(substr($data, 131)));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->seek(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- encrypt:
+string(32) "39b420e15e86515fa935e6b32cf727c4"
+string(22) "658edf4fbb3a9dd5ad2b71"
+string(32) "39b420e15e86515fa935e6b32cf727c4"
+- decrypt:
+string(32) "00000000000000000000000000000000"
+- large offset:
+bool(true)
+- errors:
+Cryptopp\StreamCipherXSalsa20: offset cannot be negative
@@ -0,0 +1,138 @@
+--TEST--
+Cipher mode: batch encryption
+--FILE--
+<?php
+
+$ivs = array(
+    "a" => Cryptopp\HexUtils::hex2bin("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"),
+    5   => Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"),
+    "b" => Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"),
+    "x" => Cryptopp\HexUtils::hex2bin("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"),
+);
+
+// CTR
+echo "- ctr:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\SymmetricModeCtr($c);
+$o->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+
+$data = array(
+    "a" => Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"),
+    5   => Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"),
+    "b" => "Lorem ipsum",
+    "x" => "",
+);
+
+$encrypted = $o->encryptBatch($ivs, $data);
+var_dump(array_keys($encrypted));
+var_dump(Cryptopp\HexUtils::bin2hex($encrypted["a"]));
+var_dump(Cryptopp\HexUtils::bin2hex($encrypted[5]));
+var_dump(Cryptopp\HexUtils::bin2hex($encrypted["b"]));
+var_dump($encrypted["x"]);
+var_dump($o->decryptBatch($ivs, $encrypted) === $data);
+var_dump($o->encryptBatch(array(), array()));
+
+// CBC, with a key set on the cipher object
+echo "- cbc:\n";
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\SymmetricModeCbc($c);
+$c->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+
+$data = array(
+    5   => Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"),
+    "a" => Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"),
+);
+
+$encrypted = $o->encryptBatch($ivs, $data);
+var_dump(Cryptopp\HexUtils::bin2hex($encrypted[5]));
+var_dump(Cryptopp\HexUtils::bin2hex($encrypted["a"]));
+var_dump($o->decryptBatch($ivs, $encrypted) === $data);
+
+// same results as setIv() then encrypt()
+echo "- same as encrypt():\n";
+
+foreach ($data as $key => $value) {
+    $o->setIv($ivs[$key]);
+    var_dump($o->encrypt($value) === $encrypted[$key]);
+}
+
+// the current iv is used again after a batch
+echo "- current iv:\n";
+$o->setIv(Cryptopp\HexUtils::hex2bin("000102030405060708090a0b0c0d0e0f"));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+$o->encryptBatch($ivs, $data);
+$o->decryptBatch($ivs, $encrypted);
+var_dump(Cryptopp\HexUtils::bin2hex($o->getIv()));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->encryptBatch(array(), array("1234567890123456"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->encryptBatch(array("1234567890123456"), array(123));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->decryptBatch(array("123"), array("1234567890123456"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->encryptBatch(array("1234567890123456"), array("12345"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o = new Cryptopp\SymmetricModeCtr(new Cryptopp\BlockCipherAes());
+
+try {
+    $o->encryptBatch(array("1234567890123456"), array("12345"));
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- ctr:
+array(4) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  int(5)
+  [2]=>
+  string(1) "b"
+  [3]=>
+  string(1) "x"
+}
+string(64) "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+string(32) "3b3fd92eb72dad20333449f8e83cfb4a"
+string(22) "1c9115a9f44d5bc6a97c5a"
+string(0) ""
+bool(true)
+array(0) {
+}
+- cbc:
+string(64) "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+string(32) "77cde91fe6df9cbc5d0c98f96efd590b"
+bool(true)
+- same as encrypt():
+bool(true)
+bool(true)
+- current iv:
+string(32) "7649abac8119b246cee98e9b12e9197d"
+string(32) "000102030405060708090a0b0c0d0e0f"
+string(32) "7649abac8119b246cee98e9b12e9197d"
+- errors:
+Cryptopp\SymmetricModeCbc : each data must have an initialization vector with the same key
+Cryptopp\SymmetricModeCbc : each data and each initialization vector must be a string
+Cryptopp\SymmetricModeCbc : 3 is not a valid initialization vector length
+Cryptopp\SymmetricModeCbc: data size (5) is not a multiple of block size (16)
+Cryptopp\SymmetricModeCtr : a key is required
@@ -0,0 +1,92 @@
+--TEST--
+Cipher mode: CBC and CFB decryption with user class process runs of blocks with a single call
+--FILE--
+<?php
+
+class BlockCipherUser implements Cryptopp\BlockCipherInterface
+{
+    public $blockCalls = 0;
+    public $bulkCalls = 0;
+
+    public function getName()
+    {
+        return "user";
+    }
+
+    public function getBlockSize()
+    {
+        return 6;
+    }
+
+    public function isValidKeyLength($keyLength)
+    {
+        return 3 == $keyLength;
+    }
+
+    public function setKey($key)
+    {
+    }
+
+    public function encryptBlock($data)
+    {
+        $this->blockCalls++;
+        return strrev($data);
+    }
+
+    public function decryptBlock($data)
+    {
+        $this->blockCalls++;
+        return strrev($data);
+    }
+
+    public function encrypt($data)
+    {
+        $this->bulkCalls++;
+        return implode("", array_map("strrev", str_split($data, 6)));
+    }
+
+    public function decrypt($data)
+    {
+        $this->bulkCalls++;
+        return implode("", array_map("strrev", str_split($data, 6)));
+    }
+}
+
+$data = "abcdef123456ghijkl789012";
+
+// cbc
+echo "- cbc:\n";
+$c = new BlockCipherUser();
+$o = new Cryptopp\SymmetricModeCbc($c);
+$o->setKey("key");
+$o->setIv("ivivi0");
+$encrypted = $o->encrypt($data);
+var_dump($c->bulkCalls);
+$o->restart();
+$c->blockCalls = 0;
+var_dump($o->decrypt($encrypted));
+var_dump($c->bulkCalls, $c->blockCalls);
+
+// cfb
+echo "- cfb:\n";
+$c = new BlockCipherUser();
+$o = new Cryptopp\SymmetricModeCfb($c);
+$o->setKey("key");
+$o->setIv("ivivi0");
+$encrypted = $o->encrypt($data);
+var_dump($c->bulkCalls);
+$o->restart();
+var_dump($o->decrypt($encrypted));
+var_dump($c->bulkCalls);
+
+?>
+--EXPECT--
+- cbc:
+int(0)
+string(24) "abcdef123456ghijkl789012"
+int(1)
+int(1)
+- cfb:
+int(0)
+string(24) "abcdef123456ghijkl789012"
+int(1)
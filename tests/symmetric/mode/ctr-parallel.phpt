@@ -0,0 +1,67 @@
+--TEST--
+Cipher mode: CTR multi-threaded processing
+--FILE--
+<?php
+
+$key = Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c");
+$iv  = Cryptopp\HexUtils::hex2bin("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+
+$serial = new Cryptopp\SymmetricModeCtr(new Cryptopp\BlockCipherAes());
+$serial->setKey($key);
+$serial->setIv($iv);
+$serial->setParallelThreshold(0);
+
+$parallel = new Cryptopp\SymmetricModeCtr(new Cryptopp\BlockCipherAes());
+$parallel->setKey($key);
+$parallel->setIv($iv);
+$parallel->setParallelThreshold(1024);
+
+// threshold
+echo "- threshold:\n";
+$o = new Cryptopp\SymmetricModeCtr(new Cryptopp\BlockCipherAes());
+var_dump($o->getParallelThreshold());
+var_dump($serial->getParallelThreshold());
+var_dump($parallel->getParallelThreshold());
+
+// same output as the single threaded path, with unaligned and chained calls
+echo "- encrypt:\n";
+$data = str_repeat("0123456789abcdefghijklmnopqrstu", 270601);
+var_dump($serial->encrypt("abc") === $parallel->encrypt("abc"));
+var_dump($serial->encrypt($data) === $parallel->encrypt($data));
+var_dump($serial->encrypt("defghijklmnopqrstuvwxyz") === $parallel->encrypt("defghijklmnopqrstuvwxyz"));
+
+echo "- decrypt:\n";
+$serial->restart();
+$parallel->restart();
+$encrypted = $serial->encrypt($data);
+var_dump($data === $parallel->decrypt($encrypted));
+
+echo "- seek:\n";
+$serial->seek(123457);
+$parallel->seek(123457);
+var_dump($serial->encrypt($data) === $parallel->encrypt($data));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->setParallelThreshold(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- threshold:
+int(4194304)
+int(0)
+int(1024)
+- encrypt:
+bool(true)
+bool(true)
+bool(true)
+- decrypt:
+bool(true)
+- seek:
+bool(true)
+- errors:
+Cryptopp\SymmetricModeCtr: threshold cannot be negative
@@ -0,0 +1,52 @@
+--TEST--
+Cipher mode: CTR seek
+--FILE--
+<?php
+
+$c = new Cryptopp\BlockCipherAes();
+$o = new Cryptopp\SymmetricModeCtr($c);
+$o->setKey(Cryptopp\HexUtils::hex2bin("2b7e151628aed2a6abf7158809cf4f3c"));
+$o->setIv(Cryptopp\HexUtils::hex2bin("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+
+// encrypt
+echo "- encrypt:\n";
+$o->seek(32);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("30c81c46a35ce411e5fbc1191a0a52ef"))));
+$o->seek(20);
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("1e03ac9c9eb76fac45af8e51"))));
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("30c81c46a35ce411e5fbc1191a0a52ef"))));
+
+// decrypt
+echo "- decrypt:\n";
+$o->seek(48);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("1e031dda2fbe03d1792170a0f3009cee"))));
+$o->seek(0);
+var_dump(Cryptopp\HexUtils::bin2hex($o->decrypt(Cryptopp\HexUtils::hex2bin("874d6191b620e3261bef6864990db6ce"))));
+
+// seek then restart
+echo "- restart:\n";
+$o->seek(16);
+$o->restart();
+var_dump(Cryptopp\HexUtils::bin2hex($o->encrypt(Cryptopp\HexUtils::hex2bin("6bc1bee22e409f96e93d7e117393172a"))));
+
+// errors
+echo "- errors:\n";
+try {
+    $o->seek(-1);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+- encrypt:
+string(32) "5ae4df3edbd5d35e5b4f09020db03eab"
+string(24) "7970fdff8617187bb9fffdff"
+string(32) "5ae4df3edbd5d35e5b4f09020db03eab"
+- decrypt:
+string(32) "f69f2445df4f9b17ad2b417be66c3710"
+string(32) "6bc1bee22e409f96e93d7e117393172a"
+- restart:
+string(32) "874d6191b620e3261bef6864990db6ce"
+- errors:
+Cryptopp\SymmetricModeCtr: offset cannot be negative
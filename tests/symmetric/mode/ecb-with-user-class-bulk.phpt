@@ -0,0 +1,98 @@
+--TEST--
+Cipher mode: ECB with user class processes runs of blocks with a single call
+--FILE--
+<?php
+
+class BlockCipherUser implements Cryptopp\BlockCipherInterface
+{
+    public $blockCalls = 0;
+    public $bulkCalls = 0;
+
+    public function getName()
+    {
+        return "user";
+    }
+
+    public function getBlockSize()
+    {
+        return 6;
+    }
+
+    public function isValidKeyLength($keyLength)
+    {
+        return 3 == $keyLength;
+    }
+
+    public function setKey($key)
+    {
+    }
+
+    public function encryptBlock($data)
+    {
+        $this->blockCalls++;
+        return strrev($data);
+    }
+
+    public function decryptBlock($data)
+    {
+        $this->blockCalls++;
+        return strrev($data);
+    }
+
+    public function encrypt($data)
+    {
+        $this->bulkCalls++;
+        return implode("", array_map("strrev", str_split($data, 6)));
+    }
+
+    public function decrypt($data)
+    {
+        $this->bulkCalls++;
+        return implode("", array_map("strrev", str_split($data, 6)));
+    }
+}
+
+$data = "abcdef123456ghijkl789012";
+
+// ecb
+echo "- ecb:\n";
+$c = new BlockCipherUser();
+$o = new Cryptopp\SymmetricModeEcb($c);
+$o->setKey("key");
+$encrypted = $o->encrypt($data);
+var_dump($encrypted);
+var_dump($c->bulkCalls, $c->blockCalls);
+$o->restart();
+var_dump($o->decrypt($encrypted));
+
+// cbc round trip
+echo "- cbc:\n";
+$c = new BlockCipherUser();
+$o = new Cryptopp\SymmetricModeCbc($c);
+$o->setKey("key");
+$o->setIv("ivivi0");
+$encrypted = $o->encrypt($data);
+$o->restart();
+var_dump($o->decrypt($encrypted));
+
+// ctr round trip
+echo "- ctr:\n";
+$c = new BlockCipherUser();
+$o = new Cryptopp\SymmetricModeCtr($c);
+$o->setKey("key");
+$o->setIv("ivivi0");
+$encrypted = $o->encrypt($data);
+$o->restart();
+var_dump($o->decrypt($encrypted));
+
+?>
+--EXPECT--
+- ecb:
+string(24) "fedcba654321lkjihg210987"
+int(1)
+int(0)
+string(24) "abcdef123456ghijkl789012"
+- cbc:
+string(24) "abcdef123456ghijkl789012"
+- ctr:
+string(24) "abcdef123456ghijkl789012"
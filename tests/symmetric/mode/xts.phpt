@@ -0,0 +1,130 @@
+--TEST--
+Cipher mode: XTS
+--FILE--
+<?php
+
+var_dump(is_a("Cryptopp\SymmetricModeXts", "Cryptopp\SymmetricModeInterface", true));
+
+// check algorithm infos
+$c1 = new Cryptopp\BlockCipherAes();
+$c2 = new Cryptopp\BlockCipherAes();
+$o  = new Cryptopp\SymmetricModeXts($c1, $c2);
+var_dump($o->getName());
+
+// IEEE 1619 test vectors
+echo "- sector:\n";
+$c1->setKey(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"));
+$c2->setKey(Cryptopp\HexUtils::hex2bin("00000000000000000000000000000000"));
+$ct = $o->encryptSector(0, Cryptopp\HexUtils::hex2bin(str_repeat("00", 32)));
+var_dump(Cryptopp\HexUtils::bin2hex($ct));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decryptSector(0, $ct)));
+
+$c1->setKey(Cryptopp\HexUtils::hex2bin("11111111111111111111111111111111"));
+$c2->setKey(Cryptopp\HexUtils::hex2bin("22222222222222222222222222222222"));
+$ct = $o->encryptSector(0x3333333333, Cryptopp\HexUtils::hex2bin(str_repeat("44", 32)));
+var_dump(Cryptopp\HexUtils::bin2hex($ct));
+var_dump(Cryptopp\HexUtils::bin2hex($o->decryptSector(0x3333333333, $ct)));
+
+// ciphertext stealing
+echo "- ciphertext stealing:\n";
+$c1->setKey(Cryptopp\HexUtils::hex2bin("fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0"));
+$c2->setKey(Cryptopp\HexUtils::hex2bin("bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0"));
+$data = "";
+
+for ($i = 0; $i < 80; $i++) {
+    $data .= chr($i);
+}
+
+foreach (array(17, 18, 19, 20) as $size) {
+    $pt = substr($data, 0, $size);
+    $ct = $o->encryptSector(0x123456789a, $pt);
+    var_dump(Cryptopp\HexUtils::bin2hex($ct));
+    var_dump($pt === $o->decryptSector(0x123456789a, $ct));
+}
+
+// several sectors at once
+echo "- sectors:\n";
+foreach (array(32, 40) as $sectorSize) {
+    $ct = $o->encryptSectors(5, $data, $sectorSize);
+    var_dump(Cryptopp\HexUtils::bin2hex($ct));
+    var_dump($data === $o->decryptSectors(5, $ct, $sectorSize));
+
+    $expected = "";
+    foreach (str_split($data, $sectorSize) as $i => $sector) {
+        $expected .= $o->encryptSector(5 + $i, $sector);
+    }
+    var_dump($expected === $ct);
+}
+
+// errors
+echo "- errors:\n";
+try {
+    $o->encryptSector(-1, $data);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->encryptSector(0, "123456789012345");
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->decryptSectors(0, $data, 15);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    $o->encryptSectors(0, $data, 36);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+$o = new Cryptopp\SymmetricModeXts($c1, new Cryptopp\BlockCipherAes());
+
+try {
+    $o->encryptSector(0, $data);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+try {
+    serialize($o);
+} catch (Cryptopp\CryptoppException $e) {
+    echo $e->getMessage() . "\n";
+}
+
+?>
+--EXPECT--
+bool(false)
+string(8) "xts(aes)"
+- sector:
+string(64) "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e"
+string(64) "0000000000000000000000000000000000000000000000000000000000000000"
+string(64) "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0"
+string(64) "4444444444444444444444444444444444444444444444444444444444444444"
+- ciphertext stealing:
+string(34) "6c1625db4671522d3d7599601de7ca09ed"
+bool(true)
+string(36) "d069444b7a7e0cab09e24447d24deb1fedbf"
+bool(true)
+string(38) "e5df1351c0544ba1350b3363cd8ef4beedbf9d"
+bool(true)
+string(40) "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac"
+bool(true)
+- sectors:
+string(160) "333992c10ec939db7e1c130a2b251a51ac264874364aedca07f997b27927c8571923b5fb4db01400c772288b386fca549257801bc36bf87b57776e7b5b5fc1d78ff14e7cd0218924fbf41ef08aa90971"
+bool(true)
+bool(true)
+string(160) "333992c10ec939db7e1c130a2b251a5178a467691140552725f8cc6448709662ac264874364aedca9a7b9d455759a11417373f4ce668233378c0464512521b75279d0dc3b2be9cba68b606b4574a6ab6"
+bool(true)
+bool(true)
+- errors:
+Cryptopp\SymmetricModeXts: sector cannot be negative
+Cryptopp\SymmetricModeXts: each sector must be at least 16 bytes long
+Cryptopp\SymmetricModeXts: sector size must be at least 16 bytes, 15 given
+Cryptopp\SymmetricModeXts: each sector must be at least 16 bytes long
+Cryptopp\BlockCipherAes : a key is required
+You cannot serialize or unserialize Cryptopp\SymmetricModeXts instances